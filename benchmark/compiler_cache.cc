@@ -0,0 +1,136 @@
+#include <benchmark/benchmark.h>
+
+#include <sourcemeta/blaze/foundation.h>
+#include <sourcemeta/core/json.h>
+
+#include <sourcemeta/jsonbinpack/compiler.h>
+#include <sourcemeta/jsonbinpack/runtime.h>
+
+#include <cstdint>    // std::int64_t
+#include <filesystem> // std::filesystem
+#include <fstream>    // std::ofstream
+#include <string>     // std::string, std::to_string
+#include <utility>    // std::move
+#include <vector>     // std::vector
+
+// A directory of record schemas, each slightly different from the others, like
+// the ones a service would compile and load when starting up
+static auto schemas_directory() -> const std::filesystem::path & {
+  static const auto result{[] {
+    const auto directory{std::filesystem::temp_directory_path() /
+                         "jsonbinpack_benchmark_schemas"};
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    for (std::int64_t index = 0; index < 100; index++) {
+      auto status{sourcemeta::core::JSON::make_array()};
+      for (std::int64_t choice = 0; choice < 2 + index % 5; choice++) {
+        status.push_back(
+            sourcemeta::core::JSON{"status_" + std::to_string(choice)});
+      }
+
+      auto properties{sourcemeta::core::parse_json(R"JSON({
+        "name": { "type": "string" },
+        "tags": {
+          "type": "array",
+          "items": { "type": "string", "maxLength": 16 }
+        },
+        "position": {
+          "type": "object",
+          "properties": {
+            "x": { "type": "number" },
+            "y": { "type": "number" }
+          },
+          "required": [ "x", "y" ],
+          "additionalProperties": false
+        },
+        "timestamp": { "type": "string", "format": "date" }
+      })JSON")};
+      auto identifier{sourcemeta::core::JSON::make_object()};
+      identifier.assign("type", sourcemeta::core::JSON{"integer"});
+      identifier.assign("minimum", sourcemeta::core::JSON{0});
+      identifier.assign("maximum", sourcemeta::core::JSON{100 + index});
+      properties.assign("id", std::move(identifier));
+      auto status_schema{sourcemeta::core::JSON::make_object()};
+      status_schema.assign("enum", std::move(status));
+      properties.assign("status", std::move(status_schema));
+
+      auto schema{sourcemeta::core::JSON::make_object()};
+      schema.assign("$schema", sourcemeta::core::JSON{
+                                   "https://json-schema.org/draft/2020-12/"
+                                   "schema"});
+      schema.assign("type", sourcemeta::core::JSON{"object"});
+      schema.assign("properties", std::move(properties));
+      schema.assign("required", sourcemeta::core::parse_json(
+                                    R"JSON([ "id", "status" ])JSON"));
+      schema.assign("additionalProperties", sourcemeta::core::JSON{false});
+      std::ofstream stream{directory /
+                           ("schema_" + std::to_string(index) + ".json")};
+      sourcemeta::core::stringify(schema, stream);
+    }
+
+    return directory;
+  }()};
+  return result;
+}
+
+static auto schema_paths() -> std::vector<std::filesystem::path> {
+  std::vector<std::filesystem::path> result;
+  for (const auto &entry :
+       std::filesystem::directory_iterator{schemas_directory()}) {
+    result.push_back(entry.path());
+  }
+
+  return result;
+}
+
+static void Compiler_Startup_Uncached(benchmark::State &state) {
+  const auto paths{schema_paths()};
+  for (auto _ : state) {
+    std::vector<sourcemeta::jsonbinpack::Encoding> encodings;
+    for (const auto &path : paths) {
+      auto schema{sourcemeta::core::read_json(path)};
+      sourcemeta::jsonbinpack::compile(schema,
+                                       sourcemeta::blaze::schema_walker,
+                                       sourcemeta::blaze::schema_resolver);
+      encodings.push_back(sourcemeta::jsonbinpack::load(schema));
+    }
+
+    benchmark::DoNotOptimize(encodings);
+  }
+
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(paths.size()));
+}
+
+static void Compiler_Startup_Cached(benchmark::State &state) {
+  const auto paths{schema_paths()};
+  const auto cache_directory{std::filesystem::temp_directory_path() /
+                             "jsonbinpack_benchmark_cache"};
+  std::filesystem::remove_all(cache_directory);
+  const sourcemeta::jsonbinpack::CompilerCache cache{cache_directory};
+  // Populate the cache, like a previous run of the same service would
+  for (const auto &path : paths) {
+    auto schema{sourcemeta::core::read_json(path)};
+    cache.compile(schema, sourcemeta::blaze::schema_walker,
+                  sourcemeta::blaze::schema_resolver);
+  }
+
+  for (auto _ : state) {
+    std::vector<sourcemeta::jsonbinpack::Encoding> encodings;
+    for (const auto &path : paths) {
+      auto schema{sourcemeta::core::read_json(path)};
+      cache.compile(schema, sourcemeta::blaze::schema_walker,
+                    sourcemeta::blaze::schema_resolver);
+      encodings.push_back(sourcemeta::jsonbinpack::load(schema));
+    }
+
+    benchmark::DoNotOptimize(encodings);
+  }
+
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(paths.size()));
+  std::filesystem::remove_all(cache_directory);
+}
+
+BENCHMARK(Compiler_Startup_Uncached)->Unit(benchmark::kMillisecond);
+BENCHMARK(Compiler_Startup_Cached)->Unit(benchmark::kMillisecond);
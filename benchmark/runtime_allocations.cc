@@ -0,0 +1,111 @@
+#include <benchmark/benchmark.h>
+
+#include <sourcemeta/core/json.h>
+
+#include <sourcemeta/jsonbinpack/runtime.h>
+
+#include <atomic>  // std::atomic
+#include <cstddef> // std::byte, std::size_t
+#include <cstdint> // std::int64_t
+#include <cstdlib> // std::malloc, std::free
+#include <new>     // std::bad_alloc
+#include <span>    // std::span
+#include <string>  // std::to_string
+#include <utility> // std::move
+#include <vector>  // std::vector
+
+// Count every heap allocation of the process, so that benchmarks can report
+// how many allocations each iteration performs. These benchmarks are built
+// into their own executable so that the others do not pay for the counting
+static std::atomic<std::size_t> allocations{0};
+
+auto operator new(std::size_t size) -> void * {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  void *pointer{std::malloc(size == 0 ? 1 : size)};
+  if (pointer == nullptr) {
+    throw std::bad_alloc{};
+  }
+
+  return pointer;
+}
+
+// GCC cannot tell that these replace the global allocation functions, and
+// considers freeing what they allocate a mismatch
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+auto operator delete(void *pointer) noexcept -> void { std::free(pointer); }
+
+auto operator delete(void *pointer, std::size_t) noexcept -> void {
+  std::free(pointer);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+// Schema-less traffic made of many small containers
+static auto containers_document() -> sourcemeta::core::JSON {
+  auto document{sourcemeta::core::JSON::make_array()};
+  for (std::int64_t index = 0; index < 100; index++) {
+    auto tags{sourcemeta::core::JSON::make_array()};
+    tags.push_back(sourcemeta::core::JSON{index});
+    tags.push_back(sourcemeta::core::JSON{index % 2 == 0});
+    tags.push_back(sourcemeta::core::JSON{nullptr});
+    auto position{sourcemeta::core::JSON::make_object()};
+    position.assign("x", sourcemeta::core::JSON{index});
+    position.assign("y", sourcemeta::core::JSON{-index});
+    auto record{sourcemeta::core::JSON::make_object()};
+    record.assign("id", sourcemeta::core::JSON{index});
+    record.assign("tags", std::move(tags));
+    record.assign("position", std::move(position));
+    record.assign("nested", sourcemeta::core::JSON::make_array());
+    document.push_back(std::move(record));
+  }
+
+  return document;
+}
+
+static void ANY_PACKED_Encode_Containers_Allocations(benchmark::State &state) {
+  const auto document{containers_document()};
+  const sourcemeta::jsonbinpack::ANY_PACKED_TYPE_TAG_BYTE_PREFIX encoding;
+  std::vector<std::byte> buffer;
+  sourcemeta::jsonbinpack::Encoder encoder{buffer};
+  // Warm up the buffer and the string cache
+  encoder.write(document, encoding);
+  std::size_t total{0};
+  for (auto _ : state) {
+    buffer.clear();
+    encoder.reset(buffer);
+    const auto before{allocations.load(std::memory_order_relaxed)};
+    encoder.write(document, encoding);
+    total += allocations.load(std::memory_order_relaxed) - before;
+    benchmark::DoNotOptimize(buffer.data());
+  }
+
+  state.counters["allocations"] = benchmark::Counter(
+      static_cast<double>(total), benchmark::Counter::kAvgIterations);
+}
+
+static void ANY_PACKED_Decode_Containers_Allocations(benchmark::State &state) {
+  const sourcemeta::jsonbinpack::ANY_PACKED_TYPE_TAG_BYTE_PREFIX encoding;
+  std::vector<std::byte> buffer;
+  sourcemeta::jsonbinpack::Encoder encoder{buffer};
+  encoder.write(containers_document(), encoding);
+  sourcemeta::jsonbinpack::Decoder decoder{
+      std::span<const std::byte>{buffer}};
+  std::size_t total{0};
+  for (auto _ : state) {
+    decoder.reset(std::span<const std::byte>{buffer});
+    const auto before{allocations.load(std::memory_order_relaxed)};
+    auto result{decoder.read(encoding)};
+    total += allocations.load(std::memory_order_relaxed) - before;
+    benchmark::DoNotOptimize(result);
+  }
+
+  state.counters["allocations"] = benchmark::Counter(
+      static_cast<double>(total), benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(ANY_PACKED_Encode_Containers_Allocations);
+BENCHMARK(ANY_PACKED_Decode_Containers_Allocations);
@@ -0,0 +1,110 @@
+#include <benchmark/benchmark.h>
+
+#include <sourcemeta/core/json.h>
+
+#include <sourcemeta/jsonbinpack/runtime.h>
+
+#include <cstddef> // std::byte, std::size_t
+#include <cstdint> // std::int64_t
+#include <sstream> // std::istringstream, std::ostringstream
+#include <string>  // std::string, std::to_string
+#include <utility> // std::move
+#include <vector>  // std::vector
+
+// The string lengths exercise the TYPE_LONG_STRING (31 to 61 bytes) and the
+// SUBTYPE_LONG_STRING_BASE_EXPONENT_* (128 bytes and over) code paths
+static void string_lengths(benchmark::internal::Benchmark *benchmark) {
+  benchmark->Arg(48)->Arg(200)->Arg(300)->Arg(600)->Arg(2048)->Arg(16384);
+}
+
+static void ANY_PACKED_Encode_Long_String(benchmark::State &state) {
+  const sourcemeta::core::JSON document{sourcemeta::core::JSON::String(
+      static_cast<std::size_t>(state.range(0)), 'x')};
+  const sourcemeta::jsonbinpack::ANY_PACKED_TYPE_TAG_BYTE_PREFIX encoding;
+  std::ostringstream stream;
+  for (auto _ : state) {
+    stream.str("");
+    sourcemeta::jsonbinpack::Encoder encoder{stream};
+    encoder.write(document, encoding);
+    benchmark::DoNotOptimize(stream);
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+static void ANY_PACKED_Decode_Long_String(benchmark::State &state) {
+  const sourcemeta::core::JSON document{sourcemeta::core::JSON::String(
+      static_cast<std::size_t>(state.range(0)), 'x')};
+  const sourcemeta::jsonbinpack::ANY_PACKED_TYPE_TAG_BYTE_PREFIX encoding;
+  std::ostringstream output;
+  sourcemeta::jsonbinpack::Encoder encoder{output};
+  encoder.write(document, encoding);
+  std::istringstream stream{output.str()};
+  for (auto _ : state) {
+    stream.clear();
+    stream.seekg(0);
+    sourcemeta::jsonbinpack::Decoder decoder{stream};
+    auto result{decoder.read(encoding)};
+    benchmark::DoNotOptimize(result);
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+// Around 600 KiB of JSON text describing log events
+static auto events_text() -> std::string {
+  auto document{sourcemeta::core::JSON::make_array()};
+  for (std::int64_t index = 0; index < 10000; index++) {
+    auto event{sourcemeta::core::JSON::make_object()};
+    event.assign("sequence", sourcemeta::core::JSON{index});
+    event.assign("level", sourcemeta::core::JSON{index % 7 == 0 ? "warning"
+                                                                : "info"});
+    event.assign("message",
+                 sourcemeta::core::JSON{"event number " +
+                                        std::to_string(index * 7919)});
+    event.assign("tags", sourcemeta::core::JSON::make_array());
+    event.at("tags").push_back(sourcemeta::core::JSON{"runtime"});
+    event.at("tags").push_back(
+        sourcemeta::core::JSON{static_cast<double>(index) * 0.5});
+    document.push_back(std::move(event));
+  }
+
+  std::ostringstream stream;
+  sourcemeta::core::stringify(document, stream);
+  return stream.str();
+}
+
+static void ANY_PACKED_Encode_Text_Parse(benchmark::State &state) {
+  const auto text{events_text()};
+  const sourcemeta::jsonbinpack::Encoding encoding{
+      sourcemeta::jsonbinpack::ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  std::vector<std::byte> buffer;
+  for (auto _ : state) {
+    buffer.clear();
+    sourcemeta::jsonbinpack::Encoder encoder{buffer};
+    encoder.write(sourcemeta::core::parse_json(text), encoding);
+    benchmark::DoNotOptimize(buffer);
+  }
+
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<std::int64_t>(text.size()));
+}
+
+static void ANY_PACKED_Encode_Text_Transcode(benchmark::State &state) {
+  const auto text{events_text()};
+  std::vector<std::byte> buffer;
+  for (auto _ : state) {
+    buffer.clear();
+    sourcemeta::jsonbinpack::Encoder encoder{buffer};
+    encoder.transcode(text);
+    benchmark::DoNotOptimize(buffer);
+  }
+
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<std::int64_t>(text.size()));
+}
+
+BENCHMARK(ANY_PACKED_Encode_Long_String)->Apply(string_lengths);
+BENCHMARK(ANY_PACKED_Decode_Long_String)->Apply(string_lengths);
+BENCHMARK(ANY_PACKED_Encode_Text_Parse);
+BENCHMARK(ANY_PACKED_Encode_Text_Transcode);
@@ -0,0 +1,92 @@
+#include <benchmark/benchmark.h>
+
+#include <sourcemeta/core/json.h>
+
+#include <sourcemeta/jsonbinpack/runtime.h>
+
+#include <cstddef> // std::byte, std::size_t
+#include <cstdint> // std::int64_t
+#include <span>    // std::span
+#include <string>  // std::to_string
+#include <utility> // std::move
+#include <vector>  // std::vector
+
+static auto records() -> const std::vector<sourcemeta::core::JSON> & {
+  static const auto result{[] {
+    std::vector<sourcemeta::core::JSON> documents;
+    for (std::int64_t index = 0; index < 20000; index++) {
+      auto record{sourcemeta::core::JSON::make_object()};
+      record.assign("sequence", sourcemeta::core::JSON{index});
+      record.assign("level", sourcemeta::core::JSON{"information"});
+      record.assign("message", sourcemeta::core::JSON{"event number " +
+                                                      std::to_string(index)});
+      auto tags{sourcemeta::core::JSON::make_array()};
+      tags.push_back(sourcemeta::core::JSON{"http"});
+      tags.push_back(sourcemeta::core::JSON{index % 7});
+      record.assign("tags", std::move(tags));
+      documents.push_back(std::move(record));
+    }
+
+    return documents;
+  }()};
+  return result;
+}
+
+static void Batch_Encode_Sequential(benchmark::State &state) {
+  const sourcemeta::jsonbinpack::Encoding encoding{
+      sourcemeta::jsonbinpack::ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  std::vector<std::byte> output;
+  std::vector<std::byte> record;
+  for (auto _ : state) {
+    output.clear();
+    sourcemeta::jsonbinpack::OutputStream stream{output};
+    sourcemeta::jsonbinpack::Encoder encoder{record};
+    for (const auto &document : records()) {
+      record.clear();
+      encoder.reset(record);
+      encoder.write(document, encoding);
+      stream.put_varint(record.size());
+      stream.put_bytes(record.data(), record.size());
+    }
+
+    benchmark::DoNotOptimize(output);
+  }
+
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(records().size()));
+}
+
+static void Batch_Encode_Parallel(benchmark::State &state) {
+  const sourcemeta::jsonbinpack::Encoding encoding{
+      sourcemeta::jsonbinpack::ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  std::vector<std::byte> output;
+  for (auto _ : state) {
+    output.clear();
+    sourcemeta::jsonbinpack::encode_batch(
+        records(), encoding, output,
+        static_cast<std::size_t>(state.range(0)));
+    benchmark::DoNotOptimize(output);
+  }
+
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(records().size()));
+}
+
+static void Batch_Decode_Parallel(benchmark::State &state) {
+  const sourcemeta::jsonbinpack::Encoding encoding{
+      sourcemeta::jsonbinpack::ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  std::vector<std::byte> input;
+  sourcemeta::jsonbinpack::encode_batch(records(), encoding, input);
+  for (auto _ : state) {
+    auto result{sourcemeta::jsonbinpack::decode_batch(
+        input, encoding, static_cast<std::size_t>(state.range(0)))};
+    benchmark::DoNotOptimize(result);
+  }
+
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(records().size()));
+}
+
+BENCHMARK(Batch_Encode_Sequential);
+BENCHMARK(Batch_Encode_Parallel)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+BENCHMARK(Batch_Decode_Parallel)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
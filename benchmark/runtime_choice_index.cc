@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+
+#include <sourcemeta/core/json.h>
+
+#include <sourcemeta/jsonbinpack/runtime.h>
+
+#include <cstddef> // std::byte
+#include <cstdint> // std::int64_t
+#include <string>  // std::to_string
+#include <utility> // std::move
+#include <vector>  // std::vector
+
+static void choice_counts(benchmark::internal::Benchmark *benchmark) {
+  benchmark->Arg(10)->Arg(1000)->Arg(100000);
+}
+
+// Enumerations of codes that only differ in their last characters
+static auto choices(const std::int64_t count) -> sourcemeta::core::JSON {
+  auto result{sourcemeta::core::JSON::make_array()};
+  for (std::int64_t index = 0; index < count; index++) {
+    result.push_back(sourcemeta::core::JSON{"SKU-" + std::to_string(index)});
+  }
+
+  return result;
+}
+
+// Encode a value from around the end of the enumeration, which is the
+// worst case for scanning the choices one by one
+static auto encode_choices(benchmark::State &state,
+                           const sourcemeta::jsonbinpack::Encoding &encoding)
+    -> void {
+  const sourcemeta::core::JSON document{"SKU-" +
+                                        std::to_string(state.range(0) - 1)};
+  std::vector<std::byte> buffer;
+  sourcemeta::jsonbinpack::Encoder encoder{buffer};
+  for (auto _ : state) {
+    buffer.clear();
+    encoder.reset(buffer);
+    encoder.write(document, encoding);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+}
+
+static void LARGE_CHOICE_INDEX_Encode_Scan(benchmark::State &state) {
+  const auto array{choices(state.range(0))};
+  const sourcemeta::jsonbinpack::Encoding encoding{
+      sourcemeta::jsonbinpack::LARGE_CHOICE_INDEX{
+          .choices = {array.as_array().cbegin(), array.as_array().cend()}}};
+  encode_choices(state, encoding);
+}
+
+static void LARGE_CHOICE_INDEX_Encode_Indexed(benchmark::State &state) {
+  auto options{sourcemeta::core::JSON::make_object()};
+  options.assign("choices", choices(state.range(0)));
+  auto input{sourcemeta::core::JSON::make_object()};
+  input.assign("binpackEncoding", sourcemeta::core::JSON{"LARGE_CHOICE_INDEX"});
+  input.assign("binpackOptions", std::move(options));
+  encode_choices(state, sourcemeta::jsonbinpack::load(input));
+}
+
+BENCHMARK(LARGE_CHOICE_INDEX_Encode_Scan)->Apply(choice_counts);
+BENCHMARK(LARGE_CHOICE_INDEX_Encode_Indexed)->Apply(choice_counts);
@@ -0,0 +1,147 @@
+#include <benchmark/benchmark.h>
+
+#include <sourcemeta/core/json.h>
+
+#include <sourcemeta/jsonbinpack/runtime.h>
+
+#include <cstddef>     // std::byte, std::size_t
+#include <cstdint>     // std::int64_t, std::uint64_t
+#include <memory>      // std::make_shared
+#include <span>        // std::span
+#include <string>      // std::to_string
+#include <string_view> // std::string_view
+#include <utility>     // std::move
+#include <vector>      // std::vector
+
+// Totals the numbers and the string lengths of a document
+class Totals : public sourcemeta::jsonbinpack::DecodeHandler {
+public:
+  auto null() -> void override {}
+  auto boolean(const bool) -> void override {}
+  auto integer(const std::int64_t value) -> void override {
+    this->numbers += value;
+  }
+
+  auto real(const double) -> void override {}
+  auto string(const std::string_view value) -> void override {
+    this->characters += value.size();
+  }
+
+  auto start_array(const std::uint64_t) -> void override {}
+  auto end_array() -> void override {}
+  auto start_object(const std::uint64_t) -> void override {}
+  auto key(const std::string_view) -> void override {}
+  auto end_object() -> void override {}
+
+  std::int64_t numbers{0};
+  std::size_t characters{0};
+};
+
+static auto events_document() -> sourcemeta::core::JSON {
+  auto document{sourcemeta::core::JSON::make_array()};
+  for (std::int64_t index = 0; index < 10000; index++) {
+    auto event{sourcemeta::core::JSON::make_object()};
+    event.assign("sequence", sourcemeta::core::JSON{index});
+    event.assign("message",
+                 sourcemeta::core::JSON{"event number " +
+                                        std::to_string(index * 7919)});
+    document.push_back(std::move(event));
+  }
+
+  return document;
+}
+
+static auto encode(const sourcemeta::core::JSON &document,
+                   const sourcemeta::jsonbinpack::Encoding &encoding)
+    -> std::vector<std::byte> {
+  std::vector<std::byte> buffer;
+  sourcemeta::jsonbinpack::Encoder encoder{buffer};
+  encoder.write(document, encoding);
+  return buffer;
+}
+
+static auto totals(const sourcemeta::core::JSON &document, Totals &result)
+    -> void {
+  if (document.is_integer()) {
+    result.numbers += document.to_integer();
+  } else if (document.is_string()) {
+    result.characters += document.to_string().size();
+  } else if (document.is_array()) {
+    for (const auto &item : document.as_array()) {
+      totals(item, result);
+    }
+  } else if (document.is_object()) {
+    for (const auto &entry : document.as_object()) {
+      totals(entry.second, result);
+    }
+  }
+}
+
+static void ANY_PACKED_Totals_Decoder(benchmark::State &state) {
+  const sourcemeta::jsonbinpack::Encoding encoding{
+      sourcemeta::jsonbinpack::ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  const auto buffer{encode(events_document(), encoding)};
+  for (auto _ : state) {
+    sourcemeta::jsonbinpack::Decoder decoder{
+        std::span<const std::byte>{buffer}};
+    Totals result;
+    totals(decoder.read(encoding), result);
+    benchmark::DoNotOptimize(result.numbers);
+    benchmark::DoNotOptimize(result.characters);
+  }
+}
+
+static void ANY_PACKED_Totals_DecodeHandler(benchmark::State &state) {
+  const sourcemeta::jsonbinpack::Encoding encoding{
+      sourcemeta::jsonbinpack::ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  const auto buffer{encode(events_document(), encoding)};
+  for (auto _ : state) {
+    sourcemeta::jsonbinpack::Decoder decoder{
+        std::span<const std::byte>{buffer}};
+    Totals result;
+    decoder.read(encoding, result);
+    benchmark::DoNotOptimize(result.numbers);
+    benchmark::DoNotOptimize(result.characters);
+  }
+}
+
+static auto typed_encoding() -> sourcemeta::jsonbinpack::Encoding {
+  using namespace sourcemeta::jsonbinpack;
+  return FLOOR_TYPED_ARRAY{
+      0,
+      std::make_shared<Encoding>(VARINT_TYPED_ARBITRARY_OBJECT{
+          std::make_shared<Encoding>(FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED{0}),
+          std::make_shared<Encoding>(ANY_PACKED_TYPE_TAG_BYTE_PREFIX{})}),
+      {}};
+}
+
+static void FLOOR_TYPED_ARRAY_Totals_Decoder(benchmark::State &state) {
+  const auto encoding{typed_encoding()};
+  const auto buffer{encode(events_document(), encoding)};
+  for (auto _ : state) {
+    sourcemeta::jsonbinpack::Decoder decoder{
+        std::span<const std::byte>{buffer}};
+    Totals result;
+    totals(decoder.read(encoding), result);
+    benchmark::DoNotOptimize(result.numbers);
+    benchmark::DoNotOptimize(result.characters);
+  }
+}
+
+static void FLOOR_TYPED_ARRAY_Totals_DecodeHandler(benchmark::State &state) {
+  const auto encoding{typed_encoding()};
+  const auto buffer{encode(events_document(), encoding)};
+  for (auto _ : state) {
+    sourcemeta::jsonbinpack::Decoder decoder{
+        std::span<const std::byte>{buffer}};
+    Totals result;
+    decoder.read(encoding, result);
+    benchmark::DoNotOptimize(result.numbers);
+    benchmark::DoNotOptimize(result.characters);
+  }
+}
+
+BENCHMARK(ANY_PACKED_Totals_Decoder);
+BENCHMARK(ANY_PACKED_Totals_DecodeHandler);
+BENCHMARK(FLOOR_TYPED_ARRAY_Totals_Decoder);
+BENCHMARK(FLOOR_TYPED_ARRAY_Totals_DecodeHandler);
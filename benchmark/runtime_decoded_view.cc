@@ -0,0 +1,176 @@
+#include <benchmark/benchmark.h>
+
+#include <sourcemeta/core/json.h>
+
+#include <sourcemeta/jsonbinpack/runtime.h>
+
+#include <cstddef> // std::byte
+#include <cstdint> // std::int64_t
+#include <memory>  // std::make_shared
+#include <span>    // std::span
+#include <string>  // std::to_string
+#include <utility> // std::move
+#include <vector>  // std::vector
+
+// A record of around 50 KiB, out of which consumers only need a few fields
+static auto record_document() -> sourcemeta::core::JSON {
+  auto events{sourcemeta::core::JSON::make_array()};
+  for (std::int64_t index = 0; index < 1000; index++) {
+    auto event{sourcemeta::core::JSON::make_object()};
+    event.assign("sequence", sourcemeta::core::JSON{index});
+    event.assign("message",
+                 sourcemeta::core::JSON{"event number " +
+                                        std::to_string(index * 7919)});
+    events.push_back(std::move(event));
+  }
+
+  auto document{sourcemeta::core::JSON::make_object()};
+  document.assign("events", std::move(events));
+  document.assign("status", sourcemeta::core::JSON{"complete"});
+  document.assign("identifier", sourcemeta::core::JSON{12345});
+  return document;
+}
+
+static auto encode(const sourcemeta::core::JSON &document,
+                   const sourcemeta::jsonbinpack::Encoding &encoding)
+    -> std::vector<std::byte> {
+  std::vector<std::byte> buffer;
+  sourcemeta::jsonbinpack::Encoder encoder{buffer};
+  encoder.write(document, encoding);
+  return buffer;
+}
+
+static void ANY_PACKED_Fields_Decoder(benchmark::State &state) {
+  const sourcemeta::jsonbinpack::Encoding encoding{
+      sourcemeta::jsonbinpack::ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  const auto buffer{encode(record_document(), encoding)};
+  for (auto _ : state) {
+    sourcemeta::jsonbinpack::Decoder decoder{
+        std::span<const std::byte>{buffer}};
+    const auto document{decoder.read(encoding)};
+    auto identifier{document.at("identifier").to_integer()};
+    auto sequence{document.at("events").at(500).at("sequence").to_integer()};
+    benchmark::DoNotOptimize(identifier);
+    benchmark::DoNotOptimize(sequence);
+  }
+}
+
+static void ANY_PACKED_Fields_DecodedView(benchmark::State &state) {
+  const sourcemeta::jsonbinpack::Encoding encoding{
+      sourcemeta::jsonbinpack::ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  const auto buffer{encode(record_document(), encoding)};
+  for (auto _ : state) {
+    const sourcemeta::jsonbinpack::DecodedView view{
+        std::span<const std::byte>{buffer}, encoding};
+    auto identifier{view.at("identifier").to_integer()};
+    auto sequence{view.at("events").at(500).at("sequence").to_integer()};
+    benchmark::DoNotOptimize(identifier);
+    benchmark::DoNotOptimize(sequence);
+  }
+}
+
+// Fixed-size items, so reaching any of them does not read the ones before it
+static auto samples_encoding() -> sourcemeta::jsonbinpack::Encoding {
+  using namespace sourcemeta::jsonbinpack;
+  return FIXED_TYPED_ARRAY{
+      10000,
+      std::make_shared<Encoding>(FIXED_TYPED_ARRAY{
+          4,
+          std::make_shared<Encoding>(
+              BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{0, 255, 1}),
+          {}}),
+      {}};
+}
+
+static auto samples_document() -> sourcemeta::core::JSON {
+  auto document{sourcemeta::core::JSON::make_array()};
+  for (std::int64_t index = 0; index < 10000; index++) {
+    auto sample{sourcemeta::core::JSON::make_array()};
+    for (std::int64_t channel = 0; channel < 4; channel++) {
+      sample.push_back(sourcemeta::core::JSON{(index + channel) % 256});
+    }
+
+    document.push_back(std::move(sample));
+  }
+
+  return document;
+}
+
+static void FIXED_TYPED_ARRAY_Item_Decoder(benchmark::State &state) {
+  const auto encoding{samples_encoding()};
+  const auto buffer{encode(samples_document(), encoding)};
+  for (auto _ : state) {
+    sourcemeta::jsonbinpack::Decoder decoder{
+        std::span<const std::byte>{buffer}};
+    auto value{decoder.read(encoding).at(9000).at(3).to_integer()};
+    benchmark::DoNotOptimize(value);
+  }
+}
+
+static void FIXED_TYPED_ARRAY_Item_DecodedView(benchmark::State &state) {
+  const auto encoding{samples_encoding()};
+  const auto buffer{encode(samples_document(), encoding)};
+  for (auto _ : state) {
+    const sourcemeta::jsonbinpack::DecodedView view{
+        std::span<const std::byte>{buffer}, encoding};
+    auto value{view.at(9000).at(3).to_integer()};
+    benchmark::DoNotOptimize(value);
+  }
+}
+
+// Records of different sizes, so reaching one means walking the ones before
+// it unless the encoding says where each of them starts
+static auto events_document() -> sourcemeta::core::JSON {
+  auto document{sourcemeta::core::JSON::make_array()};
+  for (std::int64_t index = 0; index < 10000; index++) {
+    auto event{sourcemeta::core::JSON::make_object()};
+    event.assign("sequence", sourcemeta::core::JSON{index});
+    event.assign("message",
+                 sourcemeta::core::JSON{"event number " +
+                                        std::to_string(index * 7919)});
+    document.push_back(std::move(event));
+  }
+
+  return document;
+}
+
+static void FLOOR_TYPED_ARRAY_Record_DecodedView(benchmark::State &state) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{FLOOR_TYPED_ARRAY{
+      0,
+      std::make_shared<Encoding>(VARINT_TYPED_ARBITRARY_OBJECT{
+          std::make_shared<Encoding>(FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED{0}),
+          std::make_shared<Encoding>(ANY_PACKED_TYPE_TAG_BYTE_PREFIX{})}),
+      {}}};
+  const auto buffer{encode(events_document(), encoding)};
+  for (auto _ : state) {
+    const DecodedView view{std::span<const std::byte>{buffer}, encoding};
+    auto message{view.at(9000).at("message").to_string()};
+    benchmark::DoNotOptimize(message);
+  }
+}
+
+static void
+FLOOR_TYPED_LENGTH_PREFIX_ARRAY_Record_DecodedView(benchmark::State &state) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{FLOOR_TYPED_LENGTH_PREFIX_ARRAY{
+      0,
+      std::make_shared<Encoding>(VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT{
+          std::make_shared<Encoding>(FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED{0}),
+          std::make_shared<Encoding>(ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}), true}),
+      {},
+      true}};
+  const auto buffer{encode(events_document(), encoding)};
+  for (auto _ : state) {
+    const DecodedView view{std::span<const std::byte>{buffer}, encoding};
+    auto message{view.at(9000).at("message").to_string()};
+    benchmark::DoNotOptimize(message);
+  }
+}
+
+BENCHMARK(ANY_PACKED_Fields_Decoder);
+BENCHMARK(ANY_PACKED_Fields_DecodedView);
+BENCHMARK(FIXED_TYPED_ARRAY_Item_Decoder);
+BENCHMARK(FIXED_TYPED_ARRAY_Item_DecodedView);
+BENCHMARK(FLOOR_TYPED_ARRAY_Record_DecodedView);
+BENCHMARK(FLOOR_TYPED_LENGTH_PREFIX_ARRAY_Record_DecodedView);
@@ -0,0 +1,105 @@
+#include <benchmark/benchmark.h>
+
+#include <sourcemeta/core/json.h>
+
+#include <sourcemeta/jsonbinpack/runtime.h>
+
+#include <cstddef> // std::byte
+#include <cstdint> // std::int64_t
+#include <memory>  // std::make_shared
+#include <span>    // std::span
+#include <string>  // std::to_string
+#include <utility> // std::move
+#include <vector>  // std::vector
+
+// A GeoJSON feature collection, where every feature repeats
+// the same keys and most of the same string values
+static auto features_document() -> sourcemeta::core::JSON {
+  auto features{sourcemeta::core::JSON::make_array()};
+  for (std::int64_t index = 0; index < 1000; index++) {
+    auto coordinates{sourcemeta::core::JSON::make_array()};
+    coordinates.push_back(sourcemeta::core::JSON{index % 180});
+    coordinates.push_back(sourcemeta::core::JSON{index % 90});
+    auto geometry{sourcemeta::core::JSON::make_object()};
+    geometry.assign("type", sourcemeta::core::JSON{"Point"});
+    geometry.assign("coordinates", std::move(coordinates));
+    auto properties{sourcemeta::core::JSON::make_object()};
+    properties.assign("country",
+                      sourcemeta::core::JSON{"country-" +
+                                             std::to_string(index % 20)});
+    properties.assign("category", sourcemeta::core::JSON{
+                                      index % 2 == 0 ? "residential"
+                                                     : "commercial"});
+    auto feature{sourcemeta::core::JSON::make_object()};
+    feature.assign("type", sourcemeta::core::JSON{"Feature"});
+    feature.assign("geometry", std::move(geometry));
+    feature.assign("properties", std::move(properties));
+    features.push_back(std::move(feature));
+  }
+
+  auto document{sourcemeta::core::JSON::make_object()};
+  document.assign("type", sourcemeta::core::JSON{"FeatureCollection"});
+  document.assign("features", std::move(features));
+  return document;
+}
+
+// Many package manifests sharing the same dependencies
+static auto dependencies_document() -> sourcemeta::core::JSON {
+  auto document{sourcemeta::core::JSON::make_array()};
+  for (std::int64_t index = 0; index < 1000; index++) {
+    auto dependencies{sourcemeta::core::JSON::make_object()};
+    for (std::int64_t dependency = 0; dependency < 8; dependency++) {
+      dependencies.assign(
+          "@scope/dependency-" + std::to_string((index + dependency) % 16),
+          sourcemeta::core::JSON{"^1." + std::to_string(dependency) + ".0"});
+    }
+
+    document.push_back(std::move(dependencies));
+  }
+
+  return document;
+}
+
+static auto decode(benchmark::State &state,
+                   const sourcemeta::core::JSON &document,
+                   const sourcemeta::jsonbinpack::Encoding &encoding) -> void {
+  std::vector<std::byte> buffer;
+  sourcemeta::jsonbinpack::Encoder encoder{buffer};
+  encoder.write(document, encoding);
+  sourcemeta::jsonbinpack::Decoder decoder{
+      std::span<const std::byte>{buffer}};
+  for (auto _ : state) {
+    decoder.reset(std::span<const std::byte>{buffer});
+    auto result{decoder.read(encoding)};
+    benchmark::DoNotOptimize(result);
+  }
+
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<std::int64_t>(buffer.size()));
+}
+
+static void ANY_PACKED_Decode_Shared_Features(benchmark::State &state) {
+  decode(state, features_document(),
+         sourcemeta::jsonbinpack::ANY_PACKED_TYPE_TAG_BYTE_PREFIX{});
+}
+
+static void ANY_PACKED_Decode_Shared_Dependencies(benchmark::State &state) {
+  decode(state, dependencies_document(),
+         sourcemeta::jsonbinpack::ANY_PACKED_TYPE_TAG_BYTE_PREFIX{});
+}
+
+static void PREFIX_VARINT_LENGTH_STRING_SHARED_Decode_Dependencies(
+    benchmark::State &state) {
+  using namespace sourcemeta::jsonbinpack;
+  const auto string{
+      std::make_shared<Encoding>(PREFIX_VARINT_LENGTH_STRING_SHARED{})};
+  decode(state, dependencies_document(),
+         FLOOR_TYPED_ARRAY{0,
+                           std::make_shared<Encoding>(
+                               VARINT_TYPED_ARBITRARY_OBJECT{string, string}),
+                           {}});
+}
+
+BENCHMARK(ANY_PACKED_Decode_Shared_Features);
+BENCHMARK(ANY_PACKED_Decode_Shared_Dependencies);
+BENCHMARK(PREFIX_VARINT_LENGTH_STRING_SHARED_Decode_Dependencies);
@@ -0,0 +1,91 @@
+#include <benchmark/benchmark.h>
+
+#include <sourcemeta/core/json.h>
+
+#include <sourcemeta/jsonbinpack/runtime.h>
+
+#include <cstddef>    // std::byte
+#include <cstdint>    // std::int64_t
+#include <filesystem> // std::filesystem
+#include <fstream>    // std::ifstream
+#include <ios>        // std::ios
+#include <iterator>   // std::istreambuf_iterator
+#include <span>       // std::span
+#include <sstream>    // std::ostringstream
+#include <utility>    // std::move
+#include <vector>     // std::vector
+
+struct Corpus {
+  sourcemeta::jsonbinpack::Encoding encoding;
+  std::vector<std::byte> bytes;
+};
+
+// The schema-less outputs of every end-to-end test case
+static auto corpora() -> const std::vector<Corpus> & {
+  static const auto result{[] {
+    std::vector<Corpus> corpora;
+    for (const auto &entry :
+         std::filesystem::directory_iterator{JSONBINPACK_E2E_DIRECTORY}) {
+      const auto directory{entry.path() / "schema-less"};
+      if (!std::filesystem::is_regular_file(directory / "output.bin")) {
+        continue;
+      }
+
+      std::ifstream stream{directory / "output.bin", std::ios::binary};
+      std::vector<std::byte> bytes;
+      for (auto iterator{std::istreambuf_iterator<char>{stream}};
+           iterator != std::istreambuf_iterator<char>{}; ++iterator) {
+        bytes.push_back(static_cast<std::byte>(*iterator));
+      }
+
+      corpora.push_back(
+          {sourcemeta::jsonbinpack::load(
+               sourcemeta::core::read_json(directory / "encoding.json")),
+           std::move(bytes)});
+    }
+
+    return corpora;
+  }()};
+  return result;
+}
+
+static auto corpora_size() -> std::int64_t {
+  std::int64_t result{0};
+  for (const auto &corpus : corpora()) {
+    result += static_cast<std::int64_t>(corpus.bytes.size());
+  }
+
+  return result;
+}
+
+static void E2E_Text_Decode_Stringify(benchmark::State &state) {
+  for (auto _ : state) {
+    for (const auto &corpus : corpora()) {
+      sourcemeta::jsonbinpack::Decoder decoder{
+          std::span<const std::byte>{corpus.bytes}};
+      std::ostringstream stream;
+      sourcemeta::core::stringify(decoder.read(corpus.encoding), stream);
+      benchmark::DoNotOptimize(stream);
+    }
+  }
+
+  state.SetBytesProcessed(state.iterations() * corpora_size());
+}
+
+static void E2E_Text_Transcode(benchmark::State &state) {
+  sourcemeta::core::JSON::String text;
+  for (auto _ : state) {
+    for (const auto &corpus : corpora()) {
+      sourcemeta::jsonbinpack::Decoder decoder{
+          std::span<const std::byte>{corpus.bytes}};
+      text.clear();
+      decoder.transcode(corpus.encoding, text);
+      benchmark::DoNotOptimize(text);
+    }
+  }
+
+  state.SetBytesProcessed(state.iterations() * corpora_size());
+}
+
+BENCHMARK(E2E_Text_Decode_Stringify);
+BENCHMARK(E2E_Text_Transcode);
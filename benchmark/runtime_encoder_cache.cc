@@ -0,0 +1,109 @@
+#include <benchmark/benchmark.h>
+
+#include <sourcemeta/core/json.h>
+
+#include <sourcemeta/jsonbinpack/runtime.h>
+#include <sourcemeta/jsonbinpack/runtime_encoder_cache.h>
+
+#include <cstddef> // std::byte, std::size_t
+#include <cstdint> // std::uint64_t
+#include <string>  // std::to_string
+#include <utility> // std::move
+#include <vector>  // std::vector
+
+// Log-like records, where some string values repeat often and others are
+// mostly unique, which exercises both hits and misses on the shared string
+// cache
+static auto string_heavy_fixture() -> sourcemeta::core::JSON {
+  auto result{sourcemeta::core::JSON::make_array()};
+  for (std::size_t index = 0; index < 2000; index++) {
+    auto record{sourcemeta::core::JSON::make_object()};
+    record.assign("level", sourcemeta::core::JSON{
+                               index % 7 == 0 ? "warning" : "information"});
+    record.assign("service", sourcemeta::core::JSON{
+                                 "service-" + std::to_string(index % 16)});
+    record.assign("host", sourcemeta::core::JSON{"host-" +
+                                                 std::to_string(index % 128) +
+                                                 ".internal.example.com"});
+    record.assign("request", sourcemeta::core::JSON{
+                                 "request-" + std::to_string(index * 7919)});
+    record.assign("message",
+                  sourcemeta::core::JSON{
+                      "Processed the request for the user number " +
+                      std::to_string(index % 256) + " successfully"});
+    result.push_back(std::move(record));
+  }
+
+  return result;
+}
+
+static void Encoder_String_Heavy(benchmark::State &state) {
+  const auto document{string_heavy_fixture()};
+  const sourcemeta::jsonbinpack::ANY_PACKED_TYPE_TAG_BYTE_PREFIX encoding;
+  std::vector<std::byte> buffer;
+  for (auto _ : state) {
+    buffer.clear();
+    sourcemeta::jsonbinpack::Encoder encoder{buffer};
+    encoder.write(document, encoding);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+}
+
+static void Encoder_Small_Messages_Fresh(benchmark::State &state) {
+  const auto document{string_heavy_fixture()};
+  const sourcemeta::jsonbinpack::ANY_PACKED_TYPE_TAG_BYTE_PREFIX encoding;
+  std::vector<std::byte> buffer;
+  for (auto _ : state) {
+    for (const auto &record : document.as_array()) {
+      buffer.clear();
+      sourcemeta::jsonbinpack::Encoder encoder{buffer};
+      encoder.write(record, encoding);
+    }
+
+    benchmark::DoNotOptimize(buffer.data());
+  }
+}
+
+static void Encoder_Small_Messages_Reset(benchmark::State &state) {
+  const auto document{string_heavy_fixture()};
+  const sourcemeta::jsonbinpack::ANY_PACKED_TYPE_TAG_BYTE_PREFIX encoding;
+  std::vector<std::byte> buffer;
+  sourcemeta::jsonbinpack::Encoder encoder{buffer};
+  for (auto _ : state) {
+    for (const auto &record : document.as_array()) {
+      buffer.clear();
+      encoder.reset(buffer);
+      encoder.write(record, encoding);
+    }
+
+    benchmark::DoNotOptimize(buffer.data());
+  }
+}
+
+static void Cache_Record_Find(benchmark::State &state) {
+  using CacheType = sourcemeta::jsonbinpack::Cache::Type;
+  std::vector<sourcemeta::core::JSON::String> strings;
+  for (std::size_t index = 0; index < 4096; index++) {
+    strings.push_back("https://example.com/path/" +
+                      std::to_string(index % 512));
+  }
+
+  for (auto _ : state) {
+    sourcemeta::jsonbinpack::Cache cache;
+    std::uint64_t offset{0};
+    for (const auto &string : strings) {
+      if (!cache.find(string, CacheType::Standalone).has_value()) {
+        cache.record(string, offset, CacheType::Standalone);
+      }
+
+      offset += string.size();
+    }
+
+    benchmark::ClobberMemory();
+  }
+}
+
+BENCHMARK(Encoder_String_Heavy);
+BENCHMARK(Encoder_Small_Messages_Fresh);
+BENCHMARK(Encoder_Small_Messages_Reset);
+BENCHMARK(Cache_Record_Find);
@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+
+#include <sourcemeta/jsonbinpack/runtime_input_stream.h>
+#include <sourcemeta/jsonbinpack/runtime_output_stream.h>
+
+#include <cstddef> // std::byte, std::size_t
+#include <cstdint> // std::uint64_t
+#include <span>    // std::span
+#include <sstream> // std::istringstream
+#include <string>  // std::string
+#include <vector>  // std::vector
+
+// A mix of single-byte and multi-byte Base-128 integers
+static auto varint_fixture() -> std::vector<std::byte> {
+  std::vector<std::byte> result;
+  sourcemeta::jsonbinpack::OutputStream output{result};
+  std::uint64_t value{1};
+  for (std::size_t index = 0; index < 1024; index++) {
+    output.put_varint(value);
+    value = value * 6364136223846793005u + 1442695040888963407u;
+    value >>= index % 64;
+  }
+
+  return result;
+}
+
+static void InputStream_Get_Varint_Stream(benchmark::State &state) {
+  const auto bytes{varint_fixture()};
+  std::istringstream stream{
+      std::string{reinterpret_cast<const char *>(bytes.data()), bytes.size()}};
+  for (auto _ : state) {
+    stream.clear();
+    stream.seekg(0);
+    sourcemeta::jsonbinpack::InputStream input{stream};
+    for (std::size_t index = 0; index < 1024; index++) {
+      benchmark::DoNotOptimize(input.get_varint());
+    }
+  }
+}
+
+static void InputStream_Get_Varint_Span(benchmark::State &state) {
+  const auto bytes{varint_fixture()};
+  for (auto _ : state) {
+    sourcemeta::jsonbinpack::InputStream input{std::span{bytes}};
+    for (std::size_t index = 0; index < 1024; index++) {
+      benchmark::DoNotOptimize(input.get_varint());
+    }
+  }
+}
+
+static void InputStream_Get_Varints_Span(benchmark::State &state) {
+  const auto bytes{varint_fixture()};
+  std::vector<std::uint64_t> values(1024);
+  for (auto _ : state) {
+    sourcemeta::jsonbinpack::InputStream input{std::span{bytes}};
+    input.get_varints(values);
+    benchmark::DoNotOptimize(values.data());
+  }
+}
+
+BENCHMARK(InputStream_Get_Varint_Stream);
+BENCHMARK(InputStream_Get_Varint_Span);
+BENCHMARK(InputStream_Get_Varints_Span);
@@ -0,0 +1,112 @@
+#include <benchmark/benchmark.h>
+
+#include <sourcemeta/core/json.h>
+
+#include <sourcemeta/jsonbinpack/runtime.h>
+
+#include <cstddef> // std::byte
+#include <cstdint> // std::int64_t
+#include <span>    // std::span
+#include <sstream> // std::ostringstream
+#include <string>  // std::string, std::to_string
+#include <utility> // std::move
+#include <vector>  // std::vector
+
+// An encoding schema for records with many known properties of mixed types,
+// which is what compiling a large real-world schema results in
+static auto large_encoding() -> sourcemeta::core::JSON {
+  auto required{sourcemeta::core::JSON::make_array()};
+  auto optional{sourcemeta::core::JSON::make_array()};
+  auto encodings{sourcemeta::core::JSON::make_object()};
+  for (std::int64_t index = 0; index < 1000; index++) {
+    const auto name{"property_" + std::to_string(index)};
+    auto encoding{sourcemeta::core::JSON::make_object()};
+    auto options{sourcemeta::core::JSON::make_object()};
+    switch (index % 4) {
+      case 0:
+        encoding.assign("binpackEncoding",
+                        sourcemeta::core::JSON{"FLOOR_MULTIPLE_ENUM_VARINT"});
+        options.assign("minimum", sourcemeta::core::JSON{-index});
+        options.assign("multiplier", sourcemeta::core::JSON{1});
+        break;
+      case 1:
+        encoding.assign("binpackEncoding",
+                        sourcemeta::core::JSON{
+                            "BOUNDED_8BIT_PREFIX_UTF8_STRING_SHARED"});
+        options.assign("minimum", sourcemeta::core::JSON{0});
+        options.assign("maximum", sourcemeta::core::JSON{index % 200 + 1});
+        break;
+      case 2: {
+        encoding.assign("binpackEncoding",
+                        sourcemeta::core::JSON{"BYTE_CHOICE_INDEX"});
+        auto choices{sourcemeta::core::JSON::make_array()};
+        for (std::int64_t choice = 0; choice < 8; choice++) {
+          choices.push_back(
+              sourcemeta::core::JSON{"choice_" + std::to_string(choice)});
+        }
+
+        options.assign("choices", std::move(choices));
+        break;
+      }
+      default: {
+        encoding.assign("binpackEncoding",
+                        sourcemeta::core::JSON{"FLOOR_TYPED_ARRAY"});
+        auto element{sourcemeta::core::JSON::make_object()};
+        element.assign("binpackEncoding",
+                       sourcemeta::core::JSON{"DOUBLE_VARINT_TUPLE"});
+        element.assign("binpackOptions", sourcemeta::core::JSON::make_object());
+        options.assign("minimum", sourcemeta::core::JSON{0});
+        options.assign("encoding", std::move(element));
+        options.assign("prefixEncodings", sourcemeta::core::JSON::make_array());
+        break;
+      }
+    }
+
+    encoding.assign("binpackOptions", std::move(options));
+    encodings.assign(name, std::move(encoding));
+    (index % 2 == 0 ? required : optional)
+        .push_back(sourcemeta::core::JSON{name});
+  }
+
+  auto options{sourcemeta::core::JSON::make_object()};
+  options.assign("requiredProperties", std::move(required));
+  options.assign("optionalProperties", std::move(optional));
+  options.assign("propertyEncodings", std::move(encodings));
+  auto result{sourcemeta::core::JSON::make_object()};
+  result.assign("$schema", sourcemeta::core::JSON{
+                               "tag:sourcemeta.com,2024:jsonbinpack/"
+                               "encoding/v1"});
+  result.assign("binpackEncoding",
+                sourcemeta::core::JSON{"MIXED_BOUNDED_TYPED_OBJECT"});
+  result.assign("binpackOptions", std::move(options));
+  return result;
+}
+
+static void Load_Large_JSON(benchmark::State &state) {
+  std::ostringstream stream;
+  sourcemeta::core::stringify(large_encoding(), stream);
+  const auto text{stream.str()};
+  for (auto _ : state) {
+    auto encoding{
+        sourcemeta::jsonbinpack::load(sourcemeta::core::parse_json(text))};
+    benchmark::DoNotOptimize(encoding);
+  }
+
+  state.counters["bytes"] = static_cast<double>(text.size());
+}
+
+static void Load_Large_Binary(benchmark::State &state) {
+  std::vector<std::byte> bytes;
+  sourcemeta::jsonbinpack::save(sourcemeta::jsonbinpack::load(large_encoding()),
+                                bytes);
+  for (auto _ : state) {
+    auto encoding{
+        sourcemeta::jsonbinpack::load(std::span<const std::byte>{bytes})};
+    benchmark::DoNotOptimize(encoding);
+  }
+
+  state.counters["bytes"] = static_cast<double>(bytes.size());
+}
+
+BENCHMARK(Load_Large_JSON);
+BENCHMARK(Load_Large_Binary);
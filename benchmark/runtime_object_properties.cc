@@ -0,0 +1,125 @@
+#include <benchmark/benchmark.h>
+
+#include <sourcemeta/core/json.h>
+
+#include <sourcemeta/jsonbinpack/runtime.h>
+
+#include <cstddef> // std::byte, std::size_t
+#include <cstdint> // std::int64_t
+#include <memory>  // std::make_shared
+#include <span>    // std::span
+#include <string>  // std::to_string
+#include <utility> // std::move
+#include <vector>  // std::vector
+
+// Telemetry records of a fixed shape, where some fields are optional
+static auto records() -> std::vector<sourcemeta::core::JSON> {
+  std::vector<sourcemeta::core::JSON> result;
+  for (std::size_t index = 0; index < 1000; index++) {
+    auto record{sourcemeta::core::JSON::make_object()};
+    record.assign("timestamp",
+                  sourcemeta::core::JSON{static_cast<std::int64_t>(index)});
+    record.assign("severity", sourcemeta::core::JSON{
+                                  index % 3 == 0 ? "warning" : "information"});
+    record.assign("latency", sourcemeta::core::JSON{
+                                 static_cast<std::int64_t>(index % 97)});
+    if (index % 4 == 0) {
+      record.assign("trace", sourcemeta::core::JSON{"trace-" +
+                                                    std::to_string(index)});
+    }
+
+    result.push_back(std::move(record));
+  }
+
+  return result;
+}
+
+static auto severity() -> sourcemeta::jsonbinpack::Encoding {
+  std::vector<sourcemeta::core::JSON> choices;
+  choices.emplace_back("information");
+  choices.emplace_back("warning");
+  return sourcemeta::jsonbinpack::BYTE_CHOICE_INDEX{std::move(choices)};
+}
+
+// The encoding that a schema without known properties compiles to
+static auto arbitrary() -> sourcemeta::jsonbinpack::Encoding {
+  using namespace sourcemeta::jsonbinpack;
+  return VARINT_TYPED_ARBITRARY_OBJECT{
+      std::make_shared<Encoding>(PREFIX_VARINT_LENGTH_STRING_SHARED{}),
+      std::make_shared<Encoding>(ANY_PACKED_TYPE_TAG_BYTE_PREFIX{})};
+}
+
+// The encoding that a schema with known properties compiles to
+static auto known() -> sourcemeta::jsonbinpack::Encoding {
+  using namespace sourcemeta::jsonbinpack;
+  return MIXED_BOUNDED_TYPED_OBJECT{
+      {"timestamp", "severity", "latency"},
+      {"trace"},
+      {FLOOR_MULTIPLE_ENUM_VARINT{0, 1}, severity(),
+       FLOOR_MULTIPLE_ENUM_VARINT{0, 1},
+       FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED{0}}};
+}
+
+static auto encode_records(benchmark::State &state,
+                           const sourcemeta::jsonbinpack::Encoding &encoding)
+    -> void {
+  const auto documents{records()};
+  std::vector<std::byte> output;
+  for (auto _ : state) {
+    output.clear();
+    sourcemeta::jsonbinpack::Encoder encoder{output};
+    for (const auto &document : documents) {
+      encoder.write(document, encoding);
+    }
+
+    benchmark::DoNotOptimize(output);
+  }
+
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(documents.size()));
+  state.counters["bytes"] = static_cast<double>(output.size());
+}
+
+static auto decode_records(benchmark::State &state,
+                           const sourcemeta::jsonbinpack::Encoding &encoding)
+    -> void {
+  const auto documents{records()};
+  std::vector<std::byte> input;
+  sourcemeta::jsonbinpack::Encoder encoder{input};
+  for (const auto &document : documents) {
+    encoder.write(document, encoding);
+  }
+
+  for (auto _ : state) {
+    sourcemeta::jsonbinpack::Decoder decoder{
+        std::span<const std::byte>{input}};
+    for (std::size_t index = 0; index < documents.size(); index++) {
+      auto result{decoder.read(encoding)};
+      benchmark::DoNotOptimize(result);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(documents.size()));
+}
+
+static void Object_Encode_Arbitrary_Properties(benchmark::State &state) {
+  encode_records(state, arbitrary());
+}
+
+static void Object_Encode_Known_Properties(benchmark::State &state) {
+  encode_records(state, known());
+}
+
+static void Object_Decode_Arbitrary_Properties(benchmark::State &state) {
+  decode_records(state, arbitrary());
+}
+
+static void Object_Decode_Known_Properties(benchmark::State &state) {
+  decode_records(state, known());
+}
+
+BENCHMARK(Object_Encode_Arbitrary_Properties);
+BENCHMARK(Object_Encode_Known_Properties);
+BENCHMARK(Object_Decode_Arbitrary_Properties);
+BENCHMARK(Object_Decode_Known_Properties);
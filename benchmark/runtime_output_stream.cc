@@ -0,0 +1,113 @@
+#include <benchmark/benchmark.h>
+
+#include <sourcemeta/core/io.h>
+#include <sourcemeta/core/json.h>
+
+#include <sourcemeta/jsonbinpack/runtime_output_stream.h>
+
+#include <cstddef> // std::byte
+#include <cstdint> // std::uint64_t
+#include <span>    // std::span
+#include <vector>  // std::vector
+
+// A mix of single-byte and multi-byte Base-128 integers
+static auto varint_fixture() -> std::vector<std::uint64_t> {
+  std::vector<std::uint64_t> result;
+  result.reserve(1024);
+  std::uint64_t value{1};
+  for (std::size_t index = 0; index < 1024; index++) {
+    result.push_back(value);
+    value = value * 6364136223846793005u + 1442695040888963407u;
+    value >>= index % 64;
+  }
+
+  return result;
+}
+
+static void OutputStream_Put_Varint_Stream(benchmark::State &state) {
+  const auto values{varint_fixture()};
+  for (auto _ : state) {
+    sourcemeta::core::OutputByteStream stream{};
+    sourcemeta::jsonbinpack::OutputStream output{stream};
+    for (const auto value : values) {
+      output.put_varint(value);
+    }
+
+    benchmark::DoNotOptimize(output.position());
+  }
+}
+
+static void OutputStream_Put_Varint_Buffer(benchmark::State &state) {
+  const auto values{varint_fixture()};
+  std::vector<std::byte> buffer;
+  for (auto _ : state) {
+    buffer.clear();
+    sourcemeta::jsonbinpack::OutputStream output{buffer};
+    for (const auto value : values) {
+      output.put_varint(value);
+    }
+
+    benchmark::DoNotOptimize(output.bytes().data());
+  }
+}
+
+static void OutputStream_Put_Varint_Span(benchmark::State &state) {
+  const auto values{varint_fixture()};
+  // 10 bytes is the maximum Base-128 length of a 64-bit integer
+  std::vector<std::byte> buffer(values.size() * 10);
+  for (auto _ : state) {
+    sourcemeta::jsonbinpack::OutputStream output{std::span{buffer}};
+    for (const auto value : values) {
+      output.put_varint(value);
+    }
+
+    benchmark::DoNotOptimize(output.bytes().data());
+  }
+}
+
+static void OutputStream_Put_String_UTF8_Stream(benchmark::State &state) {
+  const sourcemeta::core::JSON::String value(
+      static_cast<std::size_t>(state.range(0)), 'x');
+  for (auto _ : state) {
+    sourcemeta::core::OutputByteStream stream{};
+    sourcemeta::jsonbinpack::OutputStream output{stream};
+    output.put_string_utf8(value, value.size());
+    benchmark::DoNotOptimize(output.position());
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+static void OutputStream_Put_String_UTF8_Buffer(benchmark::State &state) {
+  const sourcemeta::core::JSON::String value(
+      static_cast<std::size_t>(state.range(0)), 'x');
+  std::vector<std::byte> buffer;
+  for (auto _ : state) {
+    buffer.clear();
+    sourcemeta::jsonbinpack::OutputStream output{buffer};
+    output.put_string_utf8(value, value.size());
+    benchmark::DoNotOptimize(output.bytes().data());
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+static void OutputStream_Put_String_UTF8_Span(benchmark::State &state) {
+  const sourcemeta::core::JSON::String value(
+      static_cast<std::size_t>(state.range(0)), 'x');
+  std::vector<std::byte> buffer(value.size());
+  for (auto _ : state) {
+    sourcemeta::jsonbinpack::OutputStream output{std::span{buffer}};
+    output.put_string_utf8(value, value.size());
+    benchmark::DoNotOptimize(output.bytes().data());
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(OutputStream_Put_Varint_Stream);
+BENCHMARK(OutputStream_Put_Varint_Buffer);
+BENCHMARK(OutputStream_Put_Varint_Span);
+BENCHMARK(OutputStream_Put_String_UTF8_Stream)->Range(8, 64 << 10);
+BENCHMARK(OutputStream_Put_String_UTF8_Buffer)->Range(8, 64 << 10);
+BENCHMARK(OutputStream_Put_String_UTF8_Span)->Range(8, 64 << 10);
@@ -0,0 +1,114 @@
+#include <benchmark/benchmark.h>
+
+#include <sourcemeta/core/json.h>
+
+#include <sourcemeta/jsonbinpack/runtime.h>
+
+#include <cstddef> // std::byte
+#include <cstdint> // std::int64_t
+#include <memory>  // std::make_shared
+#include <span>    // std::span
+#include <string>  // std::to_string
+#include <utility> // std::move
+#include <vector>  // std::vector
+
+// An array of objects with fixed-length keys whose values are integer tuples,
+// so that most of the time is spent dispatching between small encodings
+static auto records_encoding() -> sourcemeta::jsonbinpack::Encoding {
+  using namespace sourcemeta::jsonbinpack;
+  std::vector<Encoding> prefix_encodings;
+  prefix_encodings.emplace_back(BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{0, 255, 1});
+  prefix_encodings.emplace_back(FLOOR_MULTIPLE_ENUM_VARINT{0, 1});
+  prefix_encodings.emplace_back(ROOF_MULTIPLE_MIRROR_ENUM_VARINT{1000, 5});
+  const auto tuple{std::make_shared<Encoding>(FLOOR_TYPED_ARRAY{
+      3, std::make_shared<Encoding>(ARBITRARY_MULTIPLE_ZIGZAG_VARINT{1}),
+      std::move(prefix_encodings)})};
+  const auto record{std::make_shared<Encoding>(VARINT_TYPED_ARBITRARY_OBJECT{
+      std::make_shared<Encoding>(UTF8_STRING_NO_LENGTH{10}), tuple})};
+  return FLOOR_TYPED_ARRAY{0, record, {}};
+}
+
+static auto records_document() -> sourcemeta::core::JSON {
+  auto document{sourcemeta::core::JSON::make_array()};
+  for (std::int64_t index = 0; index < 1000; index++) {
+    auto record{sourcemeta::core::JSON::make_object()};
+    for (std::int64_t property = 0; property < 4; property++) {
+      auto tuple{sourcemeta::core::JSON::make_array()};
+      tuple.push_back(sourcemeta::core::JSON{(index + property) % 256});
+      tuple.push_back(sourcemeta::core::JSON{index * property});
+      tuple.push_back(sourcemeta::core::JSON{1000 - (index % 100) * 5});
+      record.assign("property_" + std::to_string(property), std::move(tuple));
+    }
+
+    document.push_back(std::move(record));
+  }
+
+  return document;
+}
+
+static void Encoder_Records_Encoding(benchmark::State &state) {
+  const auto encoding{records_encoding()};
+  const auto document{records_document()};
+  std::vector<std::byte> buffer;
+  sourcemeta::jsonbinpack::Encoder encoder{buffer};
+  for (auto _ : state) {
+    buffer.clear();
+    encoder.reset(buffer);
+    encoder.write(document, encoding);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * 1000);
+}
+
+static void Encoder_Records_Plan(benchmark::State &state) {
+  const sourcemeta::jsonbinpack::Plan plan{records_encoding()};
+  const auto document{records_document()};
+  std::vector<std::byte> buffer;
+  sourcemeta::jsonbinpack::Encoder encoder{buffer};
+  for (auto _ : state) {
+    buffer.clear();
+    encoder.reset(buffer);
+    encoder.write(document, plan);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * 1000);
+}
+
+static void Decoder_Records_Encoding(benchmark::State &state) {
+  const auto encoding{records_encoding()};
+  std::vector<std::byte> buffer;
+  sourcemeta::jsonbinpack::Encoder encoder{buffer};
+  encoder.write(records_document(), encoding);
+  sourcemeta::jsonbinpack::Decoder decoder{
+      std::span<const std::byte>{buffer}};
+  for (auto _ : state) {
+    decoder.reset(std::span<const std::byte>{buffer});
+    auto result{decoder.read(encoding)};
+    benchmark::DoNotOptimize(result);
+  }
+
+  state.SetItemsProcessed(state.iterations() * 1000);
+}
+
+static void Decoder_Records_Plan(benchmark::State &state) {
+  const sourcemeta::jsonbinpack::Plan plan{records_encoding()};
+  std::vector<std::byte> buffer;
+  sourcemeta::jsonbinpack::Encoder encoder{buffer};
+  encoder.write(records_document(), plan);
+  sourcemeta::jsonbinpack::Decoder decoder{
+      std::span<const std::byte>{buffer}};
+  for (auto _ : state) {
+    decoder.reset(std::span<const std::byte>{buffer});
+    auto result{decoder.read(plan)};
+    benchmark::DoNotOptimize(result);
+  }
+
+  state.SetItemsProcessed(state.iterations() * 1000);
+}
+
+BENCHMARK(Encoder_Records_Encoding);
+BENCHMARK(Encoder_Records_Plan);
+BENCHMARK(Decoder_Records_Encoding);
+BENCHMARK(Decoder_Records_Plan);
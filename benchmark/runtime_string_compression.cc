@@ -0,0 +1,123 @@
+#include <benchmark/benchmark.h>
+
+#include <sourcemeta/core/json.h>
+
+#include <sourcemeta/jsonbinpack/runtime.h>
+
+#include <array>   // std::array
+#include <cstddef> // std::byte, std::size_t
+#include <cstdint> // std::int64_t, std::uint32_t
+#include <span>    // std::span
+#include <string>  // std::string
+#include <vector>  // std::vector
+
+// Free text of the given byte-length, made out of words picked at random out
+// of a small vocabulary, which is roughly how repetitive natural language is
+static auto prose(const std::size_t size) -> sourcemeta::core::JSON {
+  static constexpr std::array<const char *, 24> words{
+      {"the",     "request", "failed",  "because", "of",       "a",
+       "timeout", "while",   "waiting", "for",     "upstream", "service",
+       "to",      "respond", "retry",   "after",   "backoff",  "and",
+       "check",   "network", "latency", "between", "regions",  "again"}};
+  std::string result;
+  std::uint32_t seed{42};
+  while (result.size() < size) {
+    seed = seed * 1664525 + 1013904223;
+    result.append(words[(seed >> 16) % words.size()]);
+    result.push_back((seed & 0xf) == 0 ? '\n' : ' ');
+  }
+
+  result.resize(size);
+  return sourcemeta::core::JSON{result};
+}
+
+static auto stack_trace() -> sourcemeta::core::JSON {
+  std::string result{"Unhandled exception: connection reset by peer\n"};
+  for (std::size_t index = 0; index < 64; index++) {
+    result.append("    at sourcemeta::jsonbinpack::Encoder::write(");
+    result.append(std::to_string(index));
+    result.append(") in src/runtime/encoder_common.cc:");
+    result.append(std::to_string(50 + index * 7));
+    result.push_back('\n');
+  }
+
+  return sourcemeta::core::JSON{result};
+}
+
+static auto encode_string(benchmark::State &state,
+                          const sourcemeta::jsonbinpack::Encoding &encoding,
+                          const sourcemeta::core::JSON &document) -> void {
+  std::vector<std::byte> output;
+  for (auto _ : state) {
+    output.clear();
+    sourcemeta::jsonbinpack::Encoder encoder{output};
+    encoder.write(document, encoding);
+    benchmark::DoNotOptimize(output);
+  }
+
+  const auto size{static_cast<std::int64_t>(document.to_string().size())};
+  state.SetBytesProcessed(state.iterations() * size);
+  state.counters["ratio"] = static_cast<double>(output.size()) /
+                            static_cast<double>(size);
+}
+
+static auto decode_string(benchmark::State &state,
+                          const sourcemeta::jsonbinpack::Encoding &encoding,
+                          const sourcemeta::core::JSON &document) -> void {
+  std::vector<std::byte> input;
+  sourcemeta::jsonbinpack::Encoder encoder{input};
+  encoder.write(document, encoding);
+  for (auto _ : state) {
+    sourcemeta::jsonbinpack::Decoder decoder{
+        std::span<const std::byte>{input}};
+    auto result{decoder.read(encoding)};
+    benchmark::DoNotOptimize(result);
+  }
+
+  state.SetBytesProcessed(
+      state.iterations() *
+      static_cast<std::int64_t>(document.to_string().size()));
+}
+
+static void String_Encode_Uncompressed(benchmark::State &state) {
+  encode_string(
+      state, sourcemeta::jsonbinpack::PREFIX_VARINT_LENGTH_STRING_SHARED{},
+      prose(static_cast<std::size_t>(state.range(0))));
+}
+
+static void String_Encode_Gzip(benchmark::State &state) {
+  encode_string(state,
+                sourcemeta::jsonbinpack::GZIP_VARINT_PREFIX_UTF8_STRING{},
+                prose(static_cast<std::size_t>(state.range(0))));
+}
+
+static void String_Decode_Uncompressed(benchmark::State &state) {
+  decode_string(
+      state, sourcemeta::jsonbinpack::PREFIX_VARINT_LENGTH_STRING_SHARED{},
+      prose(static_cast<std::size_t>(state.range(0))));
+}
+
+static void String_Decode_Gzip(benchmark::State &state) {
+  decode_string(state,
+                sourcemeta::jsonbinpack::GZIP_VARINT_PREFIX_UTF8_STRING{},
+                prose(static_cast<std::size_t>(state.range(0))));
+}
+
+static void String_Encode_Gzip_Stack_Trace(benchmark::State &state) {
+  encode_string(state,
+                sourcemeta::jsonbinpack::GZIP_VARINT_PREFIX_UTF8_STRING{},
+                stack_trace());
+}
+
+static void String_Decode_Gzip_Stack_Trace(benchmark::State &state) {
+  decode_string(state,
+                sourcemeta::jsonbinpack::GZIP_VARINT_PREFIX_UTF8_STRING{},
+                stack_trace());
+}
+
+BENCHMARK(String_Encode_Uncompressed)->Arg(256)->Arg(4096)->Arg(65536);
+BENCHMARK(String_Encode_Gzip)->Arg(256)->Arg(4096)->Arg(65536);
+BENCHMARK(String_Decode_Uncompressed)->Arg(256)->Arg(4096)->Arg(65536);
+BENCHMARK(String_Decode_Gzip)->Arg(256)->Arg(4096)->Arg(65536);
+BENCHMARK(String_Encode_Gzip_Stack_Trace);
+BENCHMARK(String_Decode_Gzip_Stack_Trace);
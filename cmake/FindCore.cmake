@@ -6,9 +6,7 @@ if(NOT Core_FOUND)
   endif()
 
   set(SOURCEMETA_CORE_LANG_PROCESS OFF CACHE BOOL "disable")
-  set(SOURCEMETA_CORE_LANG_PARALLEL OFF CACHE BOOL "disable")
   set(SOURCEMETA_CORE_LANG_ERROR OFF CACHE BOOL "disable")
-  set(SOURCEMETA_CORE_GZIP OFF CACHE BOOL "disable")
   set(SOURCEMETA_CORE_JSONL OFF CACHE BOOL "disable JSONL support")
   set(SOURCEMETA_CORE_JSONRPC OFF CACHE BOOL "disable")
   set(SOURCEMETA_CORE_MCP OFF CACHE BOOL "disable")
@@ -16,7 +14,7 @@ if(NOT Core_FOUND)
   set(SOURCEMETA_CORE_OAUTH OFF CACHE BOOL "disable")
   set(SOURCEMETA_CORE_SEMVER OFF CACHE BOOL "disable")
   set(SOURCEMETA_CORE_MARKDOWN OFF CACHE BOOL "disable")
-  set(SOURCEMETA_CORE_CONTRIB_GOOGLEBENCHMARK OFF CACHE BOOL "GoogleBenchmark")
+  set(SOURCEMETA_CORE_CONTRIB_GOOGLEBENCHMARK ${JSONBINPACK_BENCHMARK} CACHE BOOL "GoogleBenchmark")
   add_subdirectory("${PROJECT_SOURCE_DIR}/vendor/core")
   include(Sourcemeta)
   set(Core_FOUND ON)
@@ -0,0 +1,108 @@
+#include <sourcemeta/jsonbinpack/compiler.h>
+
+#include <sourcemeta/core/crypto.h>
+#include <sourcemeta/core/io.h>
+
+#include <filesystem>   // std::filesystem
+#include <fstream>      // std::ofstream
+#include <ios>          // std::ios_base
+#include <sstream>      // std::ostringstream
+#include <string>       // std::string
+#include <system_error> // std::error_code
+#include <utility>      // std::move
+
+// Compiling the same schema with a different version of the compiler might
+// result in a different encoding schema
+static constexpr std::string_view COMPILER_VERSION{
+    SOURCEMETA_JSONBINPACK_VERSION};
+
+namespace sourcemeta::jsonbinpack {
+
+CompilerCache::CompilerCache(std::filesystem::path directory)
+    : directory_{std::move(directory)} {}
+
+auto CompilerCache::path(const sourcemeta::core::JSON &schema,
+                         const std::string_view default_dialect) const
+    -> std::filesystem::path {
+  std::ostringstream fingerprint;
+  fingerprint << COMPILER_VERSION << '\0' << default_dialect << '\0';
+  sourcemeta::core::stringify(schema, fingerprint);
+  return this->directory_ /
+         (sourcemeta::core::sha256(fingerprint.str()) + ".json");
+}
+
+auto CompilerCache::compile(sourcemeta::core::JSON &schema,
+                            const sourcemeta::blaze::SchemaWalker &walker,
+                            const sourcemeta::blaze::SchemaResolver &resolver,
+                            const std::string_view default_dialect) const
+    -> void {
+  const auto entry_path{this->path(schema, default_dialect)};
+  std::error_code error;
+  if (std::filesystem::is_regular_file(entry_path, error)) {
+    try {
+      auto cached{sourcemeta::core::read_json(entry_path)};
+      // Only trust entries that describe the very same compilation, which
+      // also guards against fingerprint collisions
+      if (cached.is_object() && cached.defines("version") &&
+          cached.defines("defaultDialect") && cached.defines("schema") &&
+          cached.defines("encoding") &&
+          cached.at("version").is_string() &&
+          cached.at("version").to_string() == COMPILER_VERSION &&
+          cached.at("defaultDialect").is_string() &&
+          cached.at("defaultDialect").to_string() == default_dialect &&
+          cached.at("schema") == schema &&
+          cached.at("encoding").is_object()) {
+        schema = std::move(cached.at("encoding"));
+        return;
+      }
+    } catch (const sourcemeta::core::JSONParseError &) {
+      // Compile the schema again, overwriting the corrupted entry
+    } catch (const sourcemeta::core::IOFileNotFoundError &) {
+      // Another process removed the entry in the meantime
+    } catch (const sourcemeta::core::IOFilePermissionError &) {
+      // Compile the schema again, trying to overwrite the unreadable entry
+    } catch (const sourcemeta::core::IOIsADirectoryError &) {
+      // Another process replaced the entry in the meantime
+    } catch (const std::filesystem::filesystem_error &) {
+      // Compile the schema again, like for any other miss
+    } catch (const std::ios_base::failure &) {
+      // Compile the schema again, like for any other miss
+    }
+  }
+
+  auto entry{sourcemeta::core::JSON::make_object()};
+  entry.assign("version",
+               sourcemeta::core::JSON{std::string{COMPILER_VERSION}});
+  entry.assign("defaultDialect",
+               sourcemeta::core::JSON{std::string{default_dialect}});
+  entry.assign("schema", schema);
+  sourcemeta::jsonbinpack::compile(schema, walker, resolver, default_dialect);
+  entry.assign("encoding", schema);
+
+  std::filesystem::create_directories(this->directory_, error);
+  if (error) {
+    return;
+  }
+
+  // Write to a temporary file first, so that other processes reading the
+  // cache never come across a partially written entry
+  auto temporary_path{entry_path};
+  temporary_path += "." + sourcemeta::core::uuidv4() + ".tmp";
+  {
+    std::ofstream stream{temporary_path};
+    sourcemeta::core::stringify(entry, stream);
+    stream.flush();
+    if (stream.fail()) {
+      stream.close();
+      std::filesystem::remove(temporary_path, error);
+      return;
+    }
+  }
+
+  std::filesystem::rename(temporary_path, entry_path, error);
+  if (error) {
+    std::filesystem::remove(temporary_path, error);
+  }
+}
+
+} // namespace sourcemeta::jsonbinpack
@@ -8,8 +8,11 @@
 
 #include "encoding.h"
 
+#include <algorithm>   // std::min
 #include <cassert>     // assert
+#include <optional>    // std::optional
 #include <type_traits> // std::true_type
+#include <utility>     // std::move
 
 static auto transformer_callback_noop(
     const sourcemeta::core::Pointer &, const std::string_view,
@@ -38,6 +41,163 @@ auto make_encoding(sourcemeta::core::JSON &document,
   document.assign("binpackOptions", options);
 }
 
+// The element subschemas of an array and the property subschemas of an object
+// are compiled on their own, so they must not reference anything outside of
+// them
+auto is_self_contained(
+    const sourcemeta::blaze::SchemaFrame &frame,
+    const sourcemeta::blaze::SchemaFrame::Location &location) -> bool {
+  for (const auto &reference : frame.references()) {
+    const auto &origin{reference.first.second};
+    if (origin.starts_with(location.pointer) && !origin.empty() &&
+        !(origin.back().is_property() &&
+          origin.back().to_property() == "$schema")) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+auto array_minimum(const sourcemeta::core::JSON &schema)
+    -> sourcemeta::core::JSON::Integer {
+  return schema.defines("minItems") && schema.at("minItems").is_integer()
+             ? schema.at("minItems").to_integer()
+             : 0;
+}
+
+auto array_maximum(const sourcemeta::core::JSON &schema)
+    -> std::optional<sourcemeta::core::JSON::Integer> {
+  std::optional<sourcemeta::core::JSON::Integer> result;
+  if (schema.defines("maxItems") && schema.at("maxItems").is_integer()) {
+    result = schema.at("maxItems").to_integer();
+  }
+
+  // An array cannot have more elements than prefix items if the rest of the
+  // elements are disallowed
+  if (schema.defines("items") && schema.at("items").is_boolean() &&
+      !schema.at("items").to_boolean()) {
+    const sourcemeta::core::JSON::Integer size{
+        schema.defines("prefixItems") && schema.at("prefixItems").is_array()
+            ? static_cast<sourcemeta::core::JSON::Integer>(
+                  schema.at("prefixItems").size())
+            : 0};
+    result = result.has_value() ? std::min(result.value(), size) : size;
+  }
+
+  return result;
+}
+
+// Array elements and object properties are compiled on their own
+auto compile_subschema(const sourcemeta::core::JSON &subschema,
+                       const sourcemeta::blaze::SchemaWalker &walker,
+                       const sourcemeta::blaze::SchemaResolver &resolver)
+    -> sourcemeta::core::JSON {
+  auto result{subschema};
+  if (!result.is_object() || !result.defines("binpackEncoding")) {
+    compile(result, walker, resolver,
+            "https://json-schema.org/draft/2020-12/schema");
+  }
+
+  // The first choice can only be elided at the end of the input, which is
+  // never the case for a value within an array or object
+  if (result.at("binpackEncoding").to_string() ==
+      "TOP_LEVEL_BYTE_CHOICE_INDEX") {
+    result.assign("binpackEncoding",
+                  sourcemeta::core::JSON{"BYTE_CHOICE_INDEX"});
+  }
+
+  return result;
+}
+
+auto make_array_encoding(sourcemeta::core::JSON &document,
+                         const std::string &encoding,
+                         sourcemeta::core::JSON options,
+                         const sourcemeta::blaze::SchemaWalker &walker,
+                         const sourcemeta::blaze::SchemaResolver &resolver)
+    -> void {
+  options.assign("encoding",
+                 compile_subschema(document.defines("items")
+                                       ? document.at("items")
+                                       : sourcemeta::core::JSON{true},
+                                   walker, resolver));
+  auto prefix_encodings{sourcemeta::core::JSON::make_array()};
+  if (document.defines("prefixItems")) {
+    for (const auto &subschema : document.at("prefixItems").as_array()) {
+      prefix_encodings.push_back(
+          compile_subschema(subschema, walker, resolver));
+    }
+  }
+
+  options.assign("prefixEncodings", std::move(prefix_encodings));
+  make_encoding(document, encoding, options);
+}
+
+// Objects whose properties are all known ahead of time
+auto is_closed_object(const sourcemeta::core::JSON &schema) -> bool {
+  if (schema.defines("patternProperties") &&
+      (!schema.at("patternProperties").is_object() ||
+       !schema.at("patternProperties").empty())) {
+    return false;
+  }
+
+  if (schema.defines("additionalProperties")) {
+    return schema.at("additionalProperties").is_boolean() &&
+           !schema.at("additionalProperties").to_boolean();
+  }
+
+  // Other applicators may evaluate properties on their own
+  for (const auto &keyword :
+       {"allOf", "anyOf", "oneOf", "if", "dependentSchemas", "$ref",
+        "$dynamicRef"}) {
+    if (schema.defines(keyword)) {
+      return false;
+    }
+  }
+
+  return schema.defines("unevaluatedProperties") &&
+         schema.at("unevaluatedProperties").is_boolean() &&
+         !schema.at("unevaluatedProperties").to_boolean();
+}
+
+// Objects whose properties all share the same subschemas
+auto is_uniform_object(const sourcemeta::core::JSON &schema) -> bool {
+  return (!schema.defines("properties") ||
+          (schema.at("properties").is_object() &&
+           schema.at("properties").empty())) &&
+         (!schema.defines("patternProperties") ||
+          (schema.at("patternProperties").is_object() &&
+           schema.at("patternProperties").empty()));
+}
+
+auto make_object_encoding(sourcemeta::core::JSON &document,
+                          const std::string &encoding,
+                          sourcemeta::core::JSON options,
+                          const sourcemeta::blaze::SchemaWalker &walker,
+                          const sourcemeta::blaze::SchemaResolver &resolver)
+    -> void {
+  // Property names are always strings, whatever else the schema says
+  auto key_schema{document.defines("propertyNames") &&
+                          document.at("propertyNames").is_object()
+                      ? document.at("propertyNames")
+                      : sourcemeta::core::JSON::make_object()};
+  if (!key_schema.defines("type")) {
+    key_schema.assign("type", sourcemeta::core::JSON{"string"});
+  }
+
+  options.assign("keyEncoding",
+                 compile_subschema(key_schema, walker, resolver));
+  options.assign("encoding",
+                 compile_subschema(document.defines("additionalProperties")
+                                       ? document.at("additionalProperties")
+                                       : sourcemeta::core::JSON{true},
+                                   walker, resolver));
+  make_encoding(document, encoding, options);
+}
+
+#include "mapper/array_bounded_8_bit.h"
+#include "mapper/array_fixed.h"
+#include "mapper/array_lower_bound.h"
 #include "mapper/enum_8_bit.h"
 #include "mapper/enum_8_bit_top_level.h"
 #include "mapper/enum_arbitrary.h"
@@ -53,6 +213,14 @@ auto make_encoding(sourcemeta::core::JSON &document,
 #include "mapper/integer_upper_bound.h"
 #include "mapper/integer_upper_bound_multiplier.h"
 #include "mapper/number_arbitrary.h"
+#include "mapper/object_arbitrary.h"
+#include "mapper/object_bounded.h"
+#include "mapper/object_fixed.h"
+#include "mapper/string_bounded_8_bit.h"
+#include "mapper/string_compressed.h"
+#include "mapper/string_date.h"
+#include "mapper/string_lower_bound.h"
+#include "mapper/string_uuid.h"
 
 auto compile(sourcemeta::core::JSON &schema,
              const sourcemeta::blaze::SchemaWalker &walker,
@@ -84,6 +252,25 @@ auto compile(sourcemeta::core::JSON &schema,
   // Numbers
   mapper.add<NumberArbitrary>();
 
+  // Strings
+  // Formats take precedence over compression, which takes precedence over
+  // the plain length-based encodings
+  mapper.add<StringDate>();
+  mapper.add<StringUuid>();
+  mapper.add<StringCompressed>();
+  mapper.add<StringBounded8Bit>();
+  mapper.add<StringLowerBound>();
+
+  // Arrays
+  mapper.add<ArrayFixed>(walker, resolver);
+  mapper.add<ArrayBounded8Bit>(walker, resolver);
+  mapper.add<ArrayLowerBound>(walker, resolver);
+
+  // Objects
+  mapper.add<ObjectBounded>(walker, resolver);
+  mapper.add<ObjectFixed>(walker, resolver);
+  mapper.add<ObjectArbitrary>(walker, resolver);
+
   [[maybe_unused]] const auto mapper_result =
       mapper.apply(schema, walker, make_resolver(resolver),
                    transformer_callback_noop, default_dialect);
@@ -17,6 +17,7 @@
 #include <sourcemeta/blaze/foundation.h>
 #include <sourcemeta/core/json.h>
 
+#include <filesystem>  // std::filesystem::path
 #include <string_view> // std::string_view
 
 namespace sourcemeta::jsonbinpack {
@@ -83,6 +84,70 @@ auto canonicalize(sourcemeta::core::JSON &schema,
                   const sourcemeta::blaze::SchemaResolver &resolver,
                   std::string_view default_dialect = "") -> void;
 
+// Exporting symbols that depends on the standard C++ library is considered
+// safe.
+// https://learn.microsoft.com/en-us/cpp/error-messages/compiler-warnings/compiler-warning-level-2-c4275?view=msvc-170&redirectedfrom=MSDN
+#if defined(_MSC_VER)
+#pragma warning(disable : 4251 4275)
+#endif
+
+/// @ingroup compiler
+///
+/// A persistent cache of compiled encoding schemas, stored as one file per
+/// schema in the given directory. Compiling a schema that the same version of
+/// the compiler already compiled, even from another process, reads the
+/// encoding schema back from disk instead of canonicalizing and mapping the
+/// schema again. For example:
+///
+/// ```cpp
+/// #include <sourcemeta/binpack/compiler.h>
+/// #include <sourcemeta/core/json.h>
+/// #include <sourcemeta/blaze/foundation.h>
+///
+/// #include <iostream>
+///
+/// auto schema{sourcemeta::core::parse_json(R"JSON({
+///   "$schema": "https://json-schema.org/draft/2020-12/schema",
+///   "type": "string"
+/// })JSON")};
+///
+/// sourcemeta::jsonbinpack::CompilerCache cache{"/tmp/jsonbinpack"};
+/// cache.compile(schema, sourcemeta::blaze::schema_walker,
+///               sourcemeta::blaze::schema_resolver);
+///
+/// sourcemeta::core::prettify(schema, std::cout);
+/// std::cout << std::endl;
+/// ```
+///
+/// Entries are keyed by the schema, the default dialect, and the version of
+/// the compiler. The schemas that the resolver returns are assumed not to
+/// change for as long as the same cache directory is in use. Entries that
+/// cannot be read are compiled again, and entries that cannot be written are
+/// not cached.
+class SOURCEMETA_JSONBINPACK_COMPILER_EXPORT CompilerCache {
+public:
+  CompilerCache(std::filesystem::path directory);
+
+  /// Compile a JSON Schema into an encoding schema, like the `compile`
+  /// function, going through the cache
+  auto compile(sourcemeta::core::JSON &schema,
+               const sourcemeta::blaze::SchemaWalker &walker,
+               const sourcemeta::blaze::SchemaResolver &resolver,
+               std::string_view default_dialect = "") const -> void;
+
+  /// The file that holds the compiled encoding schema of the given schema
+  [[nodiscard]] auto path(const sourcemeta::core::JSON &schema,
+                          std::string_view default_dialect = "") const
+      -> std::filesystem::path;
+
+private:
+  std::filesystem::path directory_;
+};
+
+#if defined(_MSC_VER)
+#pragma warning(default : 4251 4275)
+#endif
+
 } // namespace sourcemeta::jsonbinpack
 
 #endif
@@ -0,0 +1,46 @@
+class ArrayFixed final : public sourcemeta::blaze::SchemaTransformRule {
+public:
+  using mutates = std::true_type;
+  using reframe_after_transform = std::true_type;
+  ArrayFixed(const sourcemeta::blaze::SchemaWalker &walker,
+             const sourcemeta::blaze::SchemaResolver &resolver)
+      : sourcemeta::blaze::SchemaTransformRule{"array_fixed", ""},
+        walker_{walker}, resolver_{resolver} {};
+
+  [[nodiscard]] auto
+  condition(const sourcemeta::core::JSON &schema,
+            const sourcemeta::core::JSON &,
+            const sourcemeta::blaze::Vocabularies &vocabularies,
+            const sourcemeta::blaze::SchemaFrame &frame,
+            const sourcemeta::blaze::SchemaFrame::Location &location,
+            const sourcemeta::blaze::SchemaWalker &,
+            const sourcemeta::blaze::SchemaResolver &, const bool) const
+      -> sourcemeta::blaze::SchemaTransformRule::Result override {
+    if (location.dialect != "https://json-schema.org/draft/2020-12/schema" ||
+        !vocabularies.contains(sourcemeta::blaze::Vocabularies::Known::
+                                   JSON_Schema_2020_12_Validation) ||
+        !vocabularies.contains(sourcemeta::blaze::Vocabularies::Known::
+                                   JSON_Schema_2020_12_Applicator) ||
+        !schema.is_object() || !schema.defines("type") ||
+        schema.at("type").to_string() != "array" ||
+        !is_self_contained(frame, location)) {
+      return false;
+    }
+
+    const auto maximum{array_maximum(schema)};
+    return maximum.has_value() && maximum.value() == array_minimum(schema);
+  }
+
+  auto transform(sourcemeta::core::JSON &schema,
+                 const sourcemeta::blaze::SchemaTransformRule::Result &) const
+      -> void override {
+    auto options = sourcemeta::core::JSON::make_object();
+    options.assign("size", sourcemeta::core::JSON{array_minimum(schema)});
+    make_array_encoding(schema, "FIXED_TYPED_ARRAY", std::move(options),
+                        this->walker_, this->resolver_);
+  }
+
+private:
+  const sourcemeta::blaze::SchemaWalker &walker_;
+  const sourcemeta::blaze::SchemaResolver &resolver_;
+};
@@ -0,0 +1,78 @@
+// Objects that cannot define any property other than the ones that the schema
+// lists are encoded without their property names
+class ObjectBounded final : public sourcemeta::blaze::SchemaTransformRule {
+public:
+  using mutates = std::true_type;
+  using reframe_after_transform = std::true_type;
+  ObjectBounded(const sourcemeta::blaze::SchemaWalker &walker,
+                const sourcemeta::blaze::SchemaResolver &resolver)
+      : sourcemeta::blaze::SchemaTransformRule{"object_bounded", ""},
+        walker_{walker}, resolver_{resolver} {};
+
+  [[nodiscard]] auto
+  condition(const sourcemeta::core::JSON &schema,
+            const sourcemeta::core::JSON &,
+            const sourcemeta::blaze::Vocabularies &vocabularies,
+            const sourcemeta::blaze::SchemaFrame &frame,
+            const sourcemeta::blaze::SchemaFrame::Location &location,
+            const sourcemeta::blaze::SchemaWalker &,
+            const sourcemeta::blaze::SchemaResolver &, const bool) const
+      -> sourcemeta::blaze::SchemaTransformRule::Result override {
+    return location.dialect == "https://json-schema.org/draft/2020-12/schema" &&
+           vocabularies.contains(sourcemeta::blaze::Vocabularies::Known::
+                                     JSON_Schema_2020_12_Validation) &&
+           vocabularies.contains(sourcemeta::blaze::Vocabularies::Known::
+                                     JSON_Schema_2020_12_Applicator) &&
+           schema.is_object() && schema.defines("type") &&
+           schema.at("type").to_string() == "object" &&
+           (!schema.defines("properties") ||
+            schema.at("properties").is_object()) &&
+           (!schema.defines("required") || schema.at("required").is_array()) &&
+           is_closed_object(schema) && is_self_contained(frame, location);
+  }
+
+  auto transform(sourcemeta::core::JSON &schema,
+                 const sourcemeta::blaze::SchemaTransformRule::Result &) const
+      -> void override {
+    const auto properties{schema.defines("properties")
+                              ? schema.at("properties")
+                              : sourcemeta::core::JSON::make_object()};
+    auto required_properties{sourcemeta::core::JSON::make_array()};
+    auto optional_properties{sourcemeta::core::JSON::make_array()};
+    auto property_encodings{sourcemeta::core::JSON::make_object()};
+
+    // Required properties that the schema does not describe can be anything
+    if (schema.defines("required")) {
+      for (const auto &name : schema.at("required").as_array()) {
+        if (name.is_string() && !property_encodings.defines(name.to_string())) {
+          required_properties.push_back(name);
+          property_encodings.assign(
+              name.to_string(),
+              compile_subschema(properties.defines(name.to_string())
+                                    ? properties.at(name.to_string())
+                                    : sourcemeta::core::JSON{true},
+                                this->walker_, this->resolver_));
+        }
+      }
+    }
+
+    for (const auto &entry : properties.as_object()) {
+      if (!property_encodings.defines(entry.first)) {
+        optional_properties.push_back(sourcemeta::core::JSON{entry.first});
+        property_encodings.assign(
+            entry.first,
+            compile_subschema(entry.second, this->walker_, this->resolver_));
+      }
+    }
+
+    auto options = sourcemeta::core::JSON::make_object();
+    options.assign("requiredProperties", std::move(required_properties));
+    options.assign("optionalProperties", std::move(optional_properties));
+    options.assign("propertyEncodings", std::move(property_encodings));
+    make_encoding(schema, "MIXED_BOUNDED_TYPED_OBJECT", options);
+  }
+
+private:
+  const sourcemeta::blaze::SchemaWalker &walker_;
+  const sourcemeta::blaze::SchemaResolver &resolver_;
+};
@@ -0,0 +1,45 @@
+// The length keywords count code points, while the encodings count bytes, and
+// a code point takes at most 4 bytes in UTF-8
+class StringBounded8Bit final : public sourcemeta::blaze::SchemaTransformRule {
+public:
+  using mutates = std::true_type;
+  using reframe_after_transform = std::true_type;
+  StringBounded8Bit()
+      : sourcemeta::blaze::SchemaTransformRule{"string_bounded_8_bit", ""} {};
+
+  [[nodiscard]] auto
+  condition(const sourcemeta::core::JSON &schema,
+            const sourcemeta::core::JSON &,
+            const sourcemeta::blaze::Vocabularies &vocabularies,
+            const sourcemeta::blaze::SchemaFrame &,
+            const sourcemeta::blaze::SchemaFrame::Location &location,
+            const sourcemeta::blaze::SchemaWalker &,
+            const sourcemeta::blaze::SchemaResolver &, const bool) const
+      -> sourcemeta::blaze::SchemaTransformRule::Result override {
+    if (location.dialect != "https://json-schema.org/draft/2020-12/schema" ||
+        !vocabularies.contains(sourcemeta::blaze::Vocabularies::Known::
+                                   JSON_Schema_2020_12_Validation) ||
+        !schema.is_object() || !schema.defines("type") ||
+        schema.at("type").to_string() != "string" ||
+        !schema.defines("minLength") || !schema.at("minLength").is_integer() ||
+        !schema.defines("maxLength") || !schema.at("maxLength").is_integer()) {
+      return false;
+    }
+
+    const auto minimum{schema.at("minLength").to_integer()};
+    const auto maximum{schema.at("maxLength").to_integer() * 4};
+    return minimum <= maximum &&
+           sourcemeta::core::is_byte(maximum - minimum + 1);
+  }
+
+  auto transform(sourcemeta::core::JSON &schema,
+                 const sourcemeta::blaze::SchemaTransformRule::Result &) const
+      -> void override {
+    auto minimum = schema.at("minLength");
+    auto options = sourcemeta::core::JSON::make_object();
+    options.assign("minimum", std::move(minimum));
+    options.assign("maximum", sourcemeta::core::JSON{
+                                  schema.at("maxLength").to_integer() * 4});
+    make_encoding(schema, "BOUNDED_8BIT_PREFIX_UTF8_STRING_SHARED", options);
+  }
+};
@@ -0,0 +1,39 @@
+// Strings that are known to be long, or that the schema author explicitly
+// marks through the `x-binpack-compress` annotation, are likely free text
+// that compresses well enough to make up for the compression overhead
+class StringCompressed final : public sourcemeta::blaze::SchemaTransformRule {
+public:
+  using mutates = std::true_type;
+  using reframe_after_transform = std::true_type;
+  StringCompressed()
+      : sourcemeta::blaze::SchemaTransformRule{"string_compressed", ""} {};
+
+  [[nodiscard]] auto
+  condition(const sourcemeta::core::JSON &schema,
+            const sourcemeta::core::JSON &,
+            const sourcemeta::blaze::Vocabularies &vocabularies,
+            const sourcemeta::blaze::SchemaFrame &,
+            const sourcemeta::blaze::SchemaFrame::Location &location,
+            const sourcemeta::blaze::SchemaWalker &,
+            const sourcemeta::blaze::SchemaResolver &, const bool) const
+      -> sourcemeta::blaze::SchemaTransformRule::Result override {
+    return location.dialect == "https://json-schema.org/draft/2020-12/schema" &&
+           vocabularies.contains(sourcemeta::blaze::Vocabularies::Known::
+                                     JSON_Schema_2020_12_Validation) &&
+           schema.is_object() && schema.defines("type") &&
+           schema.at("type").to_string() == "string" &&
+           ((schema.defines("x-binpack-compress") &&
+             schema.at("x-binpack-compress").is_boolean() &&
+             schema.at("x-binpack-compress").to_boolean()) ||
+            (schema.defines("minLength") &&
+             schema.at("minLength").is_integer() &&
+             schema.at("minLength").to_integer() >= 256));
+  }
+
+  auto transform(sourcemeta::core::JSON &schema,
+                 const sourcemeta::blaze::SchemaTransformRule::Result &) const
+      -> void override {
+    make_encoding(schema, "GZIP_VARINT_PREFIX_UTF8_STRING",
+                  sourcemeta::core::JSON::make_object());
+  }
+};
@@ -0,0 +1,39 @@
+// An RFC 3339 full-date always consists of a year, a month, and a day, so it
+// is cheaper to store these as integers than as 10 characters of text
+class StringDate final : public sourcemeta::blaze::SchemaTransformRule {
+public:
+  using mutates = std::true_type;
+  using reframe_after_transform = std::true_type;
+  StringDate() : sourcemeta::blaze::SchemaTransformRule{"string_date", ""} {};
+
+  [[nodiscard]] auto
+  condition(const sourcemeta::core::JSON &schema,
+            const sourcemeta::core::JSON &,
+            const sourcemeta::blaze::Vocabularies &vocabularies,
+            const sourcemeta::blaze::SchemaFrame &,
+            const sourcemeta::blaze::SchemaFrame::Location &location,
+            const sourcemeta::blaze::SchemaWalker &,
+            const sourcemeta::blaze::SchemaResolver &, const bool) const
+      -> sourcemeta::blaze::SchemaTransformRule::Result override {
+    // As an annotation, the format does not guarantee that the string is a
+    // date, and asserting formats takes a custom metaschema, so match any
+    // dialect based on 2020-12 rather than only the official one
+    return location.base_dialect ==
+               sourcemeta::blaze::SchemaBaseDialect::JSON_Schema_2020_12 &&
+           vocabularies.contains(sourcemeta::blaze::Vocabularies::Known::
+                                     JSON_Schema_2020_12_Validation) &&
+           vocabularies.contains(sourcemeta::blaze::Vocabularies::Known::
+                                     JSON_Schema_2020_12_Format_Assertion) &&
+           schema.is_object() && schema.defines("type") &&
+           schema.at("type").to_string() == "string" &&
+           schema.defines("format") && schema.at("format").is_string() &&
+           schema.at("format").to_string() == "date";
+  }
+
+  auto transform(sourcemeta::core::JSON &schema,
+                 const sourcemeta::blaze::SchemaTransformRule::Result &) const
+      -> void override {
+    make_encoding(schema, "RFC3339_DATE_INTEGER_TRIPLET",
+                  sourcemeta::core::JSON::make_object());
+  }
+};
@@ -0,0 +1,35 @@
+// A string has at least as many bytes as code points, so the minimum length
+// is a safe lower bound of its byte-length
+class StringLowerBound final : public sourcemeta::blaze::SchemaTransformRule {
+public:
+  using mutates = std::true_type;
+  using reframe_after_transform = std::true_type;
+  StringLowerBound()
+      : sourcemeta::blaze::SchemaTransformRule{"string_lower_bound", ""} {};
+
+  [[nodiscard]] auto
+  condition(const sourcemeta::core::JSON &schema,
+            const sourcemeta::core::JSON &,
+            const sourcemeta::blaze::Vocabularies &vocabularies,
+            const sourcemeta::blaze::SchemaFrame &,
+            const sourcemeta::blaze::SchemaFrame::Location &location,
+            const sourcemeta::blaze::SchemaWalker &,
+            const sourcemeta::blaze::SchemaResolver &, const bool) const
+      -> sourcemeta::blaze::SchemaTransformRule::Result override {
+    return location.dialect == "https://json-schema.org/draft/2020-12/schema" &&
+           vocabularies.contains(sourcemeta::blaze::Vocabularies::Known::
+                                     JSON_Schema_2020_12_Validation) &&
+           schema.is_object() && schema.defines("type") &&
+           schema.at("type").to_string() == "string" &&
+           schema.defines("minLength") && schema.at("minLength").is_integer();
+  }
+
+  auto transform(sourcemeta::core::JSON &schema,
+                 const sourcemeta::blaze::SchemaTransformRule::Result &) const
+      -> void override {
+    auto minimum = schema.at("minLength");
+    auto options = sourcemeta::core::JSON::make_object();
+    options.assign("minimum", std::move(minimum));
+    make_encoding(schema, "FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED", options);
+  }
+};
@@ -0,0 +1,50 @@
+// The textual form of a UUID always takes exactly 36 ASCII characters, so
+// there is no need to encode its length. This only holds if the schema
+// guarantees that the string is a UUID
+class StringUuid final : public sourcemeta::blaze::SchemaTransformRule {
+public:
+  using mutates = std::true_type;
+  using reframe_after_transform = std::true_type;
+  StringUuid() : sourcemeta::blaze::SchemaTransformRule{"string_uuid", ""} {};
+
+  [[nodiscard]] auto
+  condition(const sourcemeta::core::JSON &schema,
+            const sourcemeta::core::JSON &,
+            const sourcemeta::blaze::Vocabularies &vocabularies,
+            const sourcemeta::blaze::SchemaFrame &,
+            const sourcemeta::blaze::SchemaFrame::Location &location,
+            const sourcemeta::blaze::SchemaWalker &,
+            const sourcemeta::blaze::SchemaResolver &, const bool) const
+      -> sourcemeta::blaze::SchemaTransformRule::Result override {
+    // Asserting formats takes a custom metaschema, so match any dialect based
+    // on 2020-12 rather than only the official one
+    if (location.base_dialect !=
+            sourcemeta::blaze::SchemaBaseDialect::JSON_Schema_2020_12 ||
+        !vocabularies.contains(sourcemeta::blaze::Vocabularies::Known::
+                                   JSON_Schema_2020_12_Validation) ||
+        !schema.is_object() || !schema.defines("type") ||
+        schema.at("type").to_string() != "string" ||
+        !schema.defines("format") || !schema.at("format").is_string() ||
+        schema.at("format").to_string() != "uuid") {
+      return false;
+    }
+
+    // As an annotation, the format does not guarantee that the string is a
+    // UUID, unless its length is fixed to the one of a UUID too
+    return vocabularies.contains(sourcemeta::blaze::Vocabularies::Known::
+                                     JSON_Schema_2020_12_Format_Assertion) ||
+           (vocabularies.contains(sourcemeta::blaze::Vocabularies::Known::
+                                      JSON_Schema_2020_12_Format_Annotation) &&
+            schema.defines("minLength") && schema.defines("maxLength") &&
+            schema.at("minLength") == sourcemeta::core::JSON{36} &&
+            schema.at("maxLength") == sourcemeta::core::JSON{36});
+  }
+
+  auto transform(sourcemeta::core::JSON &schema,
+                 const sourcemeta::blaze::SchemaTransformRule::Result &) const
+      -> void override {
+    auto options = sourcemeta::core::JSON::make_object();
+    options.assign("size", sourcemeta::core::JSON{36});
+    make_encoding(schema, "UTF8_STRING_NO_LENGTH", options);
+  }
+};
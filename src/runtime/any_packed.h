@@ -0,0 +1,27 @@
+#ifndef SOURCEMETA_JSONBINPACK_RUNTIME_ANY_PACKED_H_
+#define SOURCEMETA_JSONBINPACK_RUNTIME_ANY_PACKED_H_
+
+#include <sourcemeta/jsonbinpack/runtime_encoding.h>
+
+namespace sourcemeta::jsonbinpack {
+namespace internal::ANY_PACKED_TYPE_TAG_BYTE_PREFIX {
+
+// Every array item and object value is encoded the same way, so these
+// encodings are shared by every container instead of allocated for each one
+
+inline auto value_encoding() -> const Encoding & {
+  static const Encoding encoding{
+      sourcemeta::jsonbinpack::ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  return encoding;
+}
+
+inline auto key_encoding() -> const Encoding & {
+  static const Encoding encoding{
+      sourcemeta::jsonbinpack::PREFIX_VARINT_LENGTH_STRING_SHARED{}};
+  return encoding;
+}
+
+} // namespace internal::ANY_PACKED_TYPE_TAG_BYTE_PREFIX
+} // namespace sourcemeta::jsonbinpack
+
+#endif
@@ -0,0 +1,119 @@
+#include <sourcemeta/jsonbinpack/runtime_batch.h>
+#include <sourcemeta/jsonbinpack/runtime_decoder.h>
+#include <sourcemeta/jsonbinpack/runtime_encoder.h>
+#include <sourcemeta/jsonbinpack/runtime_input_stream.h>
+#include <sourcemeta/jsonbinpack/runtime_output_stream.h>
+
+#include <sourcemeta/core/parallel.h>
+
+#include <algorithm> // std::min, std::max
+#include <cstddef>   // std::byte, std::size_t
+#include <numeric>   // std::iota
+#include <span>      // std::span
+#include <vector>    // std::vector
+
+namespace {
+
+struct Range {
+  std::size_t begin;
+  std::size_t end;
+};
+
+// Split the records into a few more contiguous ranges than there are threads,
+// so that threads that finish early pick up some of the remaining work
+auto partition(const std::size_t size, const std::size_t parallelism)
+    -> std::vector<Range> {
+  const auto count{
+      std::min(size, std::max(parallelism, static_cast<std::size_t>(1)) * 4)};
+  std::vector<Range> result;
+  result.reserve(count);
+  for (std::size_t index = 0; index < count; index++) {
+    result.push_back({size * index / count, size * (index + 1) / count});
+  }
+
+  return result;
+}
+
+auto indexes(const std::size_t size) -> std::vector<std::size_t> {
+  std::vector<std::size_t> result(size);
+  std::iota(result.begin(), result.end(), 0);
+  return result;
+}
+
+} // namespace
+
+namespace sourcemeta::jsonbinpack {
+
+auto encode_batch(std::span<const sourcemeta::core::JSON> documents,
+                  const Encoding &encoding, std::vector<std::byte> &output,
+                  const std::size_t parallelism,
+                  const CacheOptions &cache_options) -> void {
+  const auto ranges{partition(documents.size(), parallelism)};
+  const auto tasks{indexes(ranges.size())};
+  // Every range is encoded into its own buffer to concatenate them in order
+  std::vector<std::vector<std::byte>> chunks(ranges.size());
+  sourcemeta::core::parallel_for_each(
+      tasks.cbegin(), tasks.cend(),
+      [&documents, &encoding, &cache_options, &ranges,
+       &chunks](const std::size_t task, const std::size_t, const std::size_t) {
+        const auto &range{ranges[task]};
+        std::vector<std::byte> record;
+        Encoder encoder{record, cache_options};
+        OutputStream stream{chunks[task]};
+        for (std::size_t index = range.begin; index < range.end; index++) {
+          // Records are encoded on their own, so their string
+          // references never point outside of them
+          record.clear();
+          encoder.reset(record);
+          encoder.write(documents[index], encoding);
+          stream.put_varint(record.size());
+          stream.put_bytes(record.data(), record.size());
+        }
+      },
+      parallelism);
+
+  std::size_t size{output.size()};
+  for (const auto &chunk : chunks) {
+    size += chunk.size();
+  }
+
+  output.reserve(size);
+  for (const auto &chunk : chunks) {
+    output.insert(output.end(), chunk.cbegin(), chunk.cend());
+  }
+}
+
+auto decode_batch(std::span<const std::byte> input, const Encoding &encoding,
+                  const std::size_t parallelism, const Dictionary *dictionary)
+    -> std::vector<sourcemeta::core::JSON> {
+  // Finding where records start only takes reading their lengths
+  std::vector<std::span<const std::byte>> records;
+  InputStream stream{input};
+  while (stream.has_more_data()) {
+    const auto length{stream.get_varint()};
+    const auto position{stream.position()};
+    records.push_back(stream.bytes(position, length));
+    stream.seek(position + length);
+  }
+
+  std::vector<sourcemeta::core::JSON> result(records.size(),
+                                             sourcemeta::core::JSON{nullptr});
+  const auto ranges{partition(records.size(), parallelism)};
+  const auto tasks{indexes(ranges.size())};
+  sourcemeta::core::parallel_for_each(
+      tasks.cbegin(), tasks.cend(),
+      [&records, &encoding, dictionary, &ranges, &result](
+          const std::size_t task, const std::size_t, const std::size_t) {
+        const auto &range{ranges[task]};
+        Decoder decoder{records[range.begin], dictionary};
+        for (std::size_t index = range.begin; index < range.end; index++) {
+          decoder.reset(records[index]);
+          result[index] = decoder.read(encoding);
+        }
+      },
+      parallelism);
+
+  return result;
+}
+
+} // namespace sourcemeta::jsonbinpack
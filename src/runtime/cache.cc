@@ -1,66 +1,346 @@
 #include <sourcemeta/jsonbinpack/runtime_encoder_cache.h>
 
+#include <algorithm>  // std::max, std::min, std::fill, std::upper_bound
+#include <cassert>    // assert
+#include <cstring>    // std::memcpy
+#include <deque>      // std::erase_if
+#include <optional>   // std::optional
+#include <functional> // std::hash
+#include <memory>     // std::unique_ptr
+#include <utility>    // std::move
+
 namespace sourcemeta::jsonbinpack {
 
-auto Cache::record(const sourcemeta::core::JSON::String &value,
-                   const std::uint64_t offset, const Type type) -> void {
-  // Encoding a shared string has some overhead, such as the
-  // shared string marker + the offset, so its not worth
-  // doing for strings that are too small.
-  constexpr auto MINIMUM_STRING_LENGTH{3};
+// Strings are copied into arena chunks that start small
+// and double in size up to a limit, unless a single string
+// does not fit in them
+static constexpr std::size_t MINIMUM_CHUNK_SIZE{1024};
+static constexpr std::size_t MAXIMUM_CHUNK_SIZE{65536};
 
-  // We don't want to allow the context to grow
-  // forever, otherwise an attacker could force the
-  // program to exhaust memory given an input
-  // document that contains a high number of large strings.
-  constexpr auto MAXIMUM_BYTE_SIZE{20971520};
+// Must be a power of two
+static constexpr std::size_t MINIMUM_CAPACITY{64};
 
+Cache::Cache(const CacheOptions &cache_options) : options{cache_options} {}
+
+auto Cache::record(const sourcemeta::core::JSON::String &value,
+                   const std::uint64_t offset, const Type type) -> void {
   const auto value_size{value.size()};
-  if (value_size < MINIMUM_STRING_LENGTH || value_size >= MAXIMUM_BYTE_SIZE) {
+  // A reference is never smaller than an empty string, whatever the options
+  if (!this->options.sharing || value_size == 0 ||
+      value_size < this->options.minimum_string_length ||
+      value_size >= this->options.maximum_byte_size ||
+      this->options.maximum_entries == 0) {
     return;
   }
 
+  const std::string_view view{value.data(), value_size};
+  const auto hash{std::hash<std::string_view>{}(view)};
+  if (this->size > 0) {
+    const auto slot{this->lookup(view, hash, type)};
+    if (this->slots[slot] != 0) {
+      const auto index{this->slots[slot] - 1};
+      auto &entry{this->entries[index]};
+      // If the string already exists, we want to
+      // bump the offset for locality purposes.
+      if (offset > entry.offset) {
+        entry.offset = offset;
+        entry.generation += 1;
+        this->stale += 1;
+        this->enqueue(index);
+      }
+
+      return;
+    }
+  }
+
   // Remove the oldest entries to make space if needed
-  while (!this->data.empty() &&
-         this->byte_size + value_size >= MAXIMUM_BYTE_SIZE) {
+  while (this->size > 0 &&
+         (this->byte_size + value_size >= this->options.maximum_byte_size ||
+          this->size >= this->options.maximum_entries)) {
+    if (this->options.eviction == CacheOptions::Eviction::Reject) {
+      return;
+    }
+
     this->remove_oldest();
   }
 
-  auto result{this->data.insert({std::make_pair(value, type), offset})};
-  if (result.second) {
-    this->byte_size += value_size;
-    this->order.emplace(offset, result.first->first);
-  } else if (offset > result.first->second) {
-    this->order.erase(result.first->second);
-    // If the string already exists, we want to
-    // bump the offset for locality purposes.
-    result.first->second = offset;
-    this->order.emplace(offset, result.first->first);
+  // Keep the load factor at or below one half
+  if ((this->size + 1) * 2 > this->slots.size()) {
+    this->rehash(std::max(MINIMUM_CAPACITY, this->slots.size() * 2));
+  }
+
+  std::uint32_t index;
+  if (this->free_entries.empty()) {
+    index = static_cast<std::uint32_t>(this->entries.size());
+    this->entries.push_back({});
+  } else {
+    index = this->free_entries.back();
+    this->free_entries.pop_back();
   }
 
-  // Otherwise we are doing something wrong
-  assert(this->order.size() == this->data.size());
+  auto &entry{this->entries[index]};
+  entry.value = this->allocate(view);
+  entry.hash = hash;
+  entry.offset = offset;
+  entry.generation += 1;
+  entry.chunk = this->current_chunk.value();
+  entry.type = type;
+  this->slots[this->lookup(view, hash, type)] = index + 1;
+  this->byte_size += value_size;
+  this->size += 1;
+  this->enqueue(index);
 }
 
 auto Cache::remove_oldest() -> void {
-  assert(!this->data.empty());
-  // std::map are by definition ordered by key,
-  // so the begin iterator points to the entry
-  // with the lowest offset, a.k.a. the oldest.
-  const auto iterator{this->order.cbegin()};
-  this->byte_size -= iterator->second.get().first.size();
-  this->data.erase(iterator->second.get());
-  this->order.erase(iterator);
+  assert(this->size > 0);
+  // The eviction order is sorted by offset, so the first
+  // reference that is still up to date points to the
+  // entry with the lowest offset, a.k.a. the oldest.
+  while (this->order.front().generation !=
+         this->entries[this->order.front().entry].generation) {
+    this->order.pop_front();
+    this->stale -= 1;
+  }
+
+  const auto index{this->order.front().entry};
+  this->order.pop_front();
+  auto &entry{this->entries[index]};
+
+  // Remove the entry from the table by shifting back any
+  // subsequent entry of the probe sequence into the hole
+  const auto mask{this->slots.size() - 1};
+  auto hole{entry.hash & mask};
+  while (this->slots[hole] != index + 1) {
+    hole = (hole + 1) & mask;
+  }
+
+  for (auto next{(hole + 1) & mask}; this->slots[next] != 0;
+       next = (next + 1) & mask) {
+    const auto ideal{this->entries[this->slots[next] - 1].hash & mask};
+    if (((next - ideal) & mask) >= ((next - hole) & mask)) {
+      this->slots[hole] = this->slots[next];
+      hole = next;
+    }
+  }
+
+  this->slots[hole] = 0;
+  this->byte_size -= entry.value.size();
+  this->size -= 1;
+  this->release(entry.chunk);
+  entry.value = {};
+  entry.generation += 1;
+  this->free_entries.push_back(index);
 }
 
 auto Cache::find(const sourcemeta::core::JSON::String &value,
                  const Type type) const -> std::optional<std::uint64_t> {
-  const auto result{this->data.find(std::make_pair(value, type))};
-  if (result == this->data.cend()) {
+  // Checking the size also covers the case where sharing is disabled
+  if (this->size == 0) {
+    return std::nullopt;
+  }
+
+  const std::string_view view{value.data(), value.size()};
+  const auto slot{
+      this->lookup(view, std::hash<std::string_view>{}(view), type)};
+  if (this->slots[slot] == 0) {
     return std::nullopt;
   }
 
-  return result->second;
+  return this->entries[this->slots[slot] - 1].offset;
+}
+
+auto Cache::clear() -> void {
+  this->byte_size = 0;
+  this->size = 0;
+  this->entries.clear();
+  this->free_entries.clear();
+  std::fill(this->slots.begin(), this->slots.end(), 0);
+  this->order.clear();
+  this->stale = 0;
+  for (auto &chunk : this->chunks) {
+    if (chunk.data != nullptr && chunk.capacity <= MAXIMUM_CHUNK_SIZE) {
+      chunk.size = 0;
+      chunk.references = 0;
+      this->spare_chunks.push_back(std::move(chunk));
+    }
+  }
+
+  this->chunks.clear();
+  this->free_chunks.clear();
+  this->current_chunk.reset();
+  this->arena_byte_size = 0;
+}
+
+auto Cache::arena_size() const -> std::size_t { return this->arena_byte_size; }
+
+// Find the slot that holds the given string, or the empty slot
+// where the string would be inserted if its not in the table
+auto Cache::lookup(const std::string_view value, const std::size_t hash,
+                   const Type type) const -> std::size_t {
+  assert(!this->slots.empty());
+  const auto mask{this->slots.size() - 1};
+  auto slot{hash & mask};
+  while (this->slots[slot] != 0) {
+    const auto &entry{this->entries[this->slots[slot] - 1]};
+    if (entry.hash == hash && entry.type == type && entry.value == value) {
+      break;
+    }
+
+    slot = (slot + 1) & mask;
+  }
+
+  return slot;
+}
+
+auto Cache::rehash(const std::size_t capacity) -> void {
+  std::vector<std::uint32_t> result(capacity, 0);
+  const auto mask{capacity - 1};
+  for (const auto index : this->slots) {
+    if (index == 0) {
+      continue;
+    }
+
+    auto slot{this->entries[index - 1].hash & mask};
+    while (result[slot] != 0) {
+      slot = (slot + 1) & mask;
+    }
+
+    result[slot] = index;
+  }
+
+  this->slots = std::move(result);
+}
+
+auto Cache::enqueue(const std::uint32_t entry) -> void {
+  const Order element{this->entries[entry].offset, entry,
+                      this->entries[entry].generation};
+  // Offsets tend to be recorded in increasing order
+  if (this->order.empty() || this->order.back().offset <= element.offset) {
+    this->order.push_back(element);
+  } else {
+    const auto position{std::upper_bound(
+        this->order.cbegin(), this->order.cend(), element.offset,
+        [](const auto offset, const auto &other) {
+          return offset < other.offset;
+        })};
+    this->order.insert(position, element);
+  }
+
+  // Don't let outdated references pile up if the same
+  // strings keep being bumped without ever being evicted
+  if (this->stale > this->size) {
+    std::erase_if(this->order, [this](const auto &other) {
+      return other.generation != this->entries[other.entry].generation;
+    });
+
+    this->stale = 0;
+  }
+}
+
+auto Cache::allocate(const std::string_view value) -> std::string_view {
+  const auto available{
+      this->current_chunk.has_value()
+          ? this->chunks[this->current_chunk.value()].capacity -
+                this->chunks[this->current_chunk.value()].size
+          : 0};
+  if (available < value.size()) {
+    // A few long-lived strings may pin down chunks whose other strings were
+    // all evicted, so move them out of the way before growing any further
+    if (this->arena_byte_size > 2 * this->byte_size + 2 * MAXIMUM_CHUNK_SIZE) {
+      this->compact();
+    }
+
+    this->add_chunk(value.size());
+  }
+
+  auto &chunk{this->chunks[this->current_chunk.value()]};
+  char *destination{chunk.data.get() + chunk.size};
+  std::memcpy(destination, value.data(), value.size());
+  chunk.size += value.size();
+  chunk.references += 1;
+  return {destination, value.size()};
+}
+
+auto Cache::add_chunk(const std::size_t minimum) -> void {
+  const auto capacity{std::max(
+      minimum, this->current_chunk.has_value()
+                   ? std::min(MAXIMUM_CHUNK_SIZE,
+                              this->chunks[this->current_chunk.value()]
+                                      .capacity *
+                                  2)
+                   : MINIMUM_CHUNK_SIZE)};
+
+  // The chunk being replaced is only kept while it holds strings
+  if (this->current_chunk.has_value()) {
+    const auto previous{this->current_chunk.value()};
+    this->current_chunk.reset();
+    if (this->chunks[previous].references == 0) {
+      this->free_chunk(previous);
+    }
+  }
+
+  Chunk chunk{};
+  if (!this->spare_chunks.empty() &&
+      this->spare_chunks.back().capacity >= minimum) {
+    chunk = std::move(this->spare_chunks.back());
+    this->spare_chunks.pop_back();
+  } else {
+    // Deliberately leave the contents uninitialised
+    chunk = {std::unique_ptr<char[]>{new char[capacity]}, capacity, 0, 0};
+  }
+
+  this->arena_byte_size += chunk.capacity;
+  if (this->free_chunks.empty()) {
+    this->current_chunk = this->chunks.size();
+    this->chunks.push_back(std::move(chunk));
+  } else {
+    this->current_chunk = this->free_chunks.back();
+    this->free_chunks.pop_back();
+    this->chunks[this->current_chunk.value()] = std::move(chunk);
+  }
+}
+
+auto Cache::free_chunk(const std::size_t chunk) -> void {
+  auto &element{this->chunks[chunk]};
+  assert(element.references == 0);
+  assert(element.data != nullptr);
+  this->arena_byte_size -= element.capacity;
+  element = {};
+  this->free_chunks.push_back(chunk);
+}
+
+// Copy the strings that remain next to each other into a single chunk
+auto Cache::compact() -> void {
+  auto previous{std::move(this->chunks)};
+  this->chunks.clear();
+  this->free_chunks.clear();
+  this->current_chunk.reset();
+  this->arena_byte_size = 0;
+  this->add_chunk(std::max<std::size_t>(this->byte_size, 1));
+  auto &chunk{this->chunks[this->current_chunk.value()]};
+  for (auto &entry : this->entries) {
+    // Entries that were removed do not point to any string
+    if (entry.value.data() == nullptr) {
+      continue;
+    }
+
+    char *destination{chunk.data.get() + chunk.size};
+    std::memcpy(destination, entry.value.data(), entry.value.size());
+    chunk.size += entry.value.size();
+    chunk.references += 1;
+    entry.value = {destination, entry.value.size()};
+    entry.chunk = this->current_chunk.value();
+  }
+}
+
+auto Cache::release(const std::uint64_t chunk) -> void {
+  auto &element{this->chunks[chunk]};
+  assert(element.references > 0);
+  element.references -= 1;
+  // The current chunk is kept around for the next strings
+  if (element.references == 0 && chunk != this->current_chunk) {
+    this->free_chunk(chunk);
+  }
 }
 
 } // namespace sourcemeta::jsonbinpack
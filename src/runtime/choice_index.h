@@ -0,0 +1,82 @@
+#ifndef SOURCEMETA_JSONBINPACK_RUNTIME_CHOICE_INDEX_H_
+#define SOURCEMETA_JSONBINPACK_RUNTIME_CHOICE_INDEX_H_
+
+#include <sourcemeta/jsonbinpack/runtime_encoding.h>
+
+#include <sourcemeta/core/json.h>
+
+#include <algorithm>   // std::ranges::find
+#include <cassert>     // assert
+#include <cstdint>     // std::uint64_t
+#include <functional>  // std::hash
+#include <iterator>    // std::distance
+#include <string_view> // std::string_view
+#include <vector>      // std::vector
+
+namespace sourcemeta::jsonbinpack {
+
+// The fast JSON hash of a string only depends on its length, which would
+// collide for every choice of enumerations such as country or currency codes
+inline auto choice_hash(const sourcemeta::core::JSON &value) -> std::uint64_t {
+  if (value.is_string()) {
+    const auto &string{value.to_string()};
+    return std::hash<std::string_view>{}({string.data(), string.size()});
+  }
+
+  return value.fast_hash();
+}
+
+inline auto
+make_choice_index(const std::vector<sourcemeta::core::JSON> &choices)
+    -> ChoiceIndex {
+  ChoiceIndex result;
+  result.reserve(choices.size());
+  for (std::uint64_t position = 0; position < choices.size(); position++) {
+    const auto &choice{choices[position]};
+    const auto hash{choice_hash(choice)};
+    // Only index the first occurrence of duplicated choices,
+    // so that the encoder picks the same position as a scan
+    const auto [begin, end]{result.equal_range(hash)};
+    bool duplicated{false};
+    for (auto iterator = begin; iterator != end; ++iterator) {
+      if (choices[iterator->second] == choice) {
+        duplicated = true;
+        break;
+      }
+    }
+
+    if (!duplicated) {
+      result.emplace(hash, position);
+    }
+  }
+
+  return result;
+}
+
+// Find the position of the first choice that equals the given value
+inline auto find_choice(const std::vector<sourcemeta::core::JSON> &choices,
+                        const ChoiceIndex &index,
+                        const sourcemeta::core::JSON &value) -> std::uint64_t {
+  if (index.empty()) {
+    const auto iterator{std::ranges::find(choices, value)};
+    assert(iterator != choices.cend());
+    return static_cast<std::uint64_t>(
+        std::distance(choices.cbegin(), iterator));
+  }
+
+  const auto [begin, end]{index.equal_range(choice_hash(value))};
+  for (auto iterator = begin; iterator != end; ++iterator) {
+    assert(iterator->second < choices.size());
+    if (choices[iterator->second] == value) {
+      return iterator->second;
+    }
+  }
+
+  // The value must be one of the choices
+  assert(false);
+  return choices.size();
+}
+
+} // namespace sourcemeta::jsonbinpack
+
+#endif
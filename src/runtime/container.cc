@@ -0,0 +1,454 @@
+#include <sourcemeta/jsonbinpack/runtime_batch.h>
+#include <sourcemeta/jsonbinpack/runtime_container.h>
+#include <sourcemeta/jsonbinpack/runtime_decoder.h>
+#include <sourcemeta/jsonbinpack/runtime_input_stream.h>
+
+#include "digest.h"
+#include "varint.h"
+
+#include <array>   // std::array
+#include <cassert> // assert
+#include <cstddef> // std::byte, std::size_t
+#include <cstdint> // std::uint8_t, std::uint32_t, std::uint64_t
+#include <sstream> // std::ostringstream
+#include <variant> // std::get
+#include <vector>  // std::vector
+
+namespace {
+
+// The header is the magic bytes, the version, and the encoding fingerprint.
+// The footer is the position of the index, the number of frames, and the
+// magic bytes again, so that a container can be recognised from either end
+constexpr std::array<std::uint8_t, 4> MAGIC{{'J', 'B', 'P', 'K'}};
+constexpr std::uint8_t VERSION{1};
+constexpr std::uint64_t HEADER_SIZE{MAGIC.size() + 1 + 8};
+constexpr std::uint64_t FOOTER_SIZE{8 + 8 + MAGIC.size()};
+constexpr std::uint64_t INDEX_ENTRY_SIZE{8};
+
+// Digest the encodings and options involved, in order
+class EncodingDigest : public sourcemeta::jsonbinpack::internal::Digest {
+public:
+  auto json(const sourcemeta::core::JSON &value) -> void {
+    std::ostringstream stream;
+    sourcemeta::core::stringify(value, stream);
+    this->string(stream.str());
+  }
+
+  auto choices(const std::vector<sourcemeta::core::JSON> &values) -> void {
+    this->integer(values.size());
+    for (const auto &value : values) {
+      this->json(value);
+    }
+  }
+
+  auto encoding(const sourcemeta::jsonbinpack::Encoding &encoding) -> void {
+    using namespace sourcemeta::jsonbinpack;
+    this->byte(static_cast<std::uint8_t>(encoding.index()));
+    switch (encoding.index()) {
+      case 0: {
+        const auto &options{
+            std::get<BOUNDED_MULTIPLE_8BITS_ENUM_FIXED>(encoding)};
+        this->integer(static_cast<std::uint64_t>(options.minimum));
+        this->integer(static_cast<std::uint64_t>(options.maximum));
+        this->integer(options.multiplier);
+        break;
+      }
+
+      case 1: {
+        const auto &options{std::get<FLOOR_MULTIPLE_ENUM_VARINT>(encoding)};
+        this->integer(static_cast<std::uint64_t>(options.minimum));
+        this->integer(options.multiplier);
+        break;
+      }
+
+      case 2: {
+        const auto &options{
+            std::get<ROOF_MULTIPLE_MIRROR_ENUM_VARINT>(encoding)};
+        this->integer(static_cast<std::uint64_t>(options.maximum));
+        this->integer(options.multiplier);
+        break;
+      }
+
+      case 3:
+        this->integer(
+            std::get<ARBITRARY_MULTIPLE_ZIGZAG_VARINT>(encoding).multiplier);
+        break;
+
+      case 5:
+        this->choices(std::get<BYTE_CHOICE_INDEX>(encoding).choices);
+        break;
+
+      case 6:
+        this->choices(std::get<LARGE_CHOICE_INDEX>(encoding).choices);
+        break;
+
+      case 7:
+        this->choices(std::get<TOP_LEVEL_BYTE_CHOICE_INDEX>(encoding).choices);
+        break;
+
+      case 8:
+        this->json(std::get<CONST_NONE>(encoding).value);
+        break;
+
+      case 10:
+        this->integer(std::get<UTF8_STRING_NO_LENGTH>(encoding).size);
+        break;
+
+      case 11:
+        this->integer(
+            std::get<FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED>(encoding).minimum);
+        break;
+
+      case 12:
+        this->integer(
+            std::get<ROOF_VARINT_PREFIX_UTF8_STRING_SHARED>(encoding).maximum);
+        break;
+
+      case 13: {
+        const auto &options{
+            std::get<BOUNDED_8BIT_PREFIX_UTF8_STRING_SHARED>(encoding)};
+        this->integer(options.minimum);
+        this->integer(options.maximum);
+        break;
+      }
+
+      case 16: {
+        const auto &options{std::get<FIXED_TYPED_ARRAY>(encoding)};
+        this->integer(options.size);
+        this->array(options);
+        break;
+      }
+
+      case 17: {
+        const auto &options{std::get<BOUNDED_8BITS_TYPED_ARRAY>(encoding)};
+        this->integer(options.minimum);
+        this->integer(options.maximum);
+        this->array(options);
+        break;
+      }
+
+      case 18: {
+        const auto &options{std::get<FLOOR_TYPED_ARRAY>(encoding)};
+        this->integer(options.minimum);
+        this->array(options);
+        break;
+      }
+
+      case 19: {
+        const auto &options{std::get<ROOF_TYPED_ARRAY>(encoding)};
+        this->integer(options.maximum);
+        this->array(options);
+        break;
+      }
+
+      case 20: {
+        const auto &options{std::get<FIXED_TYPED_ARBITRARY_OBJECT>(encoding)};
+        this->integer(options.size);
+        this->object(options);
+        break;
+      }
+
+      case 21:
+        this->object(std::get<VARINT_TYPED_ARBITRARY_OBJECT>(encoding));
+        break;
+
+      case 22: {
+        const auto &options{
+            std::get<FLOOR_TYPED_LENGTH_PREFIX_ARRAY>(encoding)};
+        this->integer(options.minimum);
+        this->array(options);
+        this->byte(options.offsets ? 1 : 0);
+        break;
+      }
+
+      case 23: {
+        const auto &options{
+            std::get<VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT>(encoding)};
+        this->object(options);
+        this->byte(options.offsets ? 1 : 0);
+        break;
+      }
+
+      case 25: {
+        const auto &options{std::get<MIXED_BOUNDED_TYPED_OBJECT>(encoding)};
+        this->integer(options.required.size());
+        for (const auto &name : options.required) {
+          this->string(name);
+        }
+
+        this->integer(options.optional.size());
+        for (const auto &name : options.optional) {
+          this->string(name);
+        }
+
+        for (const auto &property : options.encodings) {
+          this->encoding(property);
+        }
+
+        break;
+      }
+
+      default:
+        // Every other encoding has no options
+        break;
+    }
+  }
+
+private:
+  auto array(const auto &options) -> void {
+    assert(options.encoding);
+    this->encoding(*(options.encoding));
+    this->integer(options.prefix_encodings.size());
+    for (const auto &prefix : options.prefix_encodings) {
+      this->encoding(prefix);
+    }
+  }
+
+  auto object(const auto &options) -> void {
+    assert(options.key_encoding);
+    assert(options.encoding);
+    this->encoding(*(options.key_encoding));
+    this->encoding(*(options.encoding));
+  }
+};
+
+auto put_uint64(sourcemeta::jsonbinpack::OutputStream &stream,
+                const std::uint64_t value) -> void {
+  stream.put_dword(static_cast<std::uint32_t>(value & 0xffffffff));
+  stream.put_dword(static_cast<std::uint32_t>(value >> 32));
+}
+
+auto get_uint64(sourcemeta::jsonbinpack::InputStream &stream)
+    -> std::uint64_t {
+  const std::uint64_t low{stream.get_dword()};
+  const std::uint64_t high{stream.get_dword()};
+  return low | (high << 32);
+}
+
+// Frames encoded with a dictionary only decode with the
+// same dictionary, so the header identifies both
+auto header_fingerprint(const sourcemeta::jsonbinpack::Encoding &encoding,
+                        const sourcemeta::jsonbinpack::Dictionary *dictionary)
+    -> std::uint64_t {
+  const auto result{sourcemeta::jsonbinpack::fingerprint(encoding)};
+  if (dictionary == nullptr) {
+    return result;
+  }
+
+  sourcemeta::jsonbinpack::internal::Digest digest;
+  digest.integer(result);
+  digest.integer(dictionary->identifier());
+  return digest.value();
+}
+
+struct Layout {
+  std::uint64_t index;
+  std::uint64_t size;
+};
+
+auto parse(std::span<const std::byte> input,
+           const sourcemeta::jsonbinpack::Encoding &encoding,
+           const sourcemeta::jsonbinpack::Dictionary *dictionary) -> Layout {
+  using sourcemeta::jsonbinpack::ContainerError;
+  if (input.size() < HEADER_SIZE + FOOTER_SIZE) {
+    throw ContainerError{"The input is too small to be a container"};
+  }
+
+  sourcemeta::jsonbinpack::InputStream stream{input};
+  for (const auto byte : MAGIC) {
+    if (stream.get_byte() != byte) {
+      throw ContainerError{"The input does not start like a container"};
+    }
+  }
+
+  if (stream.get_byte() != VERSION) {
+    throw ContainerError{"The container version is not supported"};
+  }
+
+  if (get_uint64(stream) != header_fingerprint(encoding, dictionary)) {
+    throw ContainerError{
+        "The container was written with another encoding or dictionary"};
+  }
+
+  stream.seek(input.size() - FOOTER_SIZE);
+  const Layout layout{.index = get_uint64(stream), .size = get_uint64(stream)};
+  for (const auto byte : MAGIC) {
+    if (stream.get_byte() != byte) {
+      throw ContainerError{"The container is not closed"};
+    }
+  }
+
+  if (layout.index < HEADER_SIZE ||
+      layout.size > (input.size() - FOOTER_SIZE) / INDEX_ENTRY_SIZE ||
+      layout.index + layout.size * INDEX_ENTRY_SIZE !=
+          input.size() - FOOTER_SIZE) {
+    throw ContainerError{"The container index is corrupted"};
+  }
+
+  return layout;
+}
+
+auto offset(std::span<const std::byte> input, const Layout &layout,
+            const std::size_t index) -> std::uint64_t {
+  assert(index < layout.size);
+  sourcemeta::jsonbinpack::InputStream stream{input};
+  stream.seek(layout.index + index * INDEX_ENTRY_SIZE);
+  return get_uint64(stream);
+}
+
+} // namespace
+
+namespace sourcemeta::jsonbinpack {
+
+auto fingerprint(const Encoding &encoding) -> std::uint64_t {
+  EncodingDigest digest;
+  digest.encoding(encoding);
+  return digest.value();
+}
+
+ContainerWriter::ContainerWriter(std::vector<std::byte> &output,
+                                 const Encoding &encoding,
+                                 const CacheOptions &cache_options)
+    : stream_{output}, encoding_{encoding}, cache_options_{cache_options},
+      encoder_{record_, cache_options} {
+  if (output.empty()) {
+    this->header();
+    return;
+  }
+
+  // Keep the frames of the existing container, and drop its index
+  // to write it again with the new frames on close
+  const auto layout{parse(output, encoding, cache_options.dictionary)};
+  this->offsets_.reserve(layout.size);
+  for (std::size_t index = 0; index < layout.size; index++) {
+    this->offsets_.push_back(offset(output, layout, index));
+  }
+
+  output.resize(layout.index);
+  this->stream_.reset(output);
+  this->position_ = layout.index;
+}
+
+ContainerWriter::ContainerWriter(OutputStream::Stream &output,
+                                 const Encoding &encoding,
+                                 const CacheOptions &cache_options)
+    : stream_{output}, encoding_{encoding}, cache_options_{cache_options},
+      encoder_{record_, cache_options} {
+  this->header();
+}
+
+auto ContainerWriter::header() -> void {
+  for (const auto byte : MAGIC) {
+    this->stream_.put_byte(byte);
+  }
+
+  this->stream_.put_byte(VERSION);
+  put_uint64(this->stream_,
+             header_fingerprint(this->encoding_,
+                                this->cache_options_.dictionary));
+  this->position_ = HEADER_SIZE;
+}
+
+auto ContainerWriter::frame(std::span<const std::byte> bytes) -> void {
+  this->offsets_.push_back(this->position_);
+  this->stream_.put_varint(bytes.size());
+  this->stream_.put_bytes(bytes.data(), bytes.size());
+  this->position_ += internal::varint_size(bytes.size()) + bytes.size();
+}
+
+auto ContainerWriter::write(const sourcemeta::core::JSON &document) -> void {
+  assert(!this->closed_);
+  // Frames are encoded on their own, so their string
+  // references never point outside of them
+  this->record_.clear();
+  this->encoder_.reset(this->record_);
+  this->encoder_.write(document, this->encoding_);
+  this->frame(this->record_);
+}
+
+auto ContainerWriter::write(std::span<const sourcemeta::core::JSON> documents,
+                            const std::size_t parallelism) -> void {
+  assert(!this->closed_);
+  // Batch records are laid out like frames, so they
+  // only need to be indexed before copying them over
+  this->record_.clear();
+  encode_batch(documents, this->encoding_, this->record_, parallelism,
+               this->cache_options_);
+  InputStream records{std::span<const std::byte>{this->record_}};
+  while (records.has_more_data()) {
+    const auto start{records.position()};
+    const auto length{records.get_varint()};
+    this->offsets_.push_back(this->position_ + start);
+    records.seek(records.position() + length);
+  }
+
+  this->stream_.put_bytes(this->record_.data(), this->record_.size());
+  this->position_ += this->record_.size();
+}
+
+auto ContainerWriter::close() -> void {
+  assert(!this->closed_);
+  const auto index{this->position_};
+  for (const auto offset : this->offsets_) {
+    put_uint64(this->stream_, offset);
+  }
+
+  put_uint64(this->stream_, index);
+  put_uint64(this->stream_, this->offsets_.size());
+  for (const auto byte : MAGIC) {
+    this->stream_.put_byte(byte);
+  }
+
+  this->closed_ = true;
+}
+
+auto ContainerWriter::size() const -> std::size_t {
+  return this->offsets_.size();
+}
+
+ContainerReader::ContainerReader(std::span<const std::byte> input,
+                                 const Encoding &encoding,
+                                 const Dictionary *dictionary)
+    : input_{input}, encoding_{encoding}, dictionary_{dictionary} {
+  const auto layout{parse(input, encoding, dictionary)};
+  this->index_ = layout.index;
+  this->size_ = layout.size;
+}
+
+ContainerReader::ContainerReader(const sourcemeta::core::FileView &input,
+                                 const Encoding &encoding,
+                                 const Dictionary *dictionary)
+    : ContainerReader{input.size() == 0
+                          ? std::span<const std::byte>{}
+                          : std::span<const std::byte>{input.as<std::byte>(),
+                                                       input.size()},
+                      encoding, dictionary} {}
+
+auto ContainerReader::size() const -> std::size_t { return this->size_; }
+
+auto ContainerReader::frame(const std::size_t index) const
+    -> std::span<const std::byte> {
+  assert(index < this->size_);
+  // Frames must end before the index starts
+  InputStream stream{this->input_.first(this->index_)};
+  stream.seek(
+      offset(this->input_, {.index = this->index_, .size = this->size_},
+             index));
+  const auto length{stream.get_varint()};
+  return stream.bytes(stream.position(), length);
+}
+
+auto ContainerReader::read(const std::size_t index) const
+    -> sourcemeta::core::JSON {
+  Decoder decoder{this->frame(index), this->dictionary_};
+  return decoder.read(this->encoding_);
+}
+
+auto ContainerReader::read_all(const std::size_t parallelism) const
+    -> std::vector<sourcemeta::core::JSON> {
+  return decode_batch(
+      this->input_.subspan(HEADER_SIZE, this->index_ - HEADER_SIZE),
+      this->encoding_, parallelism, this->dictionary_);
+}
+
+} // namespace sourcemeta::jsonbinpack
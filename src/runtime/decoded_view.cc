@@ -0,0 +1,269 @@
+#include <sourcemeta/jsonbinpack/runtime_decoded_view.h>
+
+#include <sourcemeta/core/numeric.h>
+
+#include "any_packed.h"
+#include "length_prefix.h"
+#include "presence.h"
+#include "unreachable.h"
+
+#include <cassert>  // assert
+#include <cstddef>  // std::size_t
+#include <cstdint>  // std::uint8_t, std::int64_t, std::uint64_t
+#include <memory>   // std::make_shared
+#include <optional> // std::optional, std::nullopt
+#include <utility>  // std::move
+#include <variant>  // std::get
+
+namespace sourcemeta::jsonbinpack {
+
+DecodedView::DecodedView(std::span<const std::byte> input,
+                         const Encoding &encoding,
+                         const Dictionary *dictionary)
+    : decoder_{std::make_shared<Decoder>(input, dictionary)}, offset_{0},
+      encoding_{&encoding} {}
+
+DecodedView::DecodedView(std::shared_ptr<Decoder> decoder,
+                         const std::uint64_t offset, const Encoding &encoding)
+    : decoder_{std::move(decoder)}, offset_{offset}, encoding_{&encoding} {}
+
+auto DecodedView::at(const std::size_t index) const -> DecodedView {
+  const auto container{this->open()};
+  assert(container.key_encoding == nullptr);
+  assert(index < container.size);
+  if (container.offsets) {
+    const auto &encoding{index < container.prefix_encodings->size()
+                             ? (*container.prefix_encodings)[index]
+                             : *(container.encoding)};
+    return {this->decoder_, this->locate(container, index), encoding};
+  }
+
+  if (container.prefix_encodings == nullptr) {
+    this->decoder_->skip_items(index, *(container.encoding), {});
+    return {this->decoder_, this->decoder_->position(), *(container.encoding)};
+  }
+
+  this->decoder_->skip_items(index, *(container.encoding),
+                             *(container.prefix_encodings));
+  return {this->decoder_, this->decoder_->position(),
+          index < container.prefix_encodings->size()
+              ? (*container.prefix_encodings)[index]
+              : *(container.encoding)};
+}
+
+auto DecodedView::at(const sourcemeta::core::JSON::String &key) const
+    -> DecodedView {
+  auto result{this->try_at(key)};
+  assert(result.has_value());
+  return std::move(result).value();
+}
+
+auto DecodedView::try_at(const sourcemeta::core::JSON::String &key) const
+    -> std::optional<DecodedView> {
+  // Objects of known properties do not encode their keys, so we look for the
+  // key among the property names and skip over the values that precede it
+  if (this->encoding_->index() == 25) {
+    const auto &options{
+        std::get<MIXED_BOUNDED_TYPED_OBJECT>(*(this->encoding_))};
+    const auto required{options.required.size()};
+    std::size_t target{0};
+    while (target < required && options.required[target] != key) {
+      target++;
+    }
+
+    if (target == required) {
+      while (target < required + options.optional.size() &&
+             options.optional[target - required] != key) {
+        target++;
+      }
+
+      if (target == required + options.optional.size()) {
+        return std::nullopt;
+      }
+    }
+
+    this->decoder_->seek(this->offset_);
+    internal::Presence presence{options.optional.size()};
+    for (auto &byte : presence.bytes()) {
+      byte = this->decoder_->get_byte();
+    }
+
+    if (target >= required && !presence.test(target - required)) {
+      return std::nullopt;
+    }
+
+    for (std::size_t index = 0; index < target; index++) {
+      if (index < required || presence.test(index - required)) {
+        this->decoder_->skip(options.encodings[index]);
+      }
+    }
+
+    return DecodedView{this->decoder_, this->decoder_->position(),
+                       options.encodings[target]};
+  }
+
+  const auto container{this->open()};
+  assert(container.key_encoding != nullptr);
+  for (std::uint64_t index = 0; index < container.size; index++) {
+    // Jump from key to key rather than skipping over every value
+    if (container.offsets) {
+      this->decoder_->seek(this->locate(container, index));
+    }
+
+    const auto name{this->decoder_->read(*(container.key_encoding))};
+    assert(name.is_string());
+    if (name.to_string() == key) {
+      return DecodedView{this->decoder_, this->decoder_->position(),
+                         *(container.encoding)};
+    }
+
+    if (!container.offsets) {
+      this->decoder_->skip(*(container.encoding));
+    }
+  }
+
+  return std::nullopt;
+}
+
+auto DecodedView::size() const -> std::size_t {
+  if (this->encoding_->index() == 25) {
+    const auto &options{
+        std::get<MIXED_BOUNDED_TYPED_OBJECT>(*(this->encoding_))};
+    this->decoder_->seek(this->offset_);
+    internal::Presence presence{options.optional.size()};
+    for (auto &byte : presence.bytes()) {
+      byte = this->decoder_->get_byte();
+    }
+
+    return options.required.size() + presence.count();
+  }
+
+  return static_cast<std::size_t>(this->open().size);
+}
+
+auto DecodedView::to_json() const -> sourcemeta::core::JSON {
+  this->decoder_->seek(this->offset_);
+  return this->decoder_->read(*(this->encoding_));
+}
+
+auto DecodedView::to_integer() const -> std::int64_t {
+  return this->to_json().to_integer();
+}
+
+auto DecodedView::to_real() const -> double {
+  return this->to_json().to_real();
+}
+
+auto DecodedView::to_boolean() const -> bool {
+  return this->to_json().to_boolean();
+}
+
+auto DecodedView::to_string() const -> sourcemeta::core::JSON::String {
+  return this->to_json().to_string();
+}
+
+auto DecodedView::open() const -> Container {
+  this->decoder_->seek(this->offset_);
+  const auto &encoding{*(this->encoding_)};
+  switch (encoding.index()) {
+    case 9: {
+      using namespace internal::ANY_PACKED_TYPE_TAG_BYTE_PREFIX;
+      const std::uint8_t byte{this->decoder_->get_byte()};
+      const std::uint8_t type{
+          static_cast<std::uint8_t>(byte & (0xff >> subtype_size))};
+      const std::uint8_t subtype{static_cast<std::uint8_t>(byte >> type_size)};
+      assert(type == TYPE_ARRAY || type == TYPE_OBJECT);
+      const std::uint64_t size{
+          subtype == 0
+              ? this->decoder_->get_varint() + sourcemeta::core::uint_max<5>
+              : static_cast<std::uint64_t>(subtype - 1)};
+      return {size, type == TYPE_OBJECT ? &key_encoding() : nullptr,
+              &value_encoding(), nullptr};
+    }
+
+    case 16: {
+      const auto &options{std::get<FIXED_TYPED_ARRAY>(encoding)};
+      return {options.size, nullptr, options.encoding.get(),
+              &options.prefix_encodings};
+    }
+
+    case 17: {
+      const auto &options{std::get<BOUNDED_8BITS_TYPED_ARRAY>(encoding)};
+      return {this->decoder_->get_byte() + options.minimum, nullptr,
+              options.encoding.get(), &options.prefix_encodings};
+    }
+
+    case 18: {
+      const auto &options{std::get<FLOOR_TYPED_ARRAY>(encoding)};
+      return {this->decoder_->get_varint() + options.minimum, nullptr,
+              options.encoding.get(), &options.prefix_encodings};
+    }
+
+    case 19: {
+      const auto &options{std::get<ROOF_TYPED_ARRAY>(encoding)};
+      return {options.maximum - this->decoder_->get_varint(), nullptr,
+              options.encoding.get(), &options.prefix_encodings};
+    }
+
+    case 20: {
+      const auto &options{std::get<FIXED_TYPED_ARBITRARY_OBJECT>(encoding)};
+      return {options.size, options.key_encoding.get(),
+              options.encoding.get(), nullptr};
+    }
+
+    case 21: {
+      const auto &options{std::get<VARINT_TYPED_ARBITRARY_OBJECT>(encoding)};
+      return {this->decoder_->get_varint(), options.key_encoding.get(),
+              options.encoding.get(), nullptr};
+    }
+
+    case 22: {
+      const auto &options{std::get<FLOOR_TYPED_LENGTH_PREFIX_ARRAY>(encoding)};
+      const std::uint64_t size{this->decoder_->get_varint() + options.minimum};
+      const std::uint64_t length{this->decoder_->get_dword()};
+      return {size,
+              nullptr,
+              options.encoding.get(),
+              &options.prefix_encodings,
+              options.offsets,
+              this->decoder_->position(),
+              length};
+    }
+
+    case 23: {
+      const auto &options{
+          std::get<VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT>(encoding)};
+      const std::uint64_t size{this->decoder_->get_varint()};
+      const std::uint64_t length{this->decoder_->get_dword()};
+      return {size,
+              options.key_encoding.get(),
+              options.encoding.get(),
+              nullptr,
+              options.offsets,
+              this->decoder_->position(),
+              length};
+    }
+
+    default:
+      // Only arrays and objects can be walked into
+      unreachable();
+  }
+}
+
+auto DecodedView::locate(const Container &container,
+                         const std::uint64_t index) const -> std::uint64_t {
+  assert(container.offsets);
+  assert(index < container.size);
+  const auto width{internal::offset_width(container.length)};
+  this->decoder_->seek(container.items + container.length + index * width);
+  switch (width) {
+    case 1:
+      return container.items + this->decoder_->get_byte();
+    case 2:
+      return container.items + this->decoder_->get_word();
+    default:
+      return container.items + this->decoder_->get_dword();
+  }
+}
+
+} // namespace sourcemeta::jsonbinpack
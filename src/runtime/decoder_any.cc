@@ -2,11 +2,11 @@
 
 #include <sourcemeta/core/numeric.h>
 
+#include "any_packed.h"
 #include "unreachable.h"
 
 #include <cassert> // assert
 #include <cstdint> // std::uint8_t, std::uint16_t, std::uint64_t
-#include <memory>  // std::make_shared
 
 namespace sourcemeta::jsonbinpack {
 
@@ -103,11 +103,7 @@ auto Decoder::ANY_PACKED_TYPE_TAG_BYTE_PREFIX(
                                           sourcemeta::core::uint_max<5>) *
                                           2
                                 : subtype - 1;
-        const std::uint64_t position{this->position()};
-        const std::uint64_t current{this->rewind(this->get_varint(), position)};
-        const sourcemeta::core::JSON value{this->get_string_utf8(length)};
-        this->seek(current);
-        return value;
+        return this->read_string_reference(length);
       };
       case TYPE_STRING:
         return subtype == 0
@@ -115,44 +111,22 @@ auto Decoder::ANY_PACKED_TYPE_TAG_BYTE_PREFIX(
                          {static_cast<std::uint64_t>(
                               sourcemeta::core::uint_max<5>) *
                           2})
-                   : sourcemeta::core::JSON{this->get_string_utf8(subtype - 1)};
+                   : this->read_string(subtype - 1);
       case TYPE_LONG_STRING:
         return sourcemeta::core::JSON{
             this->get_string_utf8(subtype + sourcemeta::core::uint_max<5>)};
       case TYPE_ARRAY:
-        return subtype == 0
-                   ? this->FIXED_TYPED_ARRAY(
-                         {.size = this->get_varint() +
-                                  sourcemeta::core::uint_max<5>,
-                          .encoding = std::make_shared<Encoding>(
-                              sourcemeta::jsonbinpack::
-                                  ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}),
-                          .prefix_encodings = {}})
-                   : this->FIXED_TYPED_ARRAY(
-                         {.size = static_cast<std::uint64_t>(subtype - 1),
-                          .encoding = std::make_shared<Encoding>(
-                              sourcemeta::jsonbinpack::
-                                  ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}),
-                          .prefix_encodings = {}});
+        return this->read_items(
+            subtype == 0
+                ? this->get_varint() + sourcemeta::core::uint_max<5>
+                : static_cast<std::uint64_t>(subtype - 1),
+            value_encoding(), {});
       case TYPE_OBJECT:
-        return subtype == 0
-                   ? this->FIXED_TYPED_ARBITRARY_OBJECT(
-                         {.size = this->get_varint() +
-                                  sourcemeta::core::uint_max<5>,
-                          .key_encoding = std::make_shared<Encoding>(
-                              sourcemeta::jsonbinpack::
-                                  PREFIX_VARINT_LENGTH_STRING_SHARED{}),
-                          .encoding = std::make_shared<Encoding>(
-                              sourcemeta::jsonbinpack::
-                                  ANY_PACKED_TYPE_TAG_BYTE_PREFIX{})})
-                   : this->FIXED_TYPED_ARBITRARY_OBJECT(
-                         {.size = static_cast<std::uint64_t>(subtype - 1),
-                          .key_encoding = std::make_shared<Encoding>(
-                              sourcemeta::jsonbinpack::
-                                  PREFIX_VARINT_LENGTH_STRING_SHARED{}),
-                          .encoding = std::make_shared<Encoding>(
-                              sourcemeta::jsonbinpack::
-                                  ANY_PACKED_TYPE_TAG_BYTE_PREFIX{})});
+        return this->read_entries(
+            subtype == 0
+                ? this->get_varint() + sourcemeta::core::uint_max<5>
+                : static_cast<std::uint64_t>(subtype - 1),
+            key_encoding(), value_encoding());
       default:
         unreachable();
     }
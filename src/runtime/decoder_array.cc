@@ -2,25 +2,19 @@
 
 #include <sourcemeta/core/numeric.h>
 
+#include "length_prefix.h"
+
 #include <cassert> // assert
 #include <cstdint> // std::uint8_t, std::uint64_t
-#include <utility> // std::move
+#include <vector>  // std::vector
 
 namespace sourcemeta::jsonbinpack {
 
 auto Decoder::FIXED_TYPED_ARRAY(const struct FIXED_TYPED_ARRAY &options)
     -> sourcemeta::core::JSON {
-  const auto prefix_encodings{options.prefix_encodings.size()};
-  sourcemeta::core::JSON result = sourcemeta::core::JSON::make_array();
-  for (std::size_t index = 0; index < options.size; index++) {
-    const Encoding &encoding{prefix_encodings > index
-                                 ? options.prefix_encodings[index]
-                                 : *(options.encoding)};
-    result.push_back(this->read(encoding));
-  }
-
-  assert(result.size() == options.size);
-  return result;
+  assert(options.encoding);
+  return this->read_items(options.size, *(options.encoding),
+                          options.prefix_encodings);
 };
 
 auto Decoder::BOUNDED_8BITS_TYPED_ARRAY(
@@ -30,10 +24,8 @@ auto Decoder::BOUNDED_8BITS_TYPED_ARRAY(
   const std::uint8_t byte{this->get_byte()};
   const std::uint64_t size{byte + options.minimum};
   assert(sourcemeta::core::is_within(size, options.minimum, options.maximum));
-  return this->FIXED_TYPED_ARRAY(
-      {.size = size,
-       .encoding = options.encoding,
-       .prefix_encodings = options.prefix_encodings});
+  assert(options.encoding);
+  return this->read_items(size, *(options.encoding), options.prefix_encodings);
 };
 
 auto Decoder::FLOOR_TYPED_ARRAY(const struct FLOOR_TYPED_ARRAY &options)
@@ -42,10 +34,8 @@ auto Decoder::FLOOR_TYPED_ARRAY(const struct FLOOR_TYPED_ARRAY &options)
   const std::uint64_t size{value + options.minimum};
   assert(size >= value);
   assert(size >= options.minimum);
-  return this->FIXED_TYPED_ARRAY(
-      {.size = size,
-       .encoding = options.encoding,
-       .prefix_encodings = options.prefix_encodings});
+  assert(options.encoding);
+  return this->read_items(size, *(options.encoding), options.prefix_encodings);
 };
 
 auto Decoder::ROOF_TYPED_ARRAY(const struct ROOF_TYPED_ARRAY &options)
@@ -53,10 +43,39 @@ auto Decoder::ROOF_TYPED_ARRAY(const struct ROOF_TYPED_ARRAY &options)
   const std::uint64_t value{this->get_varint()};
   const std::uint64_t size{options.maximum - value};
   assert(size <= options.maximum);
-  return this->FIXED_TYPED_ARRAY(
-      {.size = size,
-       .encoding = options.encoding,
-       .prefix_encodings = options.prefix_encodings});
+  assert(options.encoding);
+  return this->read_items(size, *(options.encoding), options.prefix_encodings);
 };
 
+auto Decoder::FLOOR_TYPED_LENGTH_PREFIX_ARRAY(
+    const struct FLOOR_TYPED_LENGTH_PREFIX_ARRAY &options)
+    -> sourcemeta::core::JSON {
+  const std::uint64_t value{this->get_varint()};
+  const std::uint64_t size{value + options.minimum};
+  assert(size >= value);
+  assert(size >= options.minimum);
+  const std::uint64_t length{this->get_dword()};
+  assert(options.encoding);
+  auto result{
+      this->read_items(size, *(options.encoding), options.prefix_encodings)};
+  if (options.offsets) {
+    this->skip_bytes(size * internal::offset_width(length));
+  }
+
+  return result;
+};
+
+auto Decoder::read_items(const std::uint64_t size, const Encoding &encoding,
+                         const std::vector<Encoding> &prefix_encodings)
+    -> sourcemeta::core::JSON {
+  sourcemeta::core::JSON result = sourcemeta::core::JSON::make_array();
+  for (std::uint64_t index = 0; index < size; index++) {
+    result.push_back(this->read(
+        index < prefix_encodings.size() ? prefix_encodings[index] : encoding));
+  }
+
+  assert(result.size() == size);
+  return result;
+}
+
 } // namespace sourcemeta::jsonbinpack
@@ -0,0 +1,124 @@
+#include <sourcemeta/jsonbinpack/runtime_decoder_cache.h>
+
+#include <algorithm>  // std::max, std::fill
+#include <cassert>    // assert
+#include <functional> // std::less, std::less_equal
+#include <utility>    // std::move
+
+namespace sourcemeta::jsonbinpack {
+
+// The same default budget as the encoder side, plus a limit
+// on the entries as many of them might share the same bytes.
+// Past them, the decoder falls back to seeking instead
+static constexpr std::size_t MAXIMUM_BYTE_SIZE{20971520};
+static constexpr std::size_t MAXIMUM_ENTRIES{1048576};
+
+// Must be a power of two
+static constexpr std::size_t MINIMUM_CAPACITY{64};
+
+// Offsets are close to each other, so spread them
+// across the table using Fibonacci hashing
+static auto hash_offset(const std::uint64_t offset) -> std::size_t {
+  return static_cast<std::size_t>((offset * 0x9E3779B97F4A7C15) >> 32);
+}
+
+auto DecoderCache::record(const std::uint64_t offset,
+                          const std::string_view value, const Type type)
+    -> std::string_view {
+  if (!this->slots.empty()) {
+    const auto slot{this->lookup(offset, type)};
+    if (this->slots[slot] != 0) {
+      const auto &entry{this->entries[this->slots[slot] - 1]};
+      return {this->arena.data() + entry.begin, entry.size};
+    }
+  }
+
+  const auto *const arena_begin{this->arena.data()};
+  const auto *const arena_end{arena_begin + this->arena.size()};
+  const bool is_owned{!this->arena.empty() &&
+                      std::less_equal<>{}(arena_begin, value.data()) &&
+                      std::less<>{}(value.data(), arena_end)};
+  if (this->entries.size() >= MAXIMUM_ENTRIES ||
+      (!is_owned && this->arena.size() + value.size() > MAXIMUM_BYTE_SIZE)) {
+    return value;
+  }
+
+  // Keep the load factor at or below one half
+  if ((this->entries.size() + 1) * 2 > this->slots.size()) {
+    this->rehash(std::max(MINIMUM_CAPACITY, this->slots.size() * 2));
+  }
+
+  std::size_t begin;
+  if (is_owned) {
+    begin = static_cast<std::size_t>(value.data() - arena_begin);
+  } else {
+    begin = this->arena.size();
+    this->arena.insert(this->arena.end(), value.cbegin(), value.cend());
+  }
+
+  this->slots[this->lookup(offset, type)] =
+      static_cast<std::uint32_t>(this->entries.size() + 1);
+  this->entries.push_back({offset, begin, value.size(), type});
+  return {this->arena.data() + begin, value.size()};
+}
+
+auto DecoderCache::find(const std::uint64_t offset, const Type type) const
+    -> std::optional<std::string_view> {
+  if (this->entries.empty()) {
+    return std::nullopt;
+  }
+
+  const auto slot{this->lookup(offset, type)};
+  if (this->slots[slot] == 0) {
+    return std::nullopt;
+  }
+
+  const auto &entry{this->entries[this->slots[slot] - 1]};
+  return std::string_view{this->arena.data() + entry.begin, entry.size};
+}
+
+auto DecoderCache::clear() -> void {
+  this->entries.clear();
+  std::fill(this->slots.begin(), this->slots.end(), 0);
+  this->arena.clear();
+}
+
+// Find the slot that holds the given offset, or the empty slot
+// where the offset would be inserted if its not in the table
+auto DecoderCache::lookup(const std::uint64_t offset, const Type type) const
+    -> std::size_t {
+  assert(!this->slots.empty());
+  const auto mask{this->slots.size() - 1};
+  auto slot{hash_offset(offset) & mask};
+  while (this->slots[slot] != 0) {
+    const auto &entry{this->entries[this->slots[slot] - 1]};
+    if (entry.offset == offset && entry.type == type) {
+      break;
+    }
+
+    slot = (slot + 1) & mask;
+  }
+
+  return slot;
+}
+
+auto DecoderCache::rehash(const std::size_t capacity) -> void {
+  std::vector<std::uint32_t> result(capacity, 0);
+  const auto mask{capacity - 1};
+  for (const auto index : this->slots) {
+    if (index == 0) {
+      continue;
+    }
+
+    auto slot{hash_offset(this->entries[index - 1].offset) & mask};
+    while (result[slot] != 0) {
+      slot = (slot + 1) & mask;
+    }
+
+    result[slot] = index;
+  }
+
+  this->slots = std::move(result);
+}
+
+} // namespace sourcemeta::jsonbinpack
@@ -1,13 +1,55 @@
 #include <sourcemeta/jsonbinpack/runtime_decoder.h>
+#include <sourcemeta/jsonbinpack/runtime_dictionary.h>
 
 #include "unreachable.h"
 
 #include <cassert> // assert
+#include <cstddef> // std::byte
+#include <cstdint> // std::uint64_t
+#include <span>    // std::span
 #include <variant> // std::get
 
 namespace sourcemeta::jsonbinpack {
 
-Decoder::Decoder(Stream &input) : InputStream{input} {}
+Decoder::Decoder(Stream &input, const Dictionary *dictionary)
+    : InputStream{input}, dictionary_{dictionary} {}
+
+Decoder::Decoder(std::span<const std::byte> input,
+                 const Dictionary *dictionary)
+    : InputStream{input}, dictionary_{dictionary} {}
+
+Decoder::Decoder(const sourcemeta::core::FileView &input,
+                 const Dictionary *dictionary)
+    : InputStream{input}, dictionary_{dictionary} {}
+
+auto Decoder::reset(Stream &input) -> void {
+  InputStream::reset(input);
+  this->cache_.clear();
+}
+
+auto Decoder::reset(std::span<const std::byte> input) -> void {
+  InputStream::reset(input);
+  this->cache_.clear();
+}
+
+auto Decoder::reset(const sourcemeta::core::FileView &input) -> void {
+  InputStream::reset(input);
+  this->cache_.clear();
+}
+
+auto Decoder::dictionary_entry(const std::uint64_t position,
+                               const std::uint64_t relative_offset) const
+    -> const sourcemeta::core::JSON::String & {
+  assert(relative_offset > position);
+  const std::uint64_t index{relative_offset - position - 1};
+  // Without the dictionary used to encode the input,
+  // the reference points to nowhere within it
+  if (this->dictionary_ == nullptr || index >= this->dictionary_->size()) {
+    throw sourcemeta::core::IOReadOutOfBoundsError{};
+  }
+
+  return this->dictionary_->at(index);
+}
 
 auto Decoder::read(const Encoding &encoding) -> sourcemeta::core::JSON {
   switch (encoding.index()) {
@@ -36,6 +78,10 @@ auto Decoder::read(const Encoding &encoding) -> sourcemeta::core::JSON {
     HANDLE_DECODING(19, ROOF_TYPED_ARRAY)
     HANDLE_DECODING(20, FIXED_TYPED_ARBITRARY_OBJECT)
     HANDLE_DECODING(21, VARINT_TYPED_ARBITRARY_OBJECT)
+    HANDLE_DECODING(22, FLOOR_TYPED_LENGTH_PREFIX_ARRAY)
+    HANDLE_DECODING(23, VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT)
+    HANDLE_DECODING(24, GZIP_VARINT_PREFIX_UTF8_STRING)
+    HANDLE_DECODING(25, MIXED_BOUNDED_TYPED_OBJECT)
 #undef HANDLE_DECODING
     default:
       // We should never get here. If so, it is definitely a bug
@@ -0,0 +1,480 @@
+#include <sourcemeta/jsonbinpack/runtime_decoder.h>
+
+#include <sourcemeta/core/numeric.h>
+
+#include "any_packed.h"
+#include "length_prefix.h"
+#include "presence.h"
+#include "unreachable.h"
+
+#include <cassert>     // assert
+#include <cstddef>     // std::byte, std::size_t
+#include <cstdint>     // std::uint8_t, std::int64_t, std::uint64_t
+#include <string_view> // std::string_view
+#include <variant>     // std::get
+#include <vector>      // std::vector
+
+namespace sourcemeta::jsonbinpack {
+
+// Values that the encoding holds as JSON, such as enumeration choices
+static auto emit(const sourcemeta::core::JSON &value, DecodeHandler &handler)
+    -> void {
+  using Type = sourcemeta::core::JSON::Type;
+  switch (value.type()) {
+    case Type::Null:
+      return handler.null();
+    case Type::Boolean:
+      return handler.boolean(value.to_boolean());
+    case Type::Integer:
+      return handler.integer(value.to_integer());
+    case Type::Real:
+      return handler.real(value.to_real());
+    case Type::Decimal:
+      return handler.real(value.to_decimal().to_double());
+    case Type::String:
+      return handler.string(value.to_string());
+    case Type::Array:
+      handler.start_array(value.size());
+      for (const auto &item : value.as_array()) {
+        emit(item, handler);
+      }
+
+      return handler.end_array();
+    case Type::Object:
+      handler.start_object(value.size());
+      for (const auto &entry : value.as_object()) {
+        handler.key(entry.first);
+        emit(entry.second, handler);
+      }
+
+      return handler.end_object();
+    default:
+      unreachable();
+  }
+}
+
+auto Decoder::read(const Encoding &encoding, DecodeHandler &handler) -> void {
+  switch (encoding.index()) {
+    case 0:
+    case 1:
+    case 2:
+    case 3:
+      return handler.integer(this->read(encoding).to_integer());
+    case 4:
+      // Large integral digits decode to an integer
+      return emit(this->read(encoding), handler);
+
+    case 5: {
+      const auto &options{std::get<5>(encoding)};
+      const std::uint8_t index{this->get_byte()};
+      assert(options.choices.size() > index);
+      return emit(options.choices[index], handler);
+    }
+
+    case 6: {
+      const auto &options{std::get<6>(encoding)};
+      const std::uint64_t index{this->get_varint()};
+      assert(options.choices.size() > index);
+      return emit(options.choices[index], handler);
+    }
+
+    case 7: {
+      const auto &options{std::get<7>(encoding)};
+      if (!this->has_more_data()) {
+        return emit(options.choices.front(), handler);
+      }
+
+      const std::uint64_t index{this->get_byte() + 1u};
+      assert(options.choices.size() > index);
+      return emit(options.choices[index], handler);
+    }
+
+    case 8:
+      return emit(std::get<8>(encoding).value, handler);
+    case 9:
+      return this->read_any_packed(handler);
+
+    case 10:
+    case 11:
+    case 12:
+    case 13:
+    case 14:
+    case 15:
+    case 24:
+      return handler.string(this->read_string_view(encoding));
+
+    case 16: {
+      const auto &options{std::get<16>(encoding)};
+      assert(options.encoding);
+      return this->read_items(options.size, *(options.encoding),
+                              options.prefix_encodings, handler);
+    }
+
+    case 17: {
+      const auto &options{std::get<17>(encoding)};
+      assert(options.encoding);
+      const std::uint64_t size{this->get_byte() + options.minimum};
+      return this->read_items(size, *(options.encoding),
+                              options.prefix_encodings, handler);
+    }
+
+    case 18: {
+      const auto &options{std::get<18>(encoding)};
+      assert(options.encoding);
+      const std::uint64_t size{this->get_varint() + options.minimum};
+      return this->read_items(size, *(options.encoding),
+                              options.prefix_encodings, handler);
+    }
+
+    case 19: {
+      const auto &options{std::get<19>(encoding)};
+      assert(options.encoding);
+      const std::uint64_t size{options.maximum - this->get_varint()};
+      return this->read_items(size, *(options.encoding),
+                              options.prefix_encodings, handler);
+    }
+
+    case 20: {
+      const auto &options{std::get<20>(encoding)};
+      assert(options.key_encoding);
+      assert(options.encoding);
+      return this->read_entries(options.size, *(options.key_encoding),
+                                *(options.encoding), handler);
+    }
+
+    case 21: {
+      const auto &options{std::get<21>(encoding)};
+      assert(options.key_encoding);
+      assert(options.encoding);
+      return this->read_entries(this->get_varint(), *(options.key_encoding),
+                                *(options.encoding), handler);
+    }
+
+    case 22: {
+      const auto &options{std::get<22>(encoding)};
+      assert(options.encoding);
+      const std::uint64_t size{this->get_varint() + options.minimum};
+      const std::uint64_t length{this->get_dword()};
+      this->read_items(size, *(options.encoding), options.prefix_encodings,
+                       handler);
+      if (options.offsets) {
+        this->skip_bytes(size * internal::offset_width(length));
+      }
+
+      return;
+    }
+
+    case 23: {
+      const auto &options{std::get<23>(encoding)};
+      assert(options.key_encoding);
+      assert(options.encoding);
+      const std::uint64_t size{this->get_varint()};
+      const std::uint64_t length{this->get_dword()};
+      this->read_entries(size, *(options.key_encoding), *(options.encoding),
+                         handler);
+      if (options.offsets) {
+        this->skip_bytes(size * internal::offset_width(length));
+      }
+
+      return;
+    }
+
+    case 25: {
+      const auto &options{std::get<25>(encoding)};
+      const auto required{options.required.size()};
+      internal::Presence presence{options.optional.size()};
+      for (auto &byte : presence.bytes()) {
+        byte = this->get_byte();
+      }
+
+      handler.start_object(required + presence.count());
+      for (std::size_t index = 0; index < required; index++) {
+        handler.key(options.required[index]);
+        this->read(options.encodings[index], handler);
+      }
+
+      for (std::size_t index = 0; index < options.optional.size(); index++) {
+        if (presence.test(index)) {
+          handler.key(options.optional[index]);
+          this->read(options.encodings[required + index], handler);
+        }
+      }
+
+      return handler.end_object();
+    }
+
+    default:
+      // We should never get here. If so, it is definitely a bug
+      unreachable();
+  }
+}
+
+auto Decoder::read_items(const std::uint64_t size, const Encoding &encoding,
+                         const std::vector<Encoding> &prefix_encodings,
+                         DecodeHandler &handler) -> void {
+  handler.start_array(size);
+  for (std::uint64_t index = 0; index < size; index++) {
+    this->read(
+        index < prefix_encodings.size() ? prefix_encodings[index] : encoding,
+        handler);
+  }
+
+  handler.end_array();
+}
+
+auto Decoder::read_entries(const std::uint64_t size,
+                           const Encoding &key_encoding,
+                           const Encoding &encoding, DecodeHandler &handler)
+    -> void {
+  handler.start_object(size);
+  for (std::uint64_t index = 0; index < size; index++) {
+    handler.key(this->read_string_view(key_encoding));
+    this->read(encoding, handler);
+  }
+
+  handler.end_object();
+}
+
+auto Decoder::read_any_packed(DecodeHandler &handler) -> void {
+  using namespace internal::ANY_PACKED_TYPE_TAG_BYTE_PREFIX;
+  const std::uint8_t byte{this->get_byte()};
+  const std::uint8_t type{
+      static_cast<std::uint8_t>(byte & (0xff >> subtype_size))};
+  const std::uint8_t subtype{static_cast<std::uint8_t>(byte >> type_size)};
+
+  if (type == TYPE_OTHER) {
+    switch (subtype) {
+      case SUBTYPE_NULL:
+        return handler.null();
+      case SUBTYPE_FALSE:
+        return handler.boolean(false);
+      case SUBTYPE_TRUE:
+        return handler.boolean(true);
+      case SUBTYPE_NUMBER:
+        // Large integral digits decode to an integer
+        return emit(this->DOUBLE_VARINT_TUPLE({}), handler);
+      case SUBTYPE_POSITIVE_REAL_INTEGER_BYTE:
+        return handler.real(static_cast<double>(this->get_byte()));
+      case SUBTYPE_POSITIVE_INTEGER:
+        return handler.integer(static_cast<std::int64_t>(this->get_varint()));
+      case SUBTYPE_NEGATIVE_INTEGER:
+        return handler.integer(-static_cast<std::int64_t>(this->get_varint()) -
+                               1);
+      case SUBTYPE_LONG_STRING_BASE_EXPONENT_7:
+        return handler.string(this->get_string_view(this->get_varint() + 128));
+      case SUBTYPE_LONG_STRING_BASE_EXPONENT_8:
+        return handler.string(this->get_string_view(this->get_varint() + 256));
+      case SUBTYPE_LONG_STRING_BASE_EXPONENT_9:
+        return handler.string(this->get_string_view(this->get_varint() + 512));
+      case SUBTYPE_LONG_STRING_BASE_EXPONENT_10:
+        return handler.string(
+            this->get_string_view(this->get_varint() + 1024));
+      default:
+        unreachable();
+    }
+  } else {
+    switch (type) {
+      case TYPE_POSITIVE_INTEGER_BYTE:
+        return handler.integer(subtype > 0 ? subtype - 1 : this->get_byte());
+      case TYPE_NEGATIVE_INTEGER_BYTE:
+        return handler.integer(
+            subtype > 0 ? static_cast<std::int64_t>(-subtype)
+                        : static_cast<std::int64_t>(-this->get_byte() - 1));
+      case TYPE_SHARED_STRING: {
+        const auto length = subtype == 0
+                                ? this->get_varint() - 1 +
+                                      static_cast<std::uint64_t>(
+                                          sourcemeta::core::uint_max<5>) *
+                                          2
+                                : subtype - 1;
+        return handler.string(this->read_string_reference_view(length));
+      }
+
+      case TYPE_STRING: {
+        if (subtype != 0) {
+          return handler.string(this->read_string_view(subtype - 1));
+        }
+
+        // As FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED
+        const std::uint64_t minimum{
+            static_cast<std::uint64_t>(sourcemeta::core::uint_max<5>) * 2};
+        const std::uint64_t prefix{this->get_varint()};
+        const bool is_shared{prefix == 0};
+        const std::uint64_t length{(is_shared ? this->get_varint() : prefix) +
+                                   minimum - 1};
+        return handler.string(is_shared
+                                  ? this->read_string_reference_view(length)
+                                  : this->read_string_view(length));
+      }
+
+      case TYPE_LONG_STRING:
+        return handler.string(
+            this->get_string_view(subtype + sourcemeta::core::uint_max<5>));
+      case TYPE_ARRAY:
+        return this->read_items(
+            subtype == 0
+                ? this->get_varint() + sourcemeta::core::uint_max<5>
+                : static_cast<std::uint64_t>(subtype - 1),
+            value_encoding(), {}, handler);
+      case TYPE_OBJECT:
+        return this->read_entries(
+            subtype == 0
+                ? this->get_varint() + sourcemeta::core::uint_max<5>
+                : static_cast<std::uint64_t>(subtype - 1),
+            key_encoding(), value_encoding(), handler);
+      default:
+        unreachable();
+    }
+  }
+}
+
+auto Decoder::read_string_view(const Encoding &encoding) -> std::string_view {
+  switch (encoding.index()) {
+    case 10:
+      return this->get_string_view(std::get<10>(encoding).size);
+
+    case 11: {
+      const auto &options{std::get<11>(encoding)};
+      const std::uint64_t prefix{this->get_varint()};
+      const bool is_shared{prefix == 0};
+      const std::uint64_t length{(is_shared ? this->get_varint() : prefix) +
+                                 options.minimum - 1};
+      assert(length >= options.minimum);
+      return is_shared ? this->read_string_reference_view(length)
+                       : this->read_string_view(length);
+    }
+
+    case 12: {
+      const auto &options{std::get<12>(encoding)};
+      const std::uint64_t prefix{this->get_varint()};
+      const bool is_shared{prefix == 0};
+      const std::uint64_t length{options.maximum -
+                                 (is_shared ? this->get_varint() : prefix) + 1};
+      assert(length <= options.maximum);
+      return is_shared ? this->read_string_reference_view(length)
+                       : this->read_string_view(length);
+    }
+
+    case 13: {
+      const auto &options{std::get<13>(encoding)};
+      const std::uint8_t prefix{this->get_byte()};
+      const bool is_shared{prefix == 0};
+      const std::uint64_t length{(is_shared ? this->get_byte() : prefix) +
+                                 options.minimum - 1};
+      assert(sourcemeta::core::is_within(length, options.minimum,
+                                         options.maximum));
+      return is_shared ? this->read_string_reference_view(length)
+                       : this->read_string_view(length);
+    }
+
+    case 15:
+      return this->read_prefixed_string_view();
+
+    default: {
+      // Encodings that do not hold the string as is, such as dates
+      // or enumeration choices, are decoded into the scratch buffer
+      const auto value{this->read(encoding)};
+      assert(value.is_string());
+      this->string_buffer_ = value.to_string();
+      return this->string_buffer_;
+    }
+  }
+}
+
+auto Decoder::read_string_view(const std::uint64_t length)
+    -> std::string_view {
+  const std::uint64_t offset{this->position()};
+  const auto value{this->get_string_view(length)};
+  // References into memory are resolved by looking at the input again
+  if (!this->in_memory()) {
+    this->cache_.record(offset, value, DecoderCache::Type::Standalone);
+  }
+
+  return value;
+}
+
+auto Decoder::read_string_reference_view(const std::uint64_t length)
+    -> std::string_view {
+  const std::uint64_t position{this->position()};
+  const std::uint64_t relative_offset{this->get_varint()};
+  if (relative_offset > position) {
+    const auto &entry{this->dictionary_entry(position, relative_offset)};
+    assert(entry.size() == length);
+    return entry;
+  }
+
+  const std::uint64_t offset{position - relative_offset};
+  if (this->in_memory()) {
+    const auto bytes{this->bytes(offset, length)};
+    return {reinterpret_cast<const sourcemeta::core::JSON::Char *>(
+                bytes.data()),
+            bytes.size()};
+  }
+
+  const auto cached{this->cache_.find(offset, DecoderCache::Type::Standalone)};
+  if (cached.has_value() && cached->size() == length) {
+    return cached.value();
+  }
+
+  const std::uint64_t current{this->rewind(relative_offset, position)};
+  const auto value{this->get_string_view(length)};
+  this->seek(current);
+  return value;
+}
+
+// As PREFIX_VARINT_LENGTH_STRING_SHARED, whose references may point to other
+// references, so we remember every occurrence to resolve them in one step
+auto Decoder::read_prefixed_string_view() -> std::string_view {
+  const std::uint64_t offset{this->position()};
+  const std::uint64_t prefix{this->get_varint()};
+  if (prefix == 0) {
+    const std::uint64_t position{this->position()};
+    const std::uint64_t relative_offset{this->get_varint()};
+    if (relative_offset > position) {
+      return this->cache_.record(
+          offset, this->dictionary_entry(position, relative_offset),
+          DecoderCache::Type::PrefixLengthVarintPlusOne);
+    }
+
+    const auto cached{
+        this->cache_.find(position - relative_offset,
+                          DecoderCache::Type::PrefixLengthVarintPlusOne)};
+    if (cached.has_value()) {
+      return this->cache_.record(offset, cached.value(),
+                                 DecoderCache::Type::PrefixLengthVarintPlusOne);
+    }
+
+    const std::uint64_t current{this->rewind(relative_offset, position)};
+    const auto value{this->read_prefixed_string_view()};
+    this->seek(current);
+    return this->cache_.record(offset, value,
+                               DecoderCache::Type::PrefixLengthVarintPlusOne);
+  }
+
+  const std::uint64_t string_offset{this->position()};
+  const auto value{this->get_string_view(prefix - 1)};
+  this->cache_.record(
+      string_offset,
+      this->cache_.record(offset, value,
+                          DecoderCache::Type::PrefixLengthVarintPlusOne),
+      DecoderCache::Type::Standalone);
+  return value;
+}
+
+auto Decoder::get_string_view(const std::uint64_t length) -> std::string_view {
+  if (this->in_memory()) {
+    const auto bytes{
+        this->bytes(this->position(), static_cast<std::size_t>(length))};
+    this->skip_bytes(length);
+    return {reinterpret_cast<const sourcemeta::core::JSON::Char *>(
+                bytes.data()),
+            bytes.size()};
+  }
+
+  this->string_buffer_.resize(static_cast<std::size_t>(length));
+  this->get_bytes(reinterpret_cast<std::byte *>(this->string_buffer_.data()),
+                  this->string_buffer_.size());
+  return this->string_buffer_;
+}
+
+} // namespace sourcemeta::jsonbinpack
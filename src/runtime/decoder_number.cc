@@ -15,6 +15,13 @@ auto Decoder::DOUBLE_VARINT_TUPLE(const struct DOUBLE_VARINT_TUPLE &)
 #endif
   const std::int64_t digits{this->get_varint_zigzag()};
   const std::uint64_t point{this->get_varint()};
+  // Not every integer beyond 2^53 is a double, so keep such digits exact,
+  // as they may come from an integer
+  constexpr std::int64_t exact_limit{std::int64_t{1} << 53};
+  if (point == 0 && (digits > exact_limit || digits < -exact_limit)) {
+    return sourcemeta::core::JSON{digits};
+  }
+
   double divisor{1.0};
   for (std::uint64_t i = 0; i < point; ++i) {
     divisor *= 10.0;
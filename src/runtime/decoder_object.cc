@@ -1,6 +1,10 @@
 #include <sourcemeta/jsonbinpack/runtime_decoder.h>
 
+#include "length_prefix.h"
+#include "presence.h"
+
 #include <cassert> // assert
+#include <cstddef> // std::size_t
 #include <cstdint> // std::uint64_t
 
 namespace sourcemeta::jsonbinpack {
@@ -8,30 +12,76 @@ namespace sourcemeta::jsonbinpack {
 auto Decoder::FIXED_TYPED_ARBITRARY_OBJECT(
     const struct FIXED_TYPED_ARBITRARY_OBJECT &options)
     -> sourcemeta::core::JSON {
-  sourcemeta::core::JSON document = sourcemeta::core::JSON::make_object();
-  for (std::size_t index = 0; index < options.size; index++) {
-    const sourcemeta::core::JSON key = this->read(*(options.key_encoding));
-    assert(key.is_string());
-    document.assign(key.to_string(), this->read(*(options.encoding)));
-  }
-
-  assert(document.size() == options.size);
-  return document;
+  assert(options.key_encoding);
+  assert(options.encoding);
+  return this->read_entries(options.size, *(options.key_encoding),
+                            *(options.encoding));
 };
 
 auto Decoder::VARINT_TYPED_ARBITRARY_OBJECT(
     const struct VARINT_TYPED_ARBITRARY_OBJECT &options)
     -> sourcemeta::core::JSON {
   const std::uint64_t size{this->get_varint()};
+  assert(options.key_encoding);
+  assert(options.encoding);
+  return this->read_entries(size, *(options.key_encoding),
+                            *(options.encoding));
+};
+
+auto Decoder::VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT(
+    const struct VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT &options)
+    -> sourcemeta::core::JSON {
+  const std::uint64_t size{this->get_varint()};
+  const std::uint64_t length{this->get_dword()};
+  assert(options.key_encoding);
+  assert(options.encoding);
+  auto result{this->read_entries(size, *(options.key_encoding),
+                                 *(options.encoding))};
+  if (options.offsets) {
+    this->skip_bytes(size * internal::offset_width(length));
+  }
+
+  return result;
+};
+
+auto Decoder::MIXED_BOUNDED_TYPED_OBJECT(
+    const struct MIXED_BOUNDED_TYPED_OBJECT &options)
+    -> sourcemeta::core::JSON {
+  const auto required{options.required.size()};
+  assert(options.encodings.size() == required + options.optional.size());
+  internal::Presence presence{options.optional.size()};
+  for (auto &byte : presence.bytes()) {
+    byte = this->get_byte();
+  }
+
   sourcemeta::core::JSON document = sourcemeta::core::JSON::make_object();
-  for (std::size_t index = 0; index < size; index++) {
-    const sourcemeta::core::JSON key = this->read(*(options.key_encoding));
+  for (std::size_t index = 0; index < required; index++) {
+    document.assign(options.required[index],
+                    this->read(options.encodings[index]));
+  }
+
+  for (std::size_t index = 0; index < options.optional.size(); index++) {
+    if (presence.test(index)) {
+      document.assign(options.optional[index],
+                      this->read(options.encodings[required + index]));
+    }
+  }
+
+  return document;
+};
+
+auto Decoder::read_entries(const std::uint64_t size,
+                           const Encoding &key_encoding,
+                           const Encoding &encoding) -> sourcemeta::core::JSON {
+  sourcemeta::core::JSON document = sourcemeta::core::JSON::make_object();
+  for (std::uint64_t index = 0; index < size; index++) {
+    const sourcemeta::core::JSON key = this->read(key_encoding);
     assert(key.is_string());
-    document.assign(key.to_string(), this->read(*(options.encoding)));
+    document.assign(key.to_string(), this->read(encoding));
   }
 
   assert(document.size() == size);
   return document;
-};
+}
 
 } // namespace sourcemeta::jsonbinpack
@@ -0,0 +1,173 @@
+#include <sourcemeta/jsonbinpack/runtime_decoder.h>
+
+#include <sourcemeta/core/numeric.h>
+
+#include "length_prefix.h"
+#include "presence.h"
+#include "unreachable.h"
+
+#include <cassert> // assert
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint8_t, std::uint32_t, std::int64_t, std::uint64_t
+
+namespace sourcemeta::jsonbinpack {
+
+auto Decoder::read(const Plan &plan) -> sourcemeta::core::JSON {
+  assert(!plan.instructions_.empty());
+  return this->execute(plan, 0);
+}
+
+auto Decoder::execute(const Plan &plan, const std::uint32_t index)
+    -> sourcemeta::core::JSON {
+  const auto &instruction{plan.instructions_[index]};
+  // We trust the encoder that the data we are seeing
+  // corresponds to valid 64-bit signed integers.
+  switch (instruction.type) {
+    case 0: {
+      const std::uint8_t byte{this->get_byte()};
+      return sourcemeta::core::JSON{static_cast<std::int64_t>(
+          (byte * instruction.multiplier) + instruction.offset)};
+    }
+
+    case 1:
+      return sourcemeta::core::JSON{static_cast<std::int64_t>(
+          (this->get_varint() * instruction.multiplier) + instruction.offset)};
+
+    case 2:
+      return sourcemeta::core::JSON{static_cast<std::int64_t>(
+          instruction.offset - (this->get_varint() * instruction.multiplier))};
+
+    case 3:
+      return sourcemeta::core::JSON{static_cast<std::int64_t>(
+          this->get_varint_zigzag() *
+          static_cast<std::int64_t>(instruction.multiplier))};
+
+#define HANDLE_ENCODING(index, name)                                           \
+  case (index):                                                                \
+    return this->name(*static_cast<const sourcemeta::jsonbinpack::name *>(     \
+        instruction.options));
+      HANDLE_ENCODING(4, DOUBLE_VARINT_TUPLE)
+      HANDLE_ENCODING(5, BYTE_CHOICE_INDEX)
+      HANDLE_ENCODING(6, LARGE_CHOICE_INDEX)
+      HANDLE_ENCODING(7, TOP_LEVEL_BYTE_CHOICE_INDEX)
+      HANDLE_ENCODING(8, CONST_NONE)
+      HANDLE_ENCODING(9, ANY_PACKED_TYPE_TAG_BYTE_PREFIX)
+      HANDLE_ENCODING(10, UTF8_STRING_NO_LENGTH)
+      HANDLE_ENCODING(11, FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED)
+      HANDLE_ENCODING(12, ROOF_VARINT_PREFIX_UTF8_STRING_SHARED)
+      HANDLE_ENCODING(13, BOUNDED_8BIT_PREFIX_UTF8_STRING_SHARED)
+      HANDLE_ENCODING(14, RFC3339_DATE_INTEGER_TRIPLET)
+      HANDLE_ENCODING(15, PREFIX_VARINT_LENGTH_STRING_SHARED)
+      HANDLE_ENCODING(24, GZIP_VARINT_PREFIX_UTF8_STRING)
+#undef HANDLE_ENCODING
+
+    case 16:
+    case 17:
+    case 18:
+    case 19: {
+      std::uint64_t size;
+      if (instruction.type == 16) {
+        size = instruction.offset;
+      } else if (instruction.type == 17) {
+        size = this->get_byte() + instruction.offset;
+      } else if (instruction.type == 18) {
+        size = this->get_varint() + instruction.offset;
+      } else {
+        size = instruction.offset - this->get_varint();
+      }
+
+      const auto *prefixes{plan.prefixes_.data() + instruction.prefixes_begin};
+      sourcemeta::core::JSON result = sourcemeta::core::JSON::make_array();
+      for (std::uint64_t cursor = 0; cursor < size; cursor++) {
+        result.push_back(this->execute(
+            plan, cursor < instruction.prefixes_size ? prefixes[cursor]
+                                                     : instruction.child));
+      }
+
+      return result;
+    }
+
+    case 20:
+    case 21: {
+      const std::uint64_t size{instruction.type == 20 ? instruction.offset
+                                                      : this->get_varint()};
+      sourcemeta::core::JSON result = sourcemeta::core::JSON::make_object();
+      for (std::uint64_t cursor = 0; cursor < size; cursor++) {
+        const sourcemeta::core::JSON key = this->execute(plan, instruction.key);
+        assert(key.is_string());
+        result.assign(key.to_string(), this->execute(plan, instruction.child));
+      }
+
+      return result;
+    }
+
+    case 22:
+    case 23: {
+      const bool is_array{instruction.type == 22};
+      const std::uint64_t size{this->get_varint() +
+                               (is_array ? instruction.offset : 0)};
+      const std::uint64_t length{this->get_dword()};
+      sourcemeta::core::JSON result =
+          is_array ? sourcemeta::core::JSON::make_array()
+                   : sourcemeta::core::JSON::make_object();
+      if (is_array) {
+        const auto *prefixes{plan.prefixes_.data() +
+                             instruction.prefixes_begin};
+        for (std::uint64_t cursor = 0; cursor < size; cursor++) {
+          result.push_back(this->execute(
+              plan, cursor < instruction.prefixes_size ? prefixes[cursor]
+                                                       : instruction.child));
+        }
+      } else {
+        for (std::uint64_t cursor = 0; cursor < size; cursor++) {
+          const sourcemeta::core::JSON key =
+              this->execute(plan, instruction.key);
+          assert(key.is_string());
+          result.assign(key.to_string(),
+                        this->execute(plan, instruction.child));
+        }
+      }
+
+      if (instruction.offsets) {
+        this->skip_bytes(size * internal::offset_width(length));
+      }
+
+      return result;
+    }
+
+    case 25: {
+      const auto &options{*static_cast<
+          const sourcemeta::jsonbinpack::MIXED_BOUNDED_TYPED_OBJECT *>(
+          instruction.options)};
+      const auto *properties{plan.prefixes_.data() +
+                             instruction.prefixes_begin};
+      internal::Presence presence{options.optional.size()};
+      for (auto &byte : presence.bytes()) {
+        byte = this->get_byte();
+      }
+
+      sourcemeta::core::JSON result = sourcemeta::core::JSON::make_object();
+      for (std::size_t cursor = 0; cursor < instruction.offset; cursor++) {
+        result.assign(options.required[cursor],
+                      this->execute(plan, properties[cursor]));
+      }
+
+      for (std::size_t cursor = 0; cursor < options.optional.size();
+           cursor++) {
+        if (presence.test(cursor)) {
+          result.assign(
+              options.optional[cursor],
+              this->execute(plan, properties[instruction.offset + cursor]));
+        }
+      }
+
+      return result;
+    }
+
+    default:
+      // We should never get here. If so, it is definitely a bug
+      unreachable();
+  }
+}
+
+} // namespace sourcemeta::jsonbinpack
@@ -0,0 +1,374 @@
+#include <sourcemeta/jsonbinpack/runtime_decoder.h>
+
+#include <sourcemeta/core/numeric.h>
+
+#include "any_packed.h"
+#include "length_prefix.h"
+#include "presence.h"
+#include "unreachable.h"
+
+#include <algorithm> // std::min
+#include <cassert>   // assert
+#include <cstddef>   // std::size_t
+#include <cstdint>   // std::uint8_t, std::uint64_t
+#include <optional>  // std::optional, std::nullopt
+#include <variant>   // std::get
+#include <vector>    // std::vector
+
+namespace sourcemeta::jsonbinpack {
+
+// The number of bytes that any value takes with the given
+// encoding, if it does not depend on the value itself
+static auto fixed_size(const Encoding &encoding)
+    -> std::optional<std::uint64_t> {
+  switch (encoding.index()) {
+    case 0:
+    case 5:
+      return 1;
+    case 8:
+      return 0;
+    case 10:
+      return std::get<10>(encoding).size;
+    case 14:
+      return 4;
+    case 16: {
+      const auto &options{std::get<16>(encoding)};
+      assert(options.encoding);
+      const auto prefixes{std::min(
+          options.size,
+          static_cast<std::uint64_t>(options.prefix_encodings.size()))};
+      std::uint64_t result{0};
+      for (std::uint64_t index = 0; index < prefixes; index++) {
+        const auto size{fixed_size(options.prefix_encodings[index])};
+        if (!size.has_value()) {
+          return std::nullopt;
+        }
+
+        result += size.value();
+      }
+
+      if (prefixes == options.size) {
+        return result;
+      }
+
+      const auto size{fixed_size(*(options.encoding))};
+      if (!size.has_value()) {
+        return std::nullopt;
+      }
+
+      return result + size.value() * (options.size - prefixes);
+    }
+
+    // Without optional properties there is no presence bitmap
+    case 25: {
+      const auto &options{std::get<25>(encoding)};
+      if (!options.optional.empty()) {
+        return std::nullopt;
+      }
+
+      std::uint64_t result{0};
+      for (const auto &property : options.encodings) {
+        const auto size{fixed_size(property)};
+        if (!size.has_value()) {
+          return std::nullopt;
+        }
+
+        result += size.value();
+      }
+
+      return result;
+    }
+
+    default:
+      return std::nullopt;
+  }
+}
+
+auto Decoder::skip(const Encoding &encoding) -> void {
+  // Values with a known size are skipped without reading any of them
+  if (const auto size{fixed_size(encoding)}; size.has_value()) {
+    return this->skip_bytes(size.value());
+  }
+
+  switch (encoding.index()) {
+    case 1:
+    case 2:
+    case 3:
+    case 6:
+      this->get_varint();
+      return;
+    case 4:
+      this->get_varint();
+      this->get_varint();
+      return;
+    case 7:
+      if (this->has_more_data()) {
+        this->get_byte();
+      }
+
+      return;
+    case 9:
+      return this->skip_any_packed();
+
+    case 11: {
+      const std::uint64_t prefix{this->get_varint()};
+      if (prefix == 0) {
+        this->get_varint();
+        this->get_varint();
+      } else {
+        this->skip_bytes(prefix + std::get<11>(encoding).minimum - 1);
+      }
+
+      return;
+    }
+
+    case 12: {
+      const std::uint64_t prefix{this->get_varint()};
+      if (prefix == 0) {
+        this->get_varint();
+        this->get_varint();
+      } else {
+        this->skip_bytes(std::get<12>(encoding).maximum - prefix + 1);
+      }
+
+      return;
+    }
+
+    case 13: {
+      const std::uint8_t prefix{this->get_byte()};
+      if (prefix == 0) {
+        this->get_byte();
+        this->get_varint();
+      } else {
+        this->skip_bytes(prefix + std::get<13>(encoding).minimum - 1);
+      }
+
+      return;
+    }
+
+    case 15: {
+      const std::uint64_t prefix{this->get_varint()};
+      if (prefix == 0) {
+        this->get_varint();
+      } else {
+        this->skip_bytes(prefix - 1);
+      }
+
+      return;
+    }
+
+    case 16: {
+      const auto &options{std::get<16>(encoding)};
+      assert(options.encoding);
+      return this->skip_items(options.size, *(options.encoding),
+                              options.prefix_encodings);
+    }
+
+    case 17: {
+      const auto &options{std::get<17>(encoding)};
+      assert(options.encoding);
+      const std::uint64_t size{this->get_byte() + options.minimum};
+      return this->skip_items(size, *(options.encoding),
+                              options.prefix_encodings);
+    }
+
+    case 18: {
+      const auto &options{std::get<18>(encoding)};
+      assert(options.encoding);
+      const std::uint64_t size{this->get_varint() + options.minimum};
+      return this->skip_items(size, *(options.encoding),
+                              options.prefix_encodings);
+    }
+
+    case 19: {
+      const auto &options{std::get<19>(encoding)};
+      assert(options.encoding);
+      const std::uint64_t size{options.maximum - this->get_varint()};
+      return this->skip_items(size, *(options.encoding),
+                              options.prefix_encodings);
+    }
+
+    case 20: {
+      const auto &options{std::get<20>(encoding)};
+      assert(options.key_encoding);
+      assert(options.encoding);
+      return this->skip_entries(options.size, *(options.key_encoding),
+                                *(options.encoding));
+    }
+
+    case 21: {
+      const auto &options{std::get<21>(encoding)};
+      assert(options.key_encoding);
+      assert(options.encoding);
+      return this->skip_entries(this->get_varint(), *(options.key_encoding),
+                                *(options.encoding));
+    }
+
+    // The byte length of the items lets us jump over them at once
+    case 22: {
+      const auto &options{std::get<22>(encoding)};
+      const std::uint64_t size{this->get_varint() + options.minimum};
+      const std::uint64_t length{this->get_dword()};
+      return this->skip_bytes(
+          options.offsets ? length + size * internal::offset_width(length)
+                          : length);
+    }
+
+    case 23: {
+      const auto &options{std::get<23>(encoding)};
+      const std::uint64_t size{this->get_varint()};
+      const std::uint64_t length{this->get_dword()};
+      return this->skip_bytes(
+          options.offsets ? length + size * internal::offset_width(length)
+                          : length);
+    }
+
+    // Skipping a compressed string does not involve decompressing it
+    case 24:
+      this->get_varint();
+      return this->skip_bytes(this->get_varint());
+
+    case 25: {
+      const auto &options{std::get<25>(encoding)};
+      internal::Presence presence{options.optional.size()};
+      for (auto &byte : presence.bytes()) {
+        byte = this->get_byte();
+      }
+
+      const auto required{options.required.size()};
+      for (std::size_t index = 0; index < required; index++) {
+        this->skip(options.encodings[index]);
+      }
+
+      for (std::size_t index = 0; index < options.optional.size(); index++) {
+        if (presence.test(index)) {
+          this->skip(options.encodings[required + index]);
+        }
+      }
+
+      return;
+    }
+
+    default:
+      // We should never get here. If so, it is definitely a bug
+      unreachable();
+  }
+}
+
+auto Decoder::skip_items(const std::uint64_t size, const Encoding &encoding,
+                         const std::vector<Encoding> &prefix_encodings)
+    -> void {
+  std::uint64_t index{0};
+  for (; index < size && index < prefix_encodings.size(); index++) {
+    this->skip(prefix_encodings[index]);
+  }
+
+  if (index == size) {
+    return;
+  }
+
+  // The rest of the items share the same encoding, so
+  // jump over all of them at once if we know their size
+  if (const auto item_size{fixed_size(encoding)}; item_size.has_value()) {
+    return this->skip_bytes(item_size.value() * (size - index));
+  }
+
+  for (; index < size; index++) {
+    this->skip(encoding);
+  }
+}
+
+auto Decoder::skip_entries(const std::uint64_t size,
+                           const Encoding &key_encoding,
+                           const Encoding &encoding) -> void {
+  for (std::uint64_t index = 0; index < size; index++) {
+    this->skip(key_encoding);
+    this->skip(encoding);
+  }
+}
+
+auto Decoder::skip_any_packed() -> void {
+  using namespace internal::ANY_PACKED_TYPE_TAG_BYTE_PREFIX;
+  const std::uint8_t byte{this->get_byte()};
+  const std::uint8_t type{
+      static_cast<std::uint8_t>(byte & (0xff >> subtype_size))};
+  const std::uint8_t subtype{static_cast<std::uint8_t>(byte >> type_size)};
+
+  if (type == TYPE_OTHER) {
+    switch (subtype) {
+      case SUBTYPE_NULL:
+      case SUBTYPE_FALSE:
+      case SUBTYPE_TRUE:
+        return;
+      case SUBTYPE_NUMBER:
+        this->get_varint();
+        this->get_varint();
+        return;
+      case SUBTYPE_POSITIVE_REAL_INTEGER_BYTE:
+        this->get_byte();
+        return;
+      case SUBTYPE_POSITIVE_INTEGER:
+      case SUBTYPE_NEGATIVE_INTEGER:
+        this->get_varint();
+        return;
+      case SUBTYPE_LONG_STRING_BASE_EXPONENT_7:
+        return this->skip_bytes(this->get_varint() + 128);
+      case SUBTYPE_LONG_STRING_BASE_EXPONENT_8:
+        return this->skip_bytes(this->get_varint() + 256);
+      case SUBTYPE_LONG_STRING_BASE_EXPONENT_9:
+        return this->skip_bytes(this->get_varint() + 512);
+      case SUBTYPE_LONG_STRING_BASE_EXPONENT_10:
+        return this->skip_bytes(this->get_varint() + 1024);
+      default:
+        unreachable();
+    }
+  } else {
+    switch (type) {
+      case TYPE_POSITIVE_INTEGER_BYTE:
+      case TYPE_NEGATIVE_INTEGER_BYTE:
+        if (subtype == 0) {
+          this->get_byte();
+        }
+
+        return;
+      case TYPE_SHARED_STRING:
+        if (subtype == 0) {
+          this->get_varint();
+        }
+
+        this->get_varint();
+        return;
+      case TYPE_STRING:
+        if (subtype == 0) {
+          return this->skip(
+              sourcemeta::jsonbinpack::FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED{
+                  static_cast<std::uint64_t>(sourcemeta::core::uint_max<5>) *
+                  2});
+        }
+
+        return this->skip_bytes(subtype - 1);
+      case TYPE_LONG_STRING:
+        return this->skip_bytes(subtype + sourcemeta::core::uint_max<5>);
+      case TYPE_ARRAY:
+        return this->skip_items(
+            subtype == 0
+                ? this->get_varint() + sourcemeta::core::uint_max<5>
+                : static_cast<std::uint64_t>(subtype - 1),
+            value_encoding(), {});
+      case TYPE_OBJECT:
+        return this->skip_entries(
+            subtype == 0
+                ? this->get_varint() + sourcemeta::core::uint_max<5>
+                : static_cast<std::uint64_t>(subtype - 1),
+            key_encoding(), value_encoding());
+      default:
+        unreachable();
+    }
+  }
+}
+
+auto Decoder::skip_bytes(const std::uint64_t length) -> void {
+  this->seek(this->position() + length);
+}
+
+} // namespace sourcemeta::jsonbinpack
@@ -1,9 +1,15 @@
 #include <sourcemeta/jsonbinpack/runtime_decoder.h>
 
-#include <cassert> // assert
-#include <cstdint> // std::uint8_t, std::uint16_t, std::uint64_t
-#include <iomanip> // std::setw, std::setfill
-#include <sstream> // std::basic_ostringstream
+#include <sourcemeta/core/gzip.h>
+
+#include <algorithm> // std::min
+#include <cassert>   // assert
+#include <cstddef>   // std::size_t
+#include <cstdint>   // std::uint8_t, std::uint16_t, std::uint64_t
+#include <iomanip>   // std::setw, std::setfill
+#include <sstream>   // std::basic_ostringstream
+#include <string>    // std::string
+#include <utility>   // std::move
 
 namespace sourcemeta::jsonbinpack {
 
@@ -21,15 +27,8 @@ auto Decoder::FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED(
                              options.minimum - 1};
   assert(length >= options.minimum);
 
-  if (is_shared) {
-    const std::uint64_t position{this->position()};
-    const std::uint64_t current{this->rewind(this->get_varint(), position)};
-    const sourcemeta::core::JSON value{this->get_string_utf8(length)};
-    this->seek(current);
-    return value;
-  } else {
-    return UTF8_STRING_NO_LENGTH({length});
-  }
+  return is_shared ? this->read_string_reference(length)
+                   : this->read_string(length);
 }
 
 auto Decoder::ROOF_VARINT_PREFIX_UTF8_STRING_SHARED(
@@ -41,15 +40,8 @@ auto Decoder::ROOF_VARINT_PREFIX_UTF8_STRING_SHARED(
                              (is_shared ? this->get_varint() : prefix) + 1};
   assert(length <= options.maximum);
 
-  if (is_shared) {
-    const std::uint64_t position{this->position()};
-    const std::uint64_t current{this->rewind(this->get_varint(), position)};
-    const sourcemeta::core::JSON value{UTF8_STRING_NO_LENGTH({length})};
-    this->seek(current);
-    return value;
-  } else {
-    return UTF8_STRING_NO_LENGTH({length});
-  }
+  return is_shared ? this->read_string_reference(length)
+                   : this->read_string(length);
 }
 
 auto Decoder::BOUNDED_8BIT_PREFIX_UTF8_STRING_SHARED(
@@ -63,15 +55,8 @@ auto Decoder::BOUNDED_8BIT_PREFIX_UTF8_STRING_SHARED(
                              options.minimum - 1};
   assert(sourcemeta::core::is_within(length, options.minimum, options.maximum));
 
-  if (is_shared) {
-    const std::uint64_t position{this->position()};
-    const std::uint64_t current{this->rewind(this->get_varint(), position)};
-    const sourcemeta::core::JSON value{UTF8_STRING_NO_LENGTH({length})};
-    this->seek(current);
-    return value;
-  } else {
-    return UTF8_STRING_NO_LENGTH({length});
-  }
+  return is_shared ? this->read_string_reference(length)
+                   : this->read_string(length);
 }
 
 auto Decoder::RFC3339_DATE_INTEGER_TRIPLET(
@@ -102,17 +87,115 @@ auto Decoder::RFC3339_DATE_INTEGER_TRIPLET(
 auto Decoder::PREFIX_VARINT_LENGTH_STRING_SHARED(
     const struct PREFIX_VARINT_LENGTH_STRING_SHARED &options)
     -> sourcemeta::core::JSON {
+  const std::uint64_t offset{this->position()};
   const std::uint64_t prefix{this->get_varint()};
   if (prefix == 0) {
     const std::uint64_t position{this->position()};
-    const std::uint64_t current{this->rewind(this->get_varint(), position)};
+    const std::uint64_t relative_offset{this->get_varint()};
+    if (relative_offset > position) {
+      const auto &entry{this->dictionary_entry(position, relative_offset)};
+      this->cache_.record(offset, entry,
+                          DecoderCache::Type::PrefixLengthVarintPlusOne);
+      return sourcemeta::core::JSON{entry};
+    }
+
+    const auto cached{this->cache_.find(
+        position - relative_offset,
+        DecoderCache::Type::PrefixLengthVarintPlusOne)};
+    if (cached.has_value()) {
+      const sourcemeta::core::JSON value{
+          sourcemeta::core::JSON::String{cached->data(), cached->size()}};
+      // The encoder moves its reference to every new occurrence, so later
+      // references are likely to point to this one rather than the original
+      this->cache_.record(offset, cached.value(),
+                          DecoderCache::Type::PrefixLengthVarintPlusOne);
+      return value;
+    }
+
+    const std::uint64_t current{this->rewind(relative_offset, position)};
     const sourcemeta::core::JSON value{
         PREFIX_VARINT_LENGTH_STRING_SHARED(options)};
     this->seek(current);
+    this->cache_.record(offset, value.to_string(),
+                        DecoderCache::Type::PrefixLengthVarintPlusOne);
     return value;
   } else {
-    return sourcemeta::core::JSON{this->get_string_utf8(prefix - 1)};
+    const std::uint64_t string_offset{this->position()};
+    sourcemeta::core::JSON::String value{this->get_string_utf8(prefix - 1)};
+    // Also remember the standalone variant of it, sharing the same bytes
+    this->cache_.record(
+        string_offset,
+        this->cache_.record(offset, value,
+                            DecoderCache::Type::PrefixLengthVarintPlusOne),
+        DecoderCache::Type::Standalone);
+    return sourcemeta::core::JSON{std::move(value)};
   }
 }
 
+auto Decoder::read_string(const std::uint64_t length)
+    -> sourcemeta::core::JSON {
+  const std::uint64_t offset{this->position()};
+  sourcemeta::core::JSON::String value{this->get_string_utf8(length)};
+  this->cache_.record(offset, value, DecoderCache::Type::Standalone);
+  return sourcemeta::core::JSON{std::move(value)};
+}
+
+auto Decoder::read_string_reference(const std::uint64_t length)
+    -> sourcemeta::core::JSON {
+  const std::uint64_t position{this->position()};
+  const std::uint64_t relative_offset{this->get_varint()};
+  if (relative_offset > position) {
+    const auto &entry{this->dictionary_entry(position, relative_offset)};
+    assert(entry.size() == length);
+    return sourcemeta::core::JSON{entry};
+  }
+
+  const auto cached{this->cache_.find(position - relative_offset,
+                                      DecoderCache::Type::Standalone)};
+  if (cached.has_value() && cached->size() == length) {
+    return sourcemeta::core::JSON{
+        sourcemeta::core::JSON::String{cached->data(), cached->size()}};
+  }
+
+  // The string was not remembered, so read it again
+  const std::uint64_t current{this->rewind(relative_offset, position)};
+  const sourcemeta::core::JSON value{this->get_string_utf8(length)};
+  this->seek(current);
+  return value;
+}
+
+auto Decoder::GZIP_VARINT_PREFIX_UTF8_STRING(
+    const struct GZIP_VARINT_PREFIX_UTF8_STRING &) -> sourcemeta::core::JSON {
+  const std::uint64_t length{this->get_varint()};
+  const auto compressed{this->get_string_view(this->get_varint())};
+  // DEFLATE cannot expand its input by more than about 1032 times, so any
+  // longer declared length is impossible and must not drive an allocation
+  constexpr std::uint64_t maximum_ratio{1032};
+  if (length / maximum_ratio > compressed.size()) {
+    throw sourcemeta::core::IOReadOutOfBoundsError{};
+  }
+
+  // Start with a ratio typical of text instead of trusting the declared
+  // length, which still bounds the output as it grows
+  constexpr std::size_t initial_ratio{4};
+  std::string value;
+  try {
+    value = sourcemeta::core::gunzip(
+        reinterpret_cast<const std::uint8_t *>(compressed.data()),
+        compressed.size(),
+        std::min(static_cast<std::size_t>(length),
+                 compressed.size() * initial_ratio),
+        static_cast<std::size_t>(length));
+  } catch (const sourcemeta::core::GZIPError &) {
+    // A corrupt stream is a malformed payload like any other
+    throw sourcemeta::core::IOReadOutOfBoundsError{};
+  }
+
+  if (value.size() != length) {
+    throw sourcemeta::core::IOReadOutOfBoundsError{};
+  }
+
+  return sourcemeta::core::JSON{std::move(value)};
+}
+
 } // namespace sourcemeta::jsonbinpack
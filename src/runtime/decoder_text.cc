@@ -0,0 +1,166 @@
+#include <sourcemeta/jsonbinpack/runtime_decoder.h>
+
+#include <array>        // std::array
+#include <cassert>      // assert
+#include <charconv>     // std::to_chars, std::chars_format
+#include <cmath>        // std::modf
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::int64_t, std::uint64_t
+#include <string_view>  // std::string_view
+#include <system_error> // std::errc
+
+namespace {
+
+// Write values as compact JSON text in the same way as
+// `sourcemeta::core::stringify`
+class TextHandler final : public sourcemeta::jsonbinpack::DecodeHandler {
+public:
+  explicit TextHandler(sourcemeta::core::JSON::String &output)
+      : output_{output} {}
+
+  auto null() -> void override {
+    this->separate();
+    this->output_.append("null");
+  }
+
+  auto boolean(const bool value) -> void override {
+    this->separate();
+    this->output_.append(value ? "true" : "false");
+  }
+
+  auto integer(const std::int64_t value) -> void override {
+    this->separate();
+    std::array<char, 20> buffer;
+    const auto result{
+        std::to_chars(buffer.data(), buffer.data() + buffer.size(), value)};
+    assert(result.ec == std::errc{});
+    this->output_.append(buffer.data(), result.ptr);
+  }
+
+  auto real(const double value) -> void override {
+    this->separate();
+    double integral;
+    if (value == 0.0) {
+      this->output_.append("0.0");
+    } else if (std::modf(value, &integral) == 0.0) {
+      // Keep the real type of integral values through an explicit fraction
+      std::array<char, 344> buffer;
+      const auto result{std::to_chars(buffer.data(),
+                                      buffer.data() + buffer.size(), value,
+                                      std::chars_format::fixed)};
+      assert(result.ec == std::errc{});
+      this->output_.append(buffer.data(), result.ptr);
+      this->output_.append(".0");
+    } else {
+      std::array<char, 64> buffer;
+      const auto result{
+          std::to_chars(buffer.data(), buffer.data() + buffer.size(), value)};
+      assert(result.ec == std::errc{});
+      this->output_.append(buffer.data(), result.ptr);
+    }
+  }
+
+  auto string(const std::string_view value) -> void override {
+    this->separate();
+    this->quote(value);
+  }
+
+  auto start_array(const std::uint64_t) -> void override {
+    this->separate();
+    this->output_.push_back('[');
+    this->comma_ = false;
+  }
+
+  auto end_array() -> void override {
+    this->output_.push_back(']');
+    this->comma_ = true;
+  }
+
+  auto start_object(const std::uint64_t) -> void override {
+    this->separate();
+    this->output_.push_back('{');
+    this->comma_ = false;
+  }
+
+  auto key(const std::string_view value) -> void override {
+    this->separate();
+    this->quote(value);
+    this->output_.push_back(':');
+    this->comma_ = false;
+  }
+
+  auto end_object() -> void override {
+    this->output_.push_back('}');
+    this->comma_ = true;
+  }
+
+private:
+  // Delimit the value from the previous one in the same container, if any
+  auto separate() -> void {
+    if (this->comma_) {
+      this->output_.push_back(',');
+    }
+
+    this->comma_ = true;
+  }
+
+  auto quote(const std::string_view value) -> void {
+    static constexpr std::string_view digits{"0123456789ABCDEF"};
+    this->output_.push_back('"');
+    // Copy runs of characters that need no escaping at once
+    std::size_t start{0};
+    for (std::size_t index = 0; index < value.size(); index++) {
+      const auto character{static_cast<unsigned char>(value[index])};
+      if (character >= 0x20 && character != '"' && character != '\\') {
+        continue;
+      }
+
+      this->output_.append(value.data() + start, index - start);
+      start = index + 1;
+      this->output_.push_back('\\');
+      switch (character) {
+        case '"':
+        case '\\':
+          this->output_.push_back(static_cast<char>(character));
+          break;
+        case '\b':
+          this->output_.push_back('b');
+          break;
+        case '\t':
+          this->output_.push_back('t');
+          break;
+        case '\n':
+          this->output_.push_back('n');
+          break;
+        case '\f':
+          this->output_.push_back('f');
+          break;
+        case '\r':
+          this->output_.push_back('r');
+          break;
+        default:
+          this->output_.append("u00");
+          this->output_.push_back(digits[character >> 4]);
+          this->output_.push_back(digits[character & 0x0f]);
+      }
+    }
+
+    this->output_.append(value.data() + start, value.size() - start);
+    this->output_.push_back('"');
+  }
+
+  sourcemeta::core::JSON::String &output_;
+  bool comma_{false};
+};
+
+} // namespace
+
+namespace sourcemeta::jsonbinpack {
+
+auto Decoder::transcode(const Encoding &encoding,
+                        sourcemeta::core::JSON::String &output) -> void {
+  TextHandler handler{output};
+  this->read(encoding, handler);
+}
+
+} // namespace sourcemeta::jsonbinpack
@@ -0,0 +1,156 @@
+#include <sourcemeta/jsonbinpack/runtime_dictionary.h>
+
+#include "digest.h"
+
+#include <algorithm>     // std::sort
+#include <cassert>       // assert
+#include <cstdint>       // std::uint8_t, std::uint64_t
+#include <unordered_map> // std::unordered_map
+#include <unordered_set> // std::unordered_set
+#include <vector>        // std::vector
+
+namespace {
+
+constexpr std::uint8_t VERSION{1};
+
+// Every distinct property name and string value of the document
+auto collect(const sourcemeta::core::JSON &document,
+             const std::size_t minimum_string_length,
+             std::unordered_set<sourcemeta::core::JSON::String> &result)
+    -> void {
+  if (document.is_string()) {
+    if (document.to_string().size() >= minimum_string_length) {
+      result.insert(document.to_string());
+    }
+  } else if (document.is_array()) {
+    for (const auto &item : document.as_array()) {
+      collect(item, minimum_string_length, result);
+    }
+  } else if (document.is_object()) {
+    for (const auto &entry : document.as_object()) {
+      if (entry.first.size() >= minimum_string_length) {
+        result.insert(entry.first);
+      }
+
+      collect(entry.second, minimum_string_length, result);
+    }
+  }
+}
+
+} // namespace
+
+namespace sourcemeta::jsonbinpack {
+
+Dictionary::Dictionary(InputStream &input) {
+  if (input.get_byte() != VERSION) {
+    throw DictionaryError{"The dictionary version is not supported"};
+  }
+
+  const auto size{input.get_varint()};
+  for (std::uint64_t index = 0; index < size; index++) {
+    if (!this->add(input.get_string_utf8(input.get_varint()))) {
+      throw DictionaryError{"The dictionary has duplicate entries"};
+    }
+  }
+}
+
+auto Dictionary::train(std::span<const sourcemeta::core::JSON> sample,
+                       const DictionaryOptions &options) -> void {
+  // Strings that repeat within a message are already shared by the encoder,
+  // so what matters is how many messages each string occurs in
+  std::unordered_map<sourcemeta::core::JSON::String, std::uint64_t> documents;
+  std::unordered_set<sourcemeta::core::JSON::String> strings;
+  for (const auto &document : sample) {
+    strings.clear();
+    collect(document, options.minimum_string_length, strings);
+    for (const auto &value : strings) {
+      documents[value]++;
+    }
+  }
+
+  struct Candidate {
+    const sourcemeta::core::JSON::String *value;
+    std::uint64_t savings;
+  };
+
+  std::vector<Candidate> candidates;
+  for (const auto &[value, count] : documents) {
+    if (count >= options.minimum_documents && !this->index_.contains(value)) {
+      candidates.push_back({.value = &value, .savings = count * value.size()});
+    }
+  }
+
+  // Earlier entries take fewer bytes to refer to. Ties are broken by the
+  // strings themselves, so that training on the same sample results in the
+  // same dictionary
+  std::sort(candidates.begin(), candidates.end(),
+            [](const Candidate &left, const Candidate &right) {
+              return left.savings != right.savings
+                         ? left.savings > right.savings
+                         : *left.value < *right.value;
+            });
+
+  std::uint64_t byte_size{0};
+  for (const auto &entry : this->entries_) {
+    byte_size += entry.size();
+  }
+
+  for (const auto &candidate : candidates) {
+    if (this->entries_.size() >= options.maximum_entries) {
+      break;
+    } else if (byte_size + candidate.value->size() <=
+               options.maximum_byte_size) {
+      this->add(*candidate.value);
+      byte_size += candidate.value->size();
+    }
+  }
+}
+
+auto Dictionary::add(const sourcemeta::core::JSON::String &value) -> bool {
+  const auto [iterator, inserted]{
+      this->index_.try_emplace(value, this->entries_.size())};
+  if (inserted) {
+    this->entries_.push_back(value);
+  }
+
+  return inserted;
+}
+
+auto Dictionary::find(const sourcemeta::core::JSON::String &value) const
+    -> std::optional<std::uint64_t> {
+  const auto match{this->index_.find(value)};
+  if (match == this->index_.cend()) {
+    return std::nullopt;
+  }
+
+  return match->second;
+}
+
+auto Dictionary::at(const std::uint64_t index) const
+    -> const sourcemeta::core::JSON::String & {
+  assert(index < this->entries_.size());
+  return this->entries_[index];
+}
+
+auto Dictionary::size() const -> std::size_t { return this->entries_.size(); }
+
+auto Dictionary::identifier() const -> std::uint64_t {
+  internal::Digest digest;
+  digest.integer(this->entries_.size());
+  for (const auto &entry : this->entries_) {
+    digest.string(entry);
+  }
+
+  return digest.value();
+}
+
+auto Dictionary::write(OutputStream &output) const -> void {
+  output.put_byte(VERSION);
+  output.put_varint(this->entries_.size());
+  for (const auto &entry : this->entries_) {
+    output.put_varint(entry.size());
+    output.put_string_utf8(entry, entry.size());
+  }
+}
+
+} // namespace sourcemeta::jsonbinpack
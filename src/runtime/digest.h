@@ -0,0 +1,41 @@
+#ifndef SOURCEMETA_JSONBINPACK_RUNTIME_DIGEST_H_
+#define SOURCEMETA_JSONBINPACK_RUNTIME_DIGEST_H_
+
+#include <cstdint>     // std::uint8_t, std::uint64_t
+#include <string_view> // std::string_view
+
+namespace sourcemeta::jsonbinpack::internal {
+
+// FNV-1a, as it is trivial to compute the same way on every platform, so
+// that digests can be persisted and compared across machines
+class Digest {
+public:
+  auto byte(const std::uint8_t value) -> void {
+    this->value_ ^= value;
+    this->value_ *= 0x100000001b3;
+  }
+
+  // As little endian, regardless of the host
+  auto integer(const std::uint64_t value) -> void {
+    for (std::uint64_t shift = 0; shift < 64; shift += 8) {
+      this->byte(static_cast<std::uint8_t>((value >> shift) & 0xff));
+    }
+  }
+
+  // Prefixed by its length, so that consecutive strings cannot be confused
+  auto string(const std::string_view value) -> void {
+    this->integer(value.size());
+    for (const auto character : value) {
+      this->byte(static_cast<std::uint8_t>(character));
+    }
+  }
+
+  [[nodiscard]] auto value() const -> std::uint64_t { return this->value_; }
+
+private:
+  std::uint64_t value_{0xcbf29ce484222325};
+};
+
+} // namespace sourcemeta::jsonbinpack::internal
+
+#endif
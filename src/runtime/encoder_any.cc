@@ -2,15 +2,12 @@
 
 #include <sourcemeta/core/numeric.h>
 
+#include "any_packed.h"
+#include "choice_index.h"
 #include "unreachable.h"
 
-#include <algorithm> // std::find_if
-#include <cassert>   // assert
-#include <cstdint>   // std::uint8_t, std::int64_t, std::uint64_t
-#include <iterator>  // std::cbegin, std::cend, std::distance
-#include <memory>    // std::make_shared
-#include <ranges>    // std::ranges
-#include <utility>   // std::move
+#include <cassert> // assert
+#include <cstdint> // std::uint8_t, std::int64_t, std::uint64_t
 
 namespace sourcemeta::jsonbinpack {
 
@@ -19,11 +16,8 @@ auto Encoder::BYTE_CHOICE_INDEX(const sourcemeta::core::JSON &document,
     -> void {
   assert(!options.choices.empty());
   assert(sourcemeta::core::is_byte(options.choices.size()));
-  const auto iterator{std::ranges::find(options.choices, document)};
-  assert(iterator != std::cend(options.choices));
-  const auto cursor{std::distance(std::cbegin(options.choices), iterator)};
-  assert(sourcemeta::core::is_within(
-      cursor, 0, static_cast<std::int64_t>(options.choices.size())));
+  const auto cursor{find_choice(options.choices, options.index, document)};
+  assert(cursor < options.choices.size());
   this->put_byte(static_cast<std::uint8_t>(cursor));
 }
 
@@ -31,14 +25,9 @@ auto Encoder::LARGE_CHOICE_INDEX(const sourcemeta::core::JSON &document,
                                  const struct LARGE_CHOICE_INDEX &options)
     -> void {
   assert(options.choices.size() > 0);
-  const auto iterator{std::ranges::find_if(
-      options.choices,
-      [&document](const auto &choice) -> bool { return choice == document; })};
-  assert(iterator != std::cend(options.choices));
-  const auto cursor{std::distance(std::cbegin(options.choices), iterator)};
-  assert(sourcemeta::core::is_within(cursor, static_cast<std::uint64_t>(0),
-                                     options.choices.size() - 1));
-  this->put_varint(static_cast<std::uint64_t>(cursor));
+  const auto cursor{find_choice(options.choices, options.index, document)};
+  assert(cursor < options.choices.size());
+  this->put_varint(cursor);
 }
 
 auto Encoder::TOP_LEVEL_BYTE_CHOICE_INDEX(
@@ -46,13 +35,8 @@ auto Encoder::TOP_LEVEL_BYTE_CHOICE_INDEX(
     const struct TOP_LEVEL_BYTE_CHOICE_INDEX &options) -> void {
   assert(options.choices.size() > 0);
   assert(sourcemeta::core::is_byte(options.choices.size()));
-  const auto iterator{std::ranges::find_if(
-      options.choices,
-      [&document](auto const &choice) -> bool { return choice == document; })};
-  assert(iterator != std::cend(options.choices));
-  const auto cursor{std::distance(std::cbegin(options.choices), iterator)};
-  assert(sourcemeta::core::is_within(
-      cursor, 0, static_cast<std::int64_t>(options.choices.size()) - 1));
+  const auto cursor{find_choice(options.choices, options.index, document)};
+  assert(cursor < options.choices.size());
   // This encoding encodes the first option of the enum as "no data"
   if (cursor > 0) {
     this->put_byte(static_cast<std::uint8_t>(cursor - 1));
@@ -120,7 +104,7 @@ auto Encoder::ANY_PACKED_TYPE_TAG_BYTE_PREFIX(
   } else if (document.is_string()) {
     const sourcemeta::core::JSON::String &value{document.to_string()};
     const auto size{document.byte_size()};
-    const auto shared{this->cache_.find(value, Cache::Type::Standalone)};
+    const auto shared{this->find_shared(value, Cache::Type::Standalone)};
     if (size < sourcemeta::core::uint_max<5>) {
       const std::uint8_t type{shared.has_value() ? TYPE_SHARED_STRING
                                                  : TYPE_STRING};
@@ -164,44 +148,26 @@ auto Encoder::ANY_PACKED_TYPE_TAG_BYTE_PREFIX(
           {static_cast<std::uint64_t>(sourcemeta::core::uint_max<5> * 2)});
     }
   } else if (document.is_array()) {
-    const auto size{document.size()};
-    if (size >= sourcemeta::core::uint_max<5>) {
-      this->put_byte(TYPE_ARRAY);
-      this->put_varint(size - sourcemeta::core::uint_max<5>);
-    } else {
-      this->put_byte(
-          static_cast<std::uint8_t>(TYPE_ARRAY | ((size + 1) << type_size)));
-    }
-
-    Encoding encoding{
-        sourcemeta::jsonbinpack::ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
-    this->FIXED_TYPED_ARRAY(
-        document, {.size = size,
-                   .encoding = std::make_shared<Encoding>(std::move(encoding)),
-                   .prefix_encodings = {}});
+    this->put_any_packed_container(TYPE_ARRAY, document.size());
+    this->write_items(document, value_encoding(), {});
   } else if (document.is_object()) {
-    const auto size{document.size()};
-    if (size >= sourcemeta::core::uint_max<5>) {
-      this->put_byte(TYPE_OBJECT);
-      this->put_varint(size - sourcemeta::core::uint_max<5>);
-    } else {
-      this->put_byte(
-          static_cast<std::uint8_t>(TYPE_OBJECT | ((size + 1) << type_size)));
-    }
-
-    Encoding key_encoding{
-        sourcemeta::jsonbinpack::PREFIX_VARINT_LENGTH_STRING_SHARED{}};
-    Encoding value_encoding{
-        sourcemeta::jsonbinpack::ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
-    this->FIXED_TYPED_ARBITRARY_OBJECT(
-        document,
-        {.size = size,
-         .key_encoding = std::make_shared<Encoding>(std::move(key_encoding)),
-         .encoding = std::make_shared<Encoding>(std::move(value_encoding))});
+    this->put_any_packed_container(TYPE_OBJECT, document.size());
+    this->write_entries(document, key_encoding(), value_encoding());
   } else {
     // We should never get here
     unreachable();
   }
 }
 
+auto Encoder::put_any_packed_container(const std::uint8_t type,
+                                       const std::uint64_t size) -> void {
+  using namespace internal::ANY_PACKED_TYPE_TAG_BYTE_PREFIX;
+  if (size >= sourcemeta::core::uint_max<5>) {
+    this->put_byte(type);
+    this->put_varint(size - sourcemeta::core::uint_max<5>);
+  } else {
+    this->put_byte(static_cast<std::uint8_t>(type | ((size + 1) << type_size)));
+  }
+}
+
 } // namespace sourcemeta::jsonbinpack
@@ -3,8 +3,9 @@
 #include <sourcemeta/core/numeric.h>
 
 #include <cassert> // assert
-#include <cstdint> // std::uint8_t
-#include <utility> // std::move
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint8_t, std::uint64_t
+#include <vector>  // std::vector
 
 namespace sourcemeta::jsonbinpack {
 
@@ -13,14 +14,8 @@ auto Encoder::FIXED_TYPED_ARRAY(const sourcemeta::core::JSON &document,
     -> void {
   assert(document.is_array());
   assert(document.size() == options.size);
-  const auto prefix_encodings{options.prefix_encodings.size()};
-  assert(prefix_encodings <= document.size());
-  for (std::size_t index = 0; index < options.size; index++) {
-    const Encoding &encoding{prefix_encodings > index
-                                 ? options.prefix_encodings[index]
-                                 : *(options.encoding)};
-    this->write(document.at(index), encoding);
-  }
+  assert(options.encoding);
+  this->write_items(document, *(options.encoding), options.prefix_encodings);
 }
 
 auto Encoder::BOUNDED_8BITS_TYPED_ARRAY(
@@ -31,10 +26,8 @@ auto Encoder::BOUNDED_8BITS_TYPED_ARRAY(
   assert(sourcemeta::core::is_within(size, options.minimum, options.maximum));
   assert(sourcemeta::core::is_byte(options.maximum - options.minimum));
   this->put_byte(static_cast<std::uint8_t>(size - options.minimum));
-  this->FIXED_TYPED_ARRAY(document,
-                          {.size = size,
-                           .encoding = options.encoding,
-                           .prefix_encodings = options.prefix_encodings});
+  assert(options.encoding);
+  this->write_items(document, *(options.encoding), options.prefix_encodings);
 }
 
 auto Encoder::FLOOR_TYPED_ARRAY(const sourcemeta::core::JSON &document,
@@ -43,10 +36,8 @@ auto Encoder::FLOOR_TYPED_ARRAY(const sourcemeta::core::JSON &document,
   const auto size{document.size()};
   assert(size >= options.minimum);
   this->put_varint(size - options.minimum);
-  this->FIXED_TYPED_ARRAY(document,
-                          {.size = size,
-                           .encoding = options.encoding,
-                           .prefix_encodings = options.prefix_encodings});
+  assert(options.encoding);
+  this->write_items(document, *(options.encoding), options.prefix_encodings);
 }
 
 auto Encoder::ROOF_TYPED_ARRAY(const sourcemeta::core::JSON &document,
@@ -54,10 +45,52 @@ auto Encoder::ROOF_TYPED_ARRAY(const sourcemeta::core::JSON &document,
   const auto size{document.size()};
   assert(size <= options.maximum);
   this->put_varint(options.maximum - size);
-  this->FIXED_TYPED_ARRAY(document,
-                          {.size = size,
-                           .encoding = options.encoding,
-                           .prefix_encodings = options.prefix_encodings});
+  assert(options.encoding);
+  this->write_items(document, *(options.encoding), options.prefix_encodings);
+}
+
+auto Encoder::FLOOR_TYPED_LENGTH_PREFIX_ARRAY(
+    const sourcemeta::core::JSON &document,
+    const struct FLOOR_TYPED_LENGTH_PREFIX_ARRAY &options) -> void {
+  assert(document.is_array());
+  const auto size{document.size()};
+  assert(size >= options.minimum);
+  this->put_varint(size - options.minimum);
+  assert(options.encoding);
+
+  const auto previous{this->divert_length_prefixed()};
+  const auto start{this->position()};
+  std::vector<std::uint64_t> offsets;
+  if (options.offsets) {
+    offsets.reserve(size);
+  }
+
+  std::size_t index{0};
+  for (const auto &item : document.as_array()) {
+    if (options.offsets) {
+      offsets.push_back(this->position() - start);
+    }
+
+    this->write(item, index < options.prefix_encodings.size()
+                          ? options.prefix_encodings[index]
+                          : *(options.encoding));
+    index += 1;
+  }
+
+  this->put_length_prefixed(previous, offsets);
+}
+
+auto Encoder::write_items(const sourcemeta::core::JSON &document,
+                          const Encoding &encoding,
+                          const std::vector<Encoding> &prefix_encodings)
+    -> void {
+  assert(document.is_array());
+  std::size_t index{0};
+  for (const auto &item : document.as_array()) {
+    this->write(item, index < prefix_encodings.size() ? prefix_encodings[index]
+                                                      : encoding);
+    index += 1;
+  }
 }
 
 } // namespace sourcemeta::jsonbinpack
@@ -1,13 +1,49 @@
+#include <sourcemeta/jsonbinpack/runtime.h>
 #include <sourcemeta/jsonbinpack/runtime_encoder.h>
 
+#include "length_prefix.h"
 #include "unreachable.h"
 
 #include <cassert> // assert
+#include <cstddef> // std::byte
+#include <cstdint> // std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t
+#include <limits>  // std::numeric_limits
+#include <span>    // std::span
 #include <variant> // std::get
+#include <vector>  // std::vector
 
 namespace sourcemeta::jsonbinpack {
 
-Encoder::Encoder(Stream &output) : OutputStream{output} {}
+Encoder::Encoder(Stream &output, const CacheOptions &cache_options)
+    : OutputStream{output}, cache_{cache_options},
+      dictionary_{cache_options.dictionary} {}
+
+Encoder::Encoder(std::vector<std::byte> &output,
+                 const CacheOptions &cache_options)
+    : OutputStream{output}, cache_{cache_options},
+      dictionary_{cache_options.dictionary} {}
+
+Encoder::Encoder(std::span<std::byte> output, const CacheOptions &cache_options)
+    : OutputStream{output}, cache_{cache_options},
+      dictionary_{cache_options.dictionary} {}
+
+auto Encoder::reset(Stream &output) -> void {
+  OutputStream::reset(output);
+  this->cache_.clear();
+  this->scratch_depth_ = 0;
+}
+
+auto Encoder::reset(std::vector<std::byte> &output) -> void {
+  OutputStream::reset(output);
+  this->cache_.clear();
+  this->scratch_depth_ = 0;
+}
+
+auto Encoder::reset(std::span<std::byte> output) -> void {
+  OutputStream::reset(output);
+  this->cache_.clear();
+  this->scratch_depth_ = 0;
+}
 
 auto Encoder::write(const sourcemeta::core::JSON &document,
                     const Encoding &encoding) -> void {
@@ -38,6 +74,10 @@ auto Encoder::write(const sourcemeta::core::JSON &document,
     HANDLE_ENCODING(19, ROOF_TYPED_ARRAY)
     HANDLE_ENCODING(20, FIXED_TYPED_ARBITRARY_OBJECT)
     HANDLE_ENCODING(21, VARINT_TYPED_ARBITRARY_OBJECT)
+    HANDLE_ENCODING(22, FLOOR_TYPED_LENGTH_PREFIX_ARRAY)
+    HANDLE_ENCODING(23, VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT)
+    HANDLE_ENCODING(24, GZIP_VARINT_PREFIX_UTF8_STRING)
+    HANDLE_ENCODING(25, MIXED_BOUNDED_TYPED_OBJECT)
 #undef HANDLE_ENCODING
     default:
       // We should never get here. If so, it is definitely a bug
@@ -45,4 +85,53 @@ auto Encoder::write(const sourcemeta::core::JSON &document,
   }
 }
 
+auto Encoder::divert_length_prefixed() -> Diversion {
+  if (this->scratch_.size() == this->scratch_depth_) {
+    this->scratch_.emplace_back();
+  }
+
+  auto &items{this->scratch_[this->scratch_depth_]};
+  this->scratch_depth_ += 1;
+  items.clear();
+  // The items start right after their 32-bit byte length
+  return this->divert(items, this->position() + 4);
+}
+
+auto Encoder::put_length_prefixed(const Diversion &previous,
+                                  const std::vector<std::uint64_t> &offsets)
+    -> void {
+  assert(this->scratch_depth_ > 0);
+  this->scratch_depth_ -= 1;
+  const auto &items{this->scratch_[this->scratch_depth_]};
+  this->restore(previous);
+
+  if (items.size() > std::numeric_limits<std::uint32_t>::max()) {
+    throw EncodingError("The encoded items of a length-prefixed container "
+                        "must fit in 4 GiB");
+  }
+
+  this->put_dword(static_cast<std::uint32_t>(items.size()));
+  this->put_bytes(items.data(), items.size());
+  switch (internal::offset_width(items.size())) {
+    case 1:
+      for (const auto offset : offsets) {
+        this->put_byte(static_cast<std::uint8_t>(offset));
+      }
+
+      break;
+    case 2:
+      for (const auto offset : offsets) {
+        this->put_word(static_cast<std::uint16_t>(offset));
+      }
+
+      break;
+    default:
+      for (const auto offset : offsets) {
+        this->put_dword(static_cast<std::uint32_t>(offset));
+      }
+
+      break;
+  }
+}
+
 } // namespace sourcemeta::jsonbinpack
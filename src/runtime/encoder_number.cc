@@ -9,6 +9,14 @@ namespace sourcemeta::jsonbinpack {
 
 auto Encoder::DOUBLE_VARINT_TUPLE(const sourcemeta::core::JSON &document,
                                   const struct DOUBLE_VARINT_TUPLE &) -> void {
+  // Integers are valid JSON Schema numbers too. Going through a real would
+  // lose precision beyond 2^53, so they are digits with no decimal point
+  if (document.is_integer()) {
+    this->put_varint_zigzag(document.to_integer());
+    this->put_varint(0);
+    return;
+  }
+
   assert(document.is_real());
   const auto value{document.to_real()};
   std::uint64_t point_position;
@@ -1,6 +1,11 @@
 #include <sourcemeta/jsonbinpack/runtime_encoder.h>
 
+#include "presence.h"
+
 #include <cassert> // assert
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+#include <vector>  // std::vector
 
 namespace sourcemeta::jsonbinpack {
 
@@ -10,10 +15,9 @@ auto Encoder::FIXED_TYPED_ARBITRARY_OBJECT(
   assert(document.is_object());
   assert(document.size() == options.size);
 
-  for (const auto &entry : document.as_object()) {
-    this->write(sourcemeta::core::JSON{entry.first}, *(options.key_encoding));
-    this->write(entry.second, *(options.encoding));
-  }
+  assert(options.key_encoding);
+  assert(options.encoding);
+  this->write_entries(document, *(options.key_encoding), *(options.encoding));
 }
 
 auto Encoder::VARINT_TYPED_ARBITRARY_OBJECT(
@@ -23,10 +27,79 @@ auto Encoder::VARINT_TYPED_ARBITRARY_OBJECT(
   const auto size{document.size()};
   this->put_varint(size);
 
+  assert(options.key_encoding);
+  assert(options.encoding);
+  this->write_entries(document, *(options.key_encoding), *(options.encoding));
+}
+
+auto Encoder::VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT(
+    const sourcemeta::core::JSON &document,
+    const struct VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT &options)
+    -> void {
+  assert(document.is_object());
+  const auto size{document.size()};
+  this->put_varint(size);
+  assert(options.key_encoding);
+  assert(options.encoding);
+
+  const auto previous{this->divert_length_prefixed()};
+  const auto start{this->position()};
+  std::vector<std::uint64_t> offsets;
+  if (options.offsets) {
+    offsets.reserve(size);
+  }
+
   for (const auto &entry : document.as_object()) {
+    if (options.offsets) {
+      offsets.push_back(this->position() - start);
+    }
+
     this->write(sourcemeta::core::JSON{entry.first}, *(options.key_encoding));
     this->write(entry.second, *(options.encoding));
   }
+
+  this->put_length_prefixed(previous, offsets);
+}
+
+auto Encoder::MIXED_BOUNDED_TYPED_OBJECT(
+    const sourcemeta::core::JSON &document,
+    const struct MIXED_BOUNDED_TYPED_OBJECT &options) -> void {
+  assert(document.is_object());
+  const auto required{options.required.size()};
+  assert(options.encodings.size() == required + options.optional.size());
+  internal::Presence presence{options.optional.size()};
+  for (std::size_t index = 0; index < options.optional.size(); index++) {
+    if (document.defines(options.optional[index])) {
+      presence.set(index);
+    }
+  }
+
+  assert(document.size() == required + presence.count());
+  for (const auto byte : presence.bytes()) {
+    this->put_byte(byte);
+  }
+
+  for (std::size_t index = 0; index < required; index++) {
+    this->write(document.at(options.required[index]),
+                options.encodings[index]);
+  }
+
+  for (std::size_t index = 0; index < options.optional.size(); index++) {
+    if (presence.test(index)) {
+      this->write(document.at(options.optional[index]),
+                  options.encodings[required + index]);
+    }
+  }
+}
+
+auto Encoder::write_entries(const sourcemeta::core::JSON &document,
+                            const Encoding &key_encoding,
+                            const Encoding &encoding) -> void {
+  assert(document.is_object());
+  for (const auto &entry : document.as_object()) {
+    this->write(sourcemeta::core::JSON{entry.first}, key_encoding);
+    this->write(entry.second, encoding);
+  }
 }
 
 } // namespace sourcemeta::jsonbinpack
@@ -0,0 +1,224 @@
+#include <sourcemeta/jsonbinpack/runtime_encoder.h>
+
+#include <sourcemeta/core/numeric.h>
+
+#include "presence.h"
+#include "unreachable.h"
+
+#include <cassert> // assert
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint8_t, std::uint32_t, std::int64_t, std::uint64_t
+#include <vector>  // std::vector
+
+namespace sourcemeta::jsonbinpack {
+
+auto Encoder::write(const sourcemeta::core::JSON &document, const Plan &plan)
+    -> void {
+  assert(!plan.instructions_.empty());
+  this->execute(document, plan, 0);
+}
+
+auto Encoder::execute(const sourcemeta::core::JSON &document, const Plan &plan,
+                      const std::uint32_t index) -> void {
+  const auto &instruction{plan.instructions_[index]};
+  switch (instruction.type) {
+    case 0: {
+      assert(document.is_integer());
+      const std::int64_t value{document.to_integer()};
+      assert(sourcemeta::core::abs(value) % instruction.multiplier == 0);
+      const std::int64_t enum_value{
+          instruction.multiplier == 1
+              ? value
+              : value / static_cast<std::int64_t>(instruction.multiplier)};
+      assert(sourcemeta::core::is_byte(enum_value - instruction.bound));
+      return this->put_byte(
+          static_cast<std::uint8_t>(enum_value - instruction.bound));
+    }
+
+    case 1: {
+      assert(document.is_integer());
+      const auto value{static_cast<std::uint64_t>(document.to_integer())};
+      return this->put_varint(
+          (instruction.multiplier == 1 ? value
+                                       : value / instruction.multiplier) -
+          static_cast<std::uint64_t>(instruction.bound));
+    }
+
+    case 2: {
+      assert(document.is_integer());
+      const auto value{static_cast<std::uint64_t>(document.to_integer())};
+      return this->put_varint(
+          static_cast<std::uint64_t>(instruction.bound) -
+          (instruction.multiplier == 1 ? value
+                                       : value / instruction.multiplier));
+    }
+
+    case 3: {
+      assert(document.is_integer());
+      const std::int64_t value{document.to_integer()};
+      return this->put_varint_zigzag(
+          instruction.multiplier == 1
+              ? value
+              : value / static_cast<std::int64_t>(instruction.multiplier));
+    }
+
+#define HANDLE_ENCODING(index, name)                                           \
+  case (index):                                                                \
+    return this->name(document,                                                \
+                      *static_cast<const sourcemeta::jsonbinpack::name *>(     \
+                          instruction.options));
+      HANDLE_ENCODING(4, DOUBLE_VARINT_TUPLE)
+      HANDLE_ENCODING(5, BYTE_CHOICE_INDEX)
+      HANDLE_ENCODING(6, LARGE_CHOICE_INDEX)
+      HANDLE_ENCODING(7, TOP_LEVEL_BYTE_CHOICE_INDEX)
+      HANDLE_ENCODING(8, CONST_NONE)
+      HANDLE_ENCODING(9, ANY_PACKED_TYPE_TAG_BYTE_PREFIX)
+      HANDLE_ENCODING(10, UTF8_STRING_NO_LENGTH)
+      HANDLE_ENCODING(11, FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED)
+      HANDLE_ENCODING(12, ROOF_VARINT_PREFIX_UTF8_STRING_SHARED)
+      HANDLE_ENCODING(13, BOUNDED_8BIT_PREFIX_UTF8_STRING_SHARED)
+      HANDLE_ENCODING(14, RFC3339_DATE_INTEGER_TRIPLET)
+      HANDLE_ENCODING(15, PREFIX_VARINT_LENGTH_STRING_SHARED)
+      HANDLE_ENCODING(24, GZIP_VARINT_PREFIX_UTF8_STRING)
+#undef HANDLE_ENCODING
+
+    case 16:
+    case 17:
+    case 18:
+    case 19: {
+      assert(document.is_array());
+      const auto size{document.size()};
+      if (instruction.type == 16) {
+        assert(size == instruction.offset);
+      } else if (instruction.type == 17) {
+        assert(size >= instruction.offset);
+        this->put_byte(static_cast<std::uint8_t>(size - instruction.offset));
+      } else if (instruction.type == 18) {
+        assert(size >= instruction.offset);
+        this->put_varint(size - instruction.offset);
+      } else {
+        assert(size <= instruction.offset);
+        this->put_varint(instruction.offset - size);
+      }
+
+      const auto *prefixes{plan.prefixes_.data() + instruction.prefixes_begin};
+      std::size_t cursor{0};
+      for (const auto &item : document.as_array()) {
+        this->execute(item, plan,
+                      cursor < instruction.prefixes_size ? prefixes[cursor]
+                                                         : instruction.child);
+        cursor += 1;
+      }
+
+      return;
+    }
+
+    case 20:
+    case 21:
+      assert(document.is_object());
+      if (instruction.type == 20) {
+        assert(document.size() == instruction.offset);
+      } else {
+        this->put_varint(document.size());
+      }
+
+      for (const auto &entry : document.as_object()) {
+        this->execute(sourcemeta::core::JSON{entry.first}, plan,
+                      instruction.key);
+        this->execute(entry.second, plan, instruction.child);
+      }
+
+      return;
+
+    case 22:
+    case 23: {
+      const bool is_array{instruction.type == 22};
+      const auto size{document.size()};
+      if (is_array) {
+        assert(document.is_array());
+        assert(size >= instruction.offset);
+        this->put_varint(size - instruction.offset);
+      } else {
+        assert(document.is_object());
+        this->put_varint(size);
+      }
+
+      const auto previous{this->divert_length_prefixed()};
+      const auto start{this->position()};
+      std::vector<std::uint64_t> offsets;
+      if (instruction.offsets) {
+        offsets.reserve(size);
+      }
+
+      if (is_array) {
+        const auto *prefixes{plan.prefixes_.data() +
+                             instruction.prefixes_begin};
+        std::size_t cursor{0};
+        for (const auto &item : document.as_array()) {
+          if (instruction.offsets) {
+            offsets.push_back(this->position() - start);
+          }
+
+          this->execute(item, plan,
+                        cursor < instruction.prefixes_size ? prefixes[cursor]
+                                                           : instruction.child);
+          cursor += 1;
+        }
+      } else {
+        for (const auto &entry : document.as_object()) {
+          if (instruction.offsets) {
+            offsets.push_back(this->position() - start);
+          }
+
+          this->execute(sourcemeta::core::JSON{entry.first}, plan,
+                        instruction.key);
+          this->execute(entry.second, plan, instruction.child);
+        }
+      }
+
+      return this->put_length_prefixed(previous, offsets);
+    }
+
+    case 25: {
+      assert(document.is_object());
+      const auto &options{*static_cast<
+          const sourcemeta::jsonbinpack::MIXED_BOUNDED_TYPED_OBJECT *>(
+          instruction.options)};
+      const auto *properties{plan.prefixes_.data() +
+                             instruction.prefixes_begin};
+      internal::Presence presence{options.optional.size()};
+      for (std::size_t cursor = 0; cursor < options.optional.size();
+           cursor++) {
+        if (document.defines(options.optional[cursor])) {
+          presence.set(cursor);
+        }
+      }
+
+      assert(document.size() == instruction.offset + presence.count());
+      for (const auto byte : presence.bytes()) {
+        this->put_byte(byte);
+      }
+
+      for (std::size_t cursor = 0; cursor < instruction.offset; cursor++) {
+        this->execute(document.at(options.required[cursor]), plan,
+                      properties[cursor]);
+      }
+
+      for (std::size_t cursor = 0; cursor < options.optional.size();
+           cursor++) {
+        if (presence.test(cursor)) {
+          this->execute(document.at(options.optional[cursor]), plan,
+                        properties[instruction.offset + cursor]);
+        }
+      }
+
+      return;
+    }
+
+    default:
+      // We should never get here. If so, it is definitely a bug
+      unreachable();
+  }
+}
+
+} // namespace sourcemeta::jsonbinpack
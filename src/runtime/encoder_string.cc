@@ -1,11 +1,54 @@
+#include <sourcemeta/jsonbinpack/runtime_dictionary.h>
 #include <sourcemeta/jsonbinpack/runtime_encoder.h>
 
-#include <cassert> // assert
-#include <cstdint> // std::uint8_t, std::uint16_t
-#include <string>  // std::stoul
+#include <sourcemeta/core/gzip.h>
+
+#include "varint.h"
+
+#include <cassert>  // assert
+#include <cstddef>  // std::byte
+#include <cstdint>  // std::uint8_t, std::uint16_t, std::uint64_t
+#include <limits>   // std::numeric_limits
+#include <optional> // std::optional, std::nullopt
+#include <string>   // std::stoul
+
+namespace {
+
+// The encoding is meant for values where size matters more than speed, so
+// favour the compression ratio over the default compression level
+constexpr int GZIP_LEVEL{9};
+
+} // namespace
 
 namespace sourcemeta::jsonbinpack {
 
+auto Encoder::find_shared(const sourcemeta::core::JSON::String &value,
+                          const Cache::Type type) const
+    -> std::optional<std::uint64_t> {
+  // An earlier occurrence within the output is always closer
+  const auto cached{this->cache_.find(value, type)};
+  if (cached.has_value() || this->dictionary_ == nullptr) {
+    return cached;
+  }
+
+  const auto entry{this->dictionary_->find(value)};
+  if (!entry.has_value()) {
+    return std::nullopt;
+  }
+
+  // The entries are laid out backwards from the start of the output, so the
+  // relative offset to an entry is the position plus the entry index plus one
+  const std::uint64_t offset{std::numeric_limits<std::uint64_t>::max() -
+                             entry.value()};
+  // Referring to the entry is not worth it if it takes as many bytes as
+  // writing the string, which the position of the output affects
+  if (internal::varint_size(this->position() - offset) >= value.size()) {
+    return std::nullopt;
+  }
+
+  return offset;
+}
+
 auto Encoder::UTF8_STRING_NO_LENGTH(const sourcemeta::core::JSON &document,
                                     const struct UTF8_STRING_NO_LENGTH &options)
     -> void {
@@ -21,7 +64,7 @@ auto Encoder::FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED(
   const sourcemeta::core::JSON::String &value{document.to_string()};
   const auto size{value.size()};
   assert(document.byte_size() == size);
-  const auto shared{this->cache_.find(value, Cache::Type::Standalone)};
+  const auto shared{this->find_shared(value, Cache::Type::Standalone)};
 
   // (1) Write 0x00 if shared, else do nothing
   if (shared.has_value()) {
@@ -48,7 +91,7 @@ auto Encoder::ROOF_VARINT_PREFIX_UTF8_STRING_SHARED(
   const auto size{value.size()};
   assert(document.byte_size() == size);
   assert(size <= options.maximum);
-  const auto shared{this->cache_.find(value, Cache::Type::Standalone)};
+  const auto shared{this->find_shared(value, Cache::Type::Standalone)};
 
   // (1) Write 0x00 if shared, else do nothing
   if (shared.has_value()) {
@@ -77,7 +120,7 @@ auto Encoder::BOUNDED_8BIT_PREFIX_UTF8_STRING_SHARED(
   assert(options.minimum <= options.maximum);
   assert(sourcemeta::core::is_byte(options.maximum - options.minimum + 1));
   assert(sourcemeta::core::is_within(size, options.minimum, options.maximum));
-  const auto shared{this->cache_.find(value, Cache::Type::Standalone)};
+  const auto shared{this->find_shared(value, Cache::Type::Standalone)};
 
   // (1) Write 0x00 if shared, else do nothing
   if (shared.has_value()) {
@@ -127,7 +170,7 @@ auto Encoder::PREFIX_VARINT_LENGTH_STRING_SHARED(
   const sourcemeta::core::JSON::String &value{document.to_string()};
 
   const auto shared{
-      this->cache_.find(value, Cache::Type::PrefixLengthVarintPlusOne)};
+      this->find_shared(value, Cache::Type::PrefixLengthVarintPlusOne)};
   if (shared.has_value()) {
     const auto new_offset{this->position()};
     this->put_byte(0);
@@ -147,4 +190,18 @@ auto Encoder::PREFIX_VARINT_LENGTH_STRING_SHARED(
   }
 }
 
+auto Encoder::GZIP_VARINT_PREFIX_UTF8_STRING(
+    const sourcemeta::core::JSON &document,
+    const struct GZIP_VARINT_PREFIX_UTF8_STRING &) -> void {
+  assert(document.is_string());
+  const sourcemeta::core::JSON::String &value{document.to_string()};
+  const auto compressed{sourcemeta::core::gzip(
+      reinterpret_cast<const std::uint8_t *>(value.data()), value.size(),
+      GZIP_LEVEL)};
+  this->put_varint(value.size());
+  this->put_varint(compressed.size());
+  this->put_bytes(reinterpret_cast<const std::byte *>(compressed.data()),
+                  compressed.size());
+}
+
 } // namespace sourcemeta::jsonbinpack
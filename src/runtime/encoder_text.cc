@@ -0,0 +1,497 @@
+#include <sourcemeta/jsonbinpack/runtime_encoder.h>
+
+#include <sourcemeta/core/json.h>
+#include <sourcemeta/core/numeric.h>
+
+#include "any_packed.h"
+
+#include <cassert>     // assert
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint8_t, std::uint64_t
+#include <optional>    // std::optional, std::nullopt
+#include <string_view> // std::string_view
+#include <utility>     // std::move
+#include <vector>      // std::vector
+
+namespace {
+
+// A position within JSON text that keeps track of lines and columns to report
+// errors at. Lines only ever break on whitespace outside of strings
+struct Cursor {
+  const char *const end;
+  const char *current;
+  std::uint64_t line{1};
+  const char *line_start;
+
+  [[noreturn]] auto fail() const -> void {
+    throw sourcemeta::core::JSONParseError(
+        this->line,
+        static_cast<std::uint64_t>(this->current - this->line_start) + 1);
+  }
+
+  auto skip_whitespace() -> void {
+    while (this->current < this->end) {
+      switch (*this->current) {
+        case '\n':
+          this->line++;
+          this->line_start = this->current + 1;
+          [[fallthrough]];
+        case ' ':
+        case '\t':
+        case '\r':
+          this->current++;
+          break;
+        default:
+          return;
+      }
+    }
+  }
+
+  // Move past a string, given the cursor is on its opening quote. Invalid
+  // escapes are reported at the start of the string, like when encoding it
+  auto skip_string() -> void {
+    assert(*this->current == '"');
+    const auto *const start{this->current};
+    this->current++;
+    while (this->current < this->end) {
+      const auto character{static_cast<unsigned char>(*this->current)};
+      if (character == '"') {
+        this->current++;
+        return;
+      } else if (character == '\\') {
+        this->current++;
+        if (!this->skip_escape()) {
+          this->current = start;
+          this->fail();
+        }
+      } else if (character < 0x20) {
+        this->fail();
+      } else {
+        this->current++;
+      }
+    }
+
+    this->current = this->end;
+    this->fail();
+  }
+
+  // Move past a number, given the cursor is on its first character. Malformed
+  // numbers are reported at their start, like when encoding them
+  auto skip_number() -> void {
+    const auto *const start{this->current};
+    if (*this->current == '-') {
+      this->current++;
+    }
+
+    if (this->current < this->end && *this->current == '0') {
+      this->current++;
+    } else if (!this->skip_digits()) {
+      this->current = start;
+      this->fail();
+    }
+
+    if (this->current < this->end && *this->current == '.') {
+      this->current++;
+      if (!this->skip_digits()) {
+        this->current = start;
+        this->fail();
+      }
+    }
+
+    if (this->current < this->end &&
+        (*this->current == 'e' || *this->current == 'E')) {
+      this->current++;
+      if (this->current < this->end &&
+          (*this->current == '+' || *this->current == '-')) {
+        this->current++;
+      }
+
+      if (!this->skip_digits()) {
+        this->current = start;
+        this->fail();
+      }
+    }
+
+    // Such as the second digit of a number with a leading zero
+    if (this->current < this->end && this->is_number_character()) {
+      this->current = start;
+      this->fail();
+    }
+  }
+
+  auto skip_literal(const std::string_view literal) -> void {
+    if (static_cast<std::size_t>(this->end - this->current) < literal.size() ||
+        std::string_view{this->current, literal.size()} != literal) {
+      this->fail();
+    }
+
+    this->current += literal.size();
+  }
+
+  [[nodiscard]] auto is_number_character() const -> bool {
+    switch (*this->current) {
+      case '0':
+      case '1':
+      case '2':
+      case '3':
+      case '4':
+      case '5':
+      case '6':
+      case '7':
+      case '8':
+      case '9':
+      case '-':
+      case '+':
+      case '.':
+      case 'e':
+      case 'E':
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  auto skip_digits() -> bool {
+    const auto *const start{this->current};
+    while (this->current < this->end && *this->current >= '0' &&
+           *this->current <= '9') {
+      this->current++;
+    }
+
+    return this->current != start;
+  }
+
+  // Read the four hexadecimal digits of a unicode escape
+  auto read_code_unit() -> std::optional<std::uint16_t> {
+    if (this->end - this->current < 4) {
+      return std::nullopt;
+    }
+
+    std::uint16_t result{0};
+    for (std::size_t index = 0; index < 4; index++) {
+      const auto character{*this->current++};
+      result = static_cast<std::uint16_t>(result << 4);
+      if (character >= '0' && character <= '9') {
+        result = static_cast<std::uint16_t>(result | (character - '0'));
+      } else if (character >= 'a' && character <= 'f') {
+        result = static_cast<std::uint16_t>(result | (character - 'a' + 10));
+      } else if (character >= 'A' && character <= 'F') {
+        result = static_cast<std::uint16_t>(result | (character - 'A' + 10));
+      } else {
+        return std::nullopt;
+      }
+    }
+
+    return result;
+  }
+
+  // Move past an escape sequence, given the cursor is past its backslash.
+  // Surrogates must come in pairs to form a code point
+  auto skip_escape() -> bool {
+    if (this->current == this->end) {
+      return false;
+    }
+
+    switch (*this->current++) {
+      case '"':
+      case '\\':
+      case '/':
+      case 'b':
+      case 'f':
+      case 'n':
+      case 'r':
+      case 't':
+        return true;
+      case 'u': {
+        const auto code_unit{this->read_code_unit()};
+        if (!code_unit.has_value() ||
+            (code_unit.value() >= 0xDC00 && code_unit.value() <= 0xDFFF)) {
+          return false;
+        } else if (code_unit.value() < 0xD800 || code_unit.value() > 0xDBFF) {
+          return true;
+        } else if (this->end - this->current < 2 || this->current[0] != '\\' ||
+                   this->current[1] != 'u') {
+          return false;
+        }
+
+        this->current += 2;
+        const auto low{this->read_code_unit()};
+        return low.has_value() && low.value() >= 0xDC00 &&
+               low.value() <= 0xDFFF;
+      }
+      default:
+        return false;
+    }
+  }
+};
+
+// Validate the text and count the items of every array and properties of
+// every object, in the order in which they start
+auto count(Cursor &cursor, std::vector<std::uint64_t> &sizes) -> void {
+  enum class Expect : std::uint8_t {
+    Value,
+    ValueOrEnd,
+    Key,
+    KeyOrEnd,
+    Colon,
+    CommaOrEnd
+  };
+
+  struct Frame {
+    bool object;
+    // The index of the size of the array or object
+    std::size_t index;
+  };
+
+  std::vector<Frame> stack;
+  auto expect{Expect::Value};
+  while (true) {
+    cursor.skip_whitespace();
+    if (cursor.current == cursor.end) {
+      if (stack.empty() && expect == Expect::CommaOrEnd) {
+        return;
+      }
+
+      cursor.fail();
+    }
+
+    const char character{*cursor.current};
+    switch (expect) {
+      case Expect::Key:
+      case Expect::KeyOrEnd:
+        if (expect == Expect::KeyOrEnd && character == '}') {
+          break;
+        } else if (character != '"') {
+          cursor.fail();
+        }
+
+        sizes[stack.back().index]++;
+        cursor.skip_string();
+        expect = Expect::Colon;
+        continue;
+      case Expect::Colon:
+        if (character != ':') {
+          cursor.fail();
+        }
+
+        cursor.current++;
+        expect = Expect::Value;
+        continue;
+      case Expect::CommaOrEnd:
+        if (stack.empty()) {
+          cursor.fail();
+        } else if (character == ',') {
+          cursor.current++;
+          expect = stack.back().object ? Expect::Key : Expect::Value;
+          continue;
+        } else if (character != (stack.back().object ? '}' : ']')) {
+          cursor.fail();
+        }
+
+        break;
+      case Expect::Value:
+      case Expect::ValueOrEnd:
+        if (expect == Expect::ValueOrEnd && character == ']') {
+          break;
+        }
+
+        if (!stack.empty() && !stack.back().object) {
+          sizes[stack.back().index]++;
+        }
+
+        switch (character) {
+          case '{':
+          case '[':
+            cursor.current++;
+            stack.push_back({character == '{', sizes.size()});
+            sizes.push_back(0);
+            expect = character == '{' ? Expect::KeyOrEnd : Expect::ValueOrEnd;
+            continue;
+          case '"':
+            cursor.skip_string();
+            break;
+          case 't':
+            cursor.skip_literal("true");
+            break;
+          case 'f':
+            cursor.skip_literal("false");
+            break;
+          case 'n':
+            cursor.skip_literal("null");
+            break;
+          default:
+            if (character != '-' && (character < '0' || character > '9')) {
+              cursor.fail();
+            }
+
+            cursor.skip_number();
+        }
+
+        expect = Expect::CommaOrEnd;
+        continue;
+    }
+
+    // The end of the innermost array or object
+    cursor.current++;
+    stack.pop_back();
+    expect = Expect::CommaOrEnd;
+  }
+}
+
+// Read numbers without exponents the way the JSON parser does, which only
+// resorts to arbitrary precision for long reals or out of range integers
+auto plain_number(const std::string_view token)
+    -> std::optional<sourcemeta::core::JSON> {
+  const std::size_t integral{token.front() == '-' ? 1u : 0u};
+  std::size_t cursor{integral};
+  while (cursor < token.size() && token[cursor] >= '0' &&
+         token[cursor] <= '9') {
+    cursor++;
+  }
+
+  // Leading zeroes are not valid JSON
+  if (cursor == integral || (token[integral] == '0' && cursor > integral + 1)) {
+    return std::nullopt;
+  } else if (cursor == token.size()) {
+    const auto value{sourcemeta::core::to_int64_t(token)};
+    if (!value.has_value()) {
+      return std::nullopt;
+    }
+
+    return sourcemeta::core::JSON{value.value()};
+  } else if (token[cursor] != '.') {
+    return std::nullopt;
+  }
+
+  const std::size_t point{cursor++};
+  while (cursor < token.size() && token[cursor] >= '0' &&
+         token[cursor] <= '9') {
+    cursor++;
+  }
+
+  if (cursor == point + 1 || cursor != token.size()) {
+    return std::nullopt;
+  }
+
+  std::size_t significant_digits{token.size() - integral - 1};
+  if (token[integral] == '0') {
+    const auto first{token.find_first_not_of('0', point + 1)};
+    if (first == std::string_view::npos) {
+      return std::nullopt;
+    }
+
+    significant_digits = token.size() - first;
+  }
+
+  if (significant_digits > 15) {
+    return std::nullopt;
+  }
+
+  const auto value{sourcemeta::core::to_double(token)};
+  if (!value.has_value()) {
+    return std::nullopt;
+  }
+
+  return sourcemeta::core::JSON{value.value()};
+}
+
+// Turn a string or number of the text into a document, which keeps the
+// interpretation of its escapes and precision the same as when parsing
+auto scalar(const Cursor &cursor, const char *const start)
+    -> sourcemeta::core::JSON {
+  const std::string_view token{
+      start, static_cast<std::size_t>(cursor.current - start)};
+  // Most strings have no escapes and most numbers have no exponents
+  if (token.front() == '"') {
+    if (token.find('\\') == std::string_view::npos) {
+      return sourcemeta::core::JSON{token.substr(1, token.size() - 2)};
+    }
+  } else if (auto number{plain_number(token)}; number.has_value()) {
+    return std::move(number).value();
+  }
+
+  try {
+    return sourcemeta::core::parse_json(token);
+  } catch (const sourcemeta::core::JSONParseError &) {
+    throw sourcemeta::core::JSONParseError(
+        cursor.line, static_cast<std::uint64_t>(start - cursor.line_start) + 1);
+  }
+}
+
+} // namespace
+
+namespace sourcemeta::jsonbinpack {
+
+auto Encoder::transcode(const std::string_view text) -> void {
+  using namespace internal::ANY_PACKED_TYPE_TAG_BYTE_PREFIX;
+  std::vector<std::uint64_t> sizes;
+  Cursor counter{text.data() + text.size(), text.data(), 1, text.data()};
+  count(counter, sizes);
+
+  // As the text is valid, we only need to tell keys apart from strings
+  std::vector<bool> objects;
+  bool key{false};
+  auto next_size{sizes.cbegin()};
+  Cursor cursor{text.data() + text.size(), text.data(), 1, text.data()};
+  while (true) {
+    cursor.skip_whitespace();
+    if (cursor.current == cursor.end) {
+      assert(next_size == sizes.cend());
+      return;
+    }
+
+    const char *const start{cursor.current};
+    switch (*start) {
+      case '{':
+      case '[':
+        cursor.current++;
+        assert(next_size != sizes.cend());
+        this->put_any_packed_container(*start == '{' ? TYPE_OBJECT : TYPE_ARRAY,
+                                       *next_size++);
+        objects.push_back(*start == '{');
+        key = objects.back();
+        break;
+      case '}':
+      case ']':
+        cursor.current++;
+        objects.pop_back();
+        break;
+      case ',':
+        cursor.current++;
+        key = objects.back();
+        break;
+      case ':':
+        cursor.current++;
+        key = false;
+        break;
+      case 't':
+        cursor.current += 4;
+        this->ANY_PACKED_TYPE_TAG_BYTE_PREFIX(sourcemeta::core::JSON{true}, {});
+        break;
+      case 'f':
+        cursor.current += 5;
+        this->ANY_PACKED_TYPE_TAG_BYTE_PREFIX(sourcemeta::core::JSON{false},
+                                              {});
+        break;
+      case 'n':
+        cursor.current += 4;
+        this->ANY_PACKED_TYPE_TAG_BYTE_PREFIX(sourcemeta::core::JSON{nullptr},
+                                              {});
+        break;
+      case '"':
+        cursor.skip_string();
+        if (key) {
+          this->PREFIX_VARINT_LENGTH_STRING_SHARED(scalar(cursor, start), {});
+        } else {
+          this->ANY_PACKED_TYPE_TAG_BYTE_PREFIX(scalar(cursor, start), {});
+        }
+
+        break;
+      default:
+        cursor.skip_number();
+        this->ANY_PACKED_TYPE_TAG_BYTE_PREFIX(scalar(cursor, start), {});
+    }
+  }
+}
+
+} // namespace sourcemeta::jsonbinpack
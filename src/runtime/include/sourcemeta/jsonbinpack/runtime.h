@@ -16,12 +16,21 @@
 
 #include <sourcemeta/core/json.h>
 
+#include <sourcemeta/jsonbinpack/runtime_batch.h>
+#include <sourcemeta/jsonbinpack/runtime_container.h>
+#include <sourcemeta/jsonbinpack/runtime_decode_handler.h>
+#include <sourcemeta/jsonbinpack/runtime_decoded_view.h>
 #include <sourcemeta/jsonbinpack/runtime_decoder.h>
+#include <sourcemeta/jsonbinpack/runtime_dictionary.h>
 #include <sourcemeta/jsonbinpack/runtime_encoder.h>
 #include <sourcemeta/jsonbinpack/runtime_encoding.h>
+#include <sourcemeta/jsonbinpack/runtime_plan.h>
 
+#include <cstddef>   // std::byte
 #include <exception> // std::exception
+#include <span>      // std::span
 #include <utility>   // std::move
+#include <vector>    // std::vector
 
 namespace sourcemeta::jsonbinpack {
 
@@ -29,6 +38,39 @@ namespace sourcemeta::jsonbinpack {
 SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT
 auto load(const sourcemeta::core::JSON &input) -> Encoding;
 
+/// @ingroup runtime
+/// Serialize an encoding into a compact binary form, appending it to the given
+/// buffer. Loading an encoding out of its binary form is much faster than
+/// loading it out of its JSON form. For example:
+///
+/// ```cpp
+/// #include <sourcemeta/jsonbinpack/runtime.h>
+/// #include <cassert>
+/// #include <vector>
+///
+/// const sourcemeta::jsonbinpack::Encoding encoding{
+///     sourcemeta::jsonbinpack::FLOOR_MULTIPLE_ENUM_VARINT{.minimum = -5,
+///                                                         .multiplier = 1}};
+/// std::vector<std::byte> bytes;
+/// sourcemeta::jsonbinpack::save(encoding, bytes);
+/// const auto result{sourcemeta::jsonbinpack::load(bytes)};
+/// assert(result.index() == encoding.index());
+/// ```
+///
+/// The binary form starts with a format version byte, followed by every
+/// encoding of the tree in pre-order, each as the varint of its position in
+/// the `Encoding` variant followed by its options. Integers are varints,
+/// strings are length-prefixed, and JSON values are length-prefixed
+/// `ANY_PACKED_TYPE_TAG_BYTE_PREFIX` BinPack documents.
+SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT
+auto save(const Encoding &encoding, std::vector<std::byte> &output) -> void;
+
+/// @ingroup runtime
+/// Load an encoding out of the binary form produced by `save`. Malformed input
+/// throws either `EncodingError` or `sourcemeta::core::IOReadOutOfBoundsError`
+SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT
+auto load(std::span<const std::byte> input) -> Encoding;
+
 // Exporting symbols that depends on the standard C++ library is considered
 // safe.
 // https://learn.microsoft.com/en-us/cpp/error-messages/compiler-warnings/compiler-warning-level-2-c4275?view=msvc-170&redirectedfrom=MSDN
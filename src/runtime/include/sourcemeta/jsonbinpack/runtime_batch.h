@@ -0,0 +1,71 @@
+#ifndef SOURCEMETA_JSONBINPACK_RUNTIME_BATCH_H_
+#define SOURCEMETA_JSONBINPACK_RUNTIME_BATCH_H_
+
+#ifndef SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT
+#include <sourcemeta/jsonbinpack/runtime_export.h>
+#endif
+
+#include <sourcemeta/jsonbinpack/runtime_dictionary.h>
+#include <sourcemeta/jsonbinpack/runtime_encoder_cache.h>
+#include <sourcemeta/jsonbinpack/runtime_encoding.h>
+
+#include <sourcemeta/core/json.h>
+
+#include <cstddef> // std::byte, std::size_t
+#include <span>    // std::span
+#include <thread>  // std::thread
+#include <vector>  // std::vector
+
+namespace sourcemeta::jsonbinpack {
+
+/// @ingroup runtime
+/// Encode many documents with the same encoding across the given number of
+/// threads, appending them to the output in order. Each document becomes a
+/// record made of its byte length as a varint followed by the document
+/// encoded on its own, so records never share strings with each other. For
+/// example, to convert the lines of a JSONL file in batches:
+///
+/// ```cpp
+/// #include <sourcemeta/jsonbinpack/runtime.h>
+/// #include <sourcemeta/core/jsonl.h>
+///
+/// std::vector<sourcemeta::core::JSON> records;
+/// std::vector<std::byte> output;
+/// for (const auto &record : sourcemeta::core::JSONL{stream}) {
+///   records.push_back(record);
+///   if (records.size() == 10000) {
+///     sourcemeta::jsonbinpack::encode_batch(records, encoding, output);
+///     records.clear();
+///   }
+/// }
+///
+/// sourcemeta::jsonbinpack::encode_batch(records, encoding, output);
+/// ```
+SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT
+auto encode_batch(std::span<const sourcemeta::core::JSON> documents,
+                  const Encoding &encoding, std::vector<std::byte> &output,
+                  const std::size_t parallelism =
+                      std::thread::hardware_concurrency(),
+                  const CacheOptions &cache_options = {}) -> void;
+
+/// @ingroup runtime
+/// Decode every record written by `encode_batch` with the same encoding, and
+/// the same dictionary if any, across the given number of threads, in the
+/// order in which they were encoded. For example:
+///
+/// ```cpp
+/// #include <sourcemeta/jsonbinpack/runtime.h>
+///
+/// const auto documents{
+///     sourcemeta::jsonbinpack::decode_batch(output, encoding)};
+/// ```
+SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT
+auto decode_batch(std::span<const std::byte> input, const Encoding &encoding,
+                  const std::size_t parallelism =
+                      std::thread::hardware_concurrency(),
+                  const Dictionary *dictionary = nullptr)
+    -> std::vector<sourcemeta::core::JSON>;
+
+} // namespace sourcemeta::jsonbinpack
+
+#endif
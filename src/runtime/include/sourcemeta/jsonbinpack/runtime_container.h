@@ -0,0 +1,174 @@
+#ifndef SOURCEMETA_JSONBINPACK_RUNTIME_CONTAINER_H_
+#define SOURCEMETA_JSONBINPACK_RUNTIME_CONTAINER_H_
+
+#ifndef SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT
+#include <sourcemeta/jsonbinpack/runtime_export.h>
+#endif
+
+#include <sourcemeta/jsonbinpack/runtime_dictionary.h>
+#include <sourcemeta/jsonbinpack/runtime_encoder.h>
+#include <sourcemeta/jsonbinpack/runtime_encoder_cache.h>
+#include <sourcemeta/jsonbinpack/runtime_encoding.h>
+#include <sourcemeta/jsonbinpack/runtime_output_stream.h>
+
+#include <sourcemeta/core/io.h>
+#include <sourcemeta/core/json.h>
+
+#include <cstddef>   // std::byte, std::size_t
+#include <cstdint>   // std::uint64_t
+#include <exception> // std::exception
+#include <span>      // std::span
+#include <thread>    // std::thread
+#include <utility>   // std::move
+#include <vector>    // std::vector
+
+namespace sourcemeta::jsonbinpack {
+
+/// @ingroup runtime
+/// A stable 64-bit digest of the given encoding, which only depends on the
+/// encodings and options involved and not on how they are laid out in memory
+SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT
+auto fingerprint(const Encoding &encoding) -> std::uint64_t;
+
+// Exporting symbols that depends on the standard C++ library is considered
+// safe.
+// https://learn.microsoft.com/en-us/cpp/error-messages/compiler-warnings/compiler-warning-level-2-c4275?view=msvc-170&redirectedfrom=MSDN
+#if defined(_MSC_VER)
+#pragma warning(disable : 4251 4275)
+#endif
+
+/// @ingroup runtime
+/// This class represents an input that is not a valid container for the
+/// given encoding
+class SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT ContainerError
+    : public std::exception {
+public:
+  ContainerError(sourcemeta::core::JSON::String message)
+      : message_{std::move(message)} {}
+
+  [[nodiscard]] auto what() const noexcept -> const char * override {
+    return this->message_.c_str();
+  }
+
+private:
+  sourcemeta::core::JSON::String message_;
+};
+
+/// @ingroup runtime
+/// Write many documents with the same encoding into a single container. A
+/// container starts with a header that identifies the encoding, and the
+/// dictionary of the cache options if any, through their fingerprint,
+/// continues with one length-prefixed frame per document, and ends with an
+/// index of where every frame starts. Frames are encoded on their own, so
+/// they can be decoded in any order and in parallel. For example:
+///
+/// ```cpp
+/// #include <sourcemeta/jsonbinpack/runtime.h>
+///
+/// std::vector<std::byte> output;
+/// sourcemeta::jsonbinpack::ContainerWriter writer{output, encoding};
+/// writer.write(sourcemeta::core::parse_json("{ \"id\": 1 }"));
+/// writer.write(sourcemeta::core::parse_json("{ \"id\": 2 }"));
+/// writer.close();
+/// ```
+///
+/// Nothing is readable until the container is closed, which writes the
+/// index. Writing to a buffer that already holds a closed container for the
+/// same encoding appends to it, replacing its index on close.
+class SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT ContainerWriter {
+public:
+  /// The caller must keep the buffer and the encoding alive while the writer
+  /// is in use
+  ContainerWriter(std::vector<std::byte> &output, const Encoding &encoding,
+                  const CacheOptions &cache_options = {});
+  /// The caller must keep the stream and the encoding alive while the writer
+  /// is in use
+  ContainerWriter(OutputStream::Stream &output, const Encoding &encoding,
+                  const CacheOptions &cache_options = {});
+
+  // Prevent copying, as this class is tied to an output resource
+  ContainerWriter(const ContainerWriter &) = delete;
+  ContainerWriter(ContainerWriter &&) = delete;
+  auto operator=(const ContainerWriter &) -> ContainerWriter & = delete;
+  auto operator=(ContainerWriter &&) -> ContainerWriter & = delete;
+
+  /// Encode a document into a new frame
+  auto write(const sourcemeta::core::JSON &document) -> void;
+  /// Encode many documents into new frames across the given number of threads
+  auto write(std::span<const sourcemeta::core::JSON> documents,
+             const std::size_t parallelism =
+                 std::thread::hardware_concurrency()) -> void;
+  /// Write the index, after which no more frames can be written
+  auto close() -> void;
+  /// The number of frames written so far
+  [[nodiscard]] auto size() const -> std::size_t;
+
+private:
+  auto header() -> void;
+  auto frame(std::span<const std::byte> bytes) -> void;
+
+  OutputStream stream_;
+  const Encoding &encoding_;
+  CacheOptions cache_options_;
+  std::vector<std::byte> record_;
+  Encoder encoder_;
+  // The position of every frame relative to the start of the container
+  std::vector<std::uint64_t> offsets_;
+  std::uint64_t position_{0};
+  bool closed_{false};
+};
+
+/// @ingroup runtime
+/// Read the documents of a container written by `ContainerWriter`, which is
+/// checked to match the given encoding and dictionary, if any. Reading a
+/// frame jumps to it through the index without looking at any other frame.
+/// For example:
+///
+/// ```cpp
+/// #include <sourcemeta/jsonbinpack/runtime.h>
+///
+/// const sourcemeta::core::FileView view{"records.jsonbinpack"};
+/// const sourcemeta::jsonbinpack::ContainerReader reader{view, encoding};
+/// const auto last{reader.read(reader.size() - 1)};
+/// ```
+///
+/// The caller must keep the input, the encoding, and the dictionary, if any,
+/// alive while the reader is in use. As reading does not modify the reader,
+/// many threads may read from the same reader at once.
+class SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT ContainerReader {
+public:
+  ContainerReader(std::span<const std::byte> input, const Encoding &encoding,
+                  const Dictionary *dictionary = nullptr);
+  ContainerReader(const sourcemeta::core::FileView &input,
+                  const Encoding &encoding,
+                  const Dictionary *dictionary = nullptr);
+
+  /// The number of frames in the container
+  [[nodiscard]] auto size() const -> std::size_t;
+  /// The encoded bytes of the given frame, without its length prefix
+  [[nodiscard]] auto frame(const std::size_t index) const
+      -> std::span<const std::byte>;
+  /// Decode the document of the given frame
+  [[nodiscard]] auto read(const std::size_t index) const
+      -> sourcemeta::core::JSON;
+  /// Decode the documents of every frame across the given number of threads
+  [[nodiscard]] auto read_all(const std::size_t parallelism =
+                                  std::thread::hardware_concurrency()) const
+      -> std::vector<sourcemeta::core::JSON>;
+
+private:
+  std::span<const std::byte> input_;
+  const Encoding &encoding_;
+  const Dictionary *dictionary_;
+  // Where the index starts
+  std::uint64_t index_;
+  std::uint64_t size_;
+};
+
+#if defined(_MSC_VER)
+#pragma warning(default : 4251 4275)
+#endif
+
+} // namespace sourcemeta::jsonbinpack
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef SOURCEMETA_JSONBINPACK_RUNTIME_DECODE_HANDLER_H_
+#define SOURCEMETA_JSONBINPACK_RUNTIME_DECODE_HANDLER_H_
+
+#ifndef SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT
+#include <sourcemeta/jsonbinpack/runtime_export.h>
+#endif
+
+#include <cstdint>     // std::int64_t, std::uint64_t
+#include <string_view> // std::string_view
+
+namespace sourcemeta::jsonbinpack {
+
+/// @ingroup runtime
+/// Receives the values of an encoded document in order as the decoder finds
+/// them, so that callers can consume them without building a JSON document.
+/// For example:
+///
+/// ```cpp
+/// #include <sourcemeta/jsonbinpack/runtime.h>
+///
+/// class Counter : public sourcemeta::jsonbinpack::DecodeHandler {
+/// public:
+///   auto null() -> void override {}
+///   auto boolean(const bool) -> void override {}
+///   auto integer(const std::int64_t value) -> void override {
+///     this->total += value;
+///   }
+///
+///   // ...
+///
+///   std::int64_t total{0};
+/// };
+///
+/// Counter counter;
+/// decoder.read(encoding, counter);
+/// ```
+///
+/// Every array starts with `start_array` and ends with `end_array`, with its
+/// items in between. Every object starts with `start_object` and ends with
+/// `end_object`, with each of its properties in between as a `key` followed
+/// by its value.
+///
+/// When decoding from memory, strings are views into the input wherever
+/// possible. In any case, string views are only valid until the callback
+/// returns, so they must be copied to be kept.
+class SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT DecodeHandler {
+public:
+  virtual ~DecodeHandler() = default;
+
+  virtual auto null() -> void = 0;
+  virtual auto boolean(const bool value) -> void = 0;
+  virtual auto integer(const std::int64_t value) -> void = 0;
+  virtual auto real(const double value) -> void = 0;
+  virtual auto string(const std::string_view value) -> void = 0;
+  /// The size is the number of items of the array
+  virtual auto start_array(const std::uint64_t size) -> void = 0;
+  virtual auto end_array() -> void = 0;
+  /// The size is the number of properties of the object
+  virtual auto start_object(const std::uint64_t size) -> void = 0;
+  virtual auto key(const std::string_view value) -> void = 0;
+  virtual auto end_object() -> void = 0;
+};
+
+} // namespace sourcemeta::jsonbinpack
+
+#endif
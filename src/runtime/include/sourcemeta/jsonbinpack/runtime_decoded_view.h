@@ -0,0 +1,107 @@
+#ifndef SOURCEMETA_JSONBINPACK_RUNTIME_DECODED_VIEW_H_
+#define SOURCEMETA_JSONBINPACK_RUNTIME_DECODED_VIEW_H_
+
+#ifndef SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT
+#include <sourcemeta/jsonbinpack/runtime_export.h>
+#endif
+
+#include <sourcemeta/jsonbinpack/runtime_decoder.h>
+#include <sourcemeta/jsonbinpack/runtime_encoding.h>
+
+#include <sourcemeta/core/json.h>
+
+#include <cstddef>  // std::byte, std::size_t
+#include <cstdint>  // std::int64_t, std::uint64_t
+#include <memory>   // std::shared_ptr
+#include <optional> // std::optional
+#include <span>     // std::span
+#include <vector>   // std::vector
+
+namespace sourcemeta::jsonbinpack {
+
+/// @ingroup runtime
+/// A view over an encoded value that decodes nothing upfront. Accessing an
+/// array item or an object property walks the encoded bytes, skipping over
+/// the values before it without decoding them, and only the values that are
+/// converted end up as JSON. For example:
+///
+/// ```cpp
+/// #include <sourcemeta/jsonbinpack/runtime.h>
+///
+/// const sourcemeta::jsonbinpack::DecodedView view{buffer, encoding};
+/// const auto identifier{view.at("items").at(3).at("id").to_integer()};
+/// ```
+///
+/// When the size of the skipped values follows from the encoding, such as
+/// for fixed-size arrays of fixed-size items, they are skipped without
+/// reading them at all. Length-prefixed arrays and objects are skipped in
+/// one go, and accessing an item of one with an offset table jumps to it
+/// directly.
+///
+/// The caller must keep the buffer, the encoding, and the dictionary, if any,
+/// alive while the view, or any view obtained from it, is in use. Views
+/// obtained from the same view share a decoder, so they must not be used
+/// concurrently.
+class SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT DecodedView {
+public:
+  DecodedView(std::span<const std::byte> input, const Encoding &encoding,
+              const Dictionary *dictionary = nullptr);
+
+  /// Get the array item at the given index, which must exist
+  [[nodiscard]] auto at(const std::size_t index) const -> DecodedView;
+  /// Get the value of the given object property, which must exist
+  [[nodiscard]] auto at(const sourcemeta::core::JSON::String &key) const
+      -> DecodedView;
+  /// Get the value of the given object property, if it exists
+  [[nodiscard]] auto try_at(const sourcemeta::core::JSON::String &key) const
+      -> std::optional<DecodedView>;
+  /// The number of items of an array or properties of an object
+  [[nodiscard]] auto size() const -> std::size_t;
+
+  /// Decode the value, and everything within it
+  [[nodiscard]] auto to_json() const -> sourcemeta::core::JSON;
+  [[nodiscard]] auto to_integer() const -> std::int64_t;
+  [[nodiscard]] auto to_real() const -> double;
+  [[nodiscard]] auto to_boolean() const -> bool;
+  [[nodiscard]] auto to_string() const -> sourcemeta::core::JSON::String;
+
+private:
+  DecodedView(std::shared_ptr<Decoder> decoder, const std::uint64_t offset,
+              const Encoding &encoding);
+
+  // How to walk an array or object, after reading its size
+  struct Container {
+    std::uint64_t size;
+    const Encoding *key_encoding;
+    const Encoding *encoding;
+    const std::vector<Encoding> *prefix_encodings;
+    // For containers followed by a table of the offsets of their items,
+    // where the items start and their byte length
+    bool offsets{false};
+    std::uint64_t items{0};
+    std::uint64_t length{0};
+  };
+
+  // Move the decoder past the size of the array or object
+  auto open() const -> Container;
+  // Find where an item starts by looking it up in the offset table
+  auto locate(const Container &container, const std::uint64_t index) const
+      -> std::uint64_t;
+
+// Exporting symbols that depends on the standard C++ library is considered
+// safe.
+// https://learn.microsoft.com/en-us/cpp/error-messages/compiler-warnings/compiler-warning-level-2-c4275?view=msvc-170&redirectedfrom=MSDN
+#if defined(_MSC_VER)
+#pragma warning(disable : 4251 4275)
+#endif
+  std::shared_ptr<Decoder> decoder_;
+#if defined(_MSC_VER)
+#pragma warning(default : 4251 4275)
+#endif
+  std::uint64_t offset_;
+  const Encoding *encoding_;
+};
+
+} // namespace sourcemeta::jsonbinpack
+
+#endif
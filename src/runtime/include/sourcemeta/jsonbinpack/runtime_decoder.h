@@ -5,18 +5,69 @@
 #include <sourcemeta/jsonbinpack/runtime_export.h>
 #endif
 
+#include <sourcemeta/jsonbinpack/runtime_decode_handler.h>
+#include <sourcemeta/jsonbinpack/runtime_decoder_cache.h>
 #include <sourcemeta/jsonbinpack/runtime_encoding.h>
 #include <sourcemeta/jsonbinpack/runtime_input_stream.h>
+#include <sourcemeta/jsonbinpack/runtime_plan.h>
 
+#include <sourcemeta/core/io.h>
 #include <sourcemeta/core/json.h>
 
+#include <cstddef>     // std::byte
+#include <cstdint>     // std::uint32_t, std::uint64_t
+#include <span>        // std::span
+#include <string_view> // std::string_view
+#include <vector>      // std::vector
+
 namespace sourcemeta::jsonbinpack {
 
+#ifndef DOXYGEN
+class DecodedView;
+class Dictionary;
+#endif
+
 /// @ingroup runtime
 class SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT Decoder : private InputStream {
 public:
-  Decoder(Stream &input);
+  /// Decoding input encoded with a dictionary requires the same dictionary,
+  /// which the caller must keep alive while the decoder is in use
+  Decoder(Stream &input, const Dictionary *dictionary = nullptr);
+  /// Decode directly out of a contiguous region of memory. The caller must
+  /// keep the buffer alive while the decoder is in use
+  Decoder(std::span<const std::byte> input,
+          const Dictionary *dictionary = nullptr);
+  /// Decode directly out of a memory-mapped file. The caller must keep the
+  /// file view alive while the decoder is in use
+  Decoder(const sourcemeta::core::FileView &input,
+          const Dictionary *dictionary = nullptr);
   auto read(const Encoding &encoding) -> sourcemeta::core::JSON;
+  /// Decode using an encoding resolved ahead of time. The result is the same
+  /// as decoding with the encoding the plan was resolved from
+  auto read(const Plan &plan) -> sourcemeta::core::JSON;
+  /// Decode by reporting every value to the given handler as it is found,
+  /// rather than building a JSON document out of them
+  auto read(const Encoding &encoding, DecodeHandler &handler) -> void;
+  /// Decode into compact JSON text appended to the given string, without
+  /// building a JSON document first. The text is the same as stringifying the
+  /// result of decoding with the same encoding. For example:
+  ///
+  /// ```cpp
+  /// #include <sourcemeta/jsonbinpack/runtime.h>
+  ///
+  /// sourcemeta::core::JSON::String text;
+  /// decoder.transcode(encoding, text);
+  /// ```
+  auto transcode(const Encoding &encoding,
+                 sourcemeta::core::JSON::String &output) -> void;
+
+  /// Start decoding a different input with the same dictionary, forgetting
+  /// about every string decoded so far. Unlike constructing a new decoder,
+  /// this retains the memory already allocated for shared strings, so that a
+  /// single decoder can be reused across messages
+  auto reset(Stream &input) -> void;
+  auto reset(std::span<const std::byte> input) -> void;
+  auto reset(const sourcemeta::core::FileView &input) -> void;
 
 // The methods that implement individual encodings as considered private
 #ifndef DOXYGEN
@@ -46,8 +97,7 @@ public:
   DECLARE_ENCODING(BOUNDED_8BIT_PREFIX_UTF8_STRING_SHARED)
   DECLARE_ENCODING(RFC3339_DATE_INTEGER_TRIPLET)
   DECLARE_ENCODING(PREFIX_VARINT_LENGTH_STRING_SHARED)
-  // TODO: Implement STRING_BROTLI encoding
-  // TODO: Implement STRING_DICTIONARY_COMPRESSOR encoding
+  DECLARE_ENCODING(GZIP_VARINT_PREFIX_UTF8_STRING)
   // TODO: Implement STRING_UNBOUNDED_SCOPED_PREFIX_LENGTH encoding
   // TODO: Implement URL_PROTOCOL_HOST_REST encoding
 
@@ -56,13 +106,75 @@ public:
   DECLARE_ENCODING(BOUNDED_8BITS_TYPED_ARRAY)
   DECLARE_ENCODING(FLOOR_TYPED_ARRAY)
   DECLARE_ENCODING(ROOF_TYPED_ARRAY)
+  DECLARE_ENCODING(FLOOR_TYPED_LENGTH_PREFIX_ARRAY)
 
   // Object
   DECLARE_ENCODING(FIXED_TYPED_ARBITRARY_OBJECT)
   DECLARE_ENCODING(VARINT_TYPED_ARBITRARY_OBJECT)
+  DECLARE_ENCODING(VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT)
+  DECLARE_ENCODING(MIXED_BOUNDED_TYPED_OBJECT)
 
 #undef DECLARE_ENCODING
 #endif
+
+private:
+  friend class DecodedView;
+
+  // Decode arrays and objects without copying their encodings
+  auto read_items(const std::uint64_t size, const Encoding &encoding,
+                  const std::vector<Encoding> &prefix_encodings)
+      -> sourcemeta::core::JSON;
+  auto read_entries(const std::uint64_t size, const Encoding &key_encoding,
+                    const Encoding &encoding) -> sourcemeta::core::JSON;
+  auto execute(const Plan &plan, const std::uint32_t index)
+      -> sourcemeta::core::JSON;
+  // Decode a string that later references may point to
+  auto read_string(const std::uint64_t length) -> sourcemeta::core::JSON;
+  // Decode a reference to a string decoded before, preferably without
+  // seeking back to it
+  auto read_string_reference(const std::uint64_t length)
+      -> sourcemeta::core::JSON;
+  // Advance past values without decoding them
+  auto skip(const Encoding &encoding) -> void;
+  auto skip_items(const std::uint64_t size, const Encoding &encoding,
+                  const std::vector<Encoding> &prefix_encodings) -> void;
+  auto skip_entries(const std::uint64_t size, const Encoding &key_encoding,
+                    const Encoding &encoding) -> void;
+  auto skip_any_packed() -> void;
+  auto skip_bytes(const std::uint64_t length) -> void;
+  // Report arrays and objects to a handler without copying their encodings
+  auto read_items(const std::uint64_t size, const Encoding &encoding,
+                  const std::vector<Encoding> &prefix_encodings,
+                  DecodeHandler &handler) -> void;
+  auto read_entries(const std::uint64_t size, const Encoding &key_encoding,
+                    const Encoding &encoding, DecodeHandler &handler) -> void;
+  auto read_any_packed(DecodeHandler &handler) -> void;
+  // Decode strings as views into the input when decoding from memory, or
+  // into a scratch buffer otherwise. Views are valid until the next read
+  auto read_string_view(const Encoding &encoding) -> std::string_view;
+  auto read_string_view(const std::uint64_t length) -> std::string_view;
+  auto read_string_reference_view(const std::uint64_t length)
+      -> std::string_view;
+  auto read_prefixed_string_view() -> std::string_view;
+  auto get_string_view(const std::uint64_t length) -> std::string_view;
+  // References that point before the start of the input
+  // refer to the entries of the dictionary, the first one last
+  auto dictionary_entry(const std::uint64_t position,
+                        const std::uint64_t relative_offset) const
+      -> const sourcemeta::core::JSON::String &;
+
+  DecoderCache cache_;
+  const Dictionary *dictionary_;
+// Exporting symbols that depends on the standard C++ library is considered
+// safe.
+// https://learn.microsoft.com/en-us/cpp/error-messages/compiler-warnings/compiler-warning-level-2-c4275?view=msvc-170&redirectedfrom=MSDN
+#if defined(_MSC_VER)
+#pragma warning(disable : 4251 4275)
+#endif
+  sourcemeta::core::JSON::String string_buffer_;
+#if defined(_MSC_VER)
+#pragma warning(default : 4251 4275)
+#endif
 };
 
 } // namespace sourcemeta::jsonbinpack
@@ -0,0 +1,66 @@
+#ifndef SOURCEMETA_JSONBINPACK_RUNTIME_DECODER_CACHE_H_
+#define SOURCEMETA_JSONBINPACK_RUNTIME_DECODER_CACHE_H_
+
+#ifndef SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT
+#include <sourcemeta/jsonbinpack/runtime_export.h>
+#endif
+
+#include <sourcemeta/core/json.h>
+
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint8_t, std::uint32_t, std::uint64_t
+#include <optional>    // std::optional
+#include <string_view> // std::string_view
+#include <vector>      // std::vector
+
+namespace sourcemeta::jsonbinpack {
+
+#ifndef DOXYGEN
+// An open-addressing hash table from the offsets at which strings were
+// decoded to such strings, so that references to them resolve without
+// seeking back and reading them again. The strings are copied into a single
+// arena, and entries for the same string can share their bytes
+class SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT DecoderCache {
+public:
+  enum class Type : std::uint8_t { Standalone, PrefixLengthVarintPlusOne };
+  // Returns the remembered copy of the string, which is valid until the next
+  // call to record or clear. Recording a view previously returned by this
+  // class reuses its bytes rather than copying them again
+  auto record(const std::uint64_t offset, const std::string_view value,
+              const Type type) -> std::string_view;
+  [[nodiscard]] auto find(const std::uint64_t offset, const Type type) const
+      -> std::optional<std::string_view>;
+  // Forget every entry while retaining the allocated memory
+  auto clear() -> void;
+
+private:
+  struct Entry {
+    std::uint64_t offset;
+    std::size_t begin;
+    std::size_t size;
+    Type type;
+  };
+
+  [[nodiscard]] auto lookup(const std::uint64_t offset, const Type type) const
+      -> std::size_t;
+  auto rehash(const std::size_t capacity) -> void;
+
+// Exporting symbols that depends on the standard C++ library is considered
+// safe.
+// https://learn.microsoft.com/en-us/cpp/error-messages/compiler-warnings/compiler-warning-level-2-c4275?view=msvc-170&redirectedfrom=MSDN
+#if defined(_MSC_VER)
+#pragma warning(disable : 4251 4275)
+#endif
+  std::vector<Entry> entries;
+  // Each slot holds an index into the entries plus one, or zero if empty
+  std::vector<std::uint32_t> slots;
+  std::vector<sourcemeta::core::JSON::Char> arena;
+#if defined(_MSC_VER)
+#pragma warning(default : 4251 4275)
+#endif
+};
+#endif
+
+} // namespace sourcemeta::jsonbinpack
+
+#endif
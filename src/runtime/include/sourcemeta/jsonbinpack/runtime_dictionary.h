@@ -0,0 +1,131 @@
+#ifndef SOURCEMETA_JSONBINPACK_RUNTIME_DICTIONARY_H_
+#define SOURCEMETA_JSONBINPACK_RUNTIME_DICTIONARY_H_
+
+#ifndef SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT
+#include <sourcemeta/jsonbinpack/runtime_export.h>
+#endif
+
+#include <sourcemeta/jsonbinpack/runtime_input_stream.h>
+#include <sourcemeta/jsonbinpack/runtime_output_stream.h>
+
+#include <sourcemeta/core/json.h>
+
+#include <cstddef>       // std::size_t
+#include <cstdint>       // std::uint64_t
+#include <exception>     // std::exception
+#include <optional>      // std::optional
+#include <span>          // std::span
+#include <unordered_map> // std::unordered_map
+#include <utility>       // std::move
+#include <vector>        // std::vector
+
+namespace sourcemeta::jsonbinpack {
+
+/// @ingroup runtime
+/// Controls which strings of a sample are worth adding to a dictionary
+struct DictionaryOptions {
+  /// Strings shorter than this are left out, as a reference to them would
+  /// not be any smaller than the string itself
+  std::size_t minimum_string_length{3};
+  /// Strings that occur in fewer documents of the sample than this are left
+  /// out, as they are unlikely to repeat across messages
+  std::size_t minimum_documents{2};
+  /// The maximum number of entries of the dictionary
+  std::size_t maximum_entries{4096};
+  /// The maximum combined byte length of the entries of the dictionary
+  std::uint64_t maximum_byte_size{1048576};
+};
+
+// Exporting symbols that depends on the standard C++ library is considered
+// safe.
+// https://learn.microsoft.com/en-us/cpp/error-messages/compiler-warnings/compiler-warning-level-2-c4275?view=msvc-170&redirectedfrom=MSDN
+#if defined(_MSC_VER)
+#pragma warning(disable : 4251 4275)
+#endif
+
+/// @ingroup runtime
+/// This class represents an input that is not a valid dictionary
+class SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT DictionaryError
+    : public std::exception {
+public:
+  DictionaryError(sourcemeta::core::JSON::String message)
+      : message_{std::move(message)} {}
+
+  [[nodiscard]] auto what() const noexcept -> const char * override {
+    return this->message_.c_str();
+  }
+
+private:
+  sourcemeta::core::JSON::String message_;
+};
+
+/// @ingroup runtime
+/// A set of strings known upfront to both the encoder and the decoder, so
+/// that every message can refer to them rather than repeating them, such as
+/// the property names and enumeration-like values that a stream of small
+/// records has in common. Shared strings refer to a dictionary entry as if
+/// the entries preceded the start of the message, so messages without
+/// dictionary references are encoded as usual. For example:
+///
+/// ```cpp
+/// #include <sourcemeta/jsonbinpack/runtime.h>
+///
+/// sourcemeta::jsonbinpack::Dictionary dictionary;
+/// dictionary.train(sample);
+///
+/// std::vector<std::byte> buffer;
+/// sourcemeta::jsonbinpack::Encoder encoder{buffer,
+///                                          {.dictionary = &dictionary}};
+/// encoder.write(document, encoding);
+///
+/// sourcemeta::jsonbinpack::Decoder decoder{buffer, &dictionary};
+/// const auto result{decoder.read(encoding)};
+/// ```
+///
+/// Entries are only ever appended, so a message encoded with a dictionary
+/// decodes with any dictionary that starts with the same entries. The
+/// identifier tells dictionaries apart. As references to entries depend on
+/// where the encoder started writing, the decoder must start reading at the
+/// same point.
+class SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT Dictionary {
+public:
+  Dictionary() = default;
+  /// Read a dictionary written by `write`
+  Dictionary(InputStream &input);
+
+  /// Append the strings of the sample that are worth referring to across
+  /// messages, starting with the ones that would save the most bytes. This
+  /// may be called many times to grow the dictionary over time
+  auto train(std::span<const sourcemeta::core::JSON> sample,
+             const DictionaryOptions &options = {}) -> void;
+  /// Append a string, unless it is already an entry. This returns whether
+  /// the string was appended
+  auto add(const sourcemeta::core::JSON::String &value) -> bool;
+
+  /// The index of the entry that holds the given string, if any
+  [[nodiscard]] auto find(const sourcemeta::core::JSON::String &value) const
+      -> std::optional<std::uint64_t>;
+  /// The string held by the given entry, which must exist
+  [[nodiscard]] auto at(const std::uint64_t index) const
+      -> const sourcemeta::core::JSON::String &;
+  /// The number of entries
+  [[nodiscard]] auto size() const -> std::size_t;
+  /// A stable 64-bit digest of the entries, in order, to tell apart the
+  /// different versions of a dictionary
+  [[nodiscard]] auto identifier() const -> std::uint64_t;
+
+  /// Write the dictionary out, to share it with the other end
+  auto write(OutputStream &output) const -> void;
+
+private:
+  std::vector<sourcemeta::core::JSON::String> entries_;
+  std::unordered_map<sourcemeta::core::JSON::String, std::uint64_t> index_;
+};
+
+#if defined(_MSC_VER)
+#pragma warning(default : 4251 4275)
+#endif
+
+} // namespace sourcemeta::jsonbinpack
+
+#endif
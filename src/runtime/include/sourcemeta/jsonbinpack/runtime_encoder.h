@@ -8,17 +8,66 @@
 #include <sourcemeta/jsonbinpack/runtime_encoder_cache.h>
 #include <sourcemeta/jsonbinpack/runtime_encoding.h>
 #include <sourcemeta/jsonbinpack/runtime_output_stream.h>
+#include <sourcemeta/jsonbinpack/runtime_plan.h>
 
 #include <sourcemeta/core/json.h>
 
+#include <cstddef>     // std::byte, std::size_t
+#include <cstdint>     // std::uint8_t, std::uint32_t, std::uint64_t
+#include <deque>       // std::deque
+#include <optional>    // std::optional
+#include <span>        // std::span
+#include <string_view> // std::string_view
+#include <vector>      // std::vector
+
 namespace sourcemeta::jsonbinpack {
 
 /// @ingroup runtime
 class SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT Encoder : private OutputStream {
 public:
-  Encoder(Stream &output);
+  /// The cache options control the memory the encoder may spend on
+  /// remembering strings to share repeated occurrences of them
+  Encoder(Stream &output, const CacheOptions &cache_options = {});
+  /// Encode by appending to a growable buffer. The caller must keep the buffer
+  /// alive while the encoder is in use
+  Encoder(std::vector<std::byte> &output,
+          const CacheOptions &cache_options = {});
+  /// Encode into a fixed region of memory. Running out of space throws
+  /// `sourcemeta::core::IOStreamWriteError`. The caller must keep the buffer
+  /// alive while the encoder is in use
+  Encoder(std::span<std::byte> output, const CacheOptions &cache_options = {});
+
+  /// The bytes encoded so far, when encoding into memory
+  using OutputStream::bytes;
+
+  /// Start encoding into a different output, forgetting about every string
+  /// written so far. Unlike constructing a new encoder, this retains the
+  /// memory already allocated for the shared string cache, so that a single
+  /// encoder can be reused across messages
+  auto reset(Stream &output) -> void;
+  auto reset(std::vector<std::byte> &output) -> void;
+  auto reset(std::span<std::byte> output) -> void;
+
   auto write(const sourcemeta::core::JSON &document, const Encoding &encoding)
       -> void;
+  /// Encode using an encoding resolved ahead of time. The output is the same
+  /// as encoding with the encoding the plan was resolved from
+  auto write(const sourcemeta::core::JSON &document, const Plan &plan) -> void;
+  /// Encode JSON text using `ANY_PACKED_TYPE_TAG_BYTE_PREFIX` without parsing
+  /// it into a document first. A first pass over the text only counts the
+  /// items and properties of each array and object, as the encoding writes
+  /// them before their contents. The output decodes to the same document as
+  /// parsing the text would result in. Invalid text throws
+  /// `sourcemeta::core::JSONParseError`. For example:
+  ///
+  /// ```cpp
+  /// #include <sourcemeta/jsonbinpack/runtime.h>
+  ///
+  /// std::vector<std::byte> buffer;
+  /// sourcemeta::jsonbinpack::Encoder encoder{buffer};
+  /// encoder.transcode("{ \"foo\": [ 1, 2, 3 ] }");
+  /// ```
+  auto transcode(const std::string_view text) -> void;
 
 // The methods that implement individual encodings as considered private
 #ifndef DOXYGEN
@@ -48,8 +97,7 @@ public:
   DECLARE_ENCODING(BOUNDED_8BIT_PREFIX_UTF8_STRING_SHARED)
   DECLARE_ENCODING(RFC3339_DATE_INTEGER_TRIPLET)
   DECLARE_ENCODING(PREFIX_VARINT_LENGTH_STRING_SHARED)
-  // TODO: Implement STRING_BROTLI encoding
-  // TODO: Implement STRING_DICTIONARY_COMPRESSOR encoding
+  DECLARE_ENCODING(GZIP_VARINT_PREFIX_UTF8_STRING)
   // TODO: Implement STRING_UNBOUNDED_SCOPED_PREFIX_LENGTH encoding
   // TODO: Implement URL_PROTOCOL_HOST_REST encoding
 
@@ -58,16 +106,61 @@ public:
   DECLARE_ENCODING(BOUNDED_8BITS_TYPED_ARRAY)
   DECLARE_ENCODING(FLOOR_TYPED_ARRAY)
   DECLARE_ENCODING(ROOF_TYPED_ARRAY)
+  DECLARE_ENCODING(FLOOR_TYPED_LENGTH_PREFIX_ARRAY)
 
   // Object
   DECLARE_ENCODING(FIXED_TYPED_ARBITRARY_OBJECT)
   DECLARE_ENCODING(VARINT_TYPED_ARBITRARY_OBJECT)
+  DECLARE_ENCODING(VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT)
+  DECLARE_ENCODING(MIXED_BOUNDED_TYPED_OBJECT)
 
 #undef DECLARE_ENCODING
 #endif
 
 private:
+  // Encode arrays and objects without copying their encodings
+  auto write_items(const sourcemeta::core::JSON &document,
+                   const Encoding &encoding,
+                   const std::vector<Encoding> &prefix_encodings) -> void;
+  auto write_entries(const sourcemeta::core::JSON &document,
+                     const Encoding &key_encoding, const Encoding &encoding)
+      -> void;
+  auto execute(const sourcemeta::core::JSON &document, const Plan &plan,
+               const std::uint32_t index) -> void;
+  // The type tag and size of an array or object of the any packed encoding
+  auto put_any_packed_container(const std::uint8_t type,
+                                const std::uint64_t size) -> void;
+  // The items of length-prefixed arrays and objects are encoded into a
+  // scratch buffer first, as their byte length must be written before them.
+  // Diverting the output into the buffer keeps positions absolute, so shared
+  // strings may point in and out of the items
+  auto divert_length_prefixed() -> Diversion;
+  // Write the byte length of the diverted items, the items, and the given
+  // offsets of each item relative to the first one, if any
+  auto put_length_prefixed(const Diversion &previous,
+                           const std::vector<std::uint64_t> &offsets) -> void;
+  // Where an earlier occurrence of the string is, if any, to refer to it. A
+  // dictionary entry is at an offset before the start of the output, so
+  // that the relative offset to it, which wraps around, is past the start
+  auto find_shared(const sourcemeta::core::JSON::String &value,
+                   const Cache::Type type) const
+      -> std::optional<std::uint64_t>;
+
   Cache cache_;
+  const Dictionary *dictionary_;
+// Exporting symbols that depends on the standard C++ library is considered
+// safe.
+// https://learn.microsoft.com/en-us/cpp/error-messages/compiler-warnings/compiler-warning-level-2-c4275?view=msvc-170&redirectedfrom=MSDN
+#if defined(_MSC_VER)
+#pragma warning(disable : 4251 4275)
+#endif
+  // One buffer per level of nested length-prefixed containers, kept around
+  // to avoid allocating them again for every container
+  std::deque<std::vector<std::byte>> scratch_;
+  std::size_t scratch_depth_{0};
+#if defined(_MSC_VER)
+#pragma warning(default : 4251 4275)
+#endif
 };
 
 } // namespace sourcemeta::jsonbinpack
@@ -1,6 +1,5 @@
 #ifndef SOURCEMETA_JSONBINPACK_RUNTIME_ENCODER_CACHE_H_
 #define SOURCEMETA_JSONBINPACK_RUNTIME_ENCODER_CACHE_H_
-#ifndef DOXYGEN
 
 #ifndef SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT
 #include <sourcemeta/jsonbinpack/runtime_export.h>
@@ -8,44 +7,143 @@
 
 #include <sourcemeta/core/json.h>
 
-#include <functional> // std::reference_wrapper
-#include <map>        // std::map
-#include <optional>   // std::optional
-#include <utility>    // std::pair
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint8_t, std::uint32_t, std::uint64_t
+#include <deque>       // std::deque
+#include <limits>      // std::numeric_limits
+#include <memory>      // std::unique_ptr
+#include <optional>    // std::optional
+#include <string_view> // std::string_view
+#include <vector>      // std::vector
 
 namespace sourcemeta::jsonbinpack {
 
+#ifndef DOXYGEN
+class Dictionary;
+#endif
+
+/// @ingroup runtime
+/// Controls how the encoder remembers strings it already wrote, so that
+/// repeated occurrences can be encoded as references to the first one
+struct CacheOptions {
+  /// What to do when recording a string would exceed the limits
+  enum class Eviction : std::uint8_t {
+    /// Forget the strings that were written the longest ago
+    Oldest,
+    /// Stop remembering new strings
+    Reject
+  };
+
+  /// Whether to share strings at all. Disabling it skips the cache entirely,
+  /// which favours latency over size for small messages
+  bool sharing{true};
+  /// Strings shorter than this are never shared, as the reference would not
+  /// be any smaller than the string itself
+  std::size_t minimum_string_length{3};
+  /// The maximum combined byte length of the remembered strings
+  std::uint64_t maximum_byte_size{20971520};
+  /// The maximum number of remembered strings
+  std::size_t maximum_entries{std::numeric_limits<std::size_t>::max()};
+  Eviction eviction{Eviction::Oldest};
+  /// Strings held by this dictionary, if any, are encoded as references to
+  /// it the first time they occur in a message too, even if the encoder does
+  /// not share strings otherwise. The caller must keep the dictionary alive
+  /// while the encoder is in use, and decode with the same dictionary
+  const Dictionary *dictionary{nullptr};
+};
+
+#ifndef DOXYGEN
+// An open-addressing hash table from strings to their latest offsets. The
+// strings are copied into an arena of chunks, each of which is released as
+// soon as none of its strings remain. The strings that remain are compacted
+// together when they pin down an arena more than twice their size
 class SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT Cache {
 public:
+  Cache(const CacheOptions &cache_options = {});
+
   enum class Type : std::uint8_t { Standalone, PrefixLengthVarintPlusOne };
   auto record(const sourcemeta::core::JSON::String &value,
               const std::uint64_t offset, const Type type) -> void;
   [[nodiscard]] auto find(const sourcemeta::core::JSON::String &value,
                           const Type type) const
       -> std::optional<std::uint64_t>;
+  // Forget every entry while retaining the allocated memory
+  auto clear() -> void;
 
 #ifndef DOXYGEN
-  // This method is considered private. We only expose it for testing purposes
+  // These methods are considered private. We only expose them for testing
+  // purposes
   auto remove_oldest() -> void;
+  [[nodiscard]] auto arena_size() const -> std::size_t;
 #endif
 
 private:
+  struct Entry {
+    std::string_view value;
+    std::size_t hash;
+    std::uint64_t offset;
+    // Bumped every time the entry moves within the eviction order or is
+    // released, to detect outdated references to it in such order
+    std::uint64_t generation;
+    std::uint64_t chunk;
+    Type type;
+  };
+
+  struct Order {
+    std::uint64_t offset;
+    std::uint32_t entry;
+    std::uint64_t generation;
+  };
+
+  struct Chunk {
+    std::unique_ptr<char[]> data;
+    std::size_t capacity;
+    std::size_t size;
+    std::size_t references;
+  };
+
+  [[nodiscard]] auto lookup(const std::string_view value,
+                            const std::size_t hash, const Type type) const
+      -> std::size_t;
+  auto rehash(const std::size_t capacity) -> void;
+  auto enqueue(const std::uint32_t entry) -> void;
+  auto allocate(const std::string_view value) -> std::string_view;
+  auto add_chunk(const std::size_t minimum) -> void;
+  auto free_chunk(const std::size_t chunk) -> void;
+  auto compact() -> void;
+  auto release(const std::uint64_t chunk) -> void;
+
 // Exporting symbols that depends on the standard C++ library is considered
 // safe.
 // https://learn.microsoft.com/en-us/cpp/error-messages/compiler-warnings/compiler-warning-level-2-c4275?view=msvc-170&redirectedfrom=MSDN
 #if defined(_MSC_VER)
 #pragma warning(disable : 4251 4275)
 #endif
+  const CacheOptions options;
   std::uint64_t byte_size{0};
-  using Entry = std::pair<sourcemeta::core::JSON::String, Type>;
-  std::map<Entry, std::uint64_t> data;
-  std::map<std::uint64_t, std::reference_wrapper<const Entry>> order;
+  std::size_t size{0};
+  std::vector<Entry> entries;
+  std::vector<std::uint32_t> free_entries;
+  // Each slot holds an index into the entries plus one, or zero if empty
+  std::vector<std::uint32_t> slots;
+  // Sorted by offset, so the front is always the oldest entry
+  std::deque<Order> order;
+  std::size_t stale{0};
+  // Released chunks leave an empty hole to be reused by the next chunk
+  std::vector<Chunk> chunks;
+  std::vector<std::size_t> free_chunks;
+  // The chunk that new strings are copied into, if any
+  std::optional<std::size_t> current_chunk;
+  // The combined capacity of the chunks in use
+  std::size_t arena_byte_size{0};
+  // Empty chunks of the minimum size retained by clearing the cache
+  std::vector<Chunk> spare_chunks;
 #if defined(_MSC_VER)
 #pragma warning(default : 4251 4275)
 #endif
 };
+#endif
 
 } // namespace sourcemeta::jsonbinpack
 
 #endif
-#endif
@@ -4,10 +4,11 @@
 #include <sourcemeta/core/json.h>
 #include <sourcemeta/core/numeric.h>
 
-#include <cstdint> // std::int64_t, std::uint64_t
-#include <memory>  // std::shared_ptr
-#include <variant> // std::variant
-#include <vector>  // std::vector
+#include <cstdint>       // std::int64_t, std::uint64_t
+#include <memory>        // std::shared_ptr
+#include <unordered_map> // std::unordered_multimap
+#include <variant>       // std::variant
+#include <vector>        // std::vector
 
 namespace sourcemeta::jsonbinpack {
 
@@ -36,6 +37,10 @@ struct FLOOR_TYPED_ARRAY;
 struct ROOF_TYPED_ARRAY;
 struct FIXED_TYPED_ARBITRARY_OBJECT;
 struct VARINT_TYPED_ARBITRARY_OBJECT;
+struct FLOOR_TYPED_LENGTH_PREFIX_ARRAY;
+struct VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT;
+struct GZIP_VARINT_PREFIX_UTF8_STRING;
+struct MIXED_BOUNDED_TYPED_OBJECT;
 #endif
 
 /// @ingroup runtime
@@ -50,7 +55,17 @@ using Encoding = std::variant<
     BOUNDED_8BIT_PREFIX_UTF8_STRING_SHARED, RFC3339_DATE_INTEGER_TRIPLET,
     PREFIX_VARINT_LENGTH_STRING_SHARED, FIXED_TYPED_ARRAY,
     BOUNDED_8BITS_TYPED_ARRAY, FLOOR_TYPED_ARRAY, ROOF_TYPED_ARRAY,
-    FIXED_TYPED_ARBITRARY_OBJECT, VARINT_TYPED_ARBITRARY_OBJECT>;
+    FIXED_TYPED_ARBITRARY_OBJECT, VARINT_TYPED_ARBITRARY_OBJECT,
+    FLOOR_TYPED_LENGTH_PREFIX_ARRAY,
+    VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT,
+    GZIP_VARINT_PREFIX_UTF8_STRING, MIXED_BOUNDED_TYPED_OBJECT>;
+
+/// @ingroup runtime
+/// Maps the hashes of enumeration choices to their positions, so that the
+/// encoder can find a value without comparing it against every choice. The
+/// loader builds it for the choice encodings. If it is empty, the encoder
+/// looks for the value in the choices one by one
+using ChoiceIndex = std::unordered_multimap<std::uint64_t, std::uint64_t>;
 
 /// @ingroup runtime
 /// @defgroup encoding_integer Integer Encodings
@@ -302,6 +317,8 @@ struct DOUBLE_VARINT_TUPLE {};
 struct BYTE_CHOICE_INDEX {
   /// The set of choice values
   std::vector<sourcemeta::core::JSON> choices;
+  /// An optional index of the choices, which must match them
+  ChoiceIndex index{};
 };
 
 // clang-format off
@@ -336,6 +353,8 @@ struct BYTE_CHOICE_INDEX {
 struct LARGE_CHOICE_INDEX {
   /// The set of choice values
   std::vector<sourcemeta::core::JSON> choices;
+  /// An optional index of the choices, which must match them
+  ChoiceIndex index{};
 };
 
 // clang-format off
@@ -375,6 +394,8 @@ struct LARGE_CHOICE_INDEX {
 struct TOP_LEVEL_BYTE_CHOICE_INDEX {
   /// The set of choice values
   std::vector<sourcemeta::core::JSON> choices;
+  /// An optional index of the choices, which must match them
+  ChoiceIndex index{};
 };
 
 // clang-format off
@@ -754,6 +775,38 @@ struct RFC3339_DATE_INTEGER_TRIPLET {};
 // clang-format on
 struct PREFIX_VARINT_LENGTH_STRING_SHARED {};
 
+// clang-format off
+/// @brief The encoding consists of the byte-length of the string as a
+/// Base-128 64-bit Little Endian variable-length unsigned integer, followed by
+/// the byte-length of the GZIP (RFC 1952) compressed UTF-8 encoding of the
+/// input value as a Base-128 64-bit Little Endian variable-length unsigned
+/// integer, followed by the compressed bytes.
+///
+/// This encoding trades speed for size, so it is only worth it for long
+/// strings of natural language or other repetitive text. Short strings result
+/// in more bytes than the string itself, given the GZIP header and trailer.
+///
+/// ### Options
+///
+/// None
+///
+/// ### Conditions
+///
+/// None
+///
+/// ### Examples
+///
+/// Given the input string `foo foo foo foo`, the encoding results in:
+///
+/// ```
+/// +------+------+------+------+-----+------+
+/// | 0x0f | 0x26 | 0x1f | 0x8b | ... | 0x00 |
+/// +------+------+------+------+-----+------+
+///   15     38     GZIP member
+/// ```
+// clang-format on
+struct GZIP_VARINT_PREFIX_UTF8_STRING {};
+
 /// @}
 
 /// @ingroup runtime
@@ -946,6 +999,63 @@ struct ROOF_TYPED_ARRAY {
   std::vector<Encoding> prefix_encodings;
 };
 
+// clang-format off
+/// @brief The encoding consists of the length of the array minus `minimum`
+/// encoded as a Base-128 64-bit Little Endian variable-length unsigned integer,
+/// followed by the byte length of the elements as a 32-bit Little Endian
+/// unsigned integer, followed by the elements of the array encoded in order.
+/// The encoding of the element at index `i` is either `prefix_encodings[i]` if
+/// set, or `encoding`.
+///
+/// If `offsets` is set, the elements are followed by a table with the position
+/// of each element relative to the first one, in order. Each entry of the
+/// table is a Little Endian unsigned integer of 1 byte if the byte length of
+/// the elements fits in 8 bits, of 2 bytes if it fits in 16 bits, or of 4
+/// bytes otherwise.
+///
+/// The byte length lets readers skip over the array without decoding its
+/// elements, and the table lets readers jump to any element directly.
+///
+/// ### Options
+///
+/// | Option            | Type         | Description                            |
+/// |-------------------|--------------|----------------------------------------|
+/// | `minimum`         | `uint`       | The minimum length of the array        |
+/// | `prefixEncodings` | `encoding[]` | Positional encodings                   |
+/// | `encoding`        | `encoding`   | Element encoding                       |
+/// | `offsets`         | `boolean`    | Whether to include the table (false)   |
+///
+/// ### Conditions
+///
+/// | Condition                           | Description                                                          |
+/// |-------------------------------------|----------------------------------------------------------------------|
+/// | `len(value) >= minimum`             | The length of the array must be greater than or equal to the minimum |
+/// | `len(encoded elements) < 2 ^ 32`    | The encoded elements must fit in 4 GiB                               |
+///
+/// ### Examples
+///
+/// Given the array `[ "foo", "ba" ]` where the minimum is 0, `encoding`
+/// corresponds to FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED with minimum 0, and
+/// `offsets` is set, the encoding results in:
+///
+/// ```
+/// +------+------+------+------+------+------+------+------+------+------+------+------+------+------+
+/// | 0x02 | 0x07 | 0x00 | 0x00 | 0x00 | 0x04 | 0x66 | 0x6f | 0x6f | 0x03 | 0x62 | 0x61 | 0x00 | 0x04 |
+/// +------+------+------+------+------+------+------+------+------+------+------+------+------+------+
+///   size   byte length                 3      f      o      o      2      b      a      0      4
+/// ```
+// clang-format on
+struct FLOOR_TYPED_LENGTH_PREFIX_ARRAY {
+  /// The minimum length of the array
+  std::uint64_t minimum;
+  /// Element encoding
+  std::shared_ptr<Encoding> encoding;
+  /// Positional encodings
+  std::vector<Encoding> prefix_encodings;
+  /// Whether to follow the elements with a table of their positions
+  bool offsets{false};
+};
+
 /// @}
 
 /// @ingroup runtime
@@ -1047,6 +1157,104 @@ struct VARINT_TYPED_ARBITRARY_OBJECT {
   std::shared_ptr<Encoding> encoding;
 };
 
+// clang-format off
+/// @brief The encoding consists of the number of key-value pairs in the input
+/// object as a Base-128 64-bit Little Endian variable-length unsigned integer,
+/// followed by the byte length of the pairs as a 32-bit Little Endian unsigned
+/// integer, followed by each pair encoded as the key followed by the value
+/// according to `key_encoding` and `encoding`. The order in which pairs are
+/// encoded is undefined.
+///
+/// If `offsets` is set, the pairs are followed by a table with the position of
+/// each pair relative to the first one, in order, with entries as described
+/// for FLOOR_TYPED_LENGTH_PREFIX_ARRAY.
+///
+/// ### Options
+///
+/// | Option        | Type       | Description                          |
+/// |---------------|------------|--------------------------------------|
+/// | `keyEncoding` | `encoding` | Key encoding                         |
+/// | `encoding`    | `encoding` | Value encoding                       |
+/// | `offsets`     | `boolean`  | Whether to include the table (false) |
+///
+/// ### Conditions
+///
+/// | Condition                     | Description                         |
+/// |-------------------------------|-------------------------------------|
+/// | `len(encoded pairs) < 2 ^ 32` | The encoded pairs must fit in 4 GiB |
+///
+/// ### Examples
+///
+/// Given the object `{ "foo": 1, "bar": 2 }` where `keyEncoding` corresponds
+/// to UTF8_STRING_NO_LENGTH (size 3), `encoding` corresponds to
+/// BOUNDED_MULTIPLE_8BITS_ENUM_FIXED (minimum 0, maximum 10,
+/// multiplier 1), and `offsets` is not set, the encoding results in:
+///
+/// ```
+/// +------+------+------+------+------+------+------+------+------+------+------+------+------+
+/// | 0x02 | 0x08 | 0x00 | 0x00 | 0x00 | 0x66 | 0x6f | 0x6f | 0x01 | 0x62 | 0x61 | 0x72 | 0x02 |
+/// +------+------+------+------+------+------+------+------+------+------+------+------+------+
+///   2      byte length                 f      o      o      1      b      a      r      2
+/// ```
+// clang-format on
+struct VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT {
+  /// Key encoding
+  std::shared_ptr<Encoding> key_encoding;
+  /// Value encoding
+  std::shared_ptr<Encoding> encoding;
+  /// Whether to follow the pairs with a table of their positions
+  bool offsets{false};
+};
+
+// clang-format off
+/// @brief The encoding consists of a bitmap of which optional properties are
+/// present, one bit per optional property in order starting at the least
+/// significant bit of the first byte, followed by the values of the required
+/// properties, in order, followed by the values of the present optional
+/// properties, in order. Property names are never encoded, and the bitmap is
+/// omitted if there are no optional properties. Leading with the bitmap means
+/// that the number of properties is known before reading any of them.
+///
+/// ### Options
+///
+/// | Option               | Type                    | Description                    |
+/// |----------------------|-------------------------|--------------------------------|
+/// | `requiredProperties` | `string[]`              | The properties that must exist |
+/// | `optionalProperties` | `string[]`              | The properties that may exist  |
+/// | `propertyEncodings`  | `map<string, encoding>` | The encoding of each property  |
+///
+/// ### Conditions
+///
+/// | Condition                                                | Description                                          |
+/// |----------------------------------------------------------|------------------------------------------------------|
+/// | `requiredProperties in keys(value)`                      | The input object must define every required property |
+/// | `keys(value) in requiredProperties + optionalProperties` | The input object must not define other properties    |
+///
+/// ### Examples
+///
+/// Given the object `{ "id": 5, "tag": "bar" }` where `requiredProperties`
+/// is `[ "id" ]`, `optionalProperties` is `[ "name", "tag" ]`, `id` corresponds
+/// to BOUNDED_MULTIPLE_8BITS_ENUM_FIXED (minimum 0, maximum 10, multiplier
+/// 1), and `name` and `tag` correspond to UTF8_STRING_NO_LENGTH (size 3), the
+/// encoding results in:
+///
+/// ```
+/// +------+------+------+------+------+
+/// | 0x02 | 0x05 | 0x62 | 0x61 | 0x72 |
+/// +------+------+------+------+------+
+///   tag    5      b      a      r
+/// ```
+// clang-format on
+struct MIXED_BOUNDED_TYPED_OBJECT {
+  /// The properties that the object must define, in order
+  std::vector<sourcemeta::core::JSON::String> required;
+  /// The properties that the object may define, in order
+  std::vector<sourcemeta::core::JSON::String> optional;
+  /// The encoding of each required property followed by the encoding of each
+  /// optional property, in order
+  std::vector<Encoding> encodings;
+};
+
 /// @}
 
 } // namespace sourcemeta::jsonbinpack
@@ -8,26 +8,83 @@
 #include <sourcemeta/core/io.h>
 #include <sourcemeta/core/json.h>
 
-#include <cstdint> // std::uint64_t, std::int64_t
-#include <istream> // std::basic_istream
+#include <cstddef>  // std::byte, std::size_t
+#include <cstdint>  // std::uint8_t, std::uint16_t, std::uint32_t, std::int64_t
+#include <istream>  // std::basic_istream
+#include <optional> // std::optional
+#include <span>     // std::span
 
 namespace sourcemeta::jsonbinpack {
 
 /// @ingroup runtime
-class SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT InputStream
-    : public sourcemeta::core::BinaryReader {
+/// An input source for the decoder. It may either wrap a standard input stream
+/// or read directly out of a contiguous region of memory, such as a
+/// memory-mapped file. In the latter case, every read is a bounds-checked
+/// pointer operation that does not go through the standard stream machinery.
+class SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT InputStream {
 public:
   using Stream = std::basic_istream<sourcemeta::core::JSON::Char,
                                     sourcemeta::core::JSON::CharTraits>;
   InputStream(Stream &input);
+  /// The caller must keep the buffer alive while the input stream is in use
+  InputStream(std::span<const std::byte> input);
+  /// The caller must keep the file view alive while the input stream is in use
+  InputStream(const sourcemeta::core::FileView &input);
+
+  // Prevent copying, as this class is tied to an input resource
+  InputStream(const InputStream &) = delete;
+  InputStream(InputStream &&) = delete;
+  auto operator=(const InputStream &) -> InputStream & = delete;
+  auto operator=(InputStream &&) -> InputStream & = delete;
+
+  /// Start reading from a different input, as if the input stream was
+  /// constructed again
+  auto reset(Stream &input) -> void;
+  auto reset(std::span<const std::byte> input) -> void;
+  auto reset(const sourcemeta::core::FileView &input) -> void;
+
+  auto get_byte() -> std::uint8_t;
+  auto get_word() -> std::uint16_t;
+  auto get_dword() -> std::uint32_t;
+  auto get_bytes(std::byte *destination, const std::size_t size) -> void;
+  [[nodiscard]] auto position() const -> std::size_t;
+  auto seek(const std::size_t position) -> void;
+  [[nodiscard]] auto has_more_data() const -> bool;
 
   // Seek backwards given a relative offset
   auto rewind(const std::uint64_t relative_offset, const std::uint64_t position)
       -> std::uint64_t;
   auto get_varint() -> std::uint64_t;
+  /// Decode as many consecutive varints as the output has room for
+  auto get_varints(std::span<std::uint64_t> output) -> void;
   auto get_varint_zigzag() -> std::int64_t;
   auto get_string_utf8(const std::uint64_t length)
       -> sourcemeta::core::JSON::String;
+
+  /// Whether the input is a contiguous region of memory
+  [[nodiscard]] auto in_memory() const -> bool;
+  /// The bytes at the given position of the input, without copying them. This
+  /// is only available when reading from memory
+  [[nodiscard]] auto bytes(const std::size_t position,
+                           const std::size_t size) const
+      -> std::span<const std::byte>;
+
+private:
+// Exporting symbols that depends on the standard C++ library is considered
+// safe.
+// https://learn.microsoft.com/en-us/cpp/error-messages/compiler-warnings/compiler-warning-level-2-c4275?view=msvc-170&redirectedfrom=MSDN
+#if defined(_MSC_VER)
+#pragma warning(disable : 4251 4275)
+#endif
+  // Only set when reading from a standard input stream
+  std::optional<sourcemeta::core::BinaryReader> reader_;
+  // Only meaningful when reading from memory
+  const std::byte *begin_{nullptr};
+  const std::byte *end_{nullptr};
+  const std::byte *cursor_{nullptr};
+#if defined(_MSC_VER)
+#pragma warning(default : 4251 4275)
+#endif
 };
 
 } // namespace sourcemeta::jsonbinpack
@@ -8,23 +8,91 @@
 #include <sourcemeta/core/io.h>
 #include <sourcemeta/core/json.h>
 
-#include <cstdint> // std::uint64_t, std::int64_t
-#include <ostream> // std::basic_ostream
+#include <cstddef>  // std::byte, std::size_t
+#include <cstdint>  // std::uint8_t, std::uint16_t, std::uint32_t, std::int64_t
+#include <optional> // std::optional
+#include <ostream>  // std::basic_ostream
+#include <span>     // std::span
+#include <vector>   // std::vector
 
 namespace sourcemeta::jsonbinpack {
 
 /// @ingroup runtime
-class SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT OutputStream
-    : public sourcemeta::core::BinaryWriter {
+/// An output sink for the encoder. It may either wrap a standard output
+/// stream, append to a caller-owned growable buffer, or write into a
+/// caller-owned fixed region of memory. Writing past the end of a fixed region
+/// throws `sourcemeta::core::IOStreamWriteError`.
+class SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT OutputStream {
 public:
   using Stream = std::basic_ostream<sourcemeta::core::JSON::Char,
                                     sourcemeta::core::JSON::CharTraits>;
   OutputStream(Stream &output);
+  /// The caller must keep the buffer alive while the output stream is in use.
+  /// Bytes are appended after any existing contents of the buffer
+  OutputStream(std::vector<std::byte> &output);
+  /// The caller must keep the buffer alive while the output stream is in use
+  OutputStream(std::span<std::byte> output);
+
+  // Prevent copying, as this class is tied to an output resource
+  OutputStream(const OutputStream &) = delete;
+  OutputStream(OutputStream &&) = delete;
+  auto operator=(const OutputStream &) -> OutputStream & = delete;
+  auto operator=(OutputStream &&) -> OutputStream & = delete;
+
+  /// Start writing to a different output, as if the output stream was
+  /// constructed again
+  auto reset(Stream &output) -> void;
+  auto reset(std::vector<std::byte> &output) -> void;
+  auto reset(std::span<std::byte> output) -> void;
+
+  auto put_byte(const std::uint8_t value) -> void;
+  auto put_word(const std::uint16_t value) -> void;
+  auto put_dword(const std::uint32_t value) -> void;
+  auto put_bytes(const std::byte *data, const std::size_t size) -> void;
+  [[nodiscard]] auto position() const -> std::size_t;
 
   auto put_varint(const std::uint64_t value) -> void;
   auto put_varint_zigzag(const std::int64_t value) -> void;
   auto put_string_utf8(const sourcemeta::core::JSON::String &string,
                        const std::uint64_t length) -> void;
+
+  /// The bytes written so far, without copying them. This is only available
+  /// when writing to memory, and the result is invalidated by further writes
+  [[nodiscard]] auto bytes() const -> std::span<const std::byte>;
+
+protected:
+  struct Diversion {
+    std::vector<std::byte> *buffer;
+    std::size_t position;
+  };
+
+  // Append every write to the given buffer instead of the output, as if the
+  // buffer started at the given position of the output. This returns the
+  // diversion in place before, if any, to restore once done
+  auto divert(std::vector<std::byte> &buffer, const std::size_t position)
+      -> Diversion;
+  auto restore(const Diversion &previous) -> void;
+
+private:
+// Exporting symbols that depends on the standard C++ library is considered
+// safe.
+// https://learn.microsoft.com/en-us/cpp/error-messages/compiler-warnings/compiler-warning-level-2-c4275?view=msvc-170&redirectedfrom=MSDN
+#if defined(_MSC_VER)
+#pragma warning(disable : 4251 4275)
+#endif
+  // Only set when writing to a standard output stream
+  std::optional<sourcemeta::core::BinaryWriter> writer_;
+  // Only set when appending to a growable buffer
+  std::vector<std::byte> *buffer_{nullptr};
+  std::size_t origin_{0};
+  // Only meaningful when writing to a fixed buffer
+  std::byte *begin_{nullptr};
+  std::byte *end_{nullptr};
+  std::byte *cursor_{nullptr};
+  Diversion diversion_{.buffer = nullptr, .position = 0};
+#if defined(_MSC_VER)
+#pragma warning(default : 4251 4275)
+#endif
 };
 
 } // namespace sourcemeta::jsonbinpack
@@ -0,0 +1,94 @@
+#ifndef SOURCEMETA_JSONBINPACK_RUNTIME_PLAN_H_
+#define SOURCEMETA_JSONBINPACK_RUNTIME_PLAN_H_
+
+#ifndef SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT
+#include <sourcemeta/jsonbinpack/runtime_export.h>
+#endif
+
+#include <sourcemeta/jsonbinpack/runtime_encoding.h>
+
+#include <cstddef> // std::size_t
+#include <cstdint> // std::int64_t, std::uint32_t, std::uint64_t
+#include <memory>  // std::unique_ptr
+#include <vector>  // std::vector
+
+namespace sourcemeta::jsonbinpack {
+
+#ifndef DOXYGEN
+class Encoder;
+class Decoder;
+#endif
+
+/// @ingroup runtime
+/// An encoding resolved ahead of time into a flat array of instructions, so
+/// that encoding and decoding many values with the same encoding does not
+/// need to walk the encoding tree nor recompute its constants every time.
+/// For example:
+///
+/// ```cpp
+/// #include <sourcemeta/jsonbinpack/runtime.h>
+///
+/// const sourcemeta::jsonbinpack::Plan plan{
+///     sourcemeta::jsonbinpack::load(encoding)};
+/// encoder.write(document, plan);
+/// ```
+class SOURCEMETA_JSONBINPACK_RUNTIME_EXPORT Plan {
+public:
+  Plan(Encoding encoding);
+
+  // Prevent copying, as the instructions point into the encoding
+  Plan(const Plan &) = delete;
+  Plan(Plan &&) = default;
+  auto operator=(const Plan &) -> Plan & = delete;
+  auto operator=(Plan &&) -> Plan & = default;
+
+  /// The encoding that the plan was resolved from
+  [[nodiscard]] auto encoding() const -> const Encoding &;
+
+private:
+  friend class Encoder;
+  friend class Decoder;
+
+  struct Instruction {
+    // The index of the encoding alternative
+    std::size_t type;
+    // Constants derived from the encoding options, whose
+    // meaning depends on the type of the encoding
+    std::uint64_t multiplier;
+    std::int64_t bound;
+    std::uint64_t offset;
+    // The instruction for array items or object values
+    std::uint32_t child;
+    // The instruction for object keys
+    std::uint32_t key;
+    // The instructions for array prefix items, as a range of the prefixes
+    std::uint32_t prefixes_begin;
+    std::uint32_t prefixes_size;
+    // Whether length-prefixed arrays and objects end with an offset table
+    bool offsets;
+    // The encoding alternative itself, for encodings that are not inlined
+    const void *options;
+  };
+
+  auto compile(const Encoding &encoding) -> std::uint32_t;
+
+// Exporting symbols that depends on the standard C++ library is considered
+// safe.
+// https://learn.microsoft.com/en-us/cpp/error-messages/compiler-warnings/compiler-warning-level-2-c4275?view=msvc-170&redirectedfrom=MSDN
+#if defined(_MSC_VER)
+#pragma warning(disable : 4251 4275)
+#endif
+  // Heap allocated so that moving the plan does not invalidate the
+  // pointers that the instructions hold into the encoding
+  std::unique_ptr<Encoding> encoding_;
+  // The root instruction is always the first one
+  std::vector<Instruction> instructions_;
+  std::vector<std::uint32_t> prefixes_;
+#if defined(_MSC_VER)
+#pragma warning(default : 4251 4275)
+#endif
+};
+
+} // namespace sourcemeta::jsonbinpack
+
+#endif
@@ -2,14 +2,148 @@
 
 #include <sourcemeta/core/numeric.h>
 
+#include <bit>     // std::countr_zero, std::endian, std::byteswap
 #include <cassert> // assert
 #include <cstddef> // std::size_t
-#include <cstdint> // std::uint8_t, std::uint64_t, std::int64_t
+#include <cstdint> // std::uint8_t, std::uint16_t, std::uint32_t, std::int64_t
+#include <cstring> // std::memcpy
+
+namespace {
+
+template <typename T> auto from_little_endian(const T value) -> T {
+  if constexpr (std::endian::native == std::endian::big) {
+    return std::byteswap(value);
+  } else {
+    return value;
+  }
+}
+
+} // namespace
 
 namespace sourcemeta::jsonbinpack {
 
-InputStream::InputStream(Stream &input)
-    : sourcemeta::core::BinaryReader{input} {}
+InputStream::InputStream(Stream &input) { this->reader_.emplace(input); }
+
+InputStream::InputStream(std::span<const std::byte> input)
+    : begin_{input.data()}, end_{input.data() + input.size()},
+      cursor_{input.data()} {}
+
+InputStream::InputStream(const sourcemeta::core::FileView &input)
+    : InputStream{input.size() == 0
+                      ? std::span<const std::byte>{}
+                      : std::span<const std::byte>{input.as<std::byte>(),
+                                                   input.size()}} {}
+
+auto InputStream::reset(Stream &input) -> void {
+  this->reader_.emplace(input);
+  this->begin_ = nullptr;
+  this->end_ = nullptr;
+  this->cursor_ = nullptr;
+}
+
+auto InputStream::reset(std::span<const std::byte> input) -> void {
+  this->reader_.reset();
+  this->begin_ = input.data();
+  this->end_ = input.data() + input.size();
+  this->cursor_ = input.data();
+}
+
+auto InputStream::reset(const sourcemeta::core::FileView &input) -> void {
+  this->reset(input.size() == 0 ? std::span<const std::byte>{}
+                                : std::span<const std::byte>{
+                                      input.as<std::byte>(), input.size()});
+}
+
+auto InputStream::get_byte() -> std::uint8_t {
+  if (this->reader_.has_value()) {
+    return this->reader_->get_byte();
+  }
+
+  if (this->cursor_ == this->end_) {
+    throw sourcemeta::core::IOReadOutOfBoundsError{};
+  }
+
+  return static_cast<std::uint8_t>(*this->cursor_++);
+}
+
+auto InputStream::get_word() -> std::uint16_t {
+  if (this->reader_.has_value()) {
+    return this->reader_->get_word();
+  }
+
+  if (this->end_ - this->cursor_ < 2) {
+    throw sourcemeta::core::IOReadOutOfBoundsError{};
+  }
+
+  // Always little endian, regardless of the host
+  const auto low{static_cast<std::uint16_t>(this->cursor_[0])};
+  const auto high{static_cast<std::uint16_t>(this->cursor_[1])};
+  this->cursor_ += 2;
+  return static_cast<std::uint16_t>(low | (high << 8));
+}
+
+auto InputStream::get_dword() -> std::uint32_t {
+  if (this->reader_.has_value()) {
+    return this->reader_->get_dword();
+  }
+
+  if (this->end_ - this->cursor_ < 4) {
+    throw sourcemeta::core::IOReadOutOfBoundsError{};
+  }
+
+  // Always little endian, regardless of the host
+  std::uint32_t result{0};
+  for (std::size_t index = 0; index < 4; index++) {
+    result |= static_cast<std::uint32_t>(this->cursor_[index]) << (index * 8);
+  }
+
+  this->cursor_ += 4;
+  return result;
+}
+
+auto InputStream::get_bytes(std::byte *destination, const std::size_t size)
+    -> void {
+  if (this->reader_.has_value()) {
+    return this->reader_->get_bytes(destination, size);
+  }
+
+  if (size > static_cast<std::size_t>(this->end_ - this->cursor_)) {
+    throw sourcemeta::core::IOReadOutOfBoundsError{};
+  }
+
+  if (size > 0) {
+    std::memcpy(destination, this->cursor_, size);
+    this->cursor_ += size;
+  }
+}
+
+auto InputStream::position() const -> std::size_t {
+  if (this->reader_.has_value()) {
+    return this->reader_->position();
+  }
+
+  return static_cast<std::size_t>(this->cursor_ - this->begin_);
+}
+
+auto InputStream::seek(const std::size_t position) -> void {
+  if (this->reader_.has_value()) {
+    return this->reader_->seek(position);
+  }
+
+  if (position > static_cast<std::size_t>(this->end_ - this->begin_)) {
+    throw sourcemeta::core::IOReadOutOfBoundsError{};
+  }
+
+  this->cursor_ = this->begin_ + position;
+}
+
+auto InputStream::has_more_data() const -> bool {
+  if (this->reader_.has_value()) {
+    return this->reader_->has_more_data();
+  }
+
+  return this->cursor_ != this->end_;
+}
 
 auto InputStream::rewind(const std::uint64_t relative_offset,
                          const std::uint64_t position) -> std::uint64_t {
@@ -26,6 +160,59 @@ auto InputStream::get_varint() -> std::uint64_t {
   constexpr std::uint8_t MOST_SIGNIFICANT_BIT{0b10000000};
   constexpr std::uint8_t SHIFT{7};
   std::uint64_t result{0};
+
+  if (!this->reader_.has_value()) {
+    // Most varints fit in 8 bytes, so when there is enough room left in the
+    // buffer, find the terminating byte and gather the 7-bit groups of a
+    // single word load without branching on every byte
+    if (this->end_ - this->cursor_ >= 8) {
+      std::uint64_t word;
+      std::memcpy(&word, this->cursor_, sizeof(word));
+      word = from_little_endian(word);
+      const std::uint64_t terminators{~word & 0x8080808080808080};
+      if (terminators != 0) {
+        const auto size{static_cast<std::size_t>(
+            (std::countr_zero(terminators) + 1) / 8)};
+        std::uint64_t groups{word & 0x7f7f7f7f7f7f7f7f};
+        if (size < 8) {
+          groups &= (std::uint64_t{1} << (size * 8)) - 1;
+        }
+
+        groups = ((groups & 0x7f007f007f007f00) >> 1) |
+                 (groups & 0x007f007f007f007f);
+        groups = ((groups & 0x3fff00003fff0000) >> 2) |
+                 (groups & 0x00003fff00003fff);
+        groups = ((groups & 0x0fffffff00000000) >> 4) |
+                 (groups & 0x000000000fffffff);
+        this->cursor_ += size;
+        return groups;
+      }
+    }
+
+    // Near the end of the buffer, or for varints of 9 or 10 bytes
+    const std::byte *pointer{this->cursor_};
+    std::uint64_t shift{0};
+    while (true) {
+      if (pointer == this->end_) {
+        throw sourcemeta::core::IOReadOutOfBoundsError{};
+      }
+
+      const auto byte{static_cast<std::uint8_t>(*pointer++)};
+      result |= static_cast<std::uint64_t>(byte & LEAST_SIGNIFICANT_BITS)
+                << shift;
+      if ((byte & MOST_SIGNIFICANT_BIT) == 0) {
+        break;
+      }
+
+      shift += SHIFT;
+      // A 64-bit integer never takes more than 10 Base-128 bytes
+      assert(shift < 64);
+    }
+
+    this->cursor_ = pointer;
+    return result;
+  }
+
   std::size_t cursor{0};
   while (true) {
     const std::uint8_t byte{this->get_byte()};
@@ -46,23 +233,52 @@ auto InputStream::get_varint() -> std::uint64_t {
   return result;
 }
 
+auto InputStream::get_varints(std::span<std::uint64_t> output) -> void {
+  for (auto &value : output) {
+    value = this->get_varint();
+  }
+}
+
 auto InputStream::get_varint_zigzag() -> std::int64_t {
   return sourcemeta::core::zigzag_decode(this->get_varint());
 }
 
 auto InputStream::get_string_utf8(const std::uint64_t length)
     -> sourcemeta::core::JSON::String {
-  sourcemeta::core::JSON::String result;
-  result.reserve(length);
-  std::uint64_t counter = 0;
-  while (counter < length) {
-    result += static_cast<sourcemeta::core::JSON::Char>(this->get_byte());
-    counter += 1;
+  if (!this->reader_.has_value()) {
+    if (length > static_cast<std::uint64_t>(this->end_ - this->cursor_)) {
+      throw sourcemeta::core::IOReadOutOfBoundsError{};
+    }
+
+    // Construct the string straight out of the underlying memory
+    const auto *start{
+        reinterpret_cast<const sourcemeta::core::JSON::Char *>(this->cursor_)};
+    this->cursor_ += length;
+    return {start, static_cast<std::size_t>(length)};
   }
 
-  assert(counter == length);
+  // Size the string upfront and fill it with a single read
+  sourcemeta::core::JSON::String result;
+  result.resize(static_cast<std::size_t>(length));
+  this->get_bytes(reinterpret_cast<std::byte *>(result.data()), result.size());
   assert(result.size() == length);
   return result;
 }
 
+auto InputStream::in_memory() const -> bool {
+  return !this->reader_.has_value();
+}
+
+auto InputStream::bytes(const std::size_t position,
+                        const std::size_t size) const
+    -> std::span<const std::byte> {
+  assert(this->in_memory());
+  const auto length{static_cast<std::size_t>(this->end_ - this->begin_)};
+  if (position > length || size > length - position) {
+    throw sourcemeta::core::IOReadOutOfBoundsError{};
+  }
+
+  return {this->begin_ + position, size};
+}
+
 } // namespace sourcemeta::jsonbinpack
@@ -0,0 +1,22 @@
+#ifndef SOURCEMETA_JSONBINPACK_RUNTIME_LENGTH_PREFIX_H_
+#define SOURCEMETA_JSONBINPACK_RUNTIME_LENGTH_PREFIX_H_
+
+#include <cstdint> // std::uint8_t, std::uint64_t
+
+namespace sourcemeta::jsonbinpack::internal {
+
+// The entries of the offset table that may follow the items of length-prefixed
+// arrays and objects are as wide as needed to point anywhere within the items
+inline auto offset_width(const std::uint64_t length) -> std::uint8_t {
+  if (length <= 0xff) {
+    return 1;
+  } else if (length <= 0xffff) {
+    return 2;
+  } else {
+    return 4;
+  }
+}
+
+} // namespace sourcemeta::jsonbinpack::internal
+
+#endif
@@ -5,6 +5,8 @@
 
 #include <sourcemeta/core/json.h>
 
+#include "choice_index.h"
+
 #include <cassert> // assert
 #include <utility> // std::move
 #include <vector>  // std::vector
@@ -17,8 +19,9 @@ auto BYTE_CHOICE_INDEX(const sourcemeta::core::JSON &options) -> Encoding {
   assert(choices.is_array());
   const auto &array{choices.as_array()};
   std::vector<sourcemeta::core::JSON> elements{array.cbegin(), array.cend()};
-  return sourcemeta::jsonbinpack::BYTE_CHOICE_INDEX{.choices =
-                                                        std::move(elements)};
+  auto index{make_choice_index(elements)};
+  return sourcemeta::jsonbinpack::BYTE_CHOICE_INDEX{
+      .choices = std::move(elements), .index = std::move(index)};
 }
 
 auto LARGE_CHOICE_INDEX(const sourcemeta::core::JSON &options) -> Encoding {
@@ -27,8 +30,9 @@ auto LARGE_CHOICE_INDEX(const sourcemeta::core::JSON &options) -> Encoding {
   assert(choices.is_array());
   const auto &array{choices.as_array()};
   std::vector<sourcemeta::core::JSON> elements{array.cbegin(), array.cend()};
-  return sourcemeta::jsonbinpack::LARGE_CHOICE_INDEX{.choices =
-                                                         std::move(elements)};
+  auto index{make_choice_index(elements)};
+  return sourcemeta::jsonbinpack::LARGE_CHOICE_INDEX{
+      .choices = std::move(elements), .index = std::move(index)};
 }
 
 auto TOP_LEVEL_BYTE_CHOICE_INDEX(const sourcemeta::core::JSON &options)
@@ -38,8 +42,9 @@ auto TOP_LEVEL_BYTE_CHOICE_INDEX(const sourcemeta::core::JSON &options)
   assert(choices.is_array());
   const auto &array{choices.as_array()};
   std::vector<sourcemeta::core::JSON> elements{array.cbegin(), array.cend()};
+  auto index{make_choice_index(elements)};
   return sourcemeta::jsonbinpack::TOP_LEVEL_BYTE_CHOICE_INDEX{
-      .choices = std::move(elements)};
+      .choices = std::move(elements), .index = std::move(index)};
 }
 
 auto CONST_NONE(const sourcemeta::core::JSON &options) -> Encoding {
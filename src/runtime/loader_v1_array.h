@@ -112,6 +112,33 @@ auto ROOF_TYPED_ARRAY(const sourcemeta::core::JSON &options) -> Encoding {
       .prefix_encodings = std::move(encodings)};
 }
 
+auto FLOOR_TYPED_LENGTH_PREFIX_ARRAY(const sourcemeta::core::JSON &options)
+    -> Encoding {
+  assert(options.defines("minimum"));
+  assert(options.defines("encoding"));
+  assert(options.defines("prefixEncodings"));
+  const auto &minimum{options.at("minimum")};
+  const auto &array_encoding{options.at("encoding")};
+  const auto &prefix_encodings{options.at("prefixEncodings")};
+  assert(minimum.is_integer());
+  assert(minimum.is_positive());
+  assert(array_encoding.is_object());
+  assert(prefix_encodings.is_array());
+  assert(!options.defines("offsets") || options.at("offsets").is_boolean());
+  std::vector<Encoding> encodings;
+  std::transform(prefix_encodings.as_array().cbegin(),
+                 prefix_encodings.as_array().cend(),
+                 std::back_inserter(encodings),
+                 [](const auto &element) -> Encoding { return load(element); });
+  assert(encodings.size() == prefix_encodings.size());
+  return sourcemeta::jsonbinpack::FLOOR_TYPED_LENGTH_PREFIX_ARRAY{
+      .minimum = static_cast<std::uint64_t>(minimum.to_integer()),
+      .encoding = std::make_shared<Encoding>(load(array_encoding)),
+      .prefix_encodings = std::move(encodings),
+      .offsets =
+          options.defines("offsets") && options.at("offsets").to_boolean()};
+}
+
 } // namespace sourcemeta::jsonbinpack::v1
 
 #endif
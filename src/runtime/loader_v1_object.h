@@ -0,0 +1,100 @@
+#ifndef SOURCEMETA_JSONBINPACK_RUNTIME_LOADER_V1_OBJECT_H_
+#define SOURCEMETA_JSONBINPACK_RUNTIME_LOADER_V1_OBJECT_H_
+
+#include <sourcemeta/jsonbinpack/runtime.h>
+
+#include <sourcemeta/core/json.h>
+
+#include <cassert> // assert
+#include <cstdint> // std::uint64_t
+#include <memory>  // std::make_shared
+#include <utility> // std::move
+#include <vector>  // std::vector
+
+namespace sourcemeta::jsonbinpack::v1 {
+
+auto FIXED_TYPED_ARBITRARY_OBJECT(const sourcemeta::core::JSON &options)
+    -> Encoding {
+  assert(options.defines("size"));
+  assert(options.defines("keyEncoding"));
+  assert(options.defines("encoding"));
+  const auto &size{options.at("size")};
+  const auto &key_encoding{options.at("keyEncoding")};
+  const auto &object_encoding{options.at("encoding")};
+  assert(size.is_integer());
+  assert(size.is_positive());
+  assert(key_encoding.is_object());
+  assert(object_encoding.is_object());
+  return sourcemeta::jsonbinpack::FIXED_TYPED_ARBITRARY_OBJECT{
+      .size = static_cast<std::uint64_t>(size.to_integer()),
+      .key_encoding = std::make_shared<Encoding>(load(key_encoding)),
+      .encoding = std::make_shared<Encoding>(load(object_encoding))};
+}
+
+auto VARINT_TYPED_ARBITRARY_OBJECT(const sourcemeta::core::JSON &options)
+    -> Encoding {
+  assert(options.defines("keyEncoding"));
+  assert(options.defines("encoding"));
+  const auto &key_encoding{options.at("keyEncoding")};
+  const auto &object_encoding{options.at("encoding")};
+  assert(key_encoding.is_object());
+  assert(object_encoding.is_object());
+  return sourcemeta::jsonbinpack::VARINT_TYPED_ARBITRARY_OBJECT{
+      .key_encoding = std::make_shared<Encoding>(load(key_encoding)),
+      .encoding = std::make_shared<Encoding>(load(object_encoding))};
+}
+
+auto VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT(
+    const sourcemeta::core::JSON &options) -> Encoding {
+  assert(options.defines("keyEncoding"));
+  assert(options.defines("encoding"));
+  const auto &key_encoding{options.at("keyEncoding")};
+  const auto &object_encoding{options.at("encoding")};
+  assert(key_encoding.is_object());
+  assert(object_encoding.is_object());
+  assert(!options.defines("offsets") || options.at("offsets").is_boolean());
+  return sourcemeta::jsonbinpack::VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT{
+      .key_encoding = std::make_shared<Encoding>(load(key_encoding)),
+      .encoding = std::make_shared<Encoding>(load(object_encoding)),
+      .offsets =
+          options.defines("offsets") && options.at("offsets").to_boolean()};
+}
+
+auto MIXED_BOUNDED_TYPED_OBJECT(const sourcemeta::core::JSON &options)
+    -> Encoding {
+  assert(options.defines("requiredProperties"));
+  assert(options.defines("optionalProperties"));
+  assert(options.defines("propertyEncodings"));
+  const auto &required_properties{options.at("requiredProperties")};
+  const auto &optional_properties{options.at("optionalProperties")};
+  const auto &property_encodings{options.at("propertyEncodings")};
+  assert(required_properties.is_array());
+  assert(optional_properties.is_array());
+  assert(property_encodings.is_object());
+  assert(property_encodings.size() ==
+         required_properties.size() + optional_properties.size());
+
+  sourcemeta::jsonbinpack::MIXED_BOUNDED_TYPED_OBJECT result;
+  result.required.reserve(required_properties.size());
+  result.optional.reserve(optional_properties.size());
+  result.encodings.reserve(property_encodings.size());
+  for (const auto &name : required_properties.as_array()) {
+    assert(name.is_string());
+    assert(property_encodings.defines(name.to_string()));
+    result.required.push_back(name.to_string());
+    result.encodings.push_back(load(property_encodings.at(name.to_string())));
+  }
+
+  for (const auto &name : optional_properties.as_array()) {
+    assert(name.is_string());
+    assert(property_encodings.defines(name.to_string()));
+    result.optional.push_back(name.to_string());
+    result.encodings.push_back(load(property_encodings.at(name.to_string())));
+  }
+
+  return result;
+}
+
+} // namespace sourcemeta::jsonbinpack::v1
+
+#endif
@@ -63,6 +63,11 @@ auto PREFIX_VARINT_LENGTH_STRING_SHARED(const sourcemeta::core::JSON &)
   return sourcemeta::jsonbinpack::PREFIX_VARINT_LENGTH_STRING_SHARED{};
 }
 
+auto GZIP_VARINT_PREFIX_UTF8_STRING(const sourcemeta::core::JSON &)
+    -> Encoding {
+  return sourcemeta::jsonbinpack::GZIP_VARINT_PREFIX_UTF8_STRING{};
+}
+
 } // namespace sourcemeta::jsonbinpack::v1
 
 #endif
@@ -2,27 +2,198 @@
 
 #include <sourcemeta/core/numeric.h>
 
-#include <cassert> // assert
-#include <cstdint> // std::uint8_t, std::uint64_t, std::int64_t
+#include <algorithm> // std::max
+#include <array>     // std::array
+#include <bit>       // std::bit_width, std::endian, std::byteswap
+#include <cassert>   // assert
+#include <cstddef>   // std::size_t
+#include <cstdint>   // std::uint8_t, std::uint16_t, std::uint32_t, std::int64_t
+#include <cstring>   // std::memcpy
+
+namespace {
+
+template <typename T> auto to_little_endian(const T value) -> T {
+  if constexpr (std::endian::native == std::endian::big) {
+    return std::byteswap(value);
+  } else {
+    return value;
+  }
+}
+
+} // namespace
 
 namespace sourcemeta::jsonbinpack {
 
-OutputStream::OutputStream(Stream &output)
-    : sourcemeta::core::BinaryWriter{output} {}
+OutputStream::OutputStream(Stream &output) { this->writer_.emplace(output); }
+
+OutputStream::OutputStream(std::vector<std::byte> &output)
+    : buffer_{&output}, origin_{output.size()} {}
+
+OutputStream::OutputStream(std::span<std::byte> output)
+    : begin_{output.data()}, end_{output.data() + output.size()},
+      cursor_{output.data()} {}
+
+auto OutputStream::reset(Stream &output) -> void {
+  this->writer_.emplace(output);
+  this->buffer_ = nullptr;
+  this->origin_ = 0;
+  this->begin_ = nullptr;
+  this->end_ = nullptr;
+  this->cursor_ = nullptr;
+  this->diversion_ = {.buffer = nullptr, .position = 0};
+}
+
+auto OutputStream::reset(std::vector<std::byte> &output) -> void {
+  this->writer_.reset();
+  this->buffer_ = &output;
+  this->origin_ = output.size();
+  this->begin_ = nullptr;
+  this->end_ = nullptr;
+  this->cursor_ = nullptr;
+  this->diversion_ = {.buffer = nullptr, .position = 0};
+}
+
+auto OutputStream::reset(std::span<std::byte> output) -> void {
+  this->writer_.reset();
+  this->buffer_ = nullptr;
+  this->origin_ = 0;
+  this->begin_ = output.data();
+  this->end_ = output.data() + output.size();
+  this->cursor_ = output.data();
+  this->diversion_ = {.buffer = nullptr, .position = 0};
+}
+
+auto OutputStream::put_byte(const std::uint8_t value) -> void {
+  if (this->diversion_.buffer != nullptr) {
+    return this->diversion_.buffer->push_back(static_cast<std::byte>(value));
+  } else if (this->writer_.has_value()) {
+    return this->writer_->put_byte(value);
+  } else if (this->buffer_ != nullptr) {
+    return this->buffer_->push_back(static_cast<std::byte>(value));
+  }
+
+  if (this->cursor_ == this->end_) {
+    throw sourcemeta::core::IOStreamWriteError{};
+  }
+
+  *this->cursor_++ = static_cast<std::byte>(value);
+}
+
+auto OutputStream::put_word(const std::uint16_t value) -> void {
+  if (this->diversion_.buffer == nullptr && this->writer_.has_value()) {
+    return this->writer_->put_word(value);
+  }
+
+  // Always little endian, regardless of the host
+  const std::array<std::byte, 2> word{{static_cast<std::byte>(value & 0xff),
+                                       static_cast<std::byte>(value >> 8)}};
+  this->put_bytes(word.data(), word.size());
+}
+
+auto OutputStream::put_dword(const std::uint32_t value) -> void {
+  if (this->diversion_.buffer == nullptr && this->writer_.has_value()) {
+    return this->writer_->put_dword(value);
+  }
+
+  // Always little endian, regardless of the host
+  const std::array<std::byte, 4> dword{
+      {static_cast<std::byte>(value & 0xff),
+       static_cast<std::byte>((value >> 8) & 0xff),
+       static_cast<std::byte>((value >> 16) & 0xff),
+       static_cast<std::byte>(value >> 24)}};
+  this->put_bytes(dword.data(), dword.size());
+}
+
+auto OutputStream::put_bytes(const std::byte *data, const std::size_t size)
+    -> void {
+  if (this->diversion_.buffer != nullptr) {
+    this->diversion_.buffer->insert(this->diversion_.buffer->end(), data,
+                                    data + size);
+    return;
+  } else if (this->writer_.has_value()) {
+    return this->writer_->put_bytes(data, size);
+  } else if (this->buffer_ != nullptr) {
+    this->buffer_->insert(this->buffer_->end(), data, data + size);
+    return;
+  }
+
+  if (size > static_cast<std::size_t>(this->end_ - this->cursor_)) {
+    throw sourcemeta::core::IOStreamWriteError{};
+  }
+
+  if (size > 0) {
+    std::memcpy(this->cursor_, data, size);
+    this->cursor_ += size;
+  }
+}
+
+auto OutputStream::position() const -> std::size_t {
+  if (this->diversion_.buffer != nullptr) {
+    return this->diversion_.position + this->diversion_.buffer->size();
+  } else if (this->writer_.has_value()) {
+    return this->writer_->position();
+  } else if (this->buffer_ != nullptr) {
+    return this->buffer_->size() - this->origin_;
+  }
+
+  return static_cast<std::size_t>(this->cursor_ - this->begin_);
+}
+
+auto OutputStream::bytes() const -> std::span<const std::byte> {
+  assert(!this->writer_.has_value());
+  assert(this->diversion_.buffer == nullptr);
+  if (this->buffer_ != nullptr) {
+    return {this->buffer_->data() + this->origin_,
+            this->buffer_->size() - this->origin_};
+  }
+
+  return {this->begin_, static_cast<std::size_t>(this->cursor_ - this->begin_)};
+}
+
+auto OutputStream::divert(std::vector<std::byte> &buffer,
+                          const std::size_t position) -> Diversion {
+  const auto previous{this->diversion_};
+  this->diversion_ = {.buffer = &buffer, .position = position};
+  return previous;
+}
+
+auto OutputStream::restore(const Diversion &previous) -> void {
+  this->diversion_ = previous;
+}
 
 auto OutputStream::put_varint(const std::uint64_t value) -> void {
   constexpr std::uint8_t LEAST_SIGNIFICANT_BITS{0b01111111};
   constexpr std::uint8_t MOST_SIGNIFICANT_BIT{0b10000000};
   constexpr std::uint8_t SHIFT{7};
-  std::uint64_t accumulator = value;
 
+  // Values that fit in 8 Base-128 bytes are spread into 7-bit groups
+  // with bit tricks and emitted in a single write
+  if (value < (std::uint64_t{1} << 56)) {
+    const auto size{std::max<std::size_t>(
+        1, (static_cast<std::size_t>(std::bit_width(value)) + 6) / 7)};
+    std::uint64_t word{((value & 0x00fffffff0000000) << 4) |
+                       (value & 0x000000000fffffff)};
+    word = ((word & 0x0fffc0000fffc000) << 2) | (word & 0x00003fff00003fff);
+    word = ((word & 0x3f803f803f803f80) << 1) | (word & 0x007f007f007f007f);
+    // Every byte but the last one has its continuation bit set
+    word |= 0x8080808080808080 & ((std::uint64_t{1} << ((size - 1) * 8)) - 1);
+    word = to_little_endian(word);
+    std::array<std::byte, sizeof(word)> bytes;
+    std::memcpy(bytes.data(), &word, sizeof(word));
+    return this->put_bytes(bytes.data(), size);
+  }
+
+  std::array<std::byte, 10> bytes;
+  std::size_t size{0};
+  std::uint64_t accumulator = value;
   while (accumulator > LEAST_SIGNIFICANT_BITS) {
-    this->put_byte(static_cast<std::uint8_t>(
-        (accumulator & LEAST_SIGNIFICANT_BITS) | MOST_SIGNIFICANT_BIT));
+    bytes[size++] = static_cast<std::byte>(
+        (accumulator & LEAST_SIGNIFICANT_BITS) | MOST_SIGNIFICANT_BIT);
     accumulator >>= SHIFT;
   }
 
-  this->put_byte(static_cast<std::uint8_t>(accumulator));
+  bytes[size++] = static_cast<std::byte>(accumulator);
+  this->put_bytes(bytes.data(), size);
 }
 
 auto OutputStream::put_varint_zigzag(const std::int64_t value) -> void {
@@ -32,11 +203,10 @@ auto OutputStream::put_varint_zigzag(const std::int64_t value) -> void {
 auto OutputStream::put_string_utf8(const sourcemeta::core::JSON::String &string,
                                    const std::uint64_t length) -> void {
   assert(string.size() == length);
-  // Do a manual for-loop based on the provided length instead of a range
-  // loop based on the string value to avoid accidental overflows
-  for (std::uint64_t index = 0; index < length; index++) {
-    this->put_byte(static_cast<std::uint8_t>(string[index]));
-  }
+  // Write the whole string in one go based on the provided length
+  // instead of byte per byte
+  this->put_bytes(reinterpret_cast<const std::byte *>(string.data()),
+                  static_cast<std::size_t>(length));
 }
 
 } // namespace sourcemeta::jsonbinpack
@@ -0,0 +1,194 @@
+#include <sourcemeta/jsonbinpack/runtime_plan.h>
+
+#include <sourcemeta/core/numeric.h>
+
+#include <cassert> // assert
+#include <cstdint> // std::int64_t, std::uint32_t, std::uint64_t
+#include <memory>  // std::make_unique
+#include <utility> // std::move
+#include <variant> // std::get, std::visit
+#include <vector>  // std::vector
+
+namespace sourcemeta::jsonbinpack {
+
+Plan::Plan(Encoding encoding)
+    : encoding_{std::make_unique<Encoding>(std::move(encoding))} {
+  this->compile(*this->encoding_);
+}
+
+auto Plan::encoding() const -> const Encoding & {
+  assert(this->encoding_);
+  return *this->encoding_;
+}
+
+auto Plan::compile(const Encoding &encoding) -> std::uint32_t {
+  const auto index{static_cast<std::uint32_t>(this->instructions_.size())};
+  this->instructions_.push_back(
+      {.type = encoding.index(),
+       .multiplier = 1,
+       .bound = 0,
+       .offset = 0,
+       .child = 0,
+       .key = 0,
+       .prefixes_begin = 0,
+       .prefixes_size = 0,
+       .offsets = false,
+       .options = std::visit(
+           [](const auto &alternative) -> const void * { return &alternative; },
+           encoding)});
+
+  // Instructions are referred to by index, as compiling
+  // children may grow and therefore move the instructions
+  const auto compile_array{[this, index](const auto &options,
+                                         const std::uint64_t offset) {
+    std::vector<std::uint32_t> prefixes;
+    prefixes.reserve(options.prefix_encodings.size());
+    for (const auto &prefix : options.prefix_encodings) {
+      prefixes.push_back(this->compile(prefix));
+    }
+
+    assert(options.encoding);
+    const auto child{this->compile(*(options.encoding))};
+    auto &instruction{this->instructions_[index]};
+    instruction.offset = offset;
+    instruction.child = child;
+    instruction.prefixes_begin =
+        static_cast<std::uint32_t>(this->prefixes_.size());
+    instruction.prefixes_size = static_cast<std::uint32_t>(prefixes.size());
+    this->prefixes_.insert(this->prefixes_.end(), prefixes.cbegin(),
+                           prefixes.cend());
+  }};
+
+  const auto compile_object{[this, index](const auto &options,
+                                          const std::uint64_t offset) {
+    assert(options.key_encoding);
+    assert(options.encoding);
+    const auto key{this->compile(*(options.key_encoding))};
+    const auto child{this->compile(*(options.encoding))};
+    auto &instruction{this->instructions_[index]};
+    instruction.offset = offset;
+    instruction.key = key;
+    instruction.child = child;
+  }};
+
+  const auto compile_integer{[this, index](const std::uint64_t multiplier,
+                                           const std::int64_t bound) {
+    assert(multiplier > 0);
+    auto &instruction{this->instructions_[index]};
+    instruction.multiplier = multiplier;
+    instruction.bound = bound;
+    instruction.offset = static_cast<std::uint64_t>(bound) * multiplier;
+  }};
+
+  switch (encoding.index()) {
+    case 0: {
+      const auto &options{
+          std::get<BOUNDED_MULTIPLE_8BITS_ENUM_FIXED>(encoding)};
+      compile_integer(options.multiplier,
+                      sourcemeta::core::divide_ceil(options.minimum,
+                                                    options.multiplier));
+      break;
+    }
+
+    case 1: {
+      const auto &options{std::get<FLOOR_MULTIPLE_ENUM_VARINT>(encoding)};
+      compile_integer(options.multiplier,
+                      sourcemeta::core::divide_ceil(options.minimum,
+                                                    options.multiplier));
+      break;
+    }
+
+    case 2: {
+      const auto &options{
+          std::get<ROOF_MULTIPLE_MIRROR_ENUM_VARINT>(encoding)};
+      compile_integer(options.multiplier,
+                      sourcemeta::core::divide_floor(options.maximum,
+                                                     options.multiplier));
+      break;
+    }
+
+    case 3:
+      compile_integer(
+          std::get<ARBITRARY_MULTIPLE_ZIGZAG_VARINT>(encoding).multiplier, 0);
+      break;
+
+    case 16: {
+      const auto &options{std::get<FIXED_TYPED_ARRAY>(encoding)};
+      compile_array(options, options.size);
+      break;
+    }
+
+    case 17: {
+      const auto &options{std::get<BOUNDED_8BITS_TYPED_ARRAY>(encoding)};
+      assert(options.maximum >= options.minimum);
+      assert(sourcemeta::core::is_byte(options.maximum - options.minimum));
+      compile_array(options, options.minimum);
+      break;
+    }
+
+    case 18: {
+      const auto &options{std::get<FLOOR_TYPED_ARRAY>(encoding)};
+      compile_array(options, options.minimum);
+      break;
+    }
+
+    case 19: {
+      const auto &options{std::get<ROOF_TYPED_ARRAY>(encoding)};
+      compile_array(options, options.maximum);
+      break;
+    }
+
+    case 20: {
+      const auto &options{std::get<FIXED_TYPED_ARBITRARY_OBJECT>(encoding)};
+      compile_object(options, options.size);
+      break;
+    }
+
+    case 21:
+      compile_object(std::get<VARINT_TYPED_ARBITRARY_OBJECT>(encoding), 0);
+      break;
+
+    case 22: {
+      const auto &options{std::get<FLOOR_TYPED_LENGTH_PREFIX_ARRAY>(encoding)};
+      compile_array(options, options.minimum);
+      this->instructions_[index].offsets = options.offsets;
+      break;
+    }
+
+    case 23: {
+      const auto &options{
+          std::get<VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT>(encoding)};
+      compile_object(options, 0);
+      this->instructions_[index].offsets = options.offsets;
+      break;
+    }
+
+    // The property names are read out of the options, while the property
+    // encodings are compiled as a range of the prefixes
+    case 25: {
+      const auto &options{std::get<MIXED_BOUNDED_TYPED_OBJECT>(encoding)};
+      std::vector<std::uint32_t> properties;
+      properties.reserve(options.encodings.size());
+      for (const auto &property : options.encodings) {
+        properties.push_back(this->compile(property));
+      }
+
+      auto &instruction{this->instructions_[index]};
+      instruction.offset = options.required.size();
+      instruction.prefixes_begin =
+          static_cast<std::uint32_t>(this->prefixes_.size());
+      instruction.prefixes_size = static_cast<std::uint32_t>(properties.size());
+      this->prefixes_.insert(this->prefixes_.end(), properties.cbegin(),
+                             properties.cend());
+      break;
+    }
+
+    default:
+      // Every other encoding is handled out of its options
+      break;
+  }
+
+  return index;
+}
+
+} // namespace sourcemeta::jsonbinpack
@@ -0,0 +1,63 @@
+#ifndef SOURCEMETA_JSONBINPACK_RUNTIME_PRESENCE_H_
+#define SOURCEMETA_JSONBINPACK_RUNTIME_PRESENCE_H_
+
+#include <array>   // std::array
+#include <bit>     // std::popcount
+#include <cassert> // assert
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint8_t
+#include <span>    // std::span
+#include <vector>  // std::vector
+
+namespace sourcemeta::jsonbinpack::internal {
+
+// The bitmap of which optional properties of an object are present, one bit
+// per optional property starting at the least significant bit of the first
+// byte. Objects with up to 64 optional properties do not allocate
+class Presence {
+public:
+  Presence(const std::size_t size) : size_{size} {
+    if (this->width() > this->inline_.size()) {
+      this->overflow_.resize(this->width());
+    }
+  }
+
+  [[nodiscard]] auto width() const -> std::size_t {
+    return (this->size_ + 7) / 8;
+  }
+
+  [[nodiscard]] auto bytes() -> std::span<std::uint8_t> {
+    return this->overflow_.empty()
+               ? std::span<std::uint8_t>{this->inline_.data(), this->width()}
+               : std::span<std::uint8_t>{this->overflow_};
+  }
+
+  auto set(const std::size_t index) -> void {
+    assert(index < this->size_);
+    this->bytes()[index / 8] |= static_cast<std::uint8_t>(1 << (index % 8));
+  }
+
+  [[nodiscard]] auto test(const std::size_t index) -> bool {
+    assert(index < this->size_);
+    return (this->bytes()[index / 8] >> (index % 8)) & 1;
+  }
+
+  // The number of optional properties that are present
+  [[nodiscard]] auto count() -> std::size_t {
+    std::size_t result{0};
+    for (const auto byte : this->bytes()) {
+      result += static_cast<std::size_t>(std::popcount(byte));
+    }
+
+    return result;
+  }
+
+private:
+  std::size_t size_;
+  std::array<std::uint8_t, 8> inline_{};
+  std::vector<std::uint8_t> overflow_;
+};
+
+} // namespace sourcemeta::jsonbinpack::internal
+
+#endif
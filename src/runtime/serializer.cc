@@ -0,0 +1,483 @@
+#include <sourcemeta/jsonbinpack/runtime.h>
+
+#include <sourcemeta/core/numeric.h>
+
+#include "choice_index.h"
+
+#include <cstddef>       // std::byte, std::size_t
+#include <cstdint>       // std::int64_t, std::uint8_t, std::uint64_t
+#include <memory>        // std::make_shared, std::shared_ptr
+#include <span>          // std::span
+#include <sstream>       // std::ostringstream
+#include <string>        // std::string, std::to_string
+#include <string_view>   // std::string_view
+#include <unordered_set> // std::unordered_set
+#include <utility>       // std::move
+#include <variant>       // std::get
+#include <vector>        // std::vector
+
+namespace {
+
+// Bump whenever the binary form of any encoding changes
+constexpr std::uint8_t FORMAT_VERSION{1};
+
+// Far deeper than any compiled schema, but shallow enough for malformed input
+// not to exhaust the stack
+constexpr std::size_t MAXIMUM_DEPTH{256};
+
+// The input is untrusted, so check the same rules that the JSON loaders
+// assert, which the encoders and decoders rely on
+auto check(const bool condition, const char *const message) -> void {
+  if (!condition) {
+    throw sourcemeta::jsonbinpack::EncodingError(
+        std::string{"Invalid binary encoding: "} + message);
+  }
+}
+
+// Whether the difference between two ordered values fits in a byte, without
+// overflowing on any of them
+auto is_byte_range(const std::int64_t minimum, const std::int64_t maximum)
+    -> bool {
+  return static_cast<std::uint64_t>(maximum) -
+             static_cast<std::uint64_t>(minimum) <=
+         0xff;
+}
+
+auto save_string(const sourcemeta::core::JSON::String &value,
+                 sourcemeta::jsonbinpack::OutputStream &output) -> void {
+  output.put_varint(value.size());
+  output.put_string_utf8(value, value.size());
+}
+
+auto load_string(sourcemeta::jsonbinpack::InputStream &input)
+    -> sourcemeta::core::JSON::String {
+  return input.get_string_utf8(input.get_varint());
+}
+
+// Arbitrary JSON values are encoded with BinPack itself
+auto save_value(const sourcemeta::core::JSON &value,
+                sourcemeta::jsonbinpack::OutputStream &output) -> void {
+  std::vector<std::byte> buffer;
+  sourcemeta::jsonbinpack::Encoder encoder{buffer};
+  encoder.write(value,
+                sourcemeta::jsonbinpack::ANY_PACKED_TYPE_TAG_BYTE_PREFIX{});
+  output.put_varint(buffer.size());
+  output.put_bytes(buffer.data(), buffer.size());
+}
+
+auto load_value(sourcemeta::jsonbinpack::InputStream &input)
+    -> sourcemeta::core::JSON {
+  const auto size{input.get_varint()};
+  const auto position{input.position()};
+  const auto bytes{input.bytes(position, static_cast<std::size_t>(size))};
+  input.seek(position + static_cast<std::size_t>(size));
+  sourcemeta::jsonbinpack::Decoder decoder{bytes};
+  return decoder.read(
+      sourcemeta::jsonbinpack::ANY_PACKED_TYPE_TAG_BYTE_PREFIX{});
+}
+
+auto save_values(const std::vector<sourcemeta::core::JSON> &values,
+                 sourcemeta::jsonbinpack::OutputStream &output) -> void {
+  output.put_varint(values.size());
+  for (const auto &value : values) {
+    save_value(value, output);
+  }
+}
+
+auto load_values(sourcemeta::jsonbinpack::InputStream &input)
+    -> std::vector<sourcemeta::core::JSON> {
+  // The count is untrusted, so let the vector grow as values are read
+  const auto size{input.get_varint()};
+  std::vector<sourcemeta::core::JSON> result;
+  for (std::uint64_t index = 0; index < size; index++) {
+    result.push_back(load_value(input));
+  }
+
+  return result;
+}
+
+auto save_encoding(const sourcemeta::jsonbinpack::Encoding &encoding,
+                   sourcemeta::jsonbinpack::OutputStream &output) -> void;
+
+auto load_encoding(sourcemeta::jsonbinpack::InputStream &input,
+                   const std::size_t depth)
+    -> sourcemeta::jsonbinpack::Encoding;
+
+auto save_encodings(
+    const std::vector<sourcemeta::jsonbinpack::Encoding> &values,
+    sourcemeta::jsonbinpack::OutputStream &output) -> void {
+  output.put_varint(values.size());
+  for (const auto &value : values) {
+    save_encoding(value, output);
+  }
+}
+
+auto load_encodings(sourcemeta::jsonbinpack::InputStream &input,
+                    const std::size_t depth)
+    -> std::vector<sourcemeta::jsonbinpack::Encoding> {
+  // The count is untrusted, so let the vector grow as encodings are read
+  const auto size{input.get_varint()};
+  std::vector<sourcemeta::jsonbinpack::Encoding> result;
+  for (std::uint64_t index = 0; index < size; index++) {
+    result.push_back(load_encoding(input, depth));
+  }
+
+  return result;
+}
+
+auto load_shared_encoding(sourcemeta::jsonbinpack::InputStream &input,
+                          const std::size_t depth)
+    -> std::shared_ptr<sourcemeta::jsonbinpack::Encoding> {
+  return std::make_shared<sourcemeta::jsonbinpack::Encoding>(
+      load_encoding(input, depth));
+}
+
+auto save_encoding(const sourcemeta::jsonbinpack::Encoding &encoding,
+                   sourcemeta::jsonbinpack::OutputStream &output) -> void {
+  output.put_varint(encoding.index());
+  switch (encoding.index()) {
+    case 0: {
+      const auto &options{std::get<0>(encoding)};
+      output.put_varint_zigzag(options.minimum);
+      output.put_varint_zigzag(options.maximum);
+      output.put_varint(options.multiplier);
+      break;
+    }
+    case 1: {
+      const auto &options{std::get<1>(encoding)};
+      output.put_varint_zigzag(options.minimum);
+      output.put_varint(options.multiplier);
+      break;
+    }
+    case 2: {
+      const auto &options{std::get<2>(encoding)};
+      output.put_varint_zigzag(options.maximum);
+      output.put_varint(options.multiplier);
+      break;
+    }
+    case 3:
+      output.put_varint(std::get<3>(encoding).multiplier);
+      break;
+    case 5:
+      save_values(std::get<5>(encoding).choices, output);
+      break;
+    case 6:
+      save_values(std::get<6>(encoding).choices, output);
+      break;
+    case 7:
+      save_values(std::get<7>(encoding).choices, output);
+      break;
+    case 8:
+      save_value(std::get<8>(encoding).value, output);
+      break;
+    case 10:
+      output.put_varint(std::get<10>(encoding).size);
+      break;
+    case 11:
+      output.put_varint(std::get<11>(encoding).minimum);
+      break;
+    case 12:
+      output.put_varint(std::get<12>(encoding).maximum);
+      break;
+    case 13: {
+      const auto &options{std::get<13>(encoding)};
+      output.put_varint(options.minimum);
+      output.put_varint(options.maximum);
+      break;
+    }
+    case 16: {
+      const auto &options{std::get<16>(encoding)};
+      output.put_varint(options.size);
+      save_encoding(*options.encoding, output);
+      save_encodings(options.prefix_encodings, output);
+      break;
+    }
+    case 17: {
+      const auto &options{std::get<17>(encoding)};
+      output.put_varint(options.minimum);
+      output.put_varint(options.maximum);
+      save_encoding(*options.encoding, output);
+      save_encodings(options.prefix_encodings, output);
+      break;
+    }
+    case 18: {
+      const auto &options{std::get<18>(encoding)};
+      output.put_varint(options.minimum);
+      save_encoding(*options.encoding, output);
+      save_encodings(options.prefix_encodings, output);
+      break;
+    }
+    case 19: {
+      const auto &options{std::get<19>(encoding)};
+      output.put_varint(options.maximum);
+      save_encoding(*options.encoding, output);
+      save_encodings(options.prefix_encodings, output);
+      break;
+    }
+    case 20: {
+      const auto &options{std::get<20>(encoding)};
+      output.put_varint(options.size);
+      save_encoding(*options.key_encoding, output);
+      save_encoding(*options.encoding, output);
+      break;
+    }
+    case 21: {
+      const auto &options{std::get<21>(encoding)};
+      save_encoding(*options.key_encoding, output);
+      save_encoding(*options.encoding, output);
+      break;
+    }
+    case 22: {
+      const auto &options{std::get<22>(encoding)};
+      output.put_varint(options.minimum);
+      save_encoding(*options.encoding, output);
+      save_encodings(options.prefix_encodings, output);
+      output.put_byte(options.offsets ? 1 : 0);
+      break;
+    }
+    case 23: {
+      const auto &options{std::get<23>(encoding)};
+      save_encoding(*options.key_encoding, output);
+      save_encoding(*options.encoding, output);
+      output.put_byte(options.offsets ? 1 : 0);
+      break;
+    }
+    case 25: {
+      const auto &options{std::get<25>(encoding)};
+      output.put_varint(options.required.size());
+      for (const auto &name : options.required) {
+        save_string(name, output);
+      }
+
+      output.put_varint(options.optional.size());
+      for (const auto &name : options.optional) {
+        save_string(name, output);
+      }
+
+      save_encodings(options.encodings, output);
+      break;
+    }
+    // Encodings without options
+    default:
+      break;
+  }
+}
+
+auto load_encoding(sourcemeta::jsonbinpack::InputStream &input,
+                   const std::size_t depth)
+    -> sourcemeta::jsonbinpack::Encoding {
+  if (depth > MAXIMUM_DEPTH) {
+    throw sourcemeta::jsonbinpack::EncodingError(
+        "Invalid binary encoding: too deeply nested");
+  }
+
+  const auto index{input.get_varint()};
+  switch (index) {
+    case 0: {
+      sourcemeta::jsonbinpack::BOUNDED_MULTIPLE_8BITS_ENUM_FIXED result;
+      result.minimum = input.get_varint_zigzag();
+      result.maximum = input.get_varint_zigzag();
+      result.multiplier = input.get_varint();
+      check(result.multiplier > 0, "zero multiplier");
+      check(result.minimum <= result.maximum, "minimum above maximum");
+      const auto enum_minimum{
+          sourcemeta::core::divide_ceil(result.minimum, result.multiplier)};
+      const auto enum_maximum{
+          sourcemeta::core::divide_floor(result.maximum, result.multiplier)};
+      check(enum_maximum < enum_minimum ||
+                is_byte_range(enum_minimum, enum_maximum),
+            "too many multiples for a byte");
+      return result;
+    }
+    case 1: {
+      sourcemeta::jsonbinpack::FLOOR_MULTIPLE_ENUM_VARINT result;
+      result.minimum = input.get_varint_zigzag();
+      result.multiplier = input.get_varint();
+      check(result.multiplier > 0, "zero multiplier");
+      return result;
+    }
+    case 2: {
+      sourcemeta::jsonbinpack::ROOF_MULTIPLE_MIRROR_ENUM_VARINT result;
+      result.maximum = input.get_varint_zigzag();
+      result.multiplier = input.get_varint();
+      check(result.multiplier > 0, "zero multiplier");
+      return result;
+    }
+    case 3: {
+      const auto multiplier{input.get_varint()};
+      check(multiplier > 0, "zero multiplier");
+      return sourcemeta::jsonbinpack::ARBITRARY_MULTIPLE_ZIGZAG_VARINT{
+          .multiplier = multiplier};
+    }
+    case 4:
+      return sourcemeta::jsonbinpack::DOUBLE_VARINT_TUPLE{};
+    case 5: {
+      auto choices{load_values(input)};
+      auto choice_index{sourcemeta::jsonbinpack::make_choice_index(choices)};
+      return sourcemeta::jsonbinpack::BYTE_CHOICE_INDEX{
+          .choices = std::move(choices), .index = std::move(choice_index)};
+    }
+    case 6: {
+      auto choices{load_values(input)};
+      auto choice_index{sourcemeta::jsonbinpack::make_choice_index(choices)};
+      return sourcemeta::jsonbinpack::LARGE_CHOICE_INDEX{
+          .choices = std::move(choices), .index = std::move(choice_index)};
+    }
+    case 7: {
+      auto choices{load_values(input)};
+      auto choice_index{sourcemeta::jsonbinpack::make_choice_index(choices)};
+      return sourcemeta::jsonbinpack::TOP_LEVEL_BYTE_CHOICE_INDEX{
+          .choices = std::move(choices), .index = std::move(choice_index)};
+    }
+    case 8:
+      return sourcemeta::jsonbinpack::CONST_NONE{.value = load_value(input)};
+    case 9:
+      return sourcemeta::jsonbinpack::ANY_PACKED_TYPE_TAG_BYTE_PREFIX{};
+    case 10:
+      return sourcemeta::jsonbinpack::UTF8_STRING_NO_LENGTH{
+          .size = input.get_varint()};
+    case 11:
+      return sourcemeta::jsonbinpack::FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED{
+          .minimum = input.get_varint()};
+    case 12:
+      return sourcemeta::jsonbinpack::ROOF_VARINT_PREFIX_UTF8_STRING_SHARED{
+          .maximum = input.get_varint()};
+    case 13: {
+      sourcemeta::jsonbinpack::BOUNDED_8BIT_PREFIX_UTF8_STRING_SHARED result;
+      result.minimum = input.get_varint();
+      result.maximum = input.get_varint();
+      check(result.minimum <= result.maximum, "minimum above maximum");
+      check(result.maximum - result.minimum <= 0xff,
+            "too long of a range for a byte");
+      return result;
+    }
+    case 14:
+      return sourcemeta::jsonbinpack::RFC3339_DATE_INTEGER_TRIPLET{};
+    case 15:
+      return sourcemeta::jsonbinpack::PREFIX_VARINT_LENGTH_STRING_SHARED{};
+    case 16: {
+      sourcemeta::jsonbinpack::FIXED_TYPED_ARRAY result;
+      result.size = input.get_varint();
+      result.encoding = load_shared_encoding(input, depth + 1);
+      result.prefix_encodings = load_encodings(input, depth + 1);
+      return result;
+    }
+    case 17: {
+      sourcemeta::jsonbinpack::BOUNDED_8BITS_TYPED_ARRAY result;
+      result.minimum = input.get_varint();
+      result.maximum = input.get_varint();
+      check(result.minimum <= result.maximum, "minimum above maximum");
+      check(result.maximum - result.minimum <= 0xff,
+            "too long of a range for a byte");
+      result.encoding = load_shared_encoding(input, depth + 1);
+      result.prefix_encodings = load_encodings(input, depth + 1);
+      return result;
+    }
+    case 18: {
+      sourcemeta::jsonbinpack::FLOOR_TYPED_ARRAY result;
+      result.minimum = input.get_varint();
+      result.encoding = load_shared_encoding(input, depth + 1);
+      result.prefix_encodings = load_encodings(input, depth + 1);
+      return result;
+    }
+    case 19: {
+      sourcemeta::jsonbinpack::ROOF_TYPED_ARRAY result;
+      result.maximum = input.get_varint();
+      result.encoding = load_shared_encoding(input, depth + 1);
+      result.prefix_encodings = load_encodings(input, depth + 1);
+      return result;
+    }
+    case 20: {
+      sourcemeta::jsonbinpack::FIXED_TYPED_ARBITRARY_OBJECT result;
+      result.size = input.get_varint();
+      result.key_encoding = load_shared_encoding(input, depth + 1);
+      result.encoding = load_shared_encoding(input, depth + 1);
+      return result;
+    }
+    case 21: {
+      sourcemeta::jsonbinpack::VARINT_TYPED_ARBITRARY_OBJECT result;
+      result.key_encoding = load_shared_encoding(input, depth + 1);
+      result.encoding = load_shared_encoding(input, depth + 1);
+      return result;
+    }
+    case 22: {
+      sourcemeta::jsonbinpack::FLOOR_TYPED_LENGTH_PREFIX_ARRAY result;
+      result.minimum = input.get_varint();
+      result.encoding = load_shared_encoding(input, depth + 1);
+      result.prefix_encodings = load_encodings(input, depth + 1);
+      result.offsets = input.get_byte() != 0;
+      return result;
+    }
+    case 23: {
+      sourcemeta::jsonbinpack::VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT
+          result;
+      result.key_encoding = load_shared_encoding(input, depth + 1);
+      result.encoding = load_shared_encoding(input, depth + 1);
+      result.offsets = input.get_byte() != 0;
+      return result;
+    }
+    case 24:
+      return sourcemeta::jsonbinpack::GZIP_VARINT_PREFIX_UTF8_STRING{};
+    case 25: {
+      sourcemeta::jsonbinpack::MIXED_BOUNDED_TYPED_OBJECT result;
+      // Like any other count, these are untrusted
+      const auto required{input.get_varint()};
+      for (std::uint64_t cursor = 0; cursor < required; cursor++) {
+        result.required.push_back(load_string(input));
+      }
+
+      const auto optional{input.get_varint()};
+      for (std::uint64_t cursor = 0; cursor < optional; cursor++) {
+        result.optional.push_back(load_string(input));
+      }
+
+      std::unordered_set<std::string_view> names;
+      for (const auto &name : result.required) {
+        check(names.insert(name).second, "duplicate property");
+      }
+
+      for (const auto &name : result.optional) {
+        check(names.insert(name).second, "duplicate property");
+      }
+
+      result.encodings = load_encodings(input, depth + 1);
+      check(result.encodings.size() ==
+                result.required.size() + result.optional.size(),
+            "mismatched property encodings");
+
+      return result;
+    }
+    default:
+      std::ostringstream error;
+      error << "Unrecognized binary encoding: " << index;
+      throw sourcemeta::jsonbinpack::EncodingError(error.str());
+  }
+}
+
+} // namespace
+
+namespace sourcemeta::jsonbinpack {
+
+auto save(const Encoding &encoding, std::vector<std::byte> &output) -> void {
+  OutputStream stream{output};
+  stream.put_byte(FORMAT_VERSION);
+  save_encoding(encoding, stream);
+}
+
+auto load(std::span<const std::byte> input) -> Encoding {
+  InputStream stream{input};
+  const auto version{stream.get_byte()};
+  if (version != FORMAT_VERSION) {
+    throw EncodingError("Unsupported binary encoding format version: " +
+                        std::to_string(version));
+  }
+
+  auto result{load_encoding(stream, 0)};
+  if (stream.has_more_data()) {
+    throw EncodingError("Invalid binary encoding: trailing bytes");
+  }
+
+  return result;
+}
+
+} // namespace sourcemeta::jsonbinpack
@@ -0,0 +1,21 @@
+#ifndef SOURCEMETA_JSONBINPACK_RUNTIME_VARINT_H_
+#define SOURCEMETA_JSONBINPACK_RUNTIME_VARINT_H_
+
+#include <cstdint> // std::uint64_t
+
+namespace sourcemeta::jsonbinpack::internal {
+
+// The number of bytes that writing the given value as a varint takes
+inline auto varint_size(std::uint64_t value) -> std::uint64_t {
+  std::uint64_t result{1};
+  while (value >= 0x80) {
+    value >>= 7;
+    result++;
+  }
+
+  return result;
+}
+
+} // namespace sourcemeta::jsonbinpack::internal
+
+#endif
@@ -0,0 +1,326 @@
+#include <sourcemeta/core/json.h>
+#include <sourcemeta/core/test.h>
+#include <sourcemeta/jsonbinpack/compiler.h>
+
+TEST(unbounded) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "array"
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "FLOOR_TYPED_ARRAY",
+    "binpackOptions": {
+      "minimum": 0,
+      "encoding": {
+        "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+        "binpackEncoding": "ANY_PACKED_TYPE_TAG_BYTE_PREFIX",
+        "binpackOptions": {}
+      },
+      "prefixEncodings": []
+    }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(min_items) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "array",
+    "minItems": 2,
+    "items": { "type": "integer", "minimum": 0 }
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "FLOOR_TYPED_ARRAY",
+    "binpackOptions": {
+      "minimum": 2,
+      "encoding": {
+        "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+        "binpackEncoding": "FLOOR_MULTIPLE_ENUM_VARINT",
+        "binpackOptions": { "minimum": 0, "multiplier": 1 }
+      },
+      "prefixEncodings": []
+    }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(max_items_8_bit) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "array",
+    "maxItems": 255,
+    "items": { "type": "number" }
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "BOUNDED_8BITS_TYPED_ARRAY",
+    "binpackOptions": {
+      "minimum": 0,
+      "maximum": 255,
+      "encoding": {
+        "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+        "binpackEncoding": "DOUBLE_VARINT_TUPLE",
+        "binpackOptions": {}
+      },
+      "prefixEncodings": []
+    }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(max_items_greater_than_8_bit) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "array",
+    "minItems": 1,
+    "maxItems": 257
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "FLOOR_TYPED_ARRAY",
+    "binpackOptions": {
+      "minimum": 1,
+      "encoding": {
+        "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+        "binpackEncoding": "ANY_PACKED_TYPE_TAG_BYTE_PREFIX",
+        "binpackOptions": {}
+      },
+      "prefixEncodings": []
+    }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(fixed_size) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "array",
+    "minItems": 3,
+    "maxItems": 3,
+    "items": { "type": "number" }
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "FIXED_TYPED_ARRAY",
+    "binpackOptions": {
+      "size": 3,
+      "encoding": {
+        "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+        "binpackEncoding": "DOUBLE_VARINT_TUPLE",
+        "binpackOptions": {}
+      },
+      "prefixEncodings": []
+    }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(prefix_items) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "array",
+    "prefixItems": [
+      { "type": "string", "format": "date" },
+      { "enum": [ "foo", "bar" ] }
+    ],
+    "items": { "type": "integer", "maximum": 100 }
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "FLOOR_TYPED_ARRAY",
+    "binpackOptions": {
+      "minimum": 0,
+      "encoding": {
+        "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+        "binpackEncoding": "ROOF_MULTIPLE_MIRROR_ENUM_VARINT",
+        "binpackOptions": { "maximum": 100, "multiplier": 1 }
+      },
+      "prefixEncodings": [
+        {
+          "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+          "binpackEncoding": "FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED",
+          "binpackOptions": { "minimum": 0 }
+        },
+        {
+          "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+          "binpackEncoding": "BYTE_CHOICE_INDEX",
+          "binpackOptions": { "choices": [ "foo", "bar" ] }
+        }
+      ]
+    }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(prefix_items_closed) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "array",
+    "minItems": 1,
+    "prefixItems": [ { "type": "number" }, { "type": "number" } ],
+    "items": false
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "BOUNDED_8BITS_TYPED_ARRAY",
+    "binpackOptions": {
+      "minimum": 1,
+      "maximum": 2,
+      "encoding": {
+        "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+        "binpackEncoding": "ANY_PACKED_TYPE_TAG_BYTE_PREFIX",
+        "binpackOptions": {}
+      },
+      "prefixEncodings": [
+        {
+          "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+          "binpackEncoding": "DOUBLE_VARINT_TUPLE",
+          "binpackOptions": {}
+        },
+        {
+          "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+          "binpackEncoding": "DOUBLE_VARINT_TUPLE",
+          "binpackOptions": {}
+        }
+      ]
+    }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(prefix_items_closed_fixed) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "array",
+    "minItems": 2,
+    "prefixItems": [ { "type": "number" }, { "type": "number" } ],
+    "items": false
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "FIXED_TYPED_ARRAY",
+    "binpackOptions": {
+      "size": 2,
+      "encoding": {
+        "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+        "binpackEncoding": "ANY_PACKED_TYPE_TAG_BYTE_PREFIX",
+        "binpackOptions": {}
+      },
+      "prefixEncodings": [
+        {
+          "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+          "binpackEncoding": "DOUBLE_VARINT_TUPLE",
+          "binpackOptions": {}
+        },
+        {
+          "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+          "binpackEncoding": "DOUBLE_VARINT_TUPLE",
+          "binpackOptions": {}
+        }
+      ]
+    }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(nested) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "array",
+    "items": {
+      "type": "array",
+      "minItems": 2,
+      "maxItems": 2,
+      "items": { "type": "number" }
+    }
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "FLOOR_TYPED_ARRAY",
+    "binpackOptions": {
+      "minimum": 0,
+      "encoding": {
+        "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+        "binpackEncoding": "FIXED_TYPED_ARRAY",
+        "binpackOptions": {
+          "size": 2,
+          "encoding": {
+            "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+            "binpackEncoding": "DOUBLE_VARINT_TUPLE",
+            "binpackOptions": {}
+          },
+          "prefixEncodings": []
+        }
+      },
+      "prefixEncodings": []
+    }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(reference) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "array",
+    "items": { "$ref": "#/$defs/string" },
+    "$defs": { "string": { "type": "string" } }
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "ANY_PACKED_TYPE_TAG_BYTE_PREFIX",
+    "binpackOptions": {}
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
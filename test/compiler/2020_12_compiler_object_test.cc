@@ -0,0 +1,264 @@
+#include <sourcemeta/core/json.h>
+#include <sourcemeta/core/test.h>
+#include <sourcemeta/jsonbinpack/compiler.h>
+
+TEST(unbounded) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "object"
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "VARINT_TYPED_ARBITRARY_OBJECT",
+    "binpackOptions": {
+      "keyEncoding": {
+        "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+        "binpackEncoding": "FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED",
+        "binpackOptions": { "minimum": 0 }
+      },
+      "encoding": {
+        "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+        "binpackEncoding": "ANY_PACKED_TYPE_TAG_BYTE_PREFIX",
+        "binpackOptions": {}
+      }
+    }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(additional_properties_schema) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "object",
+    "additionalProperties": { "type": "integer", "minimum": 0 }
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "VARINT_TYPED_ARBITRARY_OBJECT",
+    "binpackOptions": {
+      "keyEncoding": {
+        "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+        "binpackEncoding": "FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED",
+        "binpackOptions": { "minimum": 0 }
+      },
+      "encoding": {
+        "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+        "binpackEncoding": "FLOOR_MULTIPLE_ENUM_VARINT",
+        "binpackOptions": { "minimum": 0, "multiplier": 1 }
+      }
+    }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(property_names_enum_fixed_size) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "object",
+    "minProperties": 2,
+    "maxProperties": 2,
+    "propertyNames": { "enum": [ "foo", "bar", "baz" ] },
+    "additionalProperties": { "type": "boolean" }
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "FIXED_TYPED_ARBITRARY_OBJECT",
+    "binpackOptions": {
+      "size": 2,
+      "keyEncoding": {
+        "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+        "binpackEncoding": "BYTE_CHOICE_INDEX",
+        "binpackOptions": { "choices": [ "foo", "bar", "baz" ] }
+      },
+      "encoding": {
+        "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+        "binpackEncoding": "BYTE_CHOICE_INDEX",
+        "binpackOptions": { "choices": [ false, true ] }
+      }
+    }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(closed_required_and_optional) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "object",
+    "properties": {
+      "name": { "type": "string" },
+      "id": { "type": "integer", "minimum": 0, "maximum": 10 },
+      "tag": { "enum": [ "foo", "bar" ] }
+    },
+    "required": [ "id" ],
+    "additionalProperties": false
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "MIXED_BOUNDED_TYPED_OBJECT",
+    "binpackOptions": {
+      "requiredProperties": [ "id" ],
+      "optionalProperties": [ "name", "tag" ],
+      "propertyEncodings": {
+        "id": {
+          "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+          "binpackEncoding": "BOUNDED_MULTIPLE_8BITS_ENUM_FIXED",
+          "binpackOptions": { "minimum": 0, "maximum": 10, "multiplier": 1 }
+        },
+        "name": {
+          "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+          "binpackEncoding": "FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED",
+          "binpackOptions": { "minimum": 0 }
+        },
+        "tag": {
+          "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+          "binpackEncoding": "BYTE_CHOICE_INDEX",
+          "binpackOptions": { "choices": [ "foo", "bar" ] }
+        }
+      }
+    }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(closed_unevaluated_properties_undescribed_required) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "object",
+    "properties": { "foo": { "type": "boolean" } },
+    "required": [ "foo", "bar" ],
+    "unevaluatedProperties": false
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "MIXED_BOUNDED_TYPED_OBJECT",
+    "binpackOptions": {
+      "requiredProperties": [ "foo", "bar" ],
+      "optionalProperties": [],
+      "propertyEncodings": {
+        "foo": {
+          "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+          "binpackEncoding": "BYTE_CHOICE_INDEX",
+          "binpackOptions": { "choices": [ false, true ] }
+        },
+        "bar": {
+          "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+          "binpackEncoding": "ANY_PACKED_TYPE_TAG_BYTE_PREFIX",
+          "binpackOptions": {}
+        }
+      }
+    }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(closed_nested) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "object",
+    "properties": {
+      "point": {
+        "type": "object",
+        "properties": { "x": { "type": "integer" } },
+        "required": [ "x" ],
+        "additionalProperties": false
+      }
+    },
+    "additionalProperties": false
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "MIXED_BOUNDED_TYPED_OBJECT",
+    "binpackOptions": {
+      "requiredProperties": [],
+      "optionalProperties": [ "point" ],
+      "propertyEncodings": {
+        "point": {
+          "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+          "binpackEncoding": "MIXED_BOUNDED_TYPED_OBJECT",
+          "binpackOptions": {
+            "requiredProperties": [ "x" ],
+            "optionalProperties": [],
+            "propertyEncodings": {
+              "x": {
+                "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+                "binpackEncoding": "ARBITRARY_MULTIPLE_ZIGZAG_VARINT",
+                "binpackOptions": { "multiplier": 1 }
+              }
+            }
+          }
+        }
+      }
+    }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(open_with_properties) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "object",
+    "properties": { "foo": { "type": "string" } }
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "ANY_PACKED_TYPE_TAG_BYTE_PREFIX",
+    "binpackOptions": {}
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(closed_with_pattern_properties) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "object",
+    "properties": { "foo": { "type": "string" } },
+    "patternProperties": { "^x-": { "type": "string" } },
+    "additionalProperties": false
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "ANY_PACKED_TYPE_TAG_BYTE_PREFIX",
+    "binpackOptions": {}
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
@@ -0,0 +1,393 @@
+#include <sourcemeta/core/json.h>
+#include <sourcemeta/core/test.h>
+#include <sourcemeta/jsonbinpack/compiler.h>
+
+#include <optional>    // std::optional
+#include <string_view> // std::string_view
+
+// A dialect that asserts formats instead of annotating them
+static auto format_assertion_resolver(const std::string_view identifier)
+    -> std::optional<sourcemeta::core::JSON> {
+  if (identifier == "https://example.com/format-assertion") {
+    return sourcemeta::core::parse_json(R"JSON({
+      "$schema": "https://json-schema.org/draft/2020-12/schema",
+      "$id": "https://example.com/format-assertion",
+      "$vocabulary": {
+        "https://json-schema.org/draft/2020-12/vocab/core": true,
+        "https://json-schema.org/draft/2020-12/vocab/applicator": true,
+        "https://json-schema.org/draft/2020-12/vocab/validation": true,
+        "https://json-schema.org/draft/2020-12/vocab/format-assertion": true
+      },
+      "$dynamicAnchor": "meta"
+    })JSON");
+  }
+
+  return sourcemeta::blaze::schema_resolver(identifier);
+}
+
+TEST(unbounded) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "string"
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED",
+    "binpackOptions": { "minimum": 0 }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(min_length) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "string",
+    "minLength": 3
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED",
+    "binpackOptions": { "minimum": 3 }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(max_length_8_bit) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "string",
+    "maxLength": 63
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "BOUNDED_8BIT_PREFIX_UTF8_STRING_SHARED",
+    "binpackOptions": { "minimum": 0, "maximum": 252 }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(max_length_greater_than_8_bit) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "string",
+    "maxLength": 64
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED",
+    "binpackOptions": { "minimum": 0 }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(min_max_length_8_bit) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "string",
+    "minLength": 10,
+    "maxLength": 66
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "BOUNDED_8BIT_PREFIX_UTF8_STRING_SHARED",
+    "binpackOptions": { "minimum": 10, "maximum": 264 }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(min_max_length_greater_than_8_bit) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "string",
+    "minLength": 10,
+    "maxLength": 67
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED",
+    "binpackOptions": { "minimum": 10 }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(equal_min_max_length) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "string",
+    "minLength": 8,
+    "maxLength": 8
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "BOUNDED_8BIT_PREFIX_UTF8_STRING_SHARED",
+    "binpackOptions": { "minimum": 8, "maximum": 32 }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(format_date) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "string",
+    "format": "date"
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED",
+    "binpackOptions": { "minimum": 0 }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(format_date_assertion) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://example.com/format-assertion",
+    "type": "string",
+    "format": "date"
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   format_assertion_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "RFC3339_DATE_INTEGER_TRIPLET",
+    "binpackOptions": {}
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(format_date_compressed) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://example.com/format-assertion",
+    "type": "string",
+    "format": "date",
+    "x-binpack-compress": true
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   format_assertion_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "RFC3339_DATE_INTEGER_TRIPLET",
+    "binpackOptions": {}
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(format_uuid_annotation) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "string",
+    "format": "uuid"
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED",
+    "binpackOptions": { "minimum": 0 }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(format_uuid_annotation_fixed_length) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "string",
+    "format": "uuid",
+    "minLength": 36,
+    "maxLength": 36
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "UTF8_STRING_NO_LENGTH",
+    "binpackOptions": { "size": 36 }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(format_uuid_assertion) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://example.com/format-assertion",
+    "type": "string",
+    "format": "uuid"
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   format_assertion_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "UTF8_STRING_NO_LENGTH",
+    "binpackOptions": { "size": 36 }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(format_unknown) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "string",
+    "format": "email"
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED",
+    "binpackOptions": { "minimum": 0 }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(compressed_max_length) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "string",
+    "maxLength": 10,
+    "x-binpack-compress": true
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "GZIP_VARINT_PREFIX_UTF8_STRING",
+    "binpackOptions": {}
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(compressed_min_length) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "string",
+    "minLength": 256
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "GZIP_VARINT_PREFIX_UTF8_STRING",
+    "binpackOptions": {}
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(compressed_annotation) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "string",
+    "x-binpack-compress": true
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "GZIP_VARINT_PREFIX_UTF8_STRING",
+    "binpackOptions": {}
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(compressed_short_min_length) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "string",
+    "minLength": 255
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED",
+    "binpackOptions": { "minimum": 255 }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
+
+TEST(compressed_annotation_false) {
+  auto schema = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "string",
+    "x-binpack-compress": false
+  })JSON");
+
+  sourcemeta::jsonbinpack::compile(schema, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+
+  const auto expected = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED",
+    "binpackOptions": { "minimum": 0 }
+  })JSON");
+
+  EXPECT_EQ(schema, expected);
+}
@@ -0,0 +1,189 @@
+#include <sourcemeta/core/json.h>
+#include <sourcemeta/core/test.h>
+#include <sourcemeta/jsonbinpack/compiler.h>
+
+#include <cstddef>    // std::size_t
+#include <filesystem> // std::filesystem
+#include <fstream>    // std::ifstream, std::ofstream
+#include <string>     // std::string
+
+static auto cache_directory(const std::string &name) -> std::filesystem::path {
+  const auto result{std::filesystem::temp_directory_path() /
+                    ("jsonbinpack_compiler_cache_" + name)};
+  std::filesystem::remove_all(result);
+  return result;
+}
+
+static auto string_schema() -> sourcemeta::core::JSON {
+  return sourcemeta::core::parse_json(R"JSON({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "string",
+    "maxLength": 5
+  })JSON");
+}
+
+TEST(compiler_cache_miss) {
+  const auto directory{cache_directory("miss")};
+  const sourcemeta::jsonbinpack::CompilerCache cache{directory};
+  auto schema{string_schema()};
+  const auto entry_path{cache.path(schema)};
+  EXPECT_FALSE(std::filesystem::exists(entry_path));
+
+  cache.compile(schema, sourcemeta::blaze::schema_walker,
+                sourcemeta::blaze::schema_resolver);
+
+  auto expected{string_schema()};
+  sourcemeta::jsonbinpack::compile(expected, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+  EXPECT_EQ(schema, expected);
+
+  EXPECT_TRUE(std::filesystem::is_regular_file(entry_path));
+  const auto entry{sourcemeta::core::read_json(entry_path)};
+  EXPECT_EQ(entry.at("schema"), string_schema());
+  EXPECT_EQ(entry.at("encoding"), expected);
+  EXPECT_EQ(entry.at("defaultDialect").to_string(), "");
+
+  // No temporary files are left behind
+  std::size_t count{0};
+  for (const auto &file : std::filesystem::directory_iterator{directory}) {
+    EXPECT_EQ(file.path(), entry_path);
+    count += 1;
+  }
+
+  EXPECT_EQ(count, 1);
+  std::filesystem::remove_all(directory);
+}
+
+TEST(compiler_cache_hit) {
+  const auto directory{cache_directory("hit")};
+  const sourcemeta::jsonbinpack::CompilerCache cache{directory};
+  auto first{string_schema()};
+  cache.compile(first, sourcemeta::blaze::schema_walker,
+                sourcemeta::blaze::schema_resolver);
+
+  // Tamper with the entry to tell whether the cache compiles again
+  const auto entry_path{cache.path(string_schema())};
+  auto entry{sourcemeta::core::read_json(entry_path)};
+  entry.at("encoding").assign("binpackEncoding",
+                              sourcemeta::core::JSON{"FROM_CACHE"});
+  {
+    std::ofstream stream{entry_path};
+    sourcemeta::core::stringify(entry, stream);
+  }
+
+  // Another cache over the same directory, like in another process
+  const sourcemeta::jsonbinpack::CompilerCache other{directory};
+  auto second{string_schema()};
+  other.compile(second, sourcemeta::blaze::schema_walker,
+                sourcemeta::blaze::schema_resolver);
+  EXPECT_EQ(second.at("binpackEncoding").to_string(), "FROM_CACHE");
+  EXPECT_EQ(second.at("binpackOptions"), first.at("binpackOptions"));
+  std::filesystem::remove_all(directory);
+}
+
+TEST(compiler_cache_default_dialect) {
+  const auto directory{cache_directory("default_dialect")};
+  const sourcemeta::jsonbinpack::CompilerCache cache{directory};
+  const auto schema{sourcemeta::core::parse_json(R"JSON({
+    "type": "string"
+  })JSON")};
+
+  EXPECT_FALSE(
+      cache.path(schema, "https://json-schema.org/draft/2020-12/schema") ==
+      cache.path(schema, "https://json-schema.org/draft/2019-09/schema"));
+
+  auto result{schema};
+  cache.compile(result, sourcemeta::blaze::schema_walker,
+                sourcemeta::blaze::schema_resolver,
+                "https://json-schema.org/draft/2020-12/schema");
+  EXPECT_TRUE(std::filesystem::is_regular_file(
+      cache.path(schema, "https://json-schema.org/draft/2020-12/schema")));
+  EXPECT_FALSE(std::filesystem::exists(
+      cache.path(schema, "https://json-schema.org/draft/2019-09/schema")));
+  EXPECT_EQ(result.at("binpackEncoding").to_string(),
+            "FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED");
+  std::filesystem::remove_all(directory);
+}
+
+TEST(compiler_cache_schema_mismatch) {
+  const auto directory{cache_directory("schema_mismatch")};
+  const sourcemeta::jsonbinpack::CompilerCache cache{directory};
+  auto schema{string_schema()};
+
+  // An entry for another schema, as if the fingerprints collided
+  const auto entry_path{cache.path(schema)};
+  auto entry{sourcemeta::core::JSON::make_object()};
+  entry.assign("version", sourcemeta::core::JSON{"0.0.0"});
+  entry.assign("defaultDialect", sourcemeta::core::JSON{""});
+  entry.assign("schema", sourcemeta::core::JSON::make_object());
+  entry.assign("encoding", sourcemeta::core::JSON::make_object());
+  std::filesystem::create_directories(directory);
+  {
+    std::ofstream stream{entry_path};
+    sourcemeta::core::stringify(entry, stream);
+  }
+
+  cache.compile(schema, sourcemeta::blaze::schema_walker,
+                sourcemeta::blaze::schema_resolver);
+  auto expected{string_schema()};
+  sourcemeta::jsonbinpack::compile(expected, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+  EXPECT_EQ(schema, expected);
+  EXPECT_EQ(sourcemeta::core::read_json(entry_path).at("schema"),
+            string_schema());
+  std::filesystem::remove_all(directory);
+}
+
+TEST(compiler_cache_corrupted_entry) {
+  const auto directory{cache_directory("corrupted_entry")};
+  const sourcemeta::jsonbinpack::CompilerCache cache{directory};
+  auto schema{string_schema()};
+  const auto entry_path{cache.path(schema)};
+  std::filesystem::create_directories(directory);
+  {
+    std::ofstream stream{entry_path};
+    stream << "{\"version\":";
+  }
+
+  cache.compile(schema, sourcemeta::blaze::schema_walker,
+                sourcemeta::blaze::schema_resolver);
+  auto expected{string_schema()};
+  sourcemeta::jsonbinpack::compile(expected, sourcemeta::blaze::schema_walker,
+                                   sourcemeta::blaze::schema_resolver);
+  EXPECT_EQ(schema, expected);
+  EXPECT_EQ(sourcemeta::core::read_json(entry_path).at("encoding"), expected);
+  std::filesystem::remove_all(directory);
+}
+
+TEST(compiler_cache_unreadable_entry) {
+  const auto directory{cache_directory("unreadable_entry")};
+  const sourcemeta::jsonbinpack::CompilerCache cache{directory};
+  auto first{string_schema()};
+  cache.compile(first, sourcemeta::blaze::schema_walker,
+                sourcemeta::blaze::schema_resolver);
+
+  // Tamper with the entry to tell whether the cache read it
+  const auto entry_path{cache.path(string_schema())};
+  auto entry{sourcemeta::core::read_json(entry_path)};
+  entry.at("encoding").assign("binpackEncoding",
+                              sourcemeta::core::JSON{"FROM_CACHE"});
+  {
+    std::ofstream stream{entry_path};
+    sourcemeta::core::stringify(entry, stream);
+  }
+
+  std::filesystem::permissions(entry_path, std::filesystem::perms::none);
+  // Privileged users can read the entry regardless of its permissions
+  const bool readable{std::ifstream{entry_path}.is_open()};
+
+  auto second{string_schema()};
+  cache.compile(second, sourcemeta::blaze::schema_walker,
+                sourcemeta::blaze::schema_resolver);
+  if (readable) {
+    EXPECT_EQ(second.at("binpackEncoding").to_string(), "FROM_CACHE");
+  } else {
+    EXPECT_EQ(second, first);
+  }
+
+  std::filesystem::remove_all(directory);
+}
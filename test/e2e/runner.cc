@@ -3,6 +3,7 @@
 
 #include <sourcemeta/blaze/format.h>
 #include <sourcemeta/blaze/foundation.h>
+#include <sourcemeta/core/io.h>
 #include <sourcemeta/core/json.h>
 
 #include <cassert>    // assert
@@ -86,6 +87,15 @@ auto main(int argc, char *argv[]) -> int {
   sourcemeta::jsonbinpack::Decoder decoder{data_stream};
   const sourcemeta::core::JSON result = decoder.read(encoding);
 
+  // Decoder (memory-mapped)
+  const sourcemeta::core::FileView view{directory / "output.bin"};
+  sourcemeta::jsonbinpack::Decoder view_decoder{view};
+  const sourcemeta::core::JSON view_result = view_decoder.read(encoding);
+  if (view_result != result) {
+    std::cerr << "The memory-mapped decoder disagrees with the stream one\n";
+    return EXIT_FAILURE;
+  }
+
   // Report results
   if (result == instance) {
     return EXIT_SUCCESS;
@@ -0,0 +1,105 @@
+#include <sourcemeta/core/json.h>
+#include <sourcemeta/core/test.h>
+#include <sourcemeta/jsonbinpack/runtime.h>
+
+#include <cstddef> // std::byte, std::size_t
+#include <cstdint> // std::int64_t
+#include <span>    // std::span
+#include <string>  // std::to_string
+#include <utility> // std::move
+#include <vector>  // std::vector
+
+static auto records(const std::size_t size)
+    -> std::vector<sourcemeta::core::JSON> {
+  std::vector<sourcemeta::core::JSON> result;
+  for (std::size_t index = 0; index < size; index++) {
+    auto record{sourcemeta::core::JSON::make_object()};
+    record.assign("sequence",
+                  sourcemeta::core::JSON{static_cast<std::int64_t>(index)});
+    record.assign("level", sourcemeta::core::JSON{"information"});
+    record.assign("message", sourcemeta::core::JSON{"event number " +
+                                                    std::to_string(index)});
+    result.push_back(std::move(record));
+  }
+
+  return result;
+}
+
+TEST(batch_encode_records) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  const auto documents{records(3)};
+  std::vector<std::byte> output;
+  encode_batch(documents, encoding, output, 2);
+
+  // Every record is the length of the document encoded on its own
+  std::vector<std::byte> expected;
+  for (const auto &document : documents) {
+    std::vector<std::byte> record;
+    Encoder encoder{record};
+    encoder.write(document, encoding);
+    expected.push_back(static_cast<std::byte>(record.size()));
+    expected.insert(expected.end(), record.cbegin(), record.cend());
+  }
+
+  EXPECT_EQ(output, expected);
+}
+
+TEST(batch_round_trip) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  const auto documents{records(1000)};
+  for (const std::size_t parallelism : {0U, 1U, 3U, 8U}) {
+    std::vector<std::byte> output;
+    encode_batch(documents, encoding, output, parallelism);
+    EXPECT_EQ(decode_batch(output, encoding, parallelism), documents);
+  }
+}
+
+TEST(batch_parallelism_does_not_change_output) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  const auto documents{records(500)};
+  std::vector<std::byte> sequential;
+  encode_batch(documents, encoding, sequential, 1);
+  std::vector<std::byte> parallel;
+  encode_batch(documents, encoding, parallel, 8);
+  EXPECT_EQ(sequential, parallel);
+}
+
+TEST(batch_appends) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  const auto documents{records(10)};
+  std::vector<std::byte> output;
+  encode_batch(std::span{documents}.first(4), encoding, output, 2);
+  encode_batch(std::span{documents}.subspan(4), encoding, output, 2);
+  EXPECT_EQ(decode_batch(output, encoding, 2), documents);
+}
+
+TEST(batch_empty) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  std::vector<std::byte> output;
+  encode_batch({}, encoding, output);
+  EXPECT_TRUE(output.empty());
+  EXPECT_TRUE(decode_batch(output, encoding).empty());
+}
+
+TEST(batch_truncated) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  const auto documents{records(2)};
+  std::vector<std::byte> output;
+  encode_batch(documents, encoding, output);
+  output.pop_back();
+
+  bool thrown{false};
+  try {
+    decode_batch(output, encoding);
+  } catch (const sourcemeta::core::IOReadOutOfBoundsError &) {
+    thrown = true;
+  }
+
+  EXPECT_TRUE(thrown);
+}
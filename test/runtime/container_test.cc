@@ -0,0 +1,225 @@
+#include <sourcemeta/core/io.h>
+#include <sourcemeta/core/json.h>
+#include <sourcemeta/core/test.h>
+#include <sourcemeta/jsonbinpack/runtime.h>
+
+#include <cstddef>    // std::byte, std::size_t
+#include <filesystem> // std::filesystem
+#include <fstream>    // std::ofstream
+#include <ios>        // std::ios
+#include <memory>     // std::make_shared
+#include <vector>     // std::vector
+
+// Every document of the end-to-end test corpora
+static auto corpus() -> std::vector<sourcemeta::core::JSON> {
+  std::vector<sourcemeta::core::JSON> result;
+  for (const auto &entry :
+       std::filesystem::directory_iterator{JSONBINPACK_E2E_DIRECTORY}) {
+    const auto path{entry.path() / "document.json"};
+    if (std::filesystem::is_regular_file(path)) {
+      result.push_back(sourcemeta::core::read_json(path));
+    }
+  }
+
+  return result;
+}
+
+TEST(container_round_trip_e2e) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  const auto documents{corpus()};
+  EXPECT_TRUE(documents.size() > 20);
+
+  std::vector<std::byte> output;
+  ContainerWriter writer{output, encoding};
+  for (const auto &document : documents) {
+    writer.write(document);
+  }
+
+  EXPECT_EQ(writer.size(), documents.size());
+  writer.close();
+
+  const ContainerReader reader{output, encoding};
+  EXPECT_EQ(reader.size(), documents.size());
+  // In reverse, as every frame is reachable on its own
+  for (std::size_t index = documents.size(); index > 0; index--) {
+    EXPECT_EQ(reader.read(index - 1), documents[index - 1]);
+  }
+
+  EXPECT_EQ(reader.read_all(1), documents);
+  EXPECT_EQ(reader.read_all(4), documents);
+}
+
+TEST(container_round_trip_e2e_parallel) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  const auto documents{corpus()};
+
+  std::vector<std::byte> sequential;
+  ContainerWriter sequential_writer{sequential, encoding};
+  for (const auto &document : documents) {
+    sequential_writer.write(document);
+  }
+
+  sequential_writer.close();
+
+  std::vector<std::byte> parallel;
+  ContainerWriter parallel_writer{parallel, encoding};
+  parallel_writer.write(documents, 4);
+  parallel_writer.close();
+
+  EXPECT_EQ(sequential, parallel);
+}
+
+TEST(container_frame) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  std::vector<std::byte> output;
+  ContainerWriter writer{output, encoding};
+  writer.write(sourcemeta::core::JSON{"foo"});
+  writer.write(sourcemeta::core::JSON{1});
+  writer.close();
+
+  const ContainerReader reader{output, encoding};
+  EXPECT_EQ(reader.size(), 2);
+  const std::vector<std::byte> first{reader.frame(0).begin(),
+                                     reader.frame(0).end()};
+  const std::vector<std::byte> second{reader.frame(1).begin(),
+                                      reader.frame(1).end()};
+  EXPECT_EQ(first, (std::vector<std::byte>{std::byte{0x21}, std::byte{'f'},
+                                           std::byte{'o'}, std::byte{'o'}}));
+  EXPECT_EQ(second, (std::vector<std::byte>{std::byte{0x15}}));
+}
+
+TEST(container_append) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  const auto documents{corpus()};
+  std::vector<std::byte> output;
+
+  {
+    ContainerWriter writer{output, encoding};
+    writer.write(documents[0]);
+    writer.write(documents[1]);
+    writer.close();
+  }
+
+  {
+    ContainerWriter writer{output, encoding};
+    EXPECT_EQ(writer.size(), 2);
+    writer.write(documents[2]);
+    writer.close();
+  }
+
+  const ContainerReader reader{output, encoding};
+  EXPECT_EQ(reader.size(), 3);
+  EXPECT_EQ(reader.read(0), documents[0]);
+  EXPECT_EQ(reader.read(1), documents[1]);
+  EXPECT_EQ(reader.read(2), documents[2]);
+}
+
+TEST(container_empty) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  std::vector<std::byte> output;
+  ContainerWriter writer{output, encoding};
+  writer.close();
+
+  const ContainerReader reader{output, encoding};
+  EXPECT_EQ(reader.size(), 0);
+  EXPECT_TRUE(reader.read_all().empty());
+}
+
+TEST(container_file_view) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  const auto documents{corpus()};
+  const sourcemeta::core::TemporaryDirectory directory{
+      std::filesystem::temp_directory_path(), ".jsonbinpack-"};
+  const auto path{directory.path() / "records.jsonbinpack"};
+
+  {
+    std::ofstream stream{path, std::ios::binary};
+    ContainerWriter writer{stream, encoding};
+    writer.write(documents);
+    writer.close();
+  }
+
+  const sourcemeta::core::FileView view{path};
+  const ContainerReader reader{view, encoding};
+  EXPECT_EQ(reader.size(), documents.size());
+  EXPECT_EQ(reader.read(documents.size() - 1), documents.back());
+  EXPECT_EQ(reader.read_all(), documents);
+}
+
+TEST(container_fingerprint) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding floor{FLOOR_TYPED_ARRAY{
+      0, std::make_shared<Encoding>(PREFIX_VARINT_LENGTH_STRING_SHARED{}),
+      {}}};
+  const Encoding other_floor{FLOOR_TYPED_ARRAY{
+      0, std::make_shared<Encoding>(PREFIX_VARINT_LENGTH_STRING_SHARED{}),
+      {}}};
+  const Encoding other_minimum{FLOOR_TYPED_ARRAY{
+      1, std::make_shared<Encoding>(PREFIX_VARINT_LENGTH_STRING_SHARED{}),
+      {}}};
+  const Encoding other_items{FLOOR_TYPED_ARRAY{
+      0, std::make_shared<Encoding>(ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}), {}}};
+  EXPECT_EQ(fingerprint(floor), fingerprint(other_floor));
+  EXPECT_FALSE(fingerprint(floor) == fingerprint(other_minimum));
+  EXPECT_FALSE(fingerprint(floor) == fingerprint(other_items));
+  EXPECT_FALSE(fingerprint(floor) ==
+               fingerprint(ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}));
+}
+
+TEST(container_other_encoding) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  const Encoding other{PREFIX_VARINT_LENGTH_STRING_SHARED{}};
+  std::vector<std::byte> output;
+  ContainerWriter writer{output, encoding};
+  writer.write(sourcemeta::core::JSON{"foo"});
+  writer.close();
+
+  bool thrown{false};
+  try {
+    const ContainerReader reader{output, other};
+  } catch (const ContainerError &) {
+    thrown = true;
+  }
+
+  EXPECT_TRUE(thrown);
+}
+
+TEST(container_not_closed) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  std::vector<std::byte> output;
+  ContainerWriter writer{output, encoding};
+  for (std::size_t index = 0; index < 10; index++) {
+    writer.write(sourcemeta::core::JSON{"foo"});
+  }
+
+  bool thrown{false};
+  try {
+    const ContainerReader reader{output, encoding};
+  } catch (const ContainerError &) {
+    thrown = true;
+  }
+
+  EXPECT_TRUE(thrown);
+}
+
+TEST(container_not_a_container) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  const std::vector<std::byte> input(64, std::byte{0x15});
+  bool thrown{false};
+  try {
+    const ContainerReader reader{input, encoding};
+  } catch (const ContainerError &) {
+    thrown = true;
+  }
+
+  EXPECT_TRUE(thrown);
+}
@@ -238,3 +238,46 @@ TEST(ROOF_TYPED_ARRAY_complex) {
   const auto expected = sourcemeta::core::parse_json("[ true, \"foo\", 1000 ]");
   EXPECT_EQ(result, expected);
 }
+
+TEST(FLOOR_TYPED_LENGTH_PREFIX_ARRAY_foo_ba__offsets) {
+  using namespace sourcemeta::jsonbinpack;
+  sourcemeta::core::InputByteStream stream{
+      0x02,                   // size 2
+      0x07, 0x00, 0x00, 0x00, // byte length 7
+      0x04, 0x66, 0x6f, 0x6f, // "foo"
+      0x03, 0x62, 0x61,       // "ba"
+      0x00, 0x04,             // offsets
+      0x05};
+  Decoder decoder{stream};
+  const auto result = decoder.FLOOR_TYPED_LENGTH_PREFIX_ARRAY(
+      {0,
+       std::make_shared<Encoding>(FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED{0}),
+       {},
+       true});
+  const auto expected = sourcemeta::core::parse_json("[ \"foo\", \"ba\" ]");
+  EXPECT_EQ(result, expected);
+  // The decoder must end up past the offsets
+  EXPECT_EQ(decoder.BOUNDED_MULTIPLE_8BITS_ENUM_FIXED({0, 10, 1}),
+            sourcemeta::core::JSON{5});
+}
+
+TEST(FLOOR_TYPED_LENGTH_PREFIX_ARRAY_0_1_true__semityped) {
+  using namespace sourcemeta::jsonbinpack;
+  sourcemeta::core::InputByteStream stream{0x02, 0x03, 0x00, 0x00,
+                                           0x00, 0x00, 0x01, 0x01};
+  Decoder decoder{stream};
+
+  std::vector<sourcemeta::core::JSON> choices;
+  choices.emplace_back(false);
+  choices.emplace_back(true);
+
+  std::vector<Encoding> prefix_encodings;
+  prefix_encodings.emplace_back(BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{0, 10, 1});
+  prefix_encodings.emplace_back(BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{0, 10, 1});
+
+  const auto result = decoder.FLOOR_TYPED_LENGTH_PREFIX_ARRAY(
+      {1, std::make_shared<Encoding>(BYTE_CHOICE_INDEX{std::move(choices)}),
+       std::move(prefix_encodings)});
+  const auto expected = sourcemeta::core::parse_json("[ 0, 1, true ]");
+  EXPECT_EQ(result, expected);
+}
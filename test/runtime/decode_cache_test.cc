@@ -0,0 +1,91 @@
+#include <cstdint>
+#include <string_view>
+
+#include <sourcemeta/core/test.h>
+#include <sourcemeta/jsonbinpack/runtime_decoder_cache.h>
+
+TEST(decoder_cache_record_string) {
+  sourcemeta::jsonbinpack::DecoderCache cache;
+  using CacheType = sourcemeta::jsonbinpack::DecoderCache::Type;
+  EXPECT_FALSE(cache.find(2, CacheType::Standalone).has_value());
+  const auto stored{cache.record(2, "foo", CacheType::Standalone)};
+  EXPECT_EQ(stored, "foo");
+  const auto result{cache.find(2, CacheType::Standalone)};
+  EXPECT_TRUE(result.has_value());
+  EXPECT_EQ(result.value(), "foo");
+}
+
+TEST(decoder_cache_record_string_empty) {
+  sourcemeta::jsonbinpack::DecoderCache cache;
+  using CacheType = sourcemeta::jsonbinpack::DecoderCache::Type;
+  cache.record(2, "", CacheType::Standalone);
+  const auto result{cache.find(2, CacheType::Standalone)};
+  EXPECT_TRUE(result.has_value());
+  EXPECT_TRUE(result.value().empty());
+}
+
+TEST(decoder_cache_find_unknown_offset) {
+  sourcemeta::jsonbinpack::DecoderCache cache;
+  using CacheType = sourcemeta::jsonbinpack::DecoderCache::Type;
+  cache.record(2, "foo", CacheType::Standalone);
+  EXPECT_FALSE(cache.find(3, CacheType::Standalone).has_value());
+}
+
+TEST(decoder_cache_types_are_distinct) {
+  sourcemeta::jsonbinpack::DecoderCache cache;
+  using CacheType = sourcemeta::jsonbinpack::DecoderCache::Type;
+  cache.record(2, "foo", CacheType::PrefixLengthVarintPlusOne);
+  EXPECT_FALSE(cache.find(2, CacheType::Standalone).has_value());
+  const auto result{cache.find(2, CacheType::PrefixLengthVarintPlusOne)};
+  EXPECT_TRUE(result.has_value());
+  EXPECT_EQ(result.value(), "foo");
+}
+
+TEST(decoder_cache_keep_first_string_per_offset) {
+  sourcemeta::jsonbinpack::DecoderCache cache;
+  using CacheType = sourcemeta::jsonbinpack::DecoderCache::Type;
+  cache.record(2, "foo", CacheType::Standalone);
+  EXPECT_EQ(cache.record(2, "bar", CacheType::Standalone), "foo");
+  EXPECT_EQ(cache.find(2, CacheType::Standalone).value(), "foo");
+}
+
+TEST(decoder_cache_share_recorded_bytes) {
+  sourcemeta::jsonbinpack::DecoderCache cache;
+  using CacheType = sourcemeta::jsonbinpack::DecoderCache::Type;
+  const auto first{
+      cache.record(0, "foo", CacheType::PrefixLengthVarintPlusOne)};
+  const auto second{cache.record(1, first, CacheType::Standalone)};
+  EXPECT_EQ(first.data(), second.data());
+  const auto existing{cache.find(0, CacheType::PrefixLengthVarintPlusOne)};
+  const auto third{cache.record(4, existing.value(),
+                                CacheType::PrefixLengthVarintPlusOne)};
+  EXPECT_EQ(first.data(), third.data());
+  EXPECT_EQ(cache.find(4, CacheType::PrefixLengthVarintPlusOne).value(),
+            "foo");
+}
+
+TEST(decoder_cache_many_entries) {
+  sourcemeta::jsonbinpack::DecoderCache cache;
+  using CacheType = sourcemeta::jsonbinpack::DecoderCache::Type;
+  for (std::uint64_t offset = 0; offset < 1000; offset++) {
+    cache.record(offset * 4, offset % 2 == 0 ? "foo" : "bar",
+                 CacheType::Standalone);
+  }
+
+  for (std::uint64_t offset = 0; offset < 1000; offset++) {
+    const std::string_view expected{offset % 2 == 0 ? "foo" : "bar"};
+    const auto result{cache.find(offset * 4, CacheType::Standalone)};
+    EXPECT_TRUE(result.has_value());
+    EXPECT_EQ(result.value(), expected);
+  }
+}
+
+TEST(decoder_cache_clear) {
+  sourcemeta::jsonbinpack::DecoderCache cache;
+  using CacheType = sourcemeta::jsonbinpack::DecoderCache::Type;
+  cache.record(2, "foo", CacheType::Standalone);
+  cache.clear();
+  EXPECT_FALSE(cache.find(2, CacheType::Standalone).has_value());
+  cache.record(2, "bar", CacheType::Standalone);
+  EXPECT_EQ(cache.find(2, CacheType::Standalone).value(), "bar");
+}
@@ -0,0 +1,275 @@
+#include <sourcemeta/core/json.h>
+#include <sourcemeta/core/test.h>
+#include <sourcemeta/jsonbinpack/runtime.h>
+
+#include <cstddef>     // std::byte
+#include <cstdint>     // std::int64_t, std::uint64_t
+#include <memory>      // std::make_shared
+#include <span>        // std::span
+#include <sstream>     // std::istringstream
+#include <string>      // std::string
+#include <string_view> // std::string_view
+#include <utility>     // std::move
+#include <vector>      // std::vector
+
+// Build a JSON document back out of the events
+class Builder : public sourcemeta::jsonbinpack::DecodeHandler {
+public:
+  auto null() -> void override { this->value(sourcemeta::core::JSON{nullptr}); }
+  auto boolean(const bool value) -> void override {
+    this->value(sourcemeta::core::JSON{value});
+  }
+
+  auto integer(const std::int64_t value) -> void override {
+    this->value(sourcemeta::core::JSON{value});
+  }
+
+  auto real(const double value) -> void override {
+    this->value(sourcemeta::core::JSON{value});
+  }
+
+  auto string(const std::string_view value) -> void override {
+    this->views.push_back(value);
+    this->value(sourcemeta::core::JSON{std::string{value}});
+  }
+
+  auto start_array(const std::uint64_t size) -> void override {
+    this->sizes.push_back(size);
+    this->stack.push_back(sourcemeta::core::JSON::make_array());
+  }
+
+  auto end_array() -> void override { this->close(); }
+
+  auto start_object(const std::uint64_t size) -> void override {
+    this->sizes.push_back(size);
+    this->stack.push_back(sourcemeta::core::JSON::make_object());
+  }
+
+  auto key(const std::string_view value) -> void override {
+    this->views.push_back(value);
+    this->keys.emplace_back(value);
+  }
+
+  auto end_object() -> void override { this->close(); }
+
+  std::vector<sourcemeta::core::JSON> results;
+  // Every string and key, as received
+  std::vector<std::string_view> views;
+
+private:
+  auto value(sourcemeta::core::JSON &&value) -> void {
+    if (this->stack.empty()) {
+      this->results.push_back(std::move(value));
+    } else if (this->stack.back().is_array()) {
+      this->stack.back().push_back(std::move(value));
+    } else {
+      this->stack.back().assign(this->keys.back(), std::move(value));
+      this->keys.pop_back();
+    }
+  }
+
+  auto close() -> void {
+    auto container{std::move(this->stack.back())};
+    this->stack.pop_back();
+    EXPECT_EQ(container.size(), this->sizes.back());
+    this->sizes.pop_back();
+    this->value(std::move(container));
+  }
+
+  std::vector<sourcemeta::core::JSON> stack;
+  std::vector<std::string> keys;
+  std::vector<std::uint64_t> sizes;
+};
+
+// The events must describe the same documents that decoding them results in,
+// both out of memory and out of a stream
+static auto expect_events(const sourcemeta::jsonbinpack::Encoding &encoding,
+                          const std::vector<sourcemeta::core::JSON> &documents)
+    -> void {
+  using namespace sourcemeta::jsonbinpack;
+  std::vector<std::byte> buffer;
+  Encoder encoder{buffer};
+  for (const auto &document : documents) {
+    encoder.write(document, encoding);
+  }
+
+  Builder memory;
+  Decoder memory_decoder{std::span<const std::byte>{buffer}};
+  for (std::size_t index = 0; index < documents.size(); index++) {
+    memory_decoder.read(encoding, memory);
+  }
+
+  EXPECT_EQ(memory.results, documents);
+
+  std::istringstream input{
+      std::string{reinterpret_cast<const char *>(buffer.data()),
+                  buffer.size()}};
+  Builder stream;
+  Decoder stream_decoder{input};
+  for (std::size_t index = 0; index < documents.size(); index++) {
+    stream_decoder.read(encoding, stream);
+  }
+
+  EXPECT_EQ(stream.results, documents);
+}
+
+TEST(decode_handler_integer) {
+  using namespace sourcemeta::jsonbinpack;
+  expect_events(BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{-5, 5, 1},
+                {sourcemeta::core::JSON{3}, sourcemeta::core::JSON{-5}});
+  expect_events(FLOOR_MULTIPLE_ENUM_VARINT{0, 2},
+                {sourcemeta::core::JSON{1000}});
+  expect_events(ROOF_MULTIPLE_MIRROR_ENUM_VARINT{1000, 1},
+                {sourcemeta::core::JSON{-1000}});
+  expect_events(ARBITRARY_MULTIPLE_ZIGZAG_VARINT{1},
+                {sourcemeta::core::JSON{-25200}});
+}
+
+TEST(decode_handler_number) {
+  using namespace sourcemeta::jsonbinpack;
+  expect_events(DOUBLE_VARINT_TUPLE{},
+                {sourcemeta::core::JSON{3.14}, sourcemeta::core::JSON{-0.5}});
+}
+
+TEST(decode_handler_choice) {
+  using namespace sourcemeta::jsonbinpack;
+  std::vector<sourcemeta::core::JSON> choices;
+  choices.emplace_back("foo");
+  choices.push_back(sourcemeta::core::parse_json("{ \"bar\": [ 1, null ] }"));
+  const std::vector<sourcemeta::core::JSON> documents{choices[1], choices[0]};
+  expect_events(BYTE_CHOICE_INDEX{choices}, documents);
+  expect_events(LARGE_CHOICE_INDEX{choices}, documents);
+  expect_events(TOP_LEVEL_BYTE_CHOICE_INDEX{choices}, {choices[0]});
+  expect_events(TOP_LEVEL_BYTE_CHOICE_INDEX{choices}, {choices[1]});
+  expect_events(CONST_NONE{choices[1]}, {choices[1]});
+}
+
+TEST(decode_handler_string) {
+  using namespace sourcemeta::jsonbinpack;
+  const std::vector<sourcemeta::core::JSON> documents{
+      sourcemeta::core::JSON{"foo bar"}, sourcemeta::core::JSON{"foo bar"},
+      sourcemeta::core::JSON{"baz qux"}, sourcemeta::core::JSON{"foo bar"}};
+  expect_events(UTF8_STRING_NO_LENGTH{7}, documents);
+  expect_events(FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED{3}, documents);
+  expect_events(ROOF_VARINT_PREFIX_UTF8_STRING_SHARED{10}, documents);
+  expect_events(BOUNDED_8BIT_PREFIX_UTF8_STRING_SHARED{3, 10}, documents);
+  expect_events(PREFIX_VARINT_LENGTH_STRING_SHARED{}, documents);
+  expect_events(GZIP_VARINT_PREFIX_UTF8_STRING{}, documents);
+  expect_events(RFC3339_DATE_INTEGER_TRIPLET{},
+                {sourcemeta::core::JSON{"2014-10-01"}});
+}
+
+TEST(decode_handler_any) {
+  using namespace sourcemeta::jsonbinpack;
+  expect_events(
+      ANY_PACKED_TYPE_TAG_BYTE_PREFIX{},
+      {sourcemeta::core::JSON{nullptr}, sourcemeta::core::JSON{true},
+       sourcemeta::core::JSON{false}, sourcemeta::core::JSON{3.5},
+       sourcemeta::core::JSON{5.0}, sourcemeta::core::JSON{5},
+       sourcemeta::core::JSON{-300}, sourcemeta::core::JSON{1000000},
+       sourcemeta::core::JSON{-3}, sourcemeta::core::JSON{"foo"},
+       sourcemeta::core::JSON{"foo"},
+       sourcemeta::core::JSON{std::string(40, 'x')},
+       sourcemeta::core::JSON{std::string(100, 'x')},
+       sourcemeta::core::JSON{std::string(100, 'x')},
+       sourcemeta::core::JSON{std::string(300, 'x')},
+       sourcemeta::core::JSON{std::string(2000, 'x')},
+       sourcemeta::core::parse_json(
+           "{ \"foo\": [ 1, \"bar\", { \"baz\": null } ], \"bar\": \"bar\", "
+           "\"list\": [ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, "
+           "16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, "
+           "32, 33, 34 ] }")});
+}
+
+TEST(decode_handler_array) {
+  using namespace sourcemeta::jsonbinpack;
+  const auto string{
+      std::make_shared<Encoding>(FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED{0})};
+  std::vector<Encoding> prefix_encodings;
+  prefix_encodings.emplace_back(ARBITRARY_MULTIPLE_ZIGZAG_VARINT{1});
+  const std::vector<sourcemeta::core::JSON> documents{
+      sourcemeta::core::parse_json("[ 5, \"foo\", \"bar\", \"foo\" ]"),
+      sourcemeta::core::parse_json("[ -1 ]")};
+  expect_events(FLOOR_TYPED_ARRAY{1, string, prefix_encodings}, documents);
+  expect_events(ROOF_TYPED_ARRAY{4, string, prefix_encodings}, documents);
+  expect_events(BOUNDED_8BITS_TYPED_ARRAY{1, 4, string, prefix_encodings},
+                documents);
+  expect_events(FLOOR_TYPED_LENGTH_PREFIX_ARRAY{1, string, prefix_encodings,
+                                                true},
+                documents);
+  expect_events(FIXED_TYPED_ARRAY{2, string, prefix_encodings},
+                {sourcemeta::core::parse_json("[ 3, \"foo\" ]")});
+  expect_events(FIXED_TYPED_ARRAY{0, string, {}},
+                {sourcemeta::core::parse_json("[]")});
+}
+
+TEST(decode_handler_object) {
+  using namespace sourcemeta::jsonbinpack;
+  const auto key{
+      std::make_shared<Encoding>(PREFIX_VARINT_LENGTH_STRING_SHARED{})};
+  const auto value{std::make_shared<Encoding>(FLOOR_TYPED_ARRAY{
+      0, std::make_shared<Encoding>(FLOOR_MULTIPLE_ENUM_VARINT{0, 1}), {}})};
+  const std::vector<sourcemeta::core::JSON> documents{
+      sourcemeta::core::parse_json("{ \"foo\": [ 1, 2 ], \"bar\": [] }"),
+      sourcemeta::core::parse_json("{ \"bar\": [ 3 ], \"foo\": [] }")};
+  expect_events(VARINT_TYPED_ARBITRARY_OBJECT{key, value}, documents);
+  expect_events(VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT{key, value, true},
+                documents);
+  expect_events(FIXED_TYPED_ARBITRARY_OBJECT{2, key, value}, documents);
+
+  std::vector<sourcemeta::core::JSON> choices;
+  choices.emplace_back("foo");
+  choices.emplace_back("bar");
+  expect_events(VARINT_TYPED_ARBITRARY_OBJECT{
+                    std::make_shared<Encoding>(BYTE_CHOICE_INDEX{choices}),
+                    value},
+                documents);
+}
+
+TEST(decode_handler_MIXED_BOUNDED_TYPED_OBJECT) {
+  using namespace sourcemeta::jsonbinpack;
+  expect_events(
+      MIXED_BOUNDED_TYPED_OBJECT{
+          {"id"},
+          {"name", "tags"},
+          {FLOOR_MULTIPLE_ENUM_VARINT{0, 1},
+           PREFIX_VARINT_LENGTH_STRING_SHARED{},
+           FLOOR_TYPED_ARRAY{0,
+                             std::make_shared<Encoding>(
+                                 PREFIX_VARINT_LENGTH_STRING_SHARED{}),
+                             {}}}},
+      {sourcemeta::core::parse_json("{ \"id\": 1 }"),
+       sourcemeta::core::parse_json(
+           "{ \"id\": 2, \"tags\": [ \"foo\", \"bar\" ] }"),
+       sourcemeta::core::parse_json(
+           "{ \"id\": 3, \"name\": \"baz\", \"tags\": [] }")});
+}
+
+TEST(decode_handler_views_into_memory) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{FLOOR_TYPED_ARRAY{
+      0, std::make_shared<Encoding>(FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED{0}),
+      {}}};
+  const auto document{sourcemeta::core::parse_json(
+      "[ \"foo bar\", \"baz\", \"foo bar\", \"foo bar\" ]")};
+  std::vector<std::byte> buffer;
+  Encoder encoder{buffer};
+  encoder.write(document, encoding);
+
+  Builder builder;
+  Decoder decoder{std::span<const std::byte>{buffer}};
+  decoder.read(encoding, builder);
+  EXPECT_EQ(builder.results.size(), 1);
+  EXPECT_EQ(builder.results.front(), document);
+
+  // Both the strings and the references to them point into the input
+  const auto *const begin{reinterpret_cast<const char *>(buffer.data())};
+  const auto *const end{begin + buffer.size()};
+  EXPECT_EQ(builder.views.size(), 4);
+  for (const auto view : builder.views) {
+    EXPECT_TRUE(view.data() >= begin && view.data() + view.size() <= end);
+  }
+
+  EXPECT_EQ(builder.views[0].data(), builder.views[2].data());
+  EXPECT_EQ(builder.views[0].data(), builder.views[3].data());
+}
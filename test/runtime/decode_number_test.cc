@@ -3,6 +3,11 @@
 #include <sourcemeta/core/test.h>
 #include <sourcemeta/jsonbinpack/runtime.h>
 
+#include <cstddef> // std::byte
+#include <cstdint> // std::int64_t
+#include <limits>  // std::numeric_limits
+#include <vector>  // std::vector
+
 TEST(DOUBLE_VARINT_TUPLE_5) {
   sourcemeta::core::InputByteStream stream{0x0a, 0x00};
   sourcemeta::jsonbinpack::Decoder decoder{stream};
@@ -130,3 +135,23 @@ TEST(DOUBLE_VARINT_TUPLE_31_point_4) {
   const sourcemeta::core::JSON expected{31.4};
   EXPECT_EQ(result, expected);
 }
+
+// Integers beyond 2^53 do not survive a round trip through a double
+static auto expect_large_integer_round_trip(const std::int64_t value)
+    -> void {
+  const sourcemeta::core::JSON document{value};
+  std::vector<std::byte> buffer;
+  sourcemeta::jsonbinpack::Encoder encoder{buffer};
+  encoder.DOUBLE_VARINT_TUPLE(document, {});
+  sourcemeta::jsonbinpack::Decoder decoder{buffer};
+  const auto result = decoder.DOUBLE_VARINT_TUPLE({});
+  EXPECT_TRUE(result.is_integer());
+  EXPECT_EQ(result.to_integer(), value);
+}
+
+TEST(DOUBLE_VARINT_TUPLE_large_integer_round_trip) {
+  expect_large_integer_round_trip(9007199254740993);
+  expect_large_integer_round_trip(-9007199254740993);
+  expect_large_integer_round_trip(std::numeric_limits<std::int64_t>::max());
+  expect_large_integer_round_trip(std::numeric_limits<std::int64_t>::min());
+}
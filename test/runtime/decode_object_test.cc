@@ -54,3 +54,78 @@ TEST(VARINT_TYPED_ARBITRARY_OBJECT__no_length_string__integer) {
   EXPECT_EQ(foo.to_integer(), 1);
   EXPECT_EQ(bar.to_integer(), 2);
 }
+
+TEST(VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT__no_length_string__integer) {
+  using namespace sourcemeta::jsonbinpack;
+  sourcemeta::core::InputByteStream stream{
+      0x02,                   // length 2
+      0x08, 0x00, 0x00, 0x00, // byte length 8
+      0x66, 0x6f, 0x6f,       // "foo"
+      0x01,                   // 1
+      0x62, 0x61, 0x72,       // "bar"
+      0x02                    // 2
+  };
+  Decoder decoder{stream};
+  const auto result = decoder.VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT(
+      {std::make_shared<Encoding>(UTF8_STRING_NO_LENGTH{3}),
+       std::make_shared<Encoding>(BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{0, 10, 1}),
+       false});
+  EXPECT_TRUE(result.is_object());
+  EXPECT_EQ(result.size(), 2);
+  EXPECT_EQ(result.at("foo").to_integer(), 1);
+  EXPECT_EQ(result.at("bar").to_integer(), 2);
+}
+
+TEST(MIXED_BOUNDED_TYPED_OBJECT__required_and_optional) {
+  using namespace sourcemeta::jsonbinpack;
+  sourcemeta::core::InputByteStream stream{
+      0x02,            // only the second optional property
+      0x05,            // 5
+      0x62, 0x61, 0x72 // "bar"
+  };
+  Decoder decoder{stream};
+  const auto result = decoder.MIXED_BOUNDED_TYPED_OBJECT(
+      {{"id"},
+       {"name", "tag"},
+       {BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{0, 10, 1}, UTF8_STRING_NO_LENGTH{3},
+        UTF8_STRING_NO_LENGTH{3}}});
+  EXPECT_TRUE(result.is_object());
+  EXPECT_EQ(result.size(), 2);
+  EXPECT_EQ(result.at("id").to_integer(), 5);
+  EXPECT_FALSE(result.defines("name"));
+  EXPECT_EQ(result.at("tag").to_string(), "bar");
+}
+
+TEST(MIXED_BOUNDED_TYPED_OBJECT__no_optional) {
+  using namespace sourcemeta::jsonbinpack;
+  sourcemeta::core::InputByteStream stream{
+      0x01, // 1
+      0x02  // 2
+  };
+  Decoder decoder{stream};
+  const auto result = decoder.MIXED_BOUNDED_TYPED_OBJECT(
+      {{"foo", "bar"},
+       {},
+       {BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{0, 10, 1},
+        BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{0, 10, 1}}});
+  EXPECT_TRUE(result.is_object());
+  EXPECT_EQ(result.size(), 2);
+  EXPECT_EQ(result.at("foo").to_integer(), 1);
+  EXPECT_EQ(result.at("bar").to_integer(), 2);
+}
+
+TEST(MIXED_BOUNDED_TYPED_OBJECT__multi_byte_bitmap) {
+  using namespace sourcemeta::jsonbinpack;
+  sourcemeta::core::InputByteStream stream{
+      0x01, 0x01, // the first and ninth optional properties
+      0x01,       // 1
+      0x09        // 9
+  };
+  const Encoding value{BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{0, 10, 1}};
+  Decoder decoder{stream};
+  const auto result = decoder.MIXED_BOUNDED_TYPED_OBJECT(
+      {{},
+       {"a", "b", "c", "d", "e", "f", "g", "h", "i"},
+       {value, value, value, value, value, value, value, value, value}});
+  EXPECT_EQ(result, sourcemeta::core::parse_json("{\"a\":1,\"i\":9}"));
+}
@@ -3,6 +3,11 @@
 #include <sourcemeta/core/test.h>
 #include <sourcemeta/jsonbinpack/runtime.h>
 
+#include <cstddef> // std::byte, std::size_t
+#include <cstdint> // std::uint8_t
+#include <string>  // std::string, std::to_string
+#include <vector>  // std::vector
+
 TEST(UTF8_STRING_NO_LENGTH_foo_bar) {
   sourcemeta::core::InputByteStream stream{0x66, 0x6f, 0x6f, 0x20,
                                            0x62, 0x61, 0x72};
@@ -188,3 +193,89 @@ TEST(PREFIX_VARINT_LENGTH_STRING_SHARED_unicode) {
   const sourcemeta::core::JSON expected{"foø"};
   EXPECT_EQ(result, expected);
 }
+
+TEST(GZIP_VARINT_PREFIX_UTF8_STRING_foo_foo_foo_foo) {
+  sourcemeta::core::InputByteStream stream{
+      0x0f, 0x26, 0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x02, 0xff, 0x01, 0x0f, 0x00, 0xf0,
+      0xff, 0x66, 0x6f, 0x6f, 0x20, 0x66, 0x6f, 0x6f,
+      0x20, 0x66, 0x6f, 0x6f, 0x20, 0x66, 0x6f, 0x6f,
+      0xde, 0x65, 0x6b, 0x67, 0x0f, 0x00, 0x00, 0x00};
+  sourcemeta::jsonbinpack::Decoder decoder{stream};
+  const auto result = decoder.GZIP_VARINT_PREFIX_UTF8_STRING({});
+  const sourcemeta::core::JSON expected{"foo foo foo foo"};
+  EXPECT_EQ(result, expected);
+}
+
+TEST(GZIP_VARINT_PREFIX_UTF8_STRING_empty) {
+  sourcemeta::core::InputByteStream stream{
+      0x00, 0x17, 0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x02, 0xff, 0x01, 0x00, 0x00, 0xff,
+      0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00};
+  sourcemeta::jsonbinpack::Decoder decoder{stream};
+  const auto result = decoder.GZIP_VARINT_PREFIX_UTF8_STRING({});
+  const sourcemeta::core::JSON expected{""};
+  EXPECT_EQ(result, expected);
+}
+
+TEST(GZIP_VARINT_PREFIX_UTF8_STRING_round_trip) {
+  std::string value;
+  for (std::size_t index = 0; index < 1000; index++) {
+    value.append("Lorem ipsum dolor sit amet ");
+    value.append(std::to_string(index));
+    value.push_back('\n');
+  }
+
+  const sourcemeta::core::JSON document{value};
+  std::vector<std::byte> buffer;
+  sourcemeta::jsonbinpack::Encoder encoder{buffer};
+  encoder.GZIP_VARINT_PREFIX_UTF8_STRING(document, {});
+  encoder.GZIP_VARINT_PREFIX_UTF8_STRING(document, {});
+  EXPECT_TRUE(buffer.size() < value.size());
+
+  sourcemeta::jsonbinpack::Decoder decoder{buffer};
+  EXPECT_EQ(decoder.GZIP_VARINT_PREFIX_UTF8_STRING({}), document);
+  EXPECT_EQ(decoder.GZIP_VARINT_PREFIX_UTF8_STRING({}), document);
+}
+
+// Decoding the compressed bytes of "foo foo foo foo" with a wrong declared
+// length must fail without trusting it
+static auto expect_gzip_length_error(const std::vector<std::uint8_t> &length)
+    -> void {
+  std::vector<std::byte> buffer;
+  for (const auto byte : length) {
+    buffer.push_back(static_cast<std::byte>(byte));
+  }
+
+  for (const auto byte :
+       {0x26, 0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x02, 0xff, 0x01, 0x0f, 0x00, 0xf0, 0xff, 0x66, 0x6f, 0x6f,
+        0x20, 0x66, 0x6f, 0x6f, 0x20, 0x66, 0x6f, 0x6f, 0x20, 0x66,
+        0x6f, 0x6f, 0xde, 0x65, 0x6b, 0x67, 0x0f, 0x00, 0x00, 0x00}) {
+    buffer.push_back(static_cast<std::byte>(byte));
+  }
+
+  sourcemeta::jsonbinpack::Decoder decoder{buffer};
+  bool thrown{false};
+  try {
+    decoder.GZIP_VARINT_PREFIX_UTF8_STRING({});
+  } catch (const sourcemeta::core::IOReadOutOfBoundsError &) {
+    thrown = true;
+  }
+
+  EXPECT_TRUE(thrown);
+}
+
+TEST(GZIP_VARINT_PREFIX_UTF8_STRING_impossible_length) {
+  // Around 4 GiB out of 38 compressed bytes
+  expect_gzip_length_error({0xff, 0xff, 0xff, 0xff, 0x0f});
+}
+
+TEST(GZIP_VARINT_PREFIX_UTF8_STRING_longer_length) {
+  expect_gzip_length_error({0x10});
+}
+
+TEST(GZIP_VARINT_PREFIX_UTF8_STRING_shorter_length) {
+  expect_gzip_length_error({0x0e});
+}
@@ -1,3 +1,15 @@
+#include <cstddef>    // std::byte
+#include <cstdint>    // std::int64_t
+#include <filesystem> // std::filesystem
+#include <fstream>    // std::ofstream
+#include <ios>        // std::ios
+#include <memory>     // std::make_shared
+#include <span>       // std::span
+#include <sstream>    // std::istringstream
+#include <string>     // std::string
+#include <utility>    // std::move
+#include <vector>     // std::vector
+
 #include <sourcemeta/core/io.h>
 #include <sourcemeta/core/json.h>
 #include <sourcemeta/core/test.h>
@@ -28,3 +40,119 @@ TEST(ANY_PACKED_TYPE_TAG_BYTE_PREFIX_many) {
   EXPECT_EQ(result_2, expected_2);
   EXPECT_EQ(result_3, expected_3);
 }
+
+TEST(decode_span_PREFIX_VARINT_LENGTH_STRING_SHARED_foo_3) {
+  using namespace sourcemeta::jsonbinpack;
+  const std::vector<std::byte> buffer{
+      std::byte{0x04}, std::byte{0x66}, std::byte{0x6f}, std::byte{0x6f},
+      std::byte{0x00}, std::byte{0x05}, std::byte{0x00}, std::byte{0x03}};
+  Decoder decoder{std::span{buffer}};
+  PREFIX_VARINT_LENGTH_STRING_SHARED options;
+  const sourcemeta::core::JSON expected{"foo"};
+  EXPECT_EQ(decoder.read(options), expected);
+  EXPECT_EQ(decoder.read(options), expected);
+  EXPECT_EQ(decoder.read(options), expected);
+}
+
+TEST(decode_span_ANY_PACKED_TYPE_TAG_BYTE_PREFIX_many) {
+  using namespace sourcemeta::jsonbinpack;
+  const std::vector<std::byte> buffer{std::byte{0x15}, std::byte{0x1d},
+                                        std::byte{0x25}};
+  Decoder decoder{std::span{buffer}};
+  ANY_PACKED_TYPE_TAG_BYTE_PREFIX options;
+  EXPECT_EQ(decoder.read(options), sourcemeta::core::JSON{1});
+  EXPECT_EQ(decoder.read(options), sourcemeta::core::JSON{2});
+  EXPECT_EQ(decoder.read(options), sourcemeta::core::JSON{3});
+}
+
+TEST(decode_file_view_ANY_PACKED_TYPE_TAG_BYTE_PREFIX_string) {
+  using namespace sourcemeta::jsonbinpack;
+  const sourcemeta::core::TemporaryDirectory directory{
+      std::filesystem::temp_directory_path(), ".jsonbinpack-"};
+  const auto path{directory.path() / "input.bin"};
+
+  {
+    std::ofstream output{path, std::ios::binary};
+    // "foo" followed by a pointer to it
+    output << '\x21' << "foo" << '\x20' << '\x04';
+  }
+
+  const sourcemeta::core::FileView view{path};
+  Decoder decoder{view};
+  ANY_PACKED_TYPE_TAG_BYTE_PREFIX options;
+  const sourcemeta::core::JSON expected{"foo"};
+  EXPECT_EQ(decoder.read(options), expected);
+  EXPECT_EQ(decoder.read(options), expected);
+}
+
+TEST(reset_ANY_PACKED_TYPE_TAG_BYTE_PREFIX) {
+  using namespace sourcemeta::jsonbinpack;
+  const std::vector<std::byte> first{std::byte{0x15}};
+  const std::vector<std::byte> second{std::byte{0x1d}, std::byte{0x25}};
+  Decoder decoder{std::span{first}};
+  ANY_PACKED_TYPE_TAG_BYTE_PREFIX options;
+  EXPECT_EQ(decoder.read(options), sourcemeta::core::JSON{1});
+  decoder.reset(std::span{second});
+  EXPECT_EQ(decoder.read(options), sourcemeta::core::JSON{2});
+  sourcemeta::core::InputByteStream stream{0x15};
+  decoder.reset(stream);
+  EXPECT_EQ(decoder.read(options), sourcemeta::core::JSON{1});
+}
+
+TEST(reset_forgets_shared_strings) {
+  using namespace sourcemeta::jsonbinpack;
+  // A string followed by a reference to it, at the same offsets
+  const std::vector<std::byte> first{std::byte{0x04}, std::byte{0x66},
+                                     std::byte{0x6f}, std::byte{0x6f},
+                                     std::byte{0x00}, std::byte{0x05}};
+  const std::vector<std::byte> second{std::byte{0x04}, std::byte{0x62},
+                                      std::byte{0x61}, std::byte{0x72},
+                                      std::byte{0x00}, std::byte{0x05}};
+  Decoder decoder{std::span{first}};
+  PREFIX_VARINT_LENGTH_STRING_SHARED options;
+  EXPECT_EQ(decoder.read(options), sourcemeta::core::JSON{"foo"});
+  EXPECT_EQ(decoder.read(options), sourcemeta::core::JSON{"foo"});
+  decoder.reset(std::span{second});
+  EXPECT_EQ(decoder.read(options), sourcemeta::core::JSON{"bar"});
+  EXPECT_EQ(decoder.read(options), sourcemeta::core::JSON{"bar"});
+}
+
+TEST(decode_shared_strings_round_trip) {
+  using namespace sourcemeta::jsonbinpack;
+  auto document{sourcemeta::core::JSON::make_array()};
+  for (std::int64_t index = 0; index < 1000; index++) {
+    auto record{sourcemeta::core::JSON::make_object()};
+    record.assign("identifier", sourcemeta::core::JSON{index % 7});
+    record.assign("category", sourcemeta::core::JSON{
+                                  index % 3 == 0 ? "primary" : "secondary"});
+    document.push_back(std::move(record));
+  }
+
+  const ANY_PACKED_TYPE_TAG_BYTE_PREFIX any_options;
+  const FLOOR_TYPED_ARRAY array_options{
+      0,
+      std::make_shared<Encoding>(VARINT_TYPED_ARBITRARY_OBJECT{
+          std::make_shared<Encoding>(PREFIX_VARINT_LENGTH_STRING_SHARED{}),
+          std::make_shared<Encoding>(ANY_PACKED_TYPE_TAG_BYTE_PREFIX{})}),
+      {}};
+
+  std::vector<std::byte> buffer;
+  Encoder encoder{buffer};
+  encoder.write(document, any_options);
+  encoder.write(document, array_options);
+
+  Decoder decoder{std::span<const std::byte>{buffer}};
+  EXPECT_EQ(decoder.read(any_options), document);
+  EXPECT_EQ(decoder.read(array_options), document);
+
+  // Decoding from a stream, where seeking is not free, must match
+  std::string bytes;
+  for (const auto byte : buffer) {
+    bytes.push_back(static_cast<char>(byte));
+  }
+
+  std::istringstream stream{bytes};
+  Decoder stream_decoder{stream};
+  EXPECT_EQ(stream_decoder.read(any_options), document);
+  EXPECT_EQ(stream_decoder.read(array_options), document);
+}
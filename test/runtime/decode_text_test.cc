@@ -0,0 +1,110 @@
+#include <sourcemeta/core/json.h>
+#include <sourcemeta/core/test.h>
+#include <sourcemeta/jsonbinpack/runtime.h>
+
+#include <cstddef> // std::byte
+#include <memory>  // std::make_shared
+#include <span>    // std::span
+#include <sstream> // std::ostringstream
+#include <string>  // std::string
+#include <vector>  // std::vector
+
+// The text must be the same as stringifying the decoded documents
+static auto expect_text(const sourcemeta::jsonbinpack::Encoding &encoding,
+                        const std::vector<sourcemeta::core::JSON> &documents)
+    -> void {
+  using namespace sourcemeta::jsonbinpack;
+  std::vector<std::byte> buffer;
+  Encoder encoder{buffer};
+  for (const auto &document : documents) {
+    encoder.write(document, encoding);
+  }
+
+  Decoder decoder{std::span<const std::byte>{buffer}};
+  Decoder text_decoder{std::span<const std::byte>{buffer}};
+  for (std::size_t index = 0; index < documents.size(); index++) {
+    std::ostringstream expected;
+    sourcemeta::core::stringify(decoder.read(encoding), expected);
+    sourcemeta::core::JSON::String result;
+    text_decoder.transcode(encoding, result);
+    EXPECT_EQ(result, expected.str());
+  }
+}
+
+TEST(transcode_text_any) {
+  using namespace sourcemeta::jsonbinpack;
+  expect_text(
+      ANY_PACKED_TYPE_TAG_BYTE_PREFIX{},
+      {sourcemeta::core::JSON{nullptr}, sourcemeta::core::JSON{true},
+       sourcemeta::core::JSON{false}, sourcemeta::core::JSON{0},
+       sourcemeta::core::JSON{-25200}, sourcemeta::core::JSON{1000000},
+       sourcemeta::core::JSON{0.0}, sourcemeta::core::JSON{5.0},
+       sourcemeta::core::JSON{300.0}, sourcemeta::core::JSON{3.14},
+       sourcemeta::core::JSON{-0.001}, sourcemeta::core::JSON{"foo"},
+       sourcemeta::core::JSON{"foo"},
+       sourcemeta::core::JSON{std::string(300, 'x')},
+       sourcemeta::core::parse_json(
+           "{ \"foo\": [ 1, \"bar\", { \"baz\": null }, [] ], \"bar\": {}, "
+           "\"baz\": [ [ [ 1.5 ] ] ] }")});
+}
+
+TEST(transcode_text_escapes) {
+  using namespace sourcemeta::jsonbinpack;
+  std::string control;
+  for (char character = 0; character < 0x20; character++) {
+    control.push_back(character);
+  }
+
+  const std::vector<sourcemeta::core::JSON> documents{
+      sourcemeta::core::JSON{control},
+      sourcemeta::core::JSON{"quote \" backslash \\ slash / delete \x7f"},
+      sourcemeta::core::JSON{"\xc3\xa9 \xf0\x9f\x98\x80"},
+      sourcemeta::core::parse_json("{ \"a\\\"b\": \"c\\nd\" }")};
+  expect_text(ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}, documents);
+  expect_text(PREFIX_VARINT_LENGTH_STRING_SHARED{},
+              {documents[0], documents[1], documents[2], documents[0]});
+}
+
+TEST(transcode_text_typed) {
+  using namespace sourcemeta::jsonbinpack;
+  std::vector<Encoding> prefix_encodings;
+  prefix_encodings.emplace_back(DOUBLE_VARINT_TUPLE{});
+  prefix_encodings.emplace_back(RFC3339_DATE_INTEGER_TRIPLET{});
+  const Encoding encoding{VARINT_TYPED_ARBITRARY_OBJECT{
+      std::make_shared<Encoding>(PREFIX_VARINT_LENGTH_STRING_SHARED{}),
+      std::make_shared<Encoding>(FLOOR_TYPED_ARRAY{
+          2,
+          std::make_shared<Encoding>(FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED{0}),
+          prefix_encodings})}};
+  expect_text(encoding,
+              {sourcemeta::core::parse_json(
+                   "{ \"foo\": [ 3.25, \"2014-10-01\", \"bar\", \"bar\" ], "
+                   "\"bar\": [ 7.0, \"2000-01-01\" ] }"),
+               sourcemeta::core::parse_json("{}")});
+}
+
+TEST(transcode_text_choices) {
+  using namespace sourcemeta::jsonbinpack;
+  std::vector<sourcemeta::core::JSON> choices;
+  choices.emplace_back("foo");
+  choices.push_back(
+      sourcemeta::core::parse_json("{ \"bar\": [ 1, null, 2.5, \"\\t\" ] }"));
+  expect_text(BYTE_CHOICE_INDEX{choices}, {choices[1], choices[0]});
+  expect_text(CONST_NONE{choices[1]}, {choices[1]});
+}
+
+TEST(transcode_text_appends) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  std::vector<std::byte> buffer;
+  Encoder encoder{buffer};
+  encoder.write(sourcemeta::core::parse_json("[ 1, 2 ]"), encoding);
+  encoder.write(sourcemeta::core::JSON{"foo"}, encoding);
+
+  Decoder decoder{std::span<const std::byte>{buffer}};
+  sourcemeta::core::JSON::String result{"> "};
+  decoder.transcode(encoding, result);
+  result.push_back('\n');
+  decoder.transcode(encoding, result);
+  EXPECT_EQ(result, "> [1,2]\n\"foo\"");
+}
@@ -0,0 +1,321 @@
+#include <sourcemeta/core/json.h>
+#include <sourcemeta/core/test.h>
+#include <sourcemeta/jsonbinpack/runtime.h>
+
+#include <cstddef> // std::byte, std::size_t
+#include <cstdint> // std::int64_t
+#include <memory>  // std::make_shared
+#include <span>    // std::span
+#include <string>  // std::string
+#include <utility> // std::move
+#include <vector>  // std::vector
+
+// Skipping a value must land exactly where the value that follows it starts
+static auto expect_skip(const sourcemeta::jsonbinpack::Encoding &encoding,
+                        const sourcemeta::core::JSON &document) -> void {
+  using namespace sourcemeta::jsonbinpack;
+  std::vector<Encoding> prefix_encodings;
+  prefix_encodings.push_back(encoding);
+  const Encoding container{
+      FIXED_TYPED_ARRAY{2,
+                        std::make_shared<Encoding>(
+                            BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{0, 255, 1}),
+                        std::move(prefix_encodings)}};
+  auto input{sourcemeta::core::JSON::make_array()};
+  input.push_back(document);
+  input.push_back(sourcemeta::core::JSON{42});
+  std::vector<std::byte> buffer;
+  Encoder encoder{buffer};
+  encoder.write(input, container);
+  const DecodedView view{std::span<const std::byte>{buffer}, container};
+  EXPECT_EQ(view.size(), 2);
+  EXPECT_EQ(view.at(1).to_integer(), 42);
+  EXPECT_EQ(view.at(0).to_json(), document);
+}
+
+TEST(decoded_view_skip_integer) {
+  using namespace sourcemeta::jsonbinpack;
+  expect_skip(BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{-5, 5, 1},
+              sourcemeta::core::JSON{3});
+  expect_skip(FLOOR_MULTIPLE_ENUM_VARINT{0, 1}, sourcemeta::core::JSON{1000});
+  expect_skip(ROOF_MULTIPLE_MIRROR_ENUM_VARINT{1000, 1},
+              sourcemeta::core::JSON{-1000});
+  expect_skip(ARBITRARY_MULTIPLE_ZIGZAG_VARINT{1},
+              sourcemeta::core::JSON{-25200});
+}
+
+TEST(decoded_view_skip_number) {
+  using namespace sourcemeta::jsonbinpack;
+  expect_skip(DOUBLE_VARINT_TUPLE{}, sourcemeta::core::JSON{3.14});
+}
+
+TEST(decoded_view_skip_choice) {
+  using namespace sourcemeta::jsonbinpack;
+  std::vector<sourcemeta::core::JSON> choices;
+  choices.emplace_back("foo");
+  choices.emplace_back("bar");
+  expect_skip(BYTE_CHOICE_INDEX{choices}, sourcemeta::core::JSON{"bar"});
+  expect_skip(LARGE_CHOICE_INDEX{choices}, sourcemeta::core::JSON{"bar"});
+  expect_skip(CONST_NONE{sourcemeta::core::JSON{"foo"}},
+              sourcemeta::core::JSON{"foo"});
+}
+
+TEST(decoded_view_skip_any) {
+  using namespace sourcemeta::jsonbinpack;
+  const ANY_PACKED_TYPE_TAG_BYTE_PREFIX encoding;
+  expect_skip(encoding, sourcemeta::core::JSON{nullptr});
+  expect_skip(encoding, sourcemeta::core::JSON{true});
+  expect_skip(encoding, sourcemeta::core::JSON{3.5});
+  expect_skip(encoding, sourcemeta::core::JSON{5});
+  expect_skip(encoding, sourcemeta::core::JSON{-300});
+  expect_skip(encoding, sourcemeta::core::JSON{1000000});
+  expect_skip(encoding, sourcemeta::core::JSON{"foo"});
+  expect_skip(encoding, sourcemeta::core::JSON{std::string(40, 'x')});
+  expect_skip(encoding, sourcemeta::core::JSON{std::string(100, 'x')});
+  expect_skip(encoding, sourcemeta::core::JSON{std::string(300, 'x')});
+  expect_skip(encoding, sourcemeta::core::parse_json(
+                            "{ \"foo\": [ 1, \"bar\", { \"baz\": null } ], "
+                            "\"bar\": \"bar\" }"));
+}
+
+TEST(decoded_view_skip_string) {
+  using namespace sourcemeta::jsonbinpack;
+  const sourcemeta::core::JSON document{"foo bar"};
+  expect_skip(UTF8_STRING_NO_LENGTH{7}, document);
+  expect_skip(FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED{3}, document);
+  expect_skip(ROOF_VARINT_PREFIX_UTF8_STRING_SHARED{10}, document);
+  expect_skip(BOUNDED_8BIT_PREFIX_UTF8_STRING_SHARED{3, 10}, document);
+  expect_skip(RFC3339_DATE_INTEGER_TRIPLET{},
+              sourcemeta::core::JSON{"2014-10-01"});
+  expect_skip(PREFIX_VARINT_LENGTH_STRING_SHARED{}, document);
+  expect_skip(GZIP_VARINT_PREFIX_UTF8_STRING{}, document);
+}
+
+TEST(decoded_view_skip_shared_string) {
+  using namespace sourcemeta::jsonbinpack;
+  // The second string is a reference to the first one
+  const sourcemeta::core::JSON document{
+      sourcemeta::core::parse_json("[ \"foo bar\", \"foo bar\" ]")};
+  const auto string{
+      std::make_shared<Encoding>(FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED{3})};
+  expect_skip(FIXED_TYPED_ARRAY{2, string, {}}, document);
+  expect_skip(FLOOR_TYPED_ARRAY{0, string, {}}, document);
+  expect_skip(
+      ROOF_TYPED_ARRAY{
+          5,
+          std::make_shared<Encoding>(ROOF_VARINT_PREFIX_UTF8_STRING_SHARED{10}),
+          {}},
+      document);
+  expect_skip(BOUNDED_8BITS_TYPED_ARRAY{
+                  0, 5,
+                  std::make_shared<Encoding>(
+                      BOUNDED_8BIT_PREFIX_UTF8_STRING_SHARED{3, 10}),
+                  {}},
+              document);
+  expect_skip(
+      FLOOR_TYPED_ARRAY{
+          0, std::make_shared<Encoding>(PREFIX_VARINT_LENGTH_STRING_SHARED{}),
+          {}},
+      document);
+}
+
+TEST(decoded_view_skip_object) {
+  using namespace sourcemeta::jsonbinpack;
+  const auto key{
+      std::make_shared<Encoding>(PREFIX_VARINT_LENGTH_STRING_SHARED{})};
+  const auto value{
+      std::make_shared<Encoding>(FLOOR_MULTIPLE_ENUM_VARINT{0, 1})};
+  const auto document{
+      sourcemeta::core::parse_json("{ \"foo\": 1, \"bar\": 2 }")};
+  expect_skip(FIXED_TYPED_ARBITRARY_OBJECT{2, key, value}, document);
+  expect_skip(VARINT_TYPED_ARBITRARY_OBJECT{key, value}, document);
+  expect_skip(VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT{key, value, false},
+              document);
+  expect_skip(VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT{key, value, true},
+              document);
+}
+
+TEST(decoded_view_skip_object_known_properties) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding value{FLOOR_MULTIPLE_ENUM_VARINT{0, 1}};
+  const Encoding fixed{BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{0, 255, 1}};
+  expect_skip(MIXED_BOUNDED_TYPED_OBJECT{{"foo"}, {"bar", "baz"},
+                                         {value, value, value}},
+              sourcemeta::core::parse_json("{ \"foo\": 1, \"baz\": 300 }"));
+  // Without optional properties, the size of the object may be known
+  expect_skip(MIXED_BOUNDED_TYPED_OBJECT{{"foo", "bar"}, {}, {fixed, fixed}},
+              sourcemeta::core::parse_json("{ \"foo\": 1, \"bar\": 2 }"));
+}
+
+TEST(decoded_view_skip_length_prefix_array) {
+  using namespace sourcemeta::jsonbinpack;
+  const auto string{
+      std::make_shared<Encoding>(PREFIX_VARINT_LENGTH_STRING_SHARED{})};
+  const auto document{
+      sourcemeta::core::parse_json("[ \"foo\", \"bar\", \"foo\" ]")};
+  expect_skip(FLOOR_TYPED_LENGTH_PREFIX_ARRAY{1, string, {}, false}, document);
+  expect_skip(FLOOR_TYPED_LENGTH_PREFIX_ARRAY{1, string, {}, true}, document);
+  auto long_document{sourcemeta::core::JSON::make_array()};
+  long_document.push_back(sourcemeta::core::JSON{std::string(70000, 'x')});
+  long_document.push_back(sourcemeta::core::JSON{"foo"});
+  expect_skip(FLOOR_TYPED_LENGTH_PREFIX_ARRAY{0, string, {}, true},
+              long_document);
+}
+
+TEST(decoded_view_ANY_PACKED_TYPE_TAG_BYTE_PREFIX) {
+  using namespace sourcemeta::jsonbinpack;
+  const auto document{sourcemeta::core::parse_json(R"JSON({
+    "type": "FeatureCollection",
+    "features": [
+      { "type": "Feature", "id": 1, "tags": [ "foo", "bar" ] },
+      { "type": "Feature", "id": 2, "tags": [] },
+      { "type": "Feature", "id": 3, "tags": [ "baz" ], "valid": true }
+    ]
+  })JSON")};
+  const Encoding encoding{ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  std::vector<std::byte> buffer;
+  Encoder encoder{buffer};
+  encoder.write(document, encoding);
+
+  const DecodedView view{std::span<const std::byte>{buffer}, encoding};
+  EXPECT_EQ(view.size(), 2);
+  EXPECT_EQ(view.at("type").to_string(), "FeatureCollection");
+  const auto features{view.at("features")};
+  EXPECT_EQ(features.size(), 3);
+  EXPECT_EQ(features.at(2).at("id").to_integer(), 3);
+  EXPECT_EQ(features.at(2).at("type").to_string(), "Feature");
+  EXPECT_TRUE(features.at(2).at("valid").to_boolean());
+  EXPECT_EQ(features.at(0).at("tags").at(1).to_string(), "bar");
+  EXPECT_EQ(features.at(1).at("tags").size(), 0);
+  EXPECT_FALSE(features.at(1).try_at("valid").has_value());
+  EXPECT_FALSE(view.try_at("foo").has_value());
+  EXPECT_EQ(features.at(1).to_json(), document.at("features").at(1));
+  EXPECT_EQ(view.to_json(), document);
+}
+
+TEST(decoded_view_FIXED_TYPED_ARRAY_fixed_size_items) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{FIXED_TYPED_ARRAY{
+      4,
+      std::make_shared<Encoding>(FIXED_TYPED_ARRAY{
+          2, std::make_shared<Encoding>(UTF8_STRING_NO_LENGTH{3}), {}}),
+      {}}};
+  const auto document{sourcemeta::core::parse_json(
+      "[ [ \"foo\", \"bar\" ], [ \"baz\", \"qux\" ], "
+      "[ \"abc\", \"def\" ], [ \"ghi\", \"jkl\" ] ]")};
+  std::vector<std::byte> buffer;
+  Encoder encoder{buffer};
+  encoder.write(document, encoding);
+  EXPECT_EQ(buffer.size(), 24);
+
+  const DecodedView view{std::span<const std::byte>{buffer}, encoding};
+  EXPECT_EQ(view.at(3).at(1).to_string(), "jkl");
+  EXPECT_EQ(view.at(2).at(0).to_string(), "abc");
+  EXPECT_EQ(view.at(0).to_json(), document.at(0));
+}
+
+TEST(decoded_view_VARINT_TYPED_ARBITRARY_OBJECT_shared_keys) {
+  using namespace sourcemeta::jsonbinpack;
+  const auto key{
+      std::make_shared<Encoding>(PREFIX_VARINT_LENGTH_STRING_SHARED{})};
+  const Encoding encoding{FLOOR_TYPED_ARRAY{
+      0,
+      std::make_shared<Encoding>(VARINT_TYPED_ARBITRARY_OBJECT{
+          key, std::make_shared<Encoding>(FLOOR_MULTIPLE_ENUM_VARINT{0, 1})}),
+      {}}};
+  auto document{sourcemeta::core::JSON::make_array()};
+  for (std::int64_t index = 0; index < 10; index++) {
+    auto record{sourcemeta::core::JSON::make_object()};
+    record.assign("identifier", sourcemeta::core::JSON{index});
+    record.assign("count", sourcemeta::core::JSON{index * 2});
+    document.push_back(std::move(record));
+  }
+
+  std::vector<std::byte> buffer;
+  Encoder encoder{buffer};
+  encoder.write(document, encoding);
+
+  // The keys of the last records are references to earlier ones
+  const DecodedView view{std::span<const std::byte>{buffer}, encoding};
+  EXPECT_EQ(view.size(), 10);
+  EXPECT_EQ(view.at(9).at("count").to_integer(), 18);
+  EXPECT_EQ(view.at(5).at("identifier").to_integer(), 5);
+  EXPECT_EQ(view.at(0).at("count").to_integer(), 0);
+  EXPECT_EQ(view.to_json(), document);
+}
+
+TEST(decoded_view_MIXED_BOUNDED_TYPED_OBJECT) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{MIXED_BOUNDED_TYPED_OBJECT{
+      {"id", "service"},
+      {"message", "severity"},
+      {FLOOR_MULTIPLE_ENUM_VARINT{0, 1}, PREFIX_VARINT_LENGTH_STRING_SHARED{},
+       PREFIX_VARINT_LENGTH_STRING_SHARED{},
+       PREFIX_VARINT_LENGTH_STRING_SHARED{}}}};
+  const auto document{sourcemeta::core::parse_json(R"JSON({
+    "id": 300,
+    "service": "checkout",
+    "severity": "warning"
+  })JSON")};
+
+  std::vector<std::byte> buffer;
+  Encoder encoder{buffer};
+  encoder.write(document, encoding);
+
+  const DecodedView view{std::span<const std::byte>{buffer}, encoding};
+  EXPECT_EQ(view.size(), 3);
+  EXPECT_EQ(view.at("severity").to_string(), "warning");
+  EXPECT_EQ(view.at("service").to_string(), "checkout");
+  EXPECT_EQ(view.at("id").to_integer(), 300);
+  EXPECT_FALSE(view.try_at("message").has_value());
+  EXPECT_FALSE(view.try_at("other").has_value());
+  EXPECT_EQ(view.to_json(), document);
+}
+
+TEST(decoded_view_FLOOR_TYPED_LENGTH_PREFIX_ARRAY_offsets) {
+  using namespace sourcemeta::jsonbinpack;
+  const auto key{
+      std::make_shared<Encoding>(PREFIX_VARINT_LENGTH_STRING_SHARED{})};
+  const auto value{
+      std::make_shared<Encoding>(PREFIX_VARINT_LENGTH_STRING_SHARED{})};
+  std::vector<Encoding> prefix_encodings;
+  prefix_encodings.emplace_back(FLOOR_MULTIPLE_ENUM_VARINT{0, 1});
+  const Encoding encoding{FLOOR_TYPED_LENGTH_PREFIX_ARRAY{
+      0,
+      std::make_shared<Encoding>(
+          VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT{key, value, true}),
+      std::move(prefix_encodings), true}};
+  auto document{sourcemeta::core::JSON::make_array()};
+  document.push_back(sourcemeta::core::JSON{300});
+  for (std::int64_t index = 0; index < 300; index++) {
+    auto record{sourcemeta::core::JSON::make_object()};
+    record.assign("identifier", sourcemeta::core::JSON{std::to_string(index)});
+    record.assign("name", sourcemeta::core::JSON{std::string(
+                              static_cast<std::size_t>(index % 7), 'x')});
+    document.push_back(std::move(record));
+  }
+
+  std::vector<std::byte> buffer;
+  Encoder encoder{buffer};
+  encoder.write(document, encoding);
+
+  const DecodedView view{std::span<const std::byte>{buffer}, encoding};
+  EXPECT_EQ(view.size(), 301);
+  EXPECT_EQ(view.at(0).to_integer(), 300);
+  EXPECT_EQ(view.at(300).at("identifier").to_string(), "299");
+  EXPECT_EQ(view.at(101).at("name").to_string(), "xx");
+  EXPECT_EQ(view.at(1).at("identifier").to_string(), "0");
+  EXPECT_FALSE(view.at(5).try_at("foo").has_value());
+  EXPECT_EQ(view.at(42).to_json(), document.at(42));
+  EXPECT_EQ(view.to_json(), document);
+}
+
+TEST(decoded_view_to_real) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{DOUBLE_VARINT_TUPLE{}};
+  std::vector<std::byte> buffer;
+  Encoder encoder{buffer};
+  encoder.write(sourcemeta::core::JSON{3.14}, encoding);
+  const DecodedView view{std::span<const std::byte>{buffer}, encoding};
+  EXPECT_EQ(view.to_real(), 3.14);
+}
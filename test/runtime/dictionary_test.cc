@@ -0,0 +1,283 @@
+#include <sourcemeta/core/io.h>
+#include <sourcemeta/core/json.h>
+#include <sourcemeta/core/test.h>
+#include <sourcemeta/jsonbinpack/runtime.h>
+
+#include <cstddef> // std::byte, std::size_t
+#include <cstdint> // std::int64_t
+#include <memory>  // std::make_shared
+#include <span>    // std::span
+#include <sstream> // std::istringstream, std::ostringstream
+#include <string>  // std::to_string, std::string
+#include <utility> // std::move
+#include <vector>  // std::vector
+
+static auto events(const std::size_t size)
+    -> std::vector<sourcemeta::core::JSON> {
+  std::vector<sourcemeta::core::JSON> result;
+  for (std::size_t index = 0; index < size; index++) {
+    auto record{sourcemeta::core::JSON::make_object()};
+    record.assign("timestamp",
+                  sourcemeta::core::JSON{static_cast<std::int64_t>(index)});
+    record.assign("severity", sourcemeta::core::JSON{
+                                  index % 3 == 0 ? "warning" : "information"});
+    record.assign("service", sourcemeta::core::JSON{"checkout"});
+    record.assign("message", sourcemeta::core::JSON{"request number " +
+                                                    std::to_string(index)});
+    result.push_back(std::move(record));
+  }
+
+  return result;
+}
+
+static auto encode(const sourcemeta::core::JSON &document,
+                   const sourcemeta::jsonbinpack::Encoding &encoding,
+                   const sourcemeta::jsonbinpack::Dictionary *dictionary)
+    -> std::vector<std::byte> {
+  std::vector<std::byte> result;
+  sourcemeta::jsonbinpack::Encoder encoder{result,
+                                           {.dictionary = dictionary}};
+  encoder.write(document, encoding);
+  return result;
+}
+
+TEST(dictionary_add) {
+  sourcemeta::jsonbinpack::Dictionary dictionary;
+  EXPECT_EQ(dictionary.size(), 0);
+  EXPECT_TRUE(dictionary.add("foo"));
+  EXPECT_TRUE(dictionary.add("bar"));
+  EXPECT_FALSE(dictionary.add("foo"));
+  EXPECT_EQ(dictionary.size(), 2);
+  EXPECT_EQ(dictionary.at(0), "foo");
+  EXPECT_EQ(dictionary.at(1), "bar");
+  EXPECT_TRUE(dictionary.find("foo").has_value());
+  EXPECT_EQ(dictionary.find("foo").value(), 0);
+  EXPECT_EQ(dictionary.find("bar").value(), 1);
+  EXPECT_FALSE(dictionary.find("baz").has_value());
+}
+
+TEST(dictionary_train) {
+  sourcemeta::jsonbinpack::Dictionary dictionary;
+  dictionary.train(events(10));
+  // Every document has these
+  EXPECT_EQ(dictionary.at(0), "timestamp");
+  EXPECT_TRUE(dictionary.find("timestamp").has_value());
+  EXPECT_TRUE(dictionary.find("severity").has_value());
+  EXPECT_TRUE(dictionary.find("checkout").has_value());
+  EXPECT_TRUE(dictionary.find("message").has_value());
+  EXPECT_TRUE(dictionary.find("warning").has_value());
+  // These only occur once each
+  EXPECT_FALSE(dictionary.find("request number 3").has_value());
+  EXPECT_EQ(dictionary.size(), 7);
+}
+
+TEST(dictionary_train_options) {
+  sourcemeta::jsonbinpack::Dictionary dictionary;
+  dictionary.train(events(10), {.minimum_string_length = 8,
+                                .minimum_documents = 5,
+                                .maximum_entries = 2,
+                                .maximum_byte_size = 1000});
+  EXPECT_EQ(dictionary.size(), 2);
+  EXPECT_EQ(dictionary.at(0), "timestamp");
+  // Ties are broken by the strings themselves
+  EXPECT_EQ(dictionary.at(1), "checkout");
+}
+
+TEST(dictionary_train_incrementally) {
+  sourcemeta::jsonbinpack::Dictionary dictionary;
+  dictionary.add("checkout");
+  const auto identifier{dictionary.identifier()};
+  dictionary.train(events(10));
+  // Existing entries keep their place
+  EXPECT_EQ(dictionary.at(0), "checkout");
+  EXPECT_EQ(dictionary.size(), 7);
+  EXPECT_FALSE(dictionary.identifier() == identifier);
+}
+
+TEST(dictionary_train_deterministic) {
+  sourcemeta::jsonbinpack::Dictionary first;
+  first.train(events(20));
+  sourcemeta::jsonbinpack::Dictionary second;
+  second.train(events(20));
+  EXPECT_EQ(first.identifier(), second.identifier());
+}
+
+TEST(dictionary_identifier) {
+  sourcemeta::jsonbinpack::Dictionary first;
+  first.add("foo");
+  first.add("bar");
+  sourcemeta::jsonbinpack::Dictionary second;
+  second.add("bar");
+  second.add("foo");
+  sourcemeta::jsonbinpack::Dictionary third;
+  third.add("foo");
+  third.add("bar");
+  EXPECT_FALSE(first.identifier() == second.identifier());
+  EXPECT_EQ(first.identifier(), third.identifier());
+}
+
+TEST(dictionary_write_read) {
+  using namespace sourcemeta::jsonbinpack;
+  Dictionary dictionary;
+  dictionary.train(events(10));
+  std::vector<std::byte> buffer;
+  OutputStream output{buffer};
+  dictionary.write(output);
+
+  InputStream input{std::span<const std::byte>{buffer}};
+  const Dictionary result{input};
+  EXPECT_FALSE(input.has_more_data());
+  EXPECT_EQ(result.size(), dictionary.size());
+  EXPECT_EQ(result.identifier(), dictionary.identifier());
+  EXPECT_EQ(result.find("checkout"), dictionary.find("checkout"));
+}
+
+TEST(dictionary_read_unknown_version) {
+  using namespace sourcemeta::jsonbinpack;
+  const std::vector<std::byte> buffer{std::byte{0x02}, std::byte{0x00}};
+  InputStream input{std::span<const std::byte>{buffer}};
+  bool thrown{false};
+  try {
+    const Dictionary result{input};
+  } catch (const DictionaryError &) {
+    thrown = true;
+  }
+
+  EXPECT_TRUE(thrown);
+}
+
+TEST(dictionary_encode_ANY_PACKED_TYPE_TAG_BYTE_PREFIX) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  Dictionary dictionary;
+  dictionary.add("bar");
+  dictionary.add("foo");
+  // A shared string of length 3 pointing one entry past the start
+  EXPECT_EQ(encode(sourcemeta::core::JSON{"foo"}, encoding, &dictionary),
+            (std::vector<std::byte>{std::byte{0x20}, std::byte{0x03}}));
+  // Not in the dictionary
+  EXPECT_EQ(encode(sourcemeta::core::JSON{"baz"}, encoding, &dictionary),
+            encode(sourcemeta::core::JSON{"baz"}, encoding, nullptr));
+}
+
+TEST(dictionary_encode_PREFIX_VARINT_LENGTH_STRING_SHARED) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{PREFIX_VARINT_LENGTH_STRING_SHARED{}};
+  Dictionary dictionary;
+  dictionary.add("foo");
+  EXPECT_EQ(encode(sourcemeta::core::JSON{"foo"}, encoding, &dictionary),
+            (std::vector<std::byte>{std::byte{0x00}, std::byte{0x02}}));
+}
+
+TEST(dictionary_encode_short_string) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  Dictionary dictionary;
+  dictionary.add("x");
+  // A reference would not be any smaller than the string itself
+  EXPECT_EQ(encode(sourcemeta::core::JSON{"x"}, encoding, &dictionary),
+            encode(sourcemeta::core::JSON{"x"}, encoding, nullptr));
+}
+
+TEST(dictionary_round_trip) {
+  using namespace sourcemeta::jsonbinpack;
+  const auto documents{events(50)};
+  Dictionary dictionary;
+  dictionary.train(std::span{documents}.first(10));
+
+  std::vector<Encoding> encodings;
+  encodings.emplace_back(ANY_PACKED_TYPE_TAG_BYTE_PREFIX{});
+  encodings.emplace_back(VARINT_TYPED_ARBITRARY_OBJECT{
+      std::make_shared<Encoding>(PREFIX_VARINT_LENGTH_STRING_SHARED{}),
+      std::make_shared<Encoding>(ANY_PACKED_TYPE_TAG_BYTE_PREFIX{})});
+  for (const auto &encoding : encodings) {
+    std::size_t size{0};
+    std::size_t size_without_dictionary{0};
+    for (const auto &document : documents) {
+      const auto bytes{encode(document, encoding, &dictionary)};
+      size += bytes.size();
+      size_without_dictionary += encode(document, encoding, nullptr).size();
+
+      Decoder decoder{bytes, &dictionary};
+      EXPECT_EQ(decoder.read(encoding), document);
+
+      std::ostringstream expected;
+      sourcemeta::core::stringify(document, expected);
+      Decoder text_decoder{bytes, &dictionary};
+      sourcemeta::core::JSON::String text;
+      text_decoder.transcode(encoding, text);
+      EXPECT_EQ(text, expected.str());
+
+      const DecodedView view{bytes, encoding, &dictionary};
+      EXPECT_EQ(view.at("service").to_string(), "checkout");
+    }
+
+    EXPECT_TRUE(size * 2 < size_without_dictionary);
+  }
+}
+
+TEST(dictionary_round_trip_stream) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED{0}};
+  Dictionary dictionary;
+  dictionary.add("information");
+  const sourcemeta::core::JSON document{"information"};
+  const auto bytes{encode(document, encoding, &dictionary)};
+  EXPECT_EQ(bytes.size(), 3);
+
+  std::string data;
+  for (const auto byte : bytes) {
+    data.push_back(static_cast<char>(byte));
+  }
+
+  std::istringstream stream{data};
+  Decoder decoder{stream, &dictionary};
+  EXPECT_EQ(decoder.read(encoding), document);
+}
+
+TEST(dictionary_decode_without_dictionary) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  Dictionary dictionary;
+  dictionary.add("foo");
+  const auto bytes{encode(sourcemeta::core::JSON{"foo"}, encoding,
+                          &dictionary)};
+  Decoder decoder{bytes};
+  bool thrown{false};
+  try {
+    decoder.read(encoding);
+  } catch (const sourcemeta::core::IOReadOutOfBoundsError &) {
+    thrown = true;
+  }
+
+  EXPECT_TRUE(thrown);
+}
+
+TEST(dictionary_batch_and_container) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  const auto documents{events(100)};
+  Dictionary dictionary;
+  dictionary.train(documents);
+
+  std::vector<std::byte> batch;
+  encode_batch(documents, encoding, batch, 4, {.dictionary = &dictionary});
+  EXPECT_EQ(decode_batch(batch, encoding, 4, &dictionary), documents);
+
+  std::vector<std::byte> output;
+  ContainerWriter writer{output, encoding, {.dictionary = &dictionary}};
+  writer.write(documents);
+  writer.close();
+  const ContainerReader reader{output, encoding, &dictionary};
+  EXPECT_EQ(reader.read(7), documents[7]);
+  EXPECT_EQ(reader.read_all(), documents);
+
+  bool thrown{false};
+  try {
+    const ContainerReader other{output, encoding};
+  } catch (const ContainerError &) {
+    thrown = true;
+  }
+
+  EXPECT_TRUE(thrown);
+}
@@ -152,6 +152,63 @@ TEST(LARGE_CHOICE_INDEX_enum_250) {
             (std::vector<std::byte>{std::byte{0xfa}, std::byte{0x01}}));
 }
 
+TEST(LARGE_CHOICE_INDEX_indexed_strings) {
+  auto choices{sourcemeta::core::JSON::make_array()};
+  for (std::int64_t x = 0; x < 1000; x++) {
+    choices.push_back(sourcemeta::core::JSON{"choice_" + std::to_string(x)});
+  }
+
+  auto input{sourcemeta::core::JSON::make_object()};
+  input.assign("binpackEncoding", sourcemeta::core::JSON{"LARGE_CHOICE_INDEX"});
+  input.assign("binpackOptions", sourcemeta::core::JSON::make_object());
+  input.at("binpackOptions").assign("choices", std::move(choices));
+  const auto encoding{sourcemeta::jsonbinpack::load(input)};
+
+  sourcemeta::core::OutputByteStream stream{};
+  sourcemeta::jsonbinpack::Encoder encoder{stream};
+  encoder.write(sourcemeta::core::JSON{"choice_300"}, encoding);
+  encoder.write(sourcemeta::core::JSON{"choice_0"}, encoding);
+  encoder.write(sourcemeta::core::JSON{"choice_999"}, encoding);
+  EXPECT_EQ(stream.bytes(),
+            (std::vector<std::byte>{std::byte{0xac}, std::byte{0x02},
+                                    std::byte{0x00}, std::byte{0xe7},
+                                    std::byte{0x07}}));
+}
+
+TEST(LARGE_CHOICE_INDEX_indexed_duplicates) {
+  const auto encoding{
+      sourcemeta::jsonbinpack::load(sourcemeta::core::parse_json(R"JSON({
+    "binpackEncoding": "LARGE_CHOICE_INDEX",
+    "binpackOptions": {
+      "choices": [ 0, "1", { "foo": [ 1 ] }, 1, { "foo": [ 1 ] }, 1 ]
+    }
+  })JSON"))};
+
+  sourcemeta::core::OutputByteStream stream{};
+  sourcemeta::jsonbinpack::Encoder encoder{stream};
+  encoder.write(sourcemeta::core::JSON{1}, encoding);
+  encoder.write(sourcemeta::core::parse_json("{ \"foo\": [ 1 ] }"), encoding);
+  encoder.write(sourcemeta::core::JSON{"1"}, encoding);
+  EXPECT_EQ(stream.bytes(),
+            (std::vector<std::byte>{std::byte{0x03}, std::byte{0x02},
+                                    std::byte{0x01}}));
+}
+
+TEST(BYTE_CHOICE_INDEX_indexed) {
+  const auto encoding{
+      sourcemeta::jsonbinpack::load(sourcemeta::core::parse_json(R"JSON({
+    "binpackEncoding": "BYTE_CHOICE_INDEX",
+    "binpackOptions": { "choices": [ "foo", "bar", "baz" ] }
+  })JSON"))};
+
+  sourcemeta::core::OutputByteStream stream{};
+  sourcemeta::jsonbinpack::Encoder encoder{stream};
+  encoder.write(sourcemeta::core::JSON{"baz"}, encoding);
+  encoder.write(sourcemeta::core::JSON{"foo"}, encoding);
+  EXPECT_EQ(stream.bytes(),
+            (std::vector<std::byte>{std::byte{0x02}, std::byte{0x00}}));
+}
+
 TEST(TOP_LEVEL_BYTE_CHOICE_INDEX_1__1_0_0) {
   const sourcemeta::core::JSON document{1};
   sourcemeta::core::OutputByteStream stream{};
@@ -217,6 +274,20 @@ TEST(TOP_LEVEL_BYTE_CHOICE_INDEX_non_scalar_1) {
   EXPECT_EQ(stream.bytes(), (std::vector<std::byte>{std::byte{0x02}}));
 }
 
+TEST(TOP_LEVEL_BYTE_CHOICE_INDEX_indexed) {
+  const auto encoding{
+      sourcemeta::jsonbinpack::load(sourcemeta::core::parse_json(R"JSON({
+    "binpackEncoding": "TOP_LEVEL_BYTE_CHOICE_INDEX",
+    "binpackOptions": { "choices": [ "foo", "bar", "baz" ] }
+  })JSON"))};
+
+  sourcemeta::core::OutputByteStream stream{};
+  sourcemeta::jsonbinpack::Encoder encoder{stream};
+  encoder.write(sourcemeta::core::JSON{"foo"}, encoding);
+  encoder.write(sourcemeta::core::JSON{"baz"}, encoding);
+  EXPECT_EQ(stream.bytes(), (std::vector<std::byte>{std::byte{0x01}}));
+}
+
 TEST(CONST_NONE_scalar) {
   const sourcemeta::core::JSON document{1};
   sourcemeta::core::OutputByteStream stream{};
@@ -1,4 +1,6 @@
 #include <cstddef> // std::byte
+#include <span>    // std::span
+#include <string>  // std::string
 #include <vector>
 
 #include <sourcemeta/jsonbinpack/runtime.h>
@@ -279,3 +281,117 @@ TEST(ROOF_TYPED_ARRAY_complex) {
                               std::byte{0x66}, std::byte{0x6f}, std::byte{0x6f},
                               std::byte{0xfa}, std::byte{0x01}}));
 }
+
+TEST(FLOOR_TYPED_LENGTH_PREFIX_ARRAY_foo_ba__offsets) {
+  using namespace sourcemeta::jsonbinpack;
+  const sourcemeta::core::JSON document =
+      sourcemeta::core::parse_json("[ \"foo\", \"ba\" ]");
+  sourcemeta::core::OutputByteStream stream{};
+
+  Encoder encoder{stream};
+  encoder.FLOOR_TYPED_LENGTH_PREFIX_ARRAY(
+      document,
+      {0,
+       std::make_shared<Encoding>(FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED{0}),
+       {},
+       true});
+  EXPECT_EQ(stream.bytes(),
+            (std::vector<std::byte>{
+                std::byte{0x02}, std::byte{0x07}, std::byte{0x00},
+                std::byte{0x00}, std::byte{0x00}, std::byte{0x04},
+                std::byte{0x66}, std::byte{0x6f}, std::byte{0x6f},
+                std::byte{0x03}, std::byte{0x62}, std::byte{0x61},
+                std::byte{0x00}, std::byte{0x04}}));
+}
+
+TEST(FLOOR_TYPED_LENGTH_PREFIX_ARRAY_0_1_true__semityped) {
+  using namespace sourcemeta::jsonbinpack;
+  const sourcemeta::core::JSON document =
+      sourcemeta::core::parse_json("[ 0, 1, true ]");
+  std::vector<std::byte> buffer;
+
+  std::vector<sourcemeta::core::JSON> choices;
+  choices.push_back(sourcemeta::core::JSON(false));
+  choices.push_back(sourcemeta::core::JSON(true));
+
+  std::vector<Encoding> prefix_encodings;
+  prefix_encodings.emplace_back(BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{0, 10, 1});
+  prefix_encodings.emplace_back(BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{0, 10, 1});
+
+  Encoder encoder{buffer};
+  encoder.FLOOR_TYPED_LENGTH_PREFIX_ARRAY(
+      document,
+      {1, std::make_shared<Encoding>(BYTE_CHOICE_INDEX{std::move(choices)}),
+       std::move(prefix_encodings)});
+  EXPECT_EQ(buffer, (std::vector<std::byte>{
+                        std::byte{0x02}, std::byte{0x03}, std::byte{0x00},
+                        std::byte{0x00}, std::byte{0x00}, std::byte{0x00},
+                        std::byte{0x01}, std::byte{0x01}}));
+}
+
+TEST(FLOOR_TYPED_LENGTH_PREFIX_ARRAY_empty__offsets) {
+  using namespace sourcemeta::jsonbinpack;
+  const sourcemeta::core::JSON document{sourcemeta::core::JSON::Array{}};
+  std::vector<std::byte> buffer;
+
+  Encoder encoder{buffer};
+  encoder.FLOOR_TYPED_LENGTH_PREFIX_ARRAY(
+      document,
+      {0,
+       std::make_shared<Encoding>(BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{0, 10, 1}),
+       {},
+       true});
+  EXPECT_EQ(buffer,
+            (std::vector<std::byte>{std::byte{0x00}, std::byte{0x00},
+                                    std::byte{0x00}, std::byte{0x00},
+                                    std::byte{0x00}}));
+}
+
+TEST(FLOOR_TYPED_LENGTH_PREFIX_ARRAY_16_bit_offsets) {
+  using namespace sourcemeta::jsonbinpack;
+  auto document{sourcemeta::core::JSON::make_array()};
+  document.push_back(sourcemeta::core::JSON{std::string(300, 'x')});
+  document.push_back(sourcemeta::core::JSON{"y"});
+  std::vector<std::byte> buffer;
+
+  Encoder encoder{buffer};
+  encoder.FLOOR_TYPED_LENGTH_PREFIX_ARRAY(
+      document,
+      {0, std::make_shared<Encoding>(PREFIX_VARINT_LENGTH_STRING_SHARED{}),
+       {},
+       true});
+
+  // 2 bytes for the length of the long string, plus 2 for the short one
+  EXPECT_EQ(buffer.size(), 1 + 4 + 304 + 4);
+  EXPECT_EQ(buffer[1], std::byte{0x30});
+  EXPECT_EQ(buffer[2], std::byte{0x01});
+  EXPECT_EQ(buffer[3], std::byte{0x00});
+  EXPECT_EQ(buffer[4], std::byte{0x00});
+  EXPECT_EQ(buffer[309], std::byte{0x00});
+  EXPECT_EQ(buffer[310], std::byte{0x00});
+  EXPECT_EQ(buffer[311], std::byte{0x2e});
+  EXPECT_EQ(buffer[312], std::byte{0x01});
+}
+
+TEST(FLOOR_TYPED_LENGTH_PREFIX_ARRAY_nested_shared_strings) {
+  using namespace sourcemeta::jsonbinpack;
+  const auto string{
+      std::make_shared<Encoding>(FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED{0})};
+  const auto inner{std::make_shared<Encoding>(
+      FLOOR_TYPED_LENGTH_PREFIX_ARRAY{0, string, {}, true})};
+  std::vector<Encoding> prefix_encodings;
+  prefix_encodings.emplace_back(FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED{0});
+  const Encoding encoding{FLOOR_TYPED_LENGTH_PREFIX_ARRAY{
+      0, inner, std::move(prefix_encodings), false}};
+
+  // Strings within the nested arrays point back to earlier ones,
+  // which were written before the arrays that contain them
+  const auto document{sourcemeta::core::parse_json(
+      "[ \"foo bar\", [ \"foo bar\", \"baz\" ], [ \"baz\", \"foo bar\" ] ]")};
+  std::vector<std::byte> buffer;
+  Encoder encoder{buffer};
+  encoder.write(document, encoding);
+
+  Decoder decoder{std::span<const std::byte>{buffer}};
+  EXPECT_EQ(decoder.read(encoding), document);
+}
@@ -179,3 +179,205 @@ TEST(cache_no_fallback_type) {
   EXPECT_FALSE(
       cache.find("foo", CacheType::PrefixLengthVarintPlusOne).has_value());
 }
+
+TEST(cache_many_strings) {
+  sourcemeta::jsonbinpack::Cache cache;
+  using CacheType = sourcemeta::jsonbinpack::Cache::Type;
+  for (std::uint64_t index = 0; index < 10000; index++) {
+    cache.record("string-" + std::to_string(index), index,
+                 CacheType::Standalone);
+  }
+
+  for (std::uint64_t index = 0; index < 10000; index++) {
+    const auto result{
+        cache.find("string-" + std::to_string(index), CacheType::Standalone)};
+    EXPECT_TRUE(result.has_value());
+    EXPECT_EQ(result.value(), index);
+  }
+
+  EXPECT_FALSE(cache.find("string-10000", CacheType::Standalone).has_value());
+}
+
+TEST(cache_remove_oldest_many) {
+  sourcemeta::jsonbinpack::Cache cache;
+  using CacheType = sourcemeta::jsonbinpack::Cache::Type;
+  for (std::uint64_t index = 0; index < 1000; index++) {
+    cache.record("string-" + std::to_string(index), index,
+                 CacheType::Standalone);
+  }
+
+  for (std::uint64_t index = 0; index < 500; index++) {
+    cache.remove_oldest();
+  }
+
+  for (std::uint64_t index = 0; index < 1000; index++) {
+    const auto result{
+        cache.find("string-" + std::to_string(index), CacheType::Standalone)};
+    EXPECT_EQ(result.has_value(), index >= 500);
+  }
+}
+
+TEST(cache_remove_oldest_after_bumps) {
+  sourcemeta::jsonbinpack::Cache cache;
+  using CacheType = sourcemeta::jsonbinpack::Cache::Type;
+  cache.record("bar", 0, CacheType::Standalone);
+  for (std::uint64_t index = 1; index < 1000; index++) {
+    cache.record("foo", index, CacheType::Standalone);
+  }
+
+  cache.record("baz", 1000, CacheType::Standalone);
+  cache.record("bar", 1001, CacheType::Standalone);
+
+  cache.remove_oldest();
+  EXPECT_FALSE(cache.find("foo", CacheType::Standalone).has_value());
+  EXPECT_TRUE(cache.find("bar", CacheType::Standalone).has_value());
+  EXPECT_TRUE(cache.find("baz", CacheType::Standalone).has_value());
+
+  cache.remove_oldest();
+  EXPECT_TRUE(cache.find("bar", CacheType::Standalone).has_value());
+  EXPECT_FALSE(cache.find("baz", CacheType::Standalone).has_value());
+
+  cache.remove_oldest();
+  EXPECT_FALSE(cache.find("bar", CacheType::Standalone).has_value());
+}
+
+TEST(cache_options_no_sharing) {
+  sourcemeta::jsonbinpack::Cache cache{{.sharing = false}};
+  using CacheType = sourcemeta::jsonbinpack::Cache::Type;
+  cache.record("foo", 2, CacheType::Standalone);
+  EXPECT_FALSE(cache.find("foo", CacheType::Standalone).has_value());
+}
+
+TEST(cache_options_minimum_string_length) {
+  sourcemeta::jsonbinpack::Cache cache{{.minimum_string_length = 5}};
+  using CacheType = sourcemeta::jsonbinpack::Cache::Type;
+  cache.record("foo", 2, CacheType::Standalone);
+  cache.record("foobar", 5, CacheType::Standalone);
+  EXPECT_FALSE(cache.find("foo", CacheType::Standalone).has_value());
+  EXPECT_TRUE(cache.find("foobar", CacheType::Standalone).has_value());
+}
+
+TEST(cache_options_minimum_string_length_zero) {
+  sourcemeta::jsonbinpack::Cache cache{{.minimum_string_length = 0}};
+  using CacheType = sourcemeta::jsonbinpack::Cache::Type;
+  cache.record("", 1, CacheType::Standalone);
+  cache.record("a", 2, CacheType::Standalone);
+  EXPECT_FALSE(cache.find("", CacheType::Standalone).has_value());
+  EXPECT_TRUE(cache.find("a", CacheType::Standalone).has_value());
+
+  cache.clear();
+  cache.record("", 3, CacheType::Standalone);
+  cache.record("a", 4, CacheType::Standalone);
+  EXPECT_FALSE(cache.find("", CacheType::Standalone).has_value());
+  EXPECT_EQ(cache.find("a", CacheType::Standalone).value(), 4);
+}
+
+TEST(cache_options_maximum_byte_size) {
+  sourcemeta::jsonbinpack::Cache cache{{.maximum_byte_size = 8}};
+  using CacheType = sourcemeta::jsonbinpack::Cache::Type;
+  cache.record("foo", 1, CacheType::Standalone);
+  cache.record("bar", 2, CacheType::Standalone);
+  cache.record("baz", 3, CacheType::Standalone);
+  cache.record("too long", 4, CacheType::Standalone);
+  EXPECT_FALSE(cache.find("foo", CacheType::Standalone).has_value());
+  EXPECT_TRUE(cache.find("bar", CacheType::Standalone).has_value());
+  EXPECT_TRUE(cache.find("baz", CacheType::Standalone).has_value());
+  EXPECT_FALSE(cache.find("too long", CacheType::Standalone).has_value());
+}
+
+TEST(cache_options_maximum_entries) {
+  sourcemeta::jsonbinpack::Cache cache{{.maximum_entries = 2}};
+  using CacheType = sourcemeta::jsonbinpack::Cache::Type;
+  cache.record("foo", 1, CacheType::Standalone);
+  cache.record("bar", 2, CacheType::Standalone);
+  cache.record("baz", 3, CacheType::Standalone);
+  EXPECT_FALSE(cache.find("foo", CacheType::Standalone).has_value());
+  EXPECT_TRUE(cache.find("bar", CacheType::Standalone).has_value());
+  EXPECT_TRUE(cache.find("baz", CacheType::Standalone).has_value());
+}
+
+TEST(cache_options_maximum_entries_reject) {
+  using Eviction = sourcemeta::jsonbinpack::CacheOptions::Eviction;
+  sourcemeta::jsonbinpack::Cache cache{
+      {.maximum_entries = 2, .eviction = Eviction::Reject}};
+  using CacheType = sourcemeta::jsonbinpack::Cache::Type;
+  cache.record("foo", 1, CacheType::Standalone);
+  cache.record("bar", 2, CacheType::Standalone);
+  cache.record("baz", 3, CacheType::Standalone);
+  // Existing entries can still be bumped
+  cache.record("foo", 4, CacheType::Standalone);
+  EXPECT_TRUE(cache.find("foo", CacheType::Standalone).has_value());
+  EXPECT_EQ(cache.find("foo", CacheType::Standalone).value(), 4);
+  EXPECT_TRUE(cache.find("bar", CacheType::Standalone).has_value());
+  EXPECT_FALSE(cache.find("baz", CacheType::Standalone).has_value());
+}
+
+TEST(cache_clear) {
+  sourcemeta::jsonbinpack::Cache cache;
+  using CacheType = sourcemeta::jsonbinpack::Cache::Type;
+  for (std::uint64_t index = 0; index < 1000; index++) {
+    cache.record("string-" + std::to_string(index), index,
+                 CacheType::Standalone);
+  }
+
+  cache.clear();
+  EXPECT_FALSE(cache.find("string-0", CacheType::Standalone).has_value());
+  EXPECT_FALSE(cache.find("string-999", CacheType::Standalone).has_value());
+
+  cache.record("foo", 1, CacheType::Standalone);
+  cache.record("string-5", 2, CacheType::Standalone);
+  EXPECT_EQ(cache.find("foo", CacheType::Standalone).value(), 1);
+  EXPECT_EQ(cache.find("string-5", CacheType::Standalone).value(), 2);
+  EXPECT_FALSE(cache.find("string-6", CacheType::Standalone).has_value());
+  cache.remove_oldest();
+  EXPECT_FALSE(cache.find("foo", CacheType::Standalone).has_value());
+}
+
+TEST(cache_arena_long_lived_string) {
+  const std::uint64_t budget{1048576};
+  sourcemeta::jsonbinpack::Cache cache{{.maximum_byte_size = budget}};
+  using CacheType = sourcemeta::jsonbinpack::Cache::Type;
+  std::uint64_t offset{0};
+  for (std::uint64_t index = 0; index < 100000; index++) {
+    // Keep bumping the first string, so that it is never evicted
+    cache.record("long-lived-string", offset++, CacheType::Standalone);
+    cache.record("short-lived-string-" + std::to_string(index), offset++,
+                 CacheType::Standalone);
+    EXPECT_TRUE(cache.arena_size() <= 2 * budget + 3 * 65536);
+  }
+
+  EXPECT_EQ(cache.find("long-lived-string", CacheType::Standalone).value(),
+            offset - 2);
+  EXPECT_TRUE(cache.find("short-lived-string-99999", CacheType::Standalone)
+                  .has_value());
+  EXPECT_FALSE(
+      cache.find("short-lived-string-0", CacheType::Standalone).has_value());
+}
+
+TEST(cache_arena_scattered_long_lived_strings) {
+  const std::uint64_t budget{65536};
+  sourcemeta::jsonbinpack::Cache cache{{.maximum_byte_size = budget}};
+  using CacheType = sourcemeta::jsonbinpack::Cache::Type;
+  std::uint64_t offset{0};
+  for (std::uint64_t index = 0; index < 50000; index++) {
+    cache.record("string-" + std::to_string(index), offset++,
+                 CacheType::Standalone);
+    // Every chunk ends up with a few strings that keep being bumped
+    for (std::uint64_t pinned = 0; pinned < index; pinned += 2000) {
+      cache.record("string-" + std::to_string(pinned), offset++,
+                   CacheType::Standalone);
+    }
+
+    EXPECT_TRUE(cache.arena_size() <= 2 * budget + 3 * 65536);
+  }
+
+  // Compacting the arena preserves the strings that remain
+  for (std::uint64_t pinned = 0; pinned < 50000; pinned += 2000) {
+    EXPECT_TRUE(cache.find("string-" + std::to_string(pinned),
+                           CacheType::Standalone)
+                    .has_value());
+  }
+
+  EXPECT_TRUE(cache.find("string-49999", CacheType::Standalone).has_value());
+  EXPECT_FALSE(cache.find("string-1", CacheType::Standalone).has_value());
+}
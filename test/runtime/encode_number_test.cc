@@ -161,3 +161,12 @@ TEST(DOUBLE_VARINT_TUPLE_31_point_4) {
             (std::vector<std::byte>{std::byte{0xf4}, std::byte{0x04},
                                     std::byte{0x01}}));
 }
+
+TEST(DOUBLE_VARINT_TUPLE_integer_5) {
+  const sourcemeta::core::JSON document{5};
+  sourcemeta::core::OutputByteStream stream{};
+  sourcemeta::jsonbinpack::Encoder encoder{stream};
+  encoder.DOUBLE_VARINT_TUPLE(document, {});
+  EXPECT_EQ(stream.bytes(),
+            (std::vector<std::byte>{std::byte{0x0a}, std::byte{0x00}}));
+}
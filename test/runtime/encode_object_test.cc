@@ -61,3 +61,102 @@ TEST(VARINT_TYPED_ARBITRARY_OBJECT__no_length_string__integer) {
                   std::byte{0x6f}, std::byte{0x6f}, std::byte{0x01}}));
   }
 }
+
+TEST(VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT__no_length_string__integer) {
+  using namespace sourcemeta::jsonbinpack;
+  const sourcemeta::core::JSON document =
+      sourcemeta::core::parse_json("{\"foo\":1,\"bar\":2}");
+  sourcemeta::core::OutputByteStream stream{};
+
+  Encoder encoder{stream};
+  encoder.VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT(
+      document, {std::make_shared<Encoding>(UTF8_STRING_NO_LENGTH{3}),
+                 std::make_shared<Encoding>(
+                     BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{0, 10, 1}),
+                 true});
+
+  // Deal with object property non-determinism
+  if (document.as_object().cbegin()->first == "foo") {
+    EXPECT_EQ(stream.bytes(),
+              (std::vector<std::byte>{
+                  std::byte{0x02}, std::byte{0x08}, std::byte{0x00},
+                  std::byte{0x00}, std::byte{0x00}, std::byte{0x66},
+                  std::byte{0x6f}, std::byte{0x6f}, std::byte{0x01},
+                  std::byte{0x62}, std::byte{0x61}, std::byte{0x72},
+                  std::byte{0x02}, std::byte{0x00}, std::byte{0x04}}));
+  } else {
+    EXPECT_EQ(stream.bytes(),
+              (std::vector<std::byte>{
+                  std::byte{0x02}, std::byte{0x08}, std::byte{0x00},
+                  std::byte{0x00}, std::byte{0x00}, std::byte{0x62},
+                  std::byte{0x61}, std::byte{0x72}, std::byte{0x02},
+                  std::byte{0x66}, std::byte{0x6f}, std::byte{0x6f},
+                  std::byte{0x01}, std::byte{0x00}, std::byte{0x04}}));
+  }
+}
+
+TEST(MIXED_BOUNDED_TYPED_OBJECT__required_and_optional) {
+  using namespace sourcemeta::jsonbinpack;
+  const sourcemeta::core::JSON document =
+      sourcemeta::core::parse_json("{\"tag\":\"bar\",\"id\":5}");
+  sourcemeta::core::OutputByteStream stream{};
+
+  Encoder encoder{stream};
+  encoder.MIXED_BOUNDED_TYPED_OBJECT(
+      document, {{"id"},
+                 {"name", "tag"},
+                 {BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{0, 10, 1},
+                  UTF8_STRING_NO_LENGTH{3}, UTF8_STRING_NO_LENGTH{3}}});
+  EXPECT_EQ(stream.bytes(),
+            (std::vector<std::byte>{std::byte{0x02}, std::byte{0x05},
+                                    std::byte{0x62}, std::byte{0x61},
+                                    std::byte{0x72}}));
+}
+
+TEST(MIXED_BOUNDED_TYPED_OBJECT__no_optional) {
+  using namespace sourcemeta::jsonbinpack;
+  const sourcemeta::core::JSON document =
+      sourcemeta::core::parse_json("{\"bar\":2,\"foo\":1}");
+  sourcemeta::core::OutputByteStream stream{};
+
+  Encoder encoder{stream};
+  encoder.MIXED_BOUNDED_TYPED_OBJECT(
+      document, {{"foo", "bar"},
+                 {},
+                 {BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{0, 10, 1},
+                  BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{0, 10, 1}}});
+  EXPECT_EQ(stream.bytes(),
+            (std::vector<std::byte>{std::byte{0x01}, std::byte{0x02}}));
+}
+
+TEST(MIXED_BOUNDED_TYPED_OBJECT__empty) {
+  using namespace sourcemeta::jsonbinpack;
+  const sourcemeta::core::JSON document =
+      sourcemeta::core::parse_json("{}");
+  sourcemeta::core::OutputByteStream stream{};
+
+  Encoder encoder{stream};
+  encoder.MIXED_BOUNDED_TYPED_OBJECT(
+      document, {{},
+                 {"foo"},
+                 {BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{0, 10, 1}}});
+  EXPECT_EQ(stream.bytes(), (std::vector<std::byte>{std::byte{0x00}}));
+}
+
+TEST(MIXED_BOUNDED_TYPED_OBJECT__multi_byte_bitmap) {
+  using namespace sourcemeta::jsonbinpack;
+  const sourcemeta::core::JSON document =
+      sourcemeta::core::parse_json("{\"a\":1,\"i\":9}");
+  sourcemeta::core::OutputByteStream stream{};
+
+  const Encoding value{BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{0, 10, 1}};
+  Encoder encoder{stream};
+  encoder.MIXED_BOUNDED_TYPED_OBJECT(
+      document,
+      {{},
+       {"a", "b", "c", "d", "e", "f", "g", "h", "i"},
+       {value, value, value, value, value, value, value, value, value}});
+  EXPECT_EQ(stream.bytes(),
+            (std::vector<std::byte>{std::byte{0x01}, std::byte{0x01},
+                                    std::byte{0x01}, std::byte{0x09}}));
+}
@@ -1,8 +1,9 @@
-#include <cstddef> // std::byte
+#include <cstddef> // std::byte, std::size_t
 #include <sourcemeta/core/io.h>
 #include <sourcemeta/core/json.h>
 #include <sourcemeta/core/test.h>
 #include <sourcemeta/jsonbinpack/runtime.h>
+#include <string> // std::string
 #include <vector> // std::vector
 
 TEST(UTF8_STRING_NO_LENGTH_foo_bar) {
@@ -40,6 +41,17 @@ TEST(FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED_foo_0_foo_3) {
                               std::byte{0x05}}));
 }
 
+TEST(FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED_empty_no_minimum_length) {
+  const sourcemeta::core::JSON document{""};
+  sourcemeta::core::OutputByteStream stream{};
+  sourcemeta::jsonbinpack::Encoder encoder{stream,
+                                           {.minimum_string_length = 0}};
+  encoder.FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED(document, {0});
+  encoder.FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED(document, {0});
+  EXPECT_EQ(stream.bytes(),
+            (std::vector<std::byte>{std::byte{0x01}, std::byte{0x01}}));
+}
+
 TEST(FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED_unicode_1) {
   const sourcemeta::core::JSON document{"foø"};
   sourcemeta::core::OutputByteStream stream{};
@@ -204,3 +216,76 @@ TEST(PREFIX_VARINT_LENGTH_STRING_SHARED_unicode) {
       (std::vector<std::byte>{std::byte{0x05}, std::byte{0x66}, std::byte{0x6f},
                               std::byte{0xc3}, std::byte{0xb8}}));
 }
+
+TEST(PREFIX_VARINT_LENGTH_STRING_SHARED_foo_foo_no_sharing) {
+  const sourcemeta::core::JSON document{"foo"};
+  sourcemeta::core::OutputByteStream stream{};
+  sourcemeta::jsonbinpack::Encoder encoder{stream, {.sharing = false}};
+  encoder.PREFIX_VARINT_LENGTH_STRING_SHARED(document, {});
+  encoder.PREFIX_VARINT_LENGTH_STRING_SHARED(document, {});
+  EXPECT_EQ(stream.bytes(),
+            (std::vector<std::byte>{std::byte{0x04}, std::byte{0x66},
+                                    std::byte{0x6f}, std::byte{0x6f},
+                                    std::byte{0x04}, std::byte{0x66},
+                                    std::byte{0x6f}, std::byte{0x6f}}));
+}
+
+TEST(GZIP_VARINT_PREFIX_UTF8_STRING_foo_foo_foo_foo) {
+  const sourcemeta::core::JSON document{"foo foo foo foo"};
+  sourcemeta::core::OutputByteStream stream{};
+  sourcemeta::jsonbinpack::Encoder encoder{stream};
+  encoder.GZIP_VARINT_PREFIX_UTF8_STRING(document, {});
+  EXPECT_EQ(
+      stream.bytes(),
+      (std::vector<std::byte>{std::byte{0x0f}, std::byte{0x26}, std::byte{0x1f},
+                              std::byte{0x8b}, std::byte{0x08}, std::byte{0x00},
+                              std::byte{0x00}, std::byte{0x00}, std::byte{0x00},
+                              std::byte{0x00}, std::byte{0x02}, std::byte{0xff},
+                              std::byte{0x01}, std::byte{0x0f}, std::byte{0x00},
+                              std::byte{0xf0}, std::byte{0xff}, std::byte{0x66},
+                              std::byte{0x6f}, std::byte{0x6f}, std::byte{0x20},
+                              std::byte{0x66}, std::byte{0x6f}, std::byte{0x6f},
+                              std::byte{0x20}, std::byte{0x66}, std::byte{0x6f},
+                              std::byte{0x6f}, std::byte{0x20}, std::byte{0x66},
+                              std::byte{0x6f}, std::byte{0x6f}, std::byte{0xde},
+                              std::byte{0x65}, std::byte{0x6b}, std::byte{0x67},
+                              std::byte{0x0f}, std::byte{0x00}, std::byte{0x00},
+                              std::byte{0x00}}));
+}
+
+TEST(GZIP_VARINT_PREFIX_UTF8_STRING_empty) {
+  const sourcemeta::core::JSON document{""};
+  sourcemeta::core::OutputByteStream stream{};
+  sourcemeta::jsonbinpack::Encoder encoder{stream};
+  encoder.GZIP_VARINT_PREFIX_UTF8_STRING(document, {});
+  EXPECT_EQ(
+      stream.bytes(),
+      (std::vector<std::byte>{std::byte{0x00}, std::byte{0x17}, std::byte{0x1f},
+                              std::byte{0x8b}, std::byte{0x08}, std::byte{0x00},
+                              std::byte{0x00}, std::byte{0x00}, std::byte{0x00},
+                              std::byte{0x00}, std::byte{0x02}, std::byte{0xff},
+                              std::byte{0x01}, std::byte{0x00}, std::byte{0x00},
+                              std::byte{0xff}, std::byte{0xff}, std::byte{0x00},
+                              std::byte{0x00}, std::byte{0x00}, std::byte{0x00},
+                              std::byte{0x00}, std::byte{0x00}, std::byte{0x00},
+                              std::byte{0x00}}));
+}
+
+TEST(GZIP_VARINT_PREFIX_UTF8_STRING_repetitive) {
+  std::string value;
+  for (std::size_t index = 0; index < 100; index++) {
+    value.append("at sourcemeta::jsonbinpack::Encoder::write\n");
+  }
+
+  const sourcemeta::core::JSON document{value};
+  sourcemeta::core::OutputByteStream stream{};
+  sourcemeta::jsonbinpack::Encoder encoder{stream};
+  encoder.GZIP_VARINT_PREFIX_UTF8_STRING(document, {});
+  const auto bytes{stream.bytes()};
+  EXPECT_TRUE(bytes.size() < value.size() / 10);
+  // The byte-length of the string as a varint
+  EXPECT_EQ(bytes[0], std::byte{0xcc});
+  EXPECT_EQ(bytes[1], std::byte{0x21});
+  // The byte-length of the compressed string as a varint
+  EXPECT_EQ(static_cast<std::size_t>(bytes[2]), bytes.size() - 3);
+}
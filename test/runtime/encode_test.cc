@@ -3,6 +3,7 @@
 #include <sourcemeta/core/json.h>
 #include <sourcemeta/core/test.h>
 #include <sourcemeta/jsonbinpack/runtime.h>
+#include <span>   // std::span
 #include <vector> // std::vector
 
 TEST(generic_encode_BOUNDED_MULTIPLE_8BITS_ENUM_FIXED) {
@@ -27,3 +28,94 @@ TEST(ANY_PACKED_TYPE_TAG_BYTE_PREFIX_many) {
             (std::vector<std::byte>{std::byte{0x15}, std::byte{0x1d},
                                     std::byte{0x25}}));
 }
+
+TEST(buffer_encode_ANY_PACKED_TYPE_TAG_BYTE_PREFIX_many) {
+  using namespace sourcemeta::jsonbinpack;
+  std::vector<std::byte> buffer;
+  Encoder encoder{buffer};
+  ANY_PACKED_TYPE_TAG_BYTE_PREFIX options;
+  encoder.write(sourcemeta::core::JSON{1}, options);
+  encoder.write(sourcemeta::core::JSON{2}, options);
+  encoder.write(sourcemeta::core::JSON{3}, options);
+  const std::vector<std::byte> expected{std::byte{0x15}, std::byte{0x1d},
+                                        std::byte{0x25}};
+  EXPECT_EQ(buffer, expected);
+  const auto bytes{encoder.bytes()};
+  EXPECT_EQ(std::vector<std::byte>(bytes.begin(), bytes.end()), expected);
+}
+
+TEST(buffer_encode_PREFIX_VARINT_LENGTH_STRING_SHARED_existing_contents) {
+  using namespace sourcemeta::jsonbinpack;
+  std::vector<std::byte> buffer{std::byte{0xff}, std::byte{0xff}};
+  Encoder encoder{buffer};
+  PREFIX_VARINT_LENGTH_STRING_SHARED options;
+  encoder.write(sourcemeta::core::JSON{"foo"}, options);
+  encoder.write(sourcemeta::core::JSON{"foo"}, options);
+  // The backreference offsets are relative to the start of the encoding
+  EXPECT_EQ(buffer, (std::vector<std::byte>{
+                        std::byte{0xff}, std::byte{0xff}, std::byte{0x04},
+                        std::byte{0x66}, std::byte{0x6f}, std::byte{0x6f},
+                        std::byte{0x00}, std::byte{0x05}}));
+  const auto bytes{encoder.bytes()};
+  EXPECT_EQ(bytes.size(), 6);
+  EXPECT_EQ(bytes.front(), std::byte{0x04});
+}
+
+TEST(span_encode_ANY_PACKED_TYPE_TAG_BYTE_PREFIX_many) {
+  using namespace sourcemeta::jsonbinpack;
+  std::vector<std::byte> buffer(8, std::byte{0x00});
+  Encoder encoder{std::span{buffer}};
+  ANY_PACKED_TYPE_TAG_BYTE_PREFIX options;
+  encoder.write(sourcemeta::core::JSON{1}, options);
+  encoder.write(sourcemeta::core::JSON{2}, options);
+  encoder.write(sourcemeta::core::JSON{3}, options);
+  const auto bytes{encoder.bytes()};
+  EXPECT_EQ(std::vector<std::byte>(bytes.begin(), bytes.end()),
+            (std::vector<std::byte>{std::byte{0x15}, std::byte{0x1d},
+                                    std::byte{0x25}}));
+}
+
+TEST(span_encode_overflow) {
+  using namespace sourcemeta::jsonbinpack;
+  std::vector<std::byte> buffer(2, std::byte{0x00});
+  Encoder encoder{std::span{buffer}};
+  UTF8_STRING_NO_LENGTH options{3};
+  bool thrown{false};
+  try {
+    encoder.write(sourcemeta::core::JSON{"foo"}, options);
+  } catch (const sourcemeta::core::IOStreamWriteError &) {
+    thrown = true;
+  }
+
+  EXPECT_TRUE(thrown);
+}
+
+TEST(reset_PREFIX_VARINT_LENGTH_STRING_SHARED_forgets_strings) {
+  using namespace sourcemeta::jsonbinpack;
+  std::vector<std::byte> first;
+  std::vector<std::byte> second;
+  Encoder encoder{first};
+  PREFIX_VARINT_LENGTH_STRING_SHARED options;
+  encoder.write(sourcemeta::core::JSON{"foo"}, options);
+  encoder.reset(second);
+  encoder.write(sourcemeta::core::JSON{"foo"}, options);
+  encoder.write(sourcemeta::core::JSON{"foo"}, options);
+  EXPECT_EQ(first, (std::vector<std::byte>{std::byte{0x04}, std::byte{0x66},
+                                           std::byte{0x6f}, std::byte{0x6f}}));
+  EXPECT_EQ(second, (std::vector<std::byte>{
+                        std::byte{0x04}, std::byte{0x66}, std::byte{0x6f},
+                        std::byte{0x6f}, std::byte{0x00}, std::byte{0x05}}));
+}
+
+TEST(reset_stream_to_span) {
+  using namespace sourcemeta::jsonbinpack;
+  sourcemeta::core::OutputByteStream stream{};
+  std::vector<std::byte> buffer(1, std::byte{0x00});
+  Encoder encoder{stream};
+  ANY_PACKED_TYPE_TAG_BYTE_PREFIX options;
+  encoder.write(sourcemeta::core::JSON{1}, options);
+  encoder.reset(std::span{buffer});
+  encoder.write(sourcemeta::core::JSON{2}, options);
+  EXPECT_EQ(stream.bytes(), (std::vector<std::byte>{std::byte{0x15}}));
+  EXPECT_EQ(buffer, (std::vector<std::byte>{std::byte{0x1d}}));
+}
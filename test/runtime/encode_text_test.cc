@@ -0,0 +1,158 @@
+#include <sourcemeta/core/json.h>
+#include <sourcemeta/core/test.h>
+#include <sourcemeta/jsonbinpack/runtime.h>
+
+#include <cstddef>     // std::byte, std::size_t
+#include <cstdint>     // std::uint64_t
+#include <span>        // std::span
+#include <string>      // std::string, std::to_string
+#include <string_view> // std::string_view
+#include <vector>      // std::vector
+
+// Transcoding the text must result in the same bytes as parsing and
+// then encoding it, and decode back to the same document
+static auto expect_transcode(const std::string_view text) -> void {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding encoding{ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  const auto document{sourcemeta::core::parse_json(text)};
+
+  std::vector<std::byte> expected;
+  Encoder parsed{expected};
+  parsed.write(document, encoding);
+
+  std::vector<std::byte> result;
+  Encoder transcoded{result};
+  transcoded.transcode(text);
+  EXPECT_EQ(result, expected);
+
+  Decoder decoder{std::span<const std::byte>{result}};
+  EXPECT_EQ(decoder.read(encoding), document);
+}
+
+static auto expect_parse_error(const std::string_view text,
+                               const std::uint64_t line,
+                               const std::uint64_t column) -> void {
+  std::vector<std::byte> result;
+  sourcemeta::jsonbinpack::Encoder encoder{result};
+  bool thrown{false};
+  try {
+    encoder.transcode(text);
+  } catch (const sourcemeta::core::JSONParseError &error) {
+    EXPECT_EQ(error.line(), line);
+    EXPECT_EQ(error.column(), column);
+    thrown = true;
+  }
+
+  EXPECT_TRUE(thrown);
+  // Invalid text is rejected before encoding any of it
+  EXPECT_TRUE(result.empty());
+}
+
+TEST(transcode_scalars) {
+  expect_transcode("null");
+  expect_transcode("true");
+  expect_transcode(" false ");
+  expect_transcode("0");
+  expect_transcode("-0");
+  expect_transcode("30");
+  expect_transcode("-31");
+  expect_transcode("255");
+  expect_transcode("-25200");
+  expect_transcode("9223372036854775807");
+  expect_transcode("-9223372036854775808");
+  expect_transcode("3.14");
+  expect_transcode("5.0");
+  expect_transcode("0.5");
+  expect_transcode("-0.001");
+  expect_transcode("0.0");
+  expect_transcode("1234.5");
+}
+
+TEST(transcode_strings) {
+  expect_transcode("\"\"");
+  expect_transcode("\"foo\"");
+  expect_transcode("\"foo \\\"bar\\\" \\u00e9 \\ud83d\\ude00\"");
+  expect_transcode("\"" + std::string(31, 'x') + "\"");
+  expect_transcode("\"" + std::string(100, 'x') + "\"");
+  expect_transcode("\"" + std::string(3000, 'x') + "\"");
+}
+
+TEST(transcode_shared_strings) {
+  expect_transcode("[ \"foo bar\", \"foo bar\", { \"foo bar\": \"foo bar\" }, "
+                   "{ \"foo bar\": 1 } ]");
+}
+
+TEST(transcode_containers) {
+  expect_transcode("[]");
+  expect_transcode("{}");
+  expect_transcode("[ [], {}, [ [ 1 ] ], { \"a\": { \"b\": [ null ] } } ]");
+  expect_transcode("{\n  \"foo\": [ 1, 2.5, \"bar\" ],\n  \"baz\": {}\n}");
+}
+
+TEST(transcode_large_containers) {
+  std::string array{"["};
+  std::string object{"{"};
+  for (std::size_t index = 0; index < 100; index++) {
+    if (index > 0) {
+      array += ",";
+      object += ",";
+    }
+
+    array += std::to_string(index * 1000);
+    object += "\"key" + std::to_string(index) + "\":[" +
+              std::to_string(index) + "]";
+  }
+
+  array += "]";
+  object += "}";
+  expect_transcode(array);
+  expect_transcode(object);
+  expect_transcode("[" + array + "," + object + "]");
+}
+
+TEST(transcode_many_documents) {
+  using namespace sourcemeta::jsonbinpack;
+  std::vector<std::byte> result;
+  Encoder encoder{result};
+  encoder.transcode("{ \"name\": \"foo bar\" }");
+  encoder.transcode("{ \"name\": \"foo bar\" }");
+
+  Decoder decoder{std::span<const std::byte>{result}};
+  const Encoding encoding{ANY_PACKED_TYPE_TAG_BYTE_PREFIX{}};
+  const auto expected{
+      sourcemeta::core::parse_json("{ \"name\": \"foo bar\" }")};
+  EXPECT_EQ(decoder.read(encoding), expected);
+  EXPECT_EQ(decoder.read(encoding), expected);
+}
+
+TEST(transcode_invalid) {
+  expect_parse_error("", 1, 1);
+  expect_parse_error("[ 1, 2", 1, 7);
+  expect_parse_error("[ 1, 2 }", 1, 8);
+  expect_parse_error("{ \"foo\" 1 }", 1, 9);
+  expect_parse_error("{ 1: 2 }", 1, 3);
+  expect_parse_error("[ 1, ]", 1, 6);
+  expect_parse_error("[ tru ]", 1, 3);
+  expect_parse_error("1 2", 1, 3);
+  expect_parse_error("\"foo", 1, 5);
+  expect_parse_error("[\n  1,\n  01\n]", 3, 3);
+  expect_parse_error("[ 1.5.5 ]", 1, 3);
+  expect_parse_error("[ 01.5 ]", 1, 3);
+  expect_parse_error("[ 1. ]", 1, 3);
+  expect_parse_error("[ \"\\x\" ]", 1, 3);
+  expect_parse_error("[ 1, - ]", 1, 6);
+  expect_parse_error("[ 1, 1e ]", 1, 6);
+  expect_parse_error("[ 1, 1e+ ]", 1, 6);
+  expect_parse_error("[ 1, -01 ]", 1, 6);
+  expect_parse_error("[ 1, 1-2 ]", 1, 6);
+  expect_parse_error("[ \"foo\", \"\\u12\" ]", 1, 10);
+  expect_parse_error("[ \"foo\", \"\\ud800\" ]", 1, 10);
+  expect_parse_error("[ \"foo\", \"\\udc00\" ]", 1, 10);
+  expect_parse_error("[ \"foo\", \"\\ud800\\u0041\" ]", 1, 10);
+}
+
+TEST(transcode_valid_tokens) {
+  expect_transcode("[ \"\\\"\\\\\\/\\b\\f\\n\\r\\t\" ]");
+  expect_transcode("[ \"\\u0041\\u00e9\\uD83D\\uDE00\" ]");
+  expect_transcode("[ -0, 0, 0.5, -10, 120.25 ]");
+}
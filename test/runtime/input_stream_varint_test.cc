@@ -1,4 +1,8 @@
-#include <limits> // std::numeric_limits
+#include <cstddef> // std::byte
+#include <cstdint> // std::uint64_t
+#include <limits>  // std::numeric_limits
+#include <span>    // std::span
+#include <vector>  // std::vector
 #include <sourcemeta/core/io.h>
 #include <sourcemeta/core/test.h>
 #include <sourcemeta/jsonbinpack/runtime_input_stream.h>
@@ -45,3 +49,95 @@ TEST(varint_uint64_max) {
   const std::uint64_t expected{18446744073709551615U};
   EXPECT_EQ(result, expected);
 }
+
+TEST(varint_span_0xac_0x02) {
+  const std::vector<std::byte> buffer{std::byte{0xac}, std::byte{0x02}};
+  sourcemeta::jsonbinpack::InputStream decoder{std::span{buffer}};
+  EXPECT_EQ(decoder.get_varint(), 300);
+  EXPECT_EQ(decoder.position(), 2);
+  EXPECT_FALSE(decoder.has_more_data());
+}
+
+TEST(varint_span_uint64_max) {
+  const std::vector<std::byte> buffer{
+      std::byte{0xff}, std::byte{0xff}, std::byte{0xff}, std::byte{0xff},
+      std::byte{0xff}, std::byte{0xff}, std::byte{0xff}, std::byte{0xff},
+      std::byte{0xff}, std::byte{0x01}};
+  sourcemeta::jsonbinpack::InputStream decoder{std::span{buffer}};
+  const std::uint64_t result{decoder.get_varint()};
+  const std::uint64_t expected{18446744073709551615U};
+  EXPECT_EQ(result, expected);
+}
+
+TEST(varint_span_truncated) {
+  const std::vector<std::byte> buffer{std::byte{0xff}, std::byte{0xff}};
+  sourcemeta::jsonbinpack::InputStream decoder{std::span{buffer}};
+  bool thrown{false};
+  try {
+    static_cast<void>(decoder.get_varint());
+  } catch (const sourcemeta::core::IOReadOutOfBoundsError &) {
+    thrown = true;
+  }
+
+  EXPECT_TRUE(thrown);
+}
+
+TEST(varint_span_many_padded) {
+  // Every varint here has at least 8 bytes of room after it
+  const std::vector<std::byte> buffer{
+      std::byte{0x01}, std::byte{0xac}, std::byte{0x02}, std::byte{0xdf},
+      std::byte{0x89}, std::byte{0x03}, std::byte{0xfe}, std::byte{0xff},
+      std::byte{0xff}, std::byte{0xff}, std::byte{0x0f}, std::byte{0x00},
+      std::byte{0x00}, std::byte{0x00}, std::byte{0x00}, std::byte{0x00},
+      std::byte{0x00}, std::byte{0x00}, std::byte{0x00}};
+  sourcemeta::jsonbinpack::InputStream decoder{std::span{buffer}};
+  EXPECT_EQ(decoder.get_varint(), 1);
+  EXPECT_EQ(decoder.position(), 1);
+  EXPECT_EQ(decoder.get_varint(), 300);
+  EXPECT_EQ(decoder.position(), 3);
+  EXPECT_EQ(decoder.get_varint(), 50399);
+  EXPECT_EQ(decoder.position(), 6);
+  EXPECT_EQ(decoder.get_varint(), 4294967294);
+  EXPECT_EQ(decoder.position(), 11);
+}
+
+TEST(varint_span_uint64_max_padded) {
+  const std::vector<std::byte> buffer{
+      std::byte{0xff}, std::byte{0xff}, std::byte{0xff}, std::byte{0xff},
+      std::byte{0xff}, std::byte{0xff}, std::byte{0xff}, std::byte{0xff},
+      std::byte{0xff}, std::byte{0x01}, std::byte{0x07}};
+  sourcemeta::jsonbinpack::InputStream decoder{std::span{buffer}};
+  const std::uint64_t expected{18446744073709551615U};
+  EXPECT_EQ(decoder.get_varint(), expected);
+  EXPECT_EQ(decoder.get_varint(), 7);
+  EXPECT_FALSE(decoder.has_more_data());
+}
+
+TEST(varint_span_8_bytes_padded) {
+  // (1)1111111 x 7 + (0)1111111 = 2^56 - 1
+  const std::vector<std::byte> buffer{
+      std::byte{0xff}, std::byte{0xff}, std::byte{0xff}, std::byte{0xff},
+      std::byte{0xff}, std::byte{0xff}, std::byte{0xff}, std::byte{0x7f},
+      std::byte{0x00}};
+  sourcemeta::jsonbinpack::InputStream decoder{std::span{buffer}};
+  EXPECT_EQ(decoder.get_varint(), 72057594037927935U);
+  EXPECT_EQ(decoder.position(), 8);
+}
+
+TEST(varints_span) {
+  const std::vector<std::byte> buffer{std::byte{0x01}, std::byte{0xac},
+                                      std::byte{0x02}, std::byte{0x17}};
+  sourcemeta::jsonbinpack::InputStream decoder{std::span{buffer}};
+  std::vector<std::uint64_t> result(3);
+  decoder.get_varints(result);
+  EXPECT_EQ(result, (std::vector<std::uint64_t>{1, 300, 23}));
+  EXPECT_FALSE(decoder.has_more_data());
+}
+
+TEST(varints_stream) {
+  sourcemeta::core::InputByteStream stream{0x01, 0xac, 0x02, 0x17};
+  sourcemeta::jsonbinpack::InputStream decoder{stream};
+  std::vector<std::uint64_t> result(3);
+  decoder.get_varints(result);
+  EXPECT_EQ(result, (std::vector<std::uint64_t>{1, 300, 23}));
+}
@@ -1,8 +1,11 @@
 #include <cstddef> // std::byte
+#include <cstdint> // std::uint64_t
 #include <limits>  // std::numeric_limits
 #include <sourcemeta/core/io.h>
 #include <sourcemeta/core/test.h>
+#include <sourcemeta/jsonbinpack/runtime_input_stream.h>
 #include <sourcemeta/jsonbinpack/runtime_output_stream.h>
+#include <span>   // std::span
 #include <vector> // std::vector
 
 TEST(varint_1) {
@@ -64,3 +67,76 @@ TEST(varint_uint64_max) {
                               std::byte{0xff}, std::byte{0xff}, std::byte{0xff},
                               std::byte{0x01}}));
 }
+
+TEST(varint_buffer_50399) {
+  std::vector<std::byte> buffer;
+  sourcemeta::jsonbinpack::OutputStream encoder{buffer};
+  encoder.put_varint(50399);
+  EXPECT_EQ(encoder.position(), 3);
+  EXPECT_EQ(buffer, (std::vector<std::byte>{std::byte{0xdf}, std::byte{0x89},
+                                            std::byte{0x03}}));
+}
+
+TEST(varint_span_50399) {
+  std::vector<std::byte> buffer(3, std::byte{0x00});
+  sourcemeta::jsonbinpack::OutputStream encoder{std::span{buffer}};
+  encoder.put_varint(50399);
+  EXPECT_EQ(encoder.position(), 3);
+  EXPECT_EQ(encoder.bytes().size(), 3);
+  EXPECT_EQ(buffer, (std::vector<std::byte>{std::byte{0xdf}, std::byte{0x89},
+                                            std::byte{0x03}}));
+}
+
+TEST(varint_span_overflow) {
+  std::vector<std::byte> buffer(2, std::byte{0x00});
+  sourcemeta::jsonbinpack::OutputStream encoder{std::span{buffer}};
+  bool thrown{false};
+  try {
+    encoder.put_varint(50399);
+  } catch (const sourcemeta::core::IOStreamWriteError &) {
+    thrown = true;
+  }
+
+  EXPECT_TRUE(thrown);
+}
+
+TEST(varint_2_56_minus_1) {
+  sourcemeta::core::OutputByteStream stream{};
+  sourcemeta::jsonbinpack::OutputStream encoder{stream};
+  encoder.put_varint(72057594037927935U);
+  const std::vector<std::byte> expected{
+      std::byte{0xff}, std::byte{0xff}, std::byte{0xff}, std::byte{0xff},
+      std::byte{0xff}, std::byte{0xff}, std::byte{0xff}, std::byte{0x7f}};
+  EXPECT_EQ(stream.bytes(), expected);
+}
+
+TEST(varint_2_56) {
+  sourcemeta::core::OutputByteStream stream{};
+  sourcemeta::jsonbinpack::OutputStream encoder{stream};
+  encoder.put_varint(72057594037927936U);
+  const std::vector<std::byte> expected{
+      std::byte{0x80}, std::byte{0x80}, std::byte{0x80}, std::byte{0x80},
+      std::byte{0x80}, std::byte{0x80}, std::byte{0x80}, std::byte{0x80},
+      std::byte{0x01}};
+  EXPECT_EQ(stream.bytes(), expected);
+}
+
+TEST(varint_round_trip_powers_of_two) {
+  std::vector<std::byte> buffer;
+  sourcemeta::jsonbinpack::OutputStream encoder{buffer};
+  for (std::uint64_t exponent = 0; exponent < 64; exponent++) {
+    const std::uint64_t value{std::uint64_t{1} << exponent};
+    encoder.put_varint(value - 1);
+    encoder.put_varint(value);
+  }
+
+  sourcemeta::jsonbinpack::InputStream decoder{
+      std::span<const std::byte>{buffer}};
+  for (std::uint64_t exponent = 0; exponent < 64; exponent++) {
+    const std::uint64_t value{std::uint64_t{1} << exponent};
+    EXPECT_EQ(decoder.get_varint(), value - 1);
+    EXPECT_EQ(decoder.get_varint(), value);
+  }
+
+  EXPECT_FALSE(decoder.has_more_data());
+}
@@ -0,0 +1,280 @@
+#include <sourcemeta/core/json.h>
+#include <sourcemeta/core/test.h>
+#include <sourcemeta/jsonbinpack/runtime.h>
+
+#include <cstddef> // std::byte
+#include <memory>  // std::make_shared
+#include <span>    // std::span
+#include <utility> // std::move
+#include <variant> // std::holds_alternative
+#include <vector>  // std::vector
+
+// Encoding and decoding with a plan must match the original encoding
+static auto expect_same_as_encoding(
+    const sourcemeta::jsonbinpack::Encoding &encoding,
+    const std::vector<sourcemeta::core::JSON> &documents) -> void {
+  using namespace sourcemeta::jsonbinpack;
+  const Plan plan{encoding};
+
+  std::vector<std::byte> expected;
+  Encoder expected_encoder{expected};
+  for (const auto &document : documents) {
+    expected_encoder.write(document, encoding);
+  }
+
+  std::vector<std::byte> result;
+  Encoder encoder{result};
+  for (const auto &document : documents) {
+    encoder.write(document, plan);
+  }
+
+  EXPECT_EQ(result, expected);
+
+  Decoder decoder{std::span<const std::byte>{result}};
+  for (const auto &document : documents) {
+    EXPECT_EQ(decoder.read(plan), document);
+  }
+}
+
+TEST(plan_BOUNDED_MULTIPLE_8BITS_ENUM_FIXED) {
+  using namespace sourcemeta::jsonbinpack;
+  expect_same_as_encoding(BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{-5, 5, 1},
+                          {sourcemeta::core::JSON{-5},
+                           sourcemeta::core::JSON{0},
+                           sourcemeta::core::JSON{5}});
+  expect_same_as_encoding(BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{-15, 15, 5},
+                          {sourcemeta::core::JSON{-15},
+                           sourcemeta::core::JSON{-5},
+                           sourcemeta::core::JSON{10}});
+}
+
+TEST(plan_FLOOR_MULTIPLE_ENUM_VARINT) {
+  using namespace sourcemeta::jsonbinpack;
+  expect_same_as_encoding(FLOOR_MULTIPLE_ENUM_VARINT{-3, 1},
+                          {sourcemeta::core::JSON{-3},
+                           sourcemeta::core::JSON{0},
+                           sourcemeta::core::JSON{1000}});
+  expect_same_as_encoding(FLOOR_MULTIPLE_ENUM_VARINT{2, 4},
+                          {sourcemeta::core::JSON{4},
+                           sourcemeta::core::JSON{400}});
+}
+
+TEST(plan_ROOF_MULTIPLE_MIRROR_ENUM_VARINT) {
+  using namespace sourcemeta::jsonbinpack;
+  expect_same_as_encoding(ROOF_MULTIPLE_MIRROR_ENUM_VARINT{8, 1},
+                          {sourcemeta::core::JSON{8},
+                           sourcemeta::core::JSON{-1},
+                           sourcemeta::core::JSON{-1000}});
+  expect_same_as_encoding(ROOF_MULTIPLE_MIRROR_ENUM_VARINT{16, 5},
+                          {sourcemeta::core::JSON{15},
+                           sourcemeta::core::JSON{5}});
+}
+
+TEST(plan_ARBITRARY_MULTIPLE_ZIGZAG_VARINT) {
+  using namespace sourcemeta::jsonbinpack;
+  expect_same_as_encoding(ARBITRARY_MULTIPLE_ZIGZAG_VARINT{1},
+                          {sourcemeta::core::JSON{-25200},
+                           sourcemeta::core::JSON{0},
+                           sourcemeta::core::JSON{25200}});
+  expect_same_as_encoding(ARBITRARY_MULTIPLE_ZIGZAG_VARINT{3},
+                          {sourcemeta::core::JSON{-3},
+                           sourcemeta::core::JSON{300}});
+}
+
+TEST(plan_PREFIX_VARINT_LENGTH_STRING_SHARED) {
+  using namespace sourcemeta::jsonbinpack;
+  expect_same_as_encoding(PREFIX_VARINT_LENGTH_STRING_SHARED{},
+                          {sourcemeta::core::JSON{"foo"},
+                           sourcemeta::core::JSON{"bar"},
+                           sourcemeta::core::JSON{"foo"}});
+}
+
+TEST(plan_GZIP_VARINT_PREFIX_UTF8_STRING) {
+  using namespace sourcemeta::jsonbinpack;
+  expect_same_as_encoding(GZIP_VARINT_PREFIX_UTF8_STRING{},
+                          {sourcemeta::core::JSON{"foo"},
+                           sourcemeta::core::JSON{""},
+                           sourcemeta::core::JSON{"foo"}});
+}
+
+TEST(plan_ANY_PACKED_TYPE_TAG_BYTE_PREFIX) {
+  using namespace sourcemeta::jsonbinpack;
+  expect_same_as_encoding(
+      ANY_PACKED_TYPE_TAG_BYTE_PREFIX{},
+      {sourcemeta::core::parse_json("{ \"foo\": [ 1, true, null ] }"),
+       sourcemeta::core::JSON{3.14}});
+}
+
+TEST(plan_FIXED_TYPED_ARRAY_prefix_encodings) {
+  using namespace sourcemeta::jsonbinpack;
+  std::vector<sourcemeta::core::JSON> choices;
+  choices.emplace_back(false);
+  choices.emplace_back(true);
+  std::vector<Encoding> prefix_encodings;
+  prefix_encodings.emplace_back(BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{0, 10, 1});
+  prefix_encodings.emplace_back(BYTE_CHOICE_INDEX{std::move(choices)});
+  expect_same_as_encoding(
+      FIXED_TYPED_ARRAY{
+          3, std::make_shared<Encoding>(PREFIX_VARINT_LENGTH_STRING_SHARED{}),
+          std::move(prefix_encodings)},
+      {sourcemeta::core::parse_json("[ 7, true, \"foo\" ]"),
+       sourcemeta::core::parse_json("[ 0, false, \"foo\" ]")});
+}
+
+TEST(plan_BOUNDED_8BITS_TYPED_ARRAY) {
+  using namespace sourcemeta::jsonbinpack;
+  expect_same_as_encoding(
+      BOUNDED_8BITS_TYPED_ARRAY{
+          1, 3,
+          std::make_shared<Encoding>(FLOOR_MULTIPLE_ENUM_VARINT{0, 1}),
+          {}},
+      {sourcemeta::core::parse_json("[ 1 ]"),
+       sourcemeta::core::parse_json("[ 1, 2, 3 ]")});
+}
+
+TEST(plan_FLOOR_TYPED_ARRAY_nested) {
+  using namespace sourcemeta::jsonbinpack;
+  std::vector<Encoding> prefix_encodings;
+  prefix_encodings.emplace_back(ARBITRARY_MULTIPLE_ZIGZAG_VARINT{1});
+  const auto inner{std::make_shared<Encoding>(FLOOR_TYPED_ARRAY{
+      0, std::make_shared<Encoding>(PREFIX_VARINT_LENGTH_STRING_SHARED{}),
+      std::move(prefix_encodings)})};
+  expect_same_as_encoding(
+      FLOOR_TYPED_ARRAY{1, inner, {}},
+      {sourcemeta::core::parse_json("[ [ -1, \"foo\" ], [ 2 ], [ 3 ] ]"),
+       sourcemeta::core::parse_json("[ [ 5, \"foo\", \"bar\", \"foo\" ] ]")});
+}
+
+// Unless `minItems` says otherwise, arrays may end before their
+// `prefixItems` do
+TEST(plan_FLOOR_TYPED_ARRAY_shorter_than_prefix_encodings) {
+  using namespace sourcemeta::jsonbinpack;
+  std::vector<Encoding> prefix_encodings;
+  prefix_encodings.emplace_back(ARBITRARY_MULTIPLE_ZIGZAG_VARINT{1});
+  prefix_encodings.emplace_back(PREFIX_VARINT_LENGTH_STRING_SHARED{});
+  expect_same_as_encoding(
+      FLOOR_TYPED_ARRAY{
+          0, std::make_shared<Encoding>(FLOOR_MULTIPLE_ENUM_VARINT{0, 1}),
+          std::move(prefix_encodings)},
+      {sourcemeta::core::parse_json("[]"),
+       sourcemeta::core::parse_json("[ -1 ]"),
+       sourcemeta::core::parse_json("[ -1, \"foo\", 3 ]")});
+}
+
+TEST(plan_BOUNDED_8BITS_TYPED_ARRAY_shorter_than_prefix_encodings) {
+  using namespace sourcemeta::jsonbinpack;
+  std::vector<Encoding> prefix_encodings;
+  prefix_encodings.emplace_back(ARBITRARY_MULTIPLE_ZIGZAG_VARINT{1});
+  prefix_encodings.emplace_back(PREFIX_VARINT_LENGTH_STRING_SHARED{});
+  expect_same_as_encoding(
+      BOUNDED_8BITS_TYPED_ARRAY{
+          0, 3, std::make_shared<Encoding>(FLOOR_MULTIPLE_ENUM_VARINT{0, 1}),
+          std::move(prefix_encodings)},
+      {sourcemeta::core::parse_json("[]"),
+       sourcemeta::core::parse_json("[ 5 ]")});
+}
+
+TEST(plan_ROOF_TYPED_ARRAY) {
+  using namespace sourcemeta::jsonbinpack;
+  expect_same_as_encoding(
+      ROOF_TYPED_ARRAY{
+          4,
+          std::make_shared<Encoding>(ROOF_MULTIPLE_MIRROR_ENUM_VARINT{10, 1}),
+          {}},
+      {sourcemeta::core::parse_json("[]"),
+       sourcemeta::core::parse_json("[ 10, 9, -5, 0 ]")});
+}
+
+TEST(plan_FIXED_TYPED_ARBITRARY_OBJECT) {
+  using namespace sourcemeta::jsonbinpack;
+  expect_same_as_encoding(
+      FIXED_TYPED_ARBITRARY_OBJECT{
+          2, std::make_shared<Encoding>(PREFIX_VARINT_LENGTH_STRING_SHARED{}),
+          std::make_shared<Encoding>(BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{0, 255,
+                                                                       1})},
+      {sourcemeta::core::parse_json("{ \"foo\": 1, \"bar\": 2 }")});
+}
+
+TEST(plan_VARINT_TYPED_ARBITRARY_OBJECT_nested) {
+  using namespace sourcemeta::jsonbinpack;
+  const auto values{std::make_shared<Encoding>(FLOOR_TYPED_ARRAY{
+      0, std::make_shared<Encoding>(FLOOR_MULTIPLE_ENUM_VARINT{0, 1}), {}})};
+  expect_same_as_encoding(
+      VARINT_TYPED_ARBITRARY_OBJECT{
+          std::make_shared<Encoding>(PREFIX_VARINT_LENGTH_STRING_SHARED{}),
+          values},
+      {sourcemeta::core::parse_json("{}"),
+       sourcemeta::core::parse_json("{ \"foo\": [ 1, 2 ], \"bar\": [] }")});
+}
+
+TEST(plan_FLOOR_TYPED_LENGTH_PREFIX_ARRAY_nested) {
+  using namespace sourcemeta::jsonbinpack;
+  std::vector<Encoding> prefix_encodings;
+  prefix_encodings.emplace_back(ARBITRARY_MULTIPLE_ZIGZAG_VARINT{1});
+  const auto inner{std::make_shared<Encoding>(FLOOR_TYPED_LENGTH_PREFIX_ARRAY{
+      0, std::make_shared<Encoding>(PREFIX_VARINT_LENGTH_STRING_SHARED{}),
+      std::move(prefix_encodings), true})};
+  expect_same_as_encoding(
+      FLOOR_TYPED_LENGTH_PREFIX_ARRAY{1, inner, {}, false},
+      {sourcemeta::core::parse_json("[ [ -1, \"foo\" ], [ 2 ], [ 3 ] ]"),
+       sourcemeta::core::parse_json("[ [ 5, \"foo\", \"bar\", \"foo\" ] ]")});
+}
+
+TEST(plan_FLOOR_TYPED_LENGTH_PREFIX_ARRAY_shorter_than_prefix_encodings) {
+  using namespace sourcemeta::jsonbinpack;
+  std::vector<Encoding> prefix_encodings;
+  prefix_encodings.emplace_back(ARBITRARY_MULTIPLE_ZIGZAG_VARINT{1});
+  prefix_encodings.emplace_back(PREFIX_VARINT_LENGTH_STRING_SHARED{});
+  expect_same_as_encoding(
+      FLOOR_TYPED_LENGTH_PREFIX_ARRAY{
+          0, std::make_shared<Encoding>(FLOOR_MULTIPLE_ENUM_VARINT{0, 1}),
+          std::move(prefix_encodings), true},
+      {sourcemeta::core::parse_json("[]"),
+       sourcemeta::core::parse_json("[ -1 ]")});
+}
+
+TEST(plan_VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT_nested) {
+  using namespace sourcemeta::jsonbinpack;
+  const auto values{std::make_shared<Encoding>(FLOOR_TYPED_ARRAY{
+      0, std::make_shared<Encoding>(FLOOR_MULTIPLE_ENUM_VARINT{0, 1}), {}})};
+  expect_same_as_encoding(
+      VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT{
+          std::make_shared<Encoding>(PREFIX_VARINT_LENGTH_STRING_SHARED{}),
+          values, true},
+      {sourcemeta::core::parse_json("{}"),
+       sourcemeta::core::parse_json("{ \"foo\": [ 1, 2 ], \"bar\": [] }")});
+}
+
+TEST(plan_MIXED_BOUNDED_TYPED_OBJECT_nested) {
+  using namespace sourcemeta::jsonbinpack;
+  const Encoding inner{MIXED_BOUNDED_TYPED_OBJECT{
+      {"x"},
+      {"y"},
+      {FLOOR_MULTIPLE_ENUM_VARINT{0, 1}, ARBITRARY_MULTIPLE_ZIGZAG_VARINT{1}}}};
+  expect_same_as_encoding(
+      MIXED_BOUNDED_TYPED_OBJECT{
+          {"id", "point"},
+          {"name"},
+          {BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{0, 255, 1}, inner,
+           PREFIX_VARINT_LENGTH_STRING_SHARED{}}},
+      {sourcemeta::core::parse_json("{ \"id\": 1, \"point\": { \"x\": 2 } }"),
+       sourcemeta::core::parse_json("{ \"name\": \"foo\", \"id\": 3, "
+                                    "\"point\": { \"y\": -4, \"x\": 5 } }")});
+}
+
+TEST(plan_moved) {
+  using namespace sourcemeta::jsonbinpack;
+  Plan original{FLOOR_TYPED_ARRAY{
+      0, std::make_shared<Encoding>(FLOOR_MULTIPLE_ENUM_VARINT{0, 1}), {}}};
+  const Plan plan{std::move(original)};
+  EXPECT_TRUE(std::holds_alternative<FLOOR_TYPED_ARRAY>(plan.encoding()));
+  const auto document{sourcemeta::core::parse_json("[ 1, 2, 3 ]")};
+  std::vector<std::byte> buffer;
+  Encoder encoder{buffer};
+  encoder.write(document, plan);
+  EXPECT_EQ(buffer, (std::vector<std::byte>{std::byte{0x03}, std::byte{0x01},
+                                            std::byte{0x02},
+                                            std::byte{0x03}}));
+  Decoder decoder{std::span<const std::byte>{buffer}};
+  EXPECT_EQ(decoder.read(plan), document);
+}
@@ -0,0 +1,377 @@
+#include <sourcemeta/core/io.h>
+#include <sourcemeta/core/json.h>
+#include <sourcemeta/core/test.h>
+#include <sourcemeta/jsonbinpack/runtime.h>
+
+#include <cstddef> // std::byte, std::size_t, std::ptrdiff_t
+#include <cstdint> // std::uint8_t
+#include <set>     // std::set
+#include <span>    // std::span
+#include <sstream> // std::ostringstream
+#include <variant> // std::get, std::variant_size_v
+#include <vector>  // std::vector
+
+static auto round_trip(const sourcemeta::jsonbinpack::Encoding &encoding)
+    -> sourcemeta::jsonbinpack::Encoding {
+  std::vector<std::byte> bytes;
+  sourcemeta::jsonbinpack::save(encoding, bytes);
+  auto result{sourcemeta::jsonbinpack::load(std::span<const std::byte>{bytes})};
+  EXPECT_EQ(result.index(), encoding.index());
+  // Saving is deterministic, so the same bytes mean the same options
+  std::vector<std::byte> other;
+  sourcemeta::jsonbinpack::save(result, other);
+  EXPECT_TRUE(bytes == other);
+  return result;
+}
+
+// An instance of every encoding, some of them nested into others
+static const char *const ENCODINGS[]{
+    R"JSON({ "binpackEncoding": "BOUNDED_MULTIPLE_8BITS_ENUM_FIXED",
+      "binpackOptions": {
+        "minimum": -5, "maximum": 250, "multiplier": 5 } })JSON",
+    R"JSON({ "binpackEncoding": "FLOOR_MULTIPLE_ENUM_VARINT",
+      "binpackOptions": { "minimum": -100, "multiplier": 3 } })JSON",
+    R"JSON({ "binpackEncoding": "ROOF_MULTIPLE_MIRROR_ENUM_VARINT",
+      "binpackOptions": { "maximum": 1000000, "multiplier": 1 } })JSON",
+    R"JSON({ "binpackEncoding": "ARBITRARY_MULTIPLE_ZIGZAG_VARINT",
+      "binpackOptions": { "multiplier": 7 } })JSON",
+    R"JSON({ "binpackEncoding": "DOUBLE_VARINT_TUPLE",
+      "binpackOptions": {} })JSON",
+    R"JSON({ "binpackEncoding": "BYTE_CHOICE_INDEX",
+      "binpackOptions": {
+        "choices": [ "foo", 1, { "bar": [ null ] } ] } })JSON",
+    R"JSON({ "binpackEncoding": "LARGE_CHOICE_INDEX",
+      "binpackOptions": { "choices": [ true, false, 1.5, "baz" ] } })JSON",
+    R"JSON({ "binpackEncoding": "TOP_LEVEL_BYTE_CHOICE_INDEX",
+      "binpackOptions": { "choices": [ "a", "b", "a" ] } })JSON",
+    R"JSON({ "binpackEncoding": "CONST_NONE",
+      "binpackOptions": { "value": { "foo": [ 1, "two", 3.5 ] } } })JSON",
+    R"JSON({ "binpackEncoding": "ANY_PACKED_TYPE_TAG_BYTE_PREFIX",
+      "binpackOptions": {} })JSON",
+    R"JSON({ "binpackEncoding": "UTF8_STRING_NO_LENGTH",
+      "binpackOptions": { "size": 36 } })JSON",
+    R"JSON({ "binpackEncoding": "FLOOR_VARINT_PREFIX_UTF8_STRING_SHARED",
+      "binpackOptions": { "minimum": 3 } })JSON",
+    R"JSON({ "binpackEncoding": "ROOF_VARINT_PREFIX_UTF8_STRING_SHARED",
+      "binpackOptions": { "maximum": 300 } })JSON",
+    R"JSON({ "binpackEncoding": "BOUNDED_8BIT_PREFIX_UTF8_STRING_SHARED",
+      "binpackOptions": { "minimum": 1, "maximum": 64 } })JSON",
+    R"JSON({ "binpackEncoding": "RFC3339_DATE_INTEGER_TRIPLET",
+      "binpackOptions": {} })JSON",
+    R"JSON({ "binpackEncoding": "PREFIX_VARINT_LENGTH_STRING_SHARED",
+      "binpackOptions": {} })JSON",
+    R"JSON({ "binpackEncoding": "FIXED_TYPED_ARRAY",
+      "binpackOptions": {
+        "size": 3,
+        "encoding": { "binpackEncoding": "DOUBLE_VARINT_TUPLE",
+                      "binpackOptions": {} },
+        "prefixEncodings": [
+          { "binpackEncoding": "BYTE_CHOICE_INDEX",
+            "binpackOptions": { "choices": [ "x", "y" ] } }
+        ] } })JSON",
+    R"JSON({ "binpackEncoding": "BOUNDED_8BITS_TYPED_ARRAY",
+      "binpackOptions": {
+        "minimum": 1, "maximum": 4,
+        "encoding": { "binpackEncoding": "ARBITRARY_MULTIPLE_ZIGZAG_VARINT",
+                      "binpackOptions": { "multiplier": 1 } },
+        "prefixEncodings": [] } })JSON",
+    R"JSON({ "binpackEncoding": "FLOOR_TYPED_ARRAY",
+      "binpackOptions": {
+        "minimum": 2,
+        "encoding": { "binpackEncoding": "PREFIX_VARINT_LENGTH_STRING_SHARED",
+                      "binpackOptions": {} },
+        "prefixEncodings": [
+          { "binpackEncoding": "CONST_NONE",
+            "binpackOptions": { "value": 42 } },
+          { "binpackEncoding": "RFC3339_DATE_INTEGER_TRIPLET",
+            "binpackOptions": {} }
+        ] } })JSON",
+    R"JSON({ "binpackEncoding": "ROOF_TYPED_ARRAY",
+      "binpackOptions": {
+        "maximum": 10,
+        "encoding": { "binpackEncoding": "ANY_PACKED_TYPE_TAG_BYTE_PREFIX",
+                      "binpackOptions": {} },
+        "prefixEncodings": [] } })JSON",
+    R"JSON({ "binpackEncoding": "FIXED_TYPED_ARBITRARY_OBJECT",
+      "binpackOptions": {
+        "size": 2,
+        "keyEncoding": { "binpackEncoding": "UTF8_STRING_NO_LENGTH",
+                         "binpackOptions": { "size": 3 } },
+        "encoding": { "binpackEncoding": "ARBITRARY_MULTIPLE_ZIGZAG_VARINT",
+                      "binpackOptions": { "multiplier": 1 } } } })JSON",
+    R"JSON({ "binpackEncoding": "VARINT_TYPED_ARBITRARY_OBJECT",
+      "binpackOptions": {
+        "keyEncoding": {
+          "binpackEncoding": "PREFIX_VARINT_LENGTH_STRING_SHARED",
+          "binpackOptions": {} },
+        "encoding": { "binpackEncoding": "ANY_PACKED_TYPE_TAG_BYTE_PREFIX",
+                      "binpackOptions": {} } } })JSON",
+    R"JSON({ "binpackEncoding": "FLOOR_TYPED_LENGTH_PREFIX_ARRAY",
+      "binpackOptions": {
+        "minimum": 0,
+        "offsets": true,
+        "encoding": { "binpackEncoding": "GZIP_VARINT_PREFIX_UTF8_STRING",
+                      "binpackOptions": {} },
+        "prefixEncodings": [] } })JSON",
+    R"JSON({ "binpackEncoding": "VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT",
+      "binpackOptions": {
+        "offsets": true,
+        "keyEncoding": {
+          "binpackEncoding": "PREFIX_VARINT_LENGTH_STRING_SHARED",
+          "binpackOptions": {} },
+        "encoding": { "binpackEncoding": "ANY_PACKED_TYPE_TAG_BYTE_PREFIX",
+                      "binpackOptions": {} } } })JSON",
+    R"JSON({ "binpackEncoding": "GZIP_VARINT_PREFIX_UTF8_STRING",
+      "binpackOptions": {} })JSON",
+    R"JSON({ "binpackEncoding": "MIXED_BOUNDED_TYPED_OBJECT",
+      "binpackOptions": {
+        "requiredProperties": [ "id" ],
+        "optionalProperties": [ "name", "tags" ],
+        "propertyEncodings": {
+          "id": { "binpackEncoding": "FLOOR_MULTIPLE_ENUM_VARINT",
+                  "binpackOptions": { "minimum": 0, "multiplier": 1 } },
+          "name": {
+            "binpackEncoding": "PREFIX_VARINT_LENGTH_STRING_SHARED",
+            "binpackOptions": {} },
+          "tags": {
+            "binpackEncoding": "FLOOR_TYPED_ARRAY",
+            "binpackOptions": {
+              "minimum": 0,
+              "encoding": {
+                "binpackEncoding": "PREFIX_VARINT_LENGTH_STRING_SHARED",
+                "binpackOptions": {} },
+              "prefixEncodings": [] } }
+        } } })JSON"};
+
+TEST(serializer_round_trip_every_encoding) {
+  std::set<std::size_t> indexes;
+  for (const auto *const source : ENCODINGS) {
+    const auto encoding{
+        sourcemeta::jsonbinpack::load(sourcemeta::core::parse_json(source))};
+    round_trip(encoding);
+    indexes.insert(encoding.index());
+  }
+
+  EXPECT_EQ(indexes.size(),
+            std::variant_size_v<sourcemeta::jsonbinpack::Encoding>);
+}
+
+TEST(serializer_round_trip_encodes_the_same) {
+  const auto encoding{sourcemeta::jsonbinpack::load(
+      sourcemeta::core::parse_json(ENCODINGS[25]))};
+  const auto result{round_trip(encoding)};
+  const auto document{sourcemeta::core::parse_json(R"JSON({
+    "id": 7, "tags": [ "foo", "bar" ]
+  })JSON")};
+
+  std::vector<std::byte> expected;
+  sourcemeta::jsonbinpack::Encoder encoder{expected};
+  encoder.write(document, encoding);
+  std::vector<std::byte> actual;
+  sourcemeta::jsonbinpack::Encoder other{actual};
+  other.write(document, result);
+  EXPECT_TRUE(expected == actual);
+
+  sourcemeta::jsonbinpack::Decoder decoder{
+      std::span<const std::byte>{actual}};
+  EXPECT_EQ(decoder.read(result), document);
+}
+
+TEST(serializer_round_trip_options) {
+  using namespace sourcemeta::jsonbinpack;
+  const auto result{round_trip(BOUNDED_MULTIPLE_8BITS_ENUM_FIXED{
+      .minimum = -5, .maximum = 250, .multiplier = 5})};
+  EXPECT_EQ(std::get<BOUNDED_MULTIPLE_8BITS_ENUM_FIXED>(result).minimum, -5);
+  EXPECT_EQ(std::get<BOUNDED_MULTIPLE_8BITS_ENUM_FIXED>(result).maximum, 250);
+  EXPECT_EQ(std::get<BOUNDED_MULTIPLE_8BITS_ENUM_FIXED>(result).multiplier, 5);
+
+  const auto choices{round_trip(sourcemeta::jsonbinpack::load(
+      sourcemeta::core::parse_json(ENCODINGS[7])))};
+  const auto &options{std::get<TOP_LEVEL_BYTE_CHOICE_INDEX>(choices)};
+  EXPECT_EQ(options.choices.size(), 3);
+  EXPECT_EQ(options.choices.at(1), sourcemeta::core::JSON{"b"});
+  // The choice index is rebuilt on load
+  EXPECT_EQ(options.index.size(), 2);
+}
+
+TEST(serializer_smaller_than_json) {
+  const auto source{sourcemeta::core::parse_json(ENCODINGS[25])};
+  std::vector<std::byte> bytes;
+  sourcemeta::jsonbinpack::save(sourcemeta::jsonbinpack::load(source), bytes);
+  std::ostringstream json;
+  sourcemeta::core::stringify(source, json);
+  EXPECT_TRUE(bytes.size() < json.str().size() / 4);
+}
+
+TEST(serializer_unsupported_version) {
+  std::vector<std::byte> bytes;
+  sourcemeta::jsonbinpack::save(
+      sourcemeta::jsonbinpack::DOUBLE_VARINT_TUPLE{}, bytes);
+  bytes.front() = std::byte{0xff};
+  bool thrown{false};
+  try {
+    sourcemeta::jsonbinpack::load(std::span<const std::byte>{bytes});
+  } catch (const sourcemeta::jsonbinpack::EncodingError &) {
+    thrown = true;
+  }
+
+  EXPECT_TRUE(thrown);
+}
+
+TEST(serializer_unknown_encoding) {
+  const std::vector<std::byte> bytes{std::byte{0x01}, std::byte{0x7f}};
+  bool thrown{false};
+  try {
+    sourcemeta::jsonbinpack::load(std::span<const std::byte>{bytes});
+  } catch (const sourcemeta::jsonbinpack::EncodingError &) {
+    thrown = true;
+  }
+
+  EXPECT_TRUE(thrown);
+}
+
+TEST(serializer_trailing_bytes) {
+  std::vector<std::byte> bytes;
+  sourcemeta::jsonbinpack::save(
+      sourcemeta::jsonbinpack::DOUBLE_VARINT_TUPLE{}, bytes);
+  bytes.push_back(std::byte{0x00});
+  bool thrown{false};
+  try {
+    sourcemeta::jsonbinpack::load(std::span<const std::byte>{bytes});
+  } catch (const sourcemeta::jsonbinpack::EncodingError &) {
+    thrown = true;
+  }
+
+  EXPECT_TRUE(thrown);
+}
+
+TEST(serializer_truncated) {
+  std::vector<std::byte> bytes;
+  sourcemeta::jsonbinpack::save(
+      sourcemeta::jsonbinpack::load(
+          sourcemeta::core::parse_json(ENCODINGS[25])),
+      bytes);
+  bytes.resize(bytes.size() / 2);
+  bool thrown{false};
+  try {
+    sourcemeta::jsonbinpack::load(std::span<const std::byte>{bytes});
+  } catch (const sourcemeta::core::IOReadOutOfBoundsError &) {
+    thrown = true;
+  }
+
+  EXPECT_TRUE(thrown);
+}
+
+// Malformed input must throw, no matter how far it gets
+static auto expect_malformed(const std::vector<std::byte> &bytes) -> void {
+  bool thrown{false};
+  try {
+    sourcemeta::jsonbinpack::load(std::span<const std::byte>{bytes});
+  } catch (const sourcemeta::jsonbinpack::EncodingError &) {
+    thrown = true;
+  } catch (const sourcemeta::core::IOReadOutOfBoundsError &) {
+    thrown = true;
+  }
+
+  EXPECT_TRUE(thrown);
+}
+
+static auto huge_count(std::vector<std::byte> bytes) -> std::vector<std::byte> {
+  for (std::size_t index = 0; index < 9; index++) {
+    bytes.push_back(std::byte{0xff});
+  }
+
+  bytes.push_back(std::byte{0x01});
+  return bytes;
+}
+
+TEST(serializer_huge_count) {
+  // The choices of a BYTE_CHOICE_INDEX
+  expect_malformed(huge_count({std::byte{0x01}, std::byte{0x05}}));
+  // The prefix encodings of a FIXED_TYPED_ARRAY of DOUBLE_VARINT_TUPLE
+  expect_malformed(huge_count({std::byte{0x01}, std::byte{0x10},
+                               std::byte{0x00}, std::byte{0x04}}));
+  // The required properties of a MIXED_BOUNDED_TYPED_OBJECT
+  expect_malformed(huge_count({std::byte{0x01}, std::byte{0x19}}));
+}
+
+TEST(serializer_deep_nesting) {
+  // A FLOOR_TYPED_ARRAY of a FLOOR_TYPED_ARRAY of a FLOOR_TYPED_ARRAY...
+  std::vector<std::byte> bytes{std::byte{0x01}};
+  for (std::size_t index = 0; index < 1000000; index++) {
+    bytes.push_back(std::byte{0x12});
+    bytes.push_back(std::byte{0x00});
+  }
+
+  bool thrown{false};
+  try {
+    sourcemeta::jsonbinpack::load(std::span<const std::byte>{bytes});
+  } catch (const sourcemeta::jsonbinpack::EncodingError &) {
+    thrown = true;
+  }
+
+  EXPECT_TRUE(thrown);
+}
+
+TEST(serializer_truncated_anywhere) {
+  std::vector<std::byte> bytes;
+  sourcemeta::jsonbinpack::save(
+      sourcemeta::jsonbinpack::load(
+          sourcemeta::core::parse_json(ENCODINGS[25])),
+      bytes);
+  for (std::size_t size = 0; size < bytes.size(); size++) {
+    expect_malformed(
+        {bytes.begin(), bytes.begin() + static_cast<std::ptrdiff_t>(size)});
+  }
+}
+
+static auto expect_invalid(const std::vector<std::uint8_t> &input) -> void {
+  std::vector<std::byte> bytes;
+  for (const auto byte : input) {
+    bytes.push_back(static_cast<std::byte>(byte));
+  }
+
+  bool thrown{false};
+  try {
+    sourcemeta::jsonbinpack::load(std::span<const std::byte>{bytes});
+  } catch (const sourcemeta::jsonbinpack::EncodingError &) {
+    thrown = true;
+  }
+
+  EXPECT_TRUE(thrown);
+}
+
+TEST(serializer_zero_multiplier) {
+  // BOUNDED_MULTIPLE_8BITS_ENUM_FIXED from 0 to 1
+  expect_invalid({0x01, 0x00, 0x00, 0x02, 0x00});
+  // FLOOR_MULTIPLE_ENUM_VARINT from 0
+  expect_invalid({0x01, 0x01, 0x00, 0x00});
+  // ROOF_MULTIPLE_MIRROR_ENUM_VARINT up to 0
+  expect_invalid({0x01, 0x02, 0x00, 0x00});
+  // ARBITRARY_MULTIPLE_ZIGZAG_VARINT
+  expect_invalid({0x01, 0x03, 0x00});
+}
+
+TEST(serializer_minimum_above_maximum) {
+  // BOUNDED_MULTIPLE_8BITS_ENUM_FIXED from 2 to 1
+  expect_invalid({0x01, 0x00, 0x04, 0x02, 0x01});
+  // BOUNDED_8BIT_PREFIX_UTF8_STRING_SHARED from 2 to 1
+  expect_invalid({0x01, 0x0d, 0x02, 0x01});
+  // BOUNDED_8BITS_TYPED_ARRAY from 2 to 1 of DOUBLE_VARINT_TUPLE
+  expect_invalid({0x01, 0x11, 0x02, 0x01, 0x04, 0x00});
+}
+
+TEST(serializer_range_above_byte) {
+  // BOUNDED_MULTIPLE_8BITS_ENUM_FIXED from 0 to 256
+  expect_invalid({0x01, 0x00, 0x00, 0x80, 0x04, 0x01});
+  // BOUNDED_8BIT_PREFIX_UTF8_STRING_SHARED from 0 to 256
+  expect_invalid({0x01, 0x0d, 0x00, 0x80, 0x02});
+  // BOUNDED_8BITS_TYPED_ARRAY from 0 to 256 of DOUBLE_VARINT_TUPLE
+  expect_invalid({0x01, 0x11, 0x00, 0x80, 0x02, 0x04, 0x00});
+}
+
+TEST(serializer_duplicate_property) {
+  // MIXED_BOUNDED_TYPED_OBJECT with "foo" both required and optional
+  expect_invalid({0x01, 0x19, 0x01, 0x03, 0x66, 0x6f, 0x6f, 0x01, 0x03, 0x66,
+                  0x6f, 0x6f, 0x02, 0x04, 0x04});
+}
@@ -67,6 +67,24 @@ TEST(TOP_LEVEL_BYTE_CHOICE_INDEX_scalars) {
             sourcemeta::core::JSON{3});
 }
 
+TEST(LARGE_CHOICE_INDEX_index) {
+  const sourcemeta::core::JSON input = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "LARGE_CHOICE_INDEX",
+    "binpackOptions": {
+      "choices": [ "USD", "EUR", "USD", { "foo": 1 } ]
+    }
+  })JSON");
+
+  const auto result{sourcemeta::jsonbinpack::load(input)};
+  using namespace sourcemeta::jsonbinpack;
+  EXPECT_TRUE(std::holds_alternative<LARGE_CHOICE_INDEX>(result));
+  const auto &options{std::get<LARGE_CHOICE_INDEX>(result)};
+  EXPECT_EQ(options.choices.size(), 4);
+  // Duplicated choices are only indexed once
+  EXPECT_EQ(options.index.size(), 3);
+}
+
 TEST(CONST_NONE_scalar) {
   const sourcemeta::core::JSON input = sourcemeta::core::parse_json(R"JSON({
     "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
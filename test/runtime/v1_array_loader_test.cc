@@ -242,3 +242,48 @@ TEST(ROOF_TYPED_ARRAY_enum_integer_number) {
                 .multiplier,
             1);
 }
+
+TEST(FLOOR_TYPED_LENGTH_PREFIX_ARRAY_offsets) {
+  const sourcemeta::core::JSON input = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "FLOOR_TYPED_LENGTH_PREFIX_ARRAY",
+    "binpackOptions": {
+      "minimum": 1,
+      "offsets": true,
+      "encoding": {
+        "binpackEncoding": "DOUBLE_VARINT_TUPLE",
+        "binpackOptions": {}
+      },
+      "prefixEncodings": []
+    }
+  })JSON");
+
+  const auto result{sourcemeta::jsonbinpack::load(input)};
+  using namespace sourcemeta::jsonbinpack;
+  EXPECT_TRUE(std::holds_alternative<FLOOR_TYPED_LENGTH_PREFIX_ARRAY>(result));
+  const auto &options{std::get<FLOOR_TYPED_LENGTH_PREFIX_ARRAY>(result)};
+  EXPECT_EQ(options.minimum, 1);
+  EXPECT_TRUE(options.offsets);
+  EXPECT_TRUE(std::holds_alternative<DOUBLE_VARINT_TUPLE>(*(options.encoding)));
+  EXPECT_EQ(options.prefix_encodings.size(), 0);
+}
+
+TEST(FLOOR_TYPED_LENGTH_PREFIX_ARRAY_no_offsets) {
+  const sourcemeta::core::JSON input = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "FLOOR_TYPED_LENGTH_PREFIX_ARRAY",
+    "binpackOptions": {
+      "minimum": 0,
+      "encoding": {
+        "binpackEncoding": "DOUBLE_VARINT_TUPLE",
+        "binpackOptions": {}
+      },
+      "prefixEncodings": []
+    }
+  })JSON");
+
+  const auto result{sourcemeta::jsonbinpack::load(input)};
+  using namespace sourcemeta::jsonbinpack;
+  EXPECT_TRUE(std::holds_alternative<FLOOR_TYPED_LENGTH_PREFIX_ARRAY>(result));
+  EXPECT_FALSE(std::get<FLOOR_TYPED_LENGTH_PREFIX_ARRAY>(result).offsets);
+}
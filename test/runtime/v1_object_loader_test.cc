@@ -0,0 +1,154 @@
+#include <sourcemeta/core/json.h>
+#include <sourcemeta/core/test.h>
+#include <sourcemeta/jsonbinpack/runtime.h>
+
+#include <variant>
+
+TEST(FIXED_TYPED_ARBITRARY_OBJECT_string_integer) {
+  const sourcemeta::core::JSON input = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "FIXED_TYPED_ARBITRARY_OBJECT",
+    "binpackOptions": {
+      "size": 2,
+      "keyEncoding": {
+        "binpackEncoding": "UTF8_STRING_NO_LENGTH",
+        "binpackOptions": { "size": 3 }
+      },
+      "encoding": {
+        "binpackEncoding": "ARBITRARY_MULTIPLE_ZIGZAG_VARINT",
+        "binpackOptions": { "multiplier": 1 }
+      }
+    }
+  })JSON");
+
+  const auto result{sourcemeta::jsonbinpack::load(input)};
+  using namespace sourcemeta::jsonbinpack;
+  EXPECT_TRUE(std::holds_alternative<FIXED_TYPED_ARBITRARY_OBJECT>(result));
+  const auto &options{std::get<FIXED_TYPED_ARBITRARY_OBJECT>(result)};
+  EXPECT_EQ(options.size, 2);
+  EXPECT_TRUE(
+      std::holds_alternative<UTF8_STRING_NO_LENGTH>(*(options.key_encoding)));
+  EXPECT_EQ(std::get<UTF8_STRING_NO_LENGTH>(*(options.key_encoding)).size, 3);
+  EXPECT_TRUE(std::holds_alternative<ARBITRARY_MULTIPLE_ZIGZAG_VARINT>(
+      *(options.encoding)));
+}
+
+TEST(VARINT_TYPED_ARBITRARY_OBJECT_string_any) {
+  const sourcemeta::core::JSON input = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "VARINT_TYPED_ARBITRARY_OBJECT",
+    "binpackOptions": {
+      "keyEncoding": {
+        "binpackEncoding": "PREFIX_VARINT_LENGTH_STRING_SHARED",
+        "binpackOptions": {}
+      },
+      "encoding": {
+        "binpackEncoding": "ANY_PACKED_TYPE_TAG_BYTE_PREFIX",
+        "binpackOptions": {}
+      }
+    }
+  })JSON");
+
+  const auto result{sourcemeta::jsonbinpack::load(input)};
+  using namespace sourcemeta::jsonbinpack;
+  EXPECT_TRUE(std::holds_alternative<VARINT_TYPED_ARBITRARY_OBJECT>(result));
+  const auto &options{std::get<VARINT_TYPED_ARBITRARY_OBJECT>(result)};
+  EXPECT_TRUE(std::holds_alternative<PREFIX_VARINT_LENGTH_STRING_SHARED>(
+      *(options.key_encoding)));
+  EXPECT_TRUE(std::holds_alternative<ANY_PACKED_TYPE_TAG_BYTE_PREFIX>(
+      *(options.encoding)));
+}
+
+TEST(VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT_offsets) {
+  const sourcemeta::core::JSON input = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT",
+    "binpackOptions": {
+      "keyEncoding": {
+        "binpackEncoding": "PREFIX_VARINT_LENGTH_STRING_SHARED",
+        "binpackOptions": {}
+      },
+      "encoding": {
+        "binpackEncoding": "ANY_PACKED_TYPE_TAG_BYTE_PREFIX",
+        "binpackOptions": {}
+      },
+      "offsets": true
+    }
+  })JSON");
+
+  const auto result{sourcemeta::jsonbinpack::load(input)};
+  using namespace sourcemeta::jsonbinpack;
+  EXPECT_TRUE(
+      std::holds_alternative<VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT>(
+          result));
+  EXPECT_TRUE(
+      std::get<VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT>(result).offsets);
+}
+
+TEST(VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT_no_offsets) {
+  const sourcemeta::core::JSON input = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT",
+    "binpackOptions": {
+      "keyEncoding": {
+        "binpackEncoding": "PREFIX_VARINT_LENGTH_STRING_SHARED",
+        "binpackOptions": {}
+      },
+      "encoding": {
+        "binpackEncoding": "ANY_PACKED_TYPE_TAG_BYTE_PREFIX",
+        "binpackOptions": {}
+      }
+    }
+  })JSON");
+
+  const auto result{sourcemeta::jsonbinpack::load(input)};
+  using namespace sourcemeta::jsonbinpack;
+  EXPECT_TRUE(
+      std::holds_alternative<VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT>(
+          result));
+  EXPECT_FALSE(
+      std::get<VARINT_TYPED_LENGTH_PREFIX_ARBITRARY_OBJECT>(result).offsets);
+}
+
+TEST(MIXED_BOUNDED_TYPED_OBJECT_required_optional) {
+  const sourcemeta::core::JSON input = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "MIXED_BOUNDED_TYPED_OBJECT",
+    "binpackOptions": {
+      "requiredProperties": [ "id" ],
+      "optionalProperties": [ "name", "tag" ],
+      "propertyEncodings": {
+        "tag": {
+          "binpackEncoding": "BYTE_CHOICE_INDEX",
+          "binpackOptions": { "choices": [ "foo", "bar" ] }
+        },
+        "name": {
+          "binpackEncoding": "PREFIX_VARINT_LENGTH_STRING_SHARED",
+          "binpackOptions": {}
+        },
+        "id": {
+          "binpackEncoding": "FLOOR_MULTIPLE_ENUM_VARINT",
+          "binpackOptions": { "minimum": 0, "multiplier": 1 }
+        }
+      }
+    }
+  })JSON");
+
+  const auto result{sourcemeta::jsonbinpack::load(input)};
+  using namespace sourcemeta::jsonbinpack;
+  EXPECT_TRUE(std::holds_alternative<MIXED_BOUNDED_TYPED_OBJECT>(result));
+  const auto &options{std::get<MIXED_BOUNDED_TYPED_OBJECT>(result)};
+  EXPECT_EQ(options.required.size(), 1);
+  EXPECT_EQ(options.required.at(0), "id");
+  EXPECT_EQ(options.optional.size(), 2);
+  EXPECT_EQ(options.optional.at(0), "name");
+  EXPECT_EQ(options.optional.at(1), "tag");
+  // The encodings follow the order of the properties
+  EXPECT_EQ(options.encodings.size(), 3);
+  EXPECT_TRUE(std::holds_alternative<FLOOR_MULTIPLE_ENUM_VARINT>(
+      options.encodings.at(0)));
+  EXPECT_TRUE(std::holds_alternative<PREFIX_VARINT_LENGTH_STRING_SHARED>(
+      options.encodings.at(1)));
+  EXPECT_TRUE(
+      std::holds_alternative<BYTE_CHOICE_INDEX>(options.encodings.at(2)));
+}
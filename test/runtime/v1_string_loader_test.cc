@@ -96,3 +96,15 @@ TEST(PREFIX_VARINT_LENGTH_STRING_SHARED) {
   EXPECT_TRUE(
       std::holds_alternative<PREFIX_VARINT_LENGTH_STRING_SHARED>(result));
 }
+
+TEST(GZIP_VARINT_PREFIX_UTF8_STRING) {
+  const sourcemeta::core::JSON input = sourcemeta::core::parse_json(R"JSON({
+    "$schema": "tag:sourcemeta.com,2024:jsonbinpack/encoding/v1",
+    "binpackEncoding": "GZIP_VARINT_PREFIX_UTF8_STRING",
+    "binpackOptions": {}
+  })JSON");
+
+  const auto result{sourcemeta::jsonbinpack::load(input)};
+  using namespace sourcemeta::jsonbinpack;
+  EXPECT_TRUE(std::holds_alternative<GZIP_VARINT_PREFIX_UTF8_STRING>(result));
+}